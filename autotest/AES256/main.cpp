@@ -81,5 +81,74 @@ CONSOLE_APP_MAIN
 			DeleteFile(filename);
 	}
 
+	// Segmented format, parallel
+	for(int len : { 0, 1, 1024 * 1024 - 1, 1024 * 1024, 1024 * 1024 + 1, 5 * 1024 * 1024 + 7 }) {
+		String data = large_string.Mid(0, min(len, large_string.GetLength()));
+		while(data.GetLength() < len)
+			data << (char)Random(256);
+		encrypted = CoAES256Encrypt(data, password);
+		ASSERT(!encrypted.IsVoid());
+		ASSERT(CoAES256Decrypt(encrypted, password) == data);
+		ASSERT(AES256Decrypt(encrypted, password) == data);
+		ASSERT(CoAES256Decrypt(encrypted, "wrong_password").IsVoid());
+	}
+	
+	// v1 format can be decrypted by Co
+	ASSERT(CoAES256Decrypt(AES256Encrypt(original, password), password) == original);
+	
+	{
+		const int SEGMENT = 1024;
+		const int HEADER = 7 + 4 + 16 + 16 + 7;
+		const int BLOCK = SEGMENT + 16;
+		String data = large_string.Mid(0, 10 * SEGMENT + 100);
+		Aes256Gcm aes;
+		aes.Co().SegmentSize(SEGMENT);
+		ASSERT(aes.Encrypt(data, password, encrypted));
+		ASSERT(encrypted.GetLength() == HEADER + 11 * 16 + data.GetLength());
+		ASSERT(aes.Decrypt(encrypted, password, decrypted) && decrypted == data);
+		
+		// Truncation at segment boundary
+		ASSERT(!aes.Decrypt(encrypted.Mid(0, HEADER + 5 * BLOCK), password, decrypted));
+		ASSERT(!aes.Decrypt(encrypted.Mid(0, HEADER), password, decrypted));
+		
+		// Reordering of segments
+		String swapped = encrypted.Mid(0, HEADER) + encrypted.Mid(HEADER + BLOCK, BLOCK) +
+		                 encrypted.Mid(HEADER, BLOCK) + encrypted.Mid(HEADER + 2 * BLOCK);
+		ASSERT(!aes.Decrypt(swapped, password, decrypted));
+		
+		// Trailing data
+		ASSERT(!aes.Decrypt(encrypted + encrypted.Mid(HEADER, BLOCK), password, decrypted));
+		
+		// Tampering of header and data
+		for(int pos : { 8, 20, 30, HEADER - 1, HEADER + 3 * BLOCK + 5 }) {
+			String t = encrypted; // StringBuffer would pick encrypted
+			t.Set(pos, t[pos] ^ 0x01);
+			ASSERT(!aes.Decrypt(t, password, decrypted));
+		}
+	}
+	
+	// Key cache
+	ClearAES256KeyCache();
+	{
+		Aes256Gcm aes;
+		aes.Co().KeyCache(false);
+		ASSERT(aes.Encrypt(original, password, encrypted));
+		ASSERT(CoAES256Decrypt(encrypted, password) == original);
+		ASSERT(CoAES256Decrypt(encrypted, password) == original);
+	}
+	{ // cached PBKDF2 salt is shared, but stream salt, nonce and therefore key are not
+		String a = CoAES256Encrypt(original, password);
+		String b = CoAES256Encrypt(original, password);
+		ASSERT(a.Mid(11, 16) == b.Mid(11, 16));
+		ASSERT(a.Mid(27, 16) != b.Mid(27, 16) && a.Mid(43, 7) != b.Mid(43, 7));
+		ASSERT(CoAES256Decrypt(a, password) == original && CoAES256Decrypt(b, password) == original);
+		
+		// GCMv1 encrypts with PBKDF2 key, so the salt is never reused
+		a = AES256Encrypt(original, password);
+		b = AES256Encrypt(original, password);
+		ASSERT(a.Mid(7, 16) != b.Mid(7, 16));
+		ASSERT(AES256Decrypt(a, password) == original && AES256Decrypt(b, password) == original);
+	}
+
 	LOG("================ OK");
 }
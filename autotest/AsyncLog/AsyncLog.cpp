@@ -0,0 +1,136 @@
+#include <Core/Core.h>
+
+using namespace Upp;
+
+String ReadParts(const String& path, int n)
+{
+	String r;
+	for(int i = n; i >= 0; i--) {
+		String fn = i ? path + "." + AsString(i) : path;
+		String gz = fn + ".gz";
+		if(FileExists(gz))
+			r << GZDecompress(LoadFile(gz));
+		else
+			r << LoadFile(fn);
+	}
+	return r;
+}
+
+void DeleteParts(const String& path)
+{
+	for(int i = 0; i < 10; i++) {
+		String fn = i ? path + "." + AsString(i) : path;
+		DeleteFile(fn);
+		DeleteFile(fn + ".gz");
+	}
+}
+
+void LogThreads(int threads, int lines)
+{
+	Array<Thread> t;
+	for(int i = 0; i < threads; i++)
+		t.Add().Run([=] {
+			for(int j = 0; j < lines; j++)
+				RLOG("T" << i << ' ' << j);
+		});
+	for(Thread& h : t)
+		h.Wait();
+}
+
+// Checks that lines of each thread are in order, returns number of lines found
+int CheckLines(const String& log, int threads, bool complete, int lines)
+{
+	Vector<int> next;
+	next.SetCount(threads, 0);
+	int count = 0;
+	for(const String& l : Split(log, '\n')) {
+		const char *s = strchr(l, 'T'); // skip timestamp
+		if(!s || !IsDigit(s[1]))
+			continue;
+		CParser p(s + 1);
+		int t = p.ReadInt();
+		int j = p.ReadInt();
+		ASSERT(t >= 0 && t < threads);
+		if(complete)
+			ASSERT(j == next[t]);
+		else
+			ASSERT(j >= next[t]);
+		next[t] = j + 1;
+		count++;
+	}
+	if(complete)
+		for(int n : next)
+			ASSERT(n == lines);
+	return count;
+}
+
+CONSOLE_APP_MAIN
+{
+	String path = GetHomeDirFile("AsyncLog.log");
+
+	{ // all lines are written, each thread in order, files are rotated by size
+		DeleteParts(path);
+		StdLogSetup(LOG_FILE|LOG_ASYNC|LOG_TIMESTAMP|LOG_ROTATE(9), path, 300000);
+		LogThreads(8, 5000);
+		StdLogFlush();
+		ASSERT(FileExists(path + ".1") && FileExists(path + ".2"));
+		ASSERT(CheckLines(ReadParts(path, 9), 8, true, 5000) == 8 * 5000);
+		Cout() << "rotation by size OK\n";
+	}
+
+	{ // older parts are compressed
+		DeleteParts(path);
+		StdLogSetup(LOG_FILE|LOG_ASYNC|LOG_ROTATE_GZIP|LOG_ROTATE(9), path, 40000);
+		LogThreads(2, 10000);
+		StdLogFlush();
+		ASSERT(FileExists(path + ".1") && FileExists(path + ".2.gz"));
+		ASSERT(CheckLines(ReadParts(path, 9), 2, true, 10000) == 2 * 10000);
+		Cout() << "compression OK\n";
+	}
+
+	{ // without LOG_ROTATE, previous part is kept
+		DeleteParts(path);
+		StdLogSetup(LOG_FILE|LOG_ASYNC, path, 50000);
+		LogThreads(1, 20000);
+		StdLogFlush();
+		ASSERT(FileExists(path + ".1") && !FileExists(path + ".2"));
+		ASSERT(GetFileLength(path + ".1") > 50000);
+		Cout() << "single part OK\n";
+	}
+
+	{ // rotation by time
+		DeleteParts(path);
+		StdLogSetup(LOG_FILE|LOG_ASYNC|LOG_ROTATE(3), path, INT_MAX, 1);
+		RLOG("T0 0");
+		Sleep(1100);
+		RLOG("T0 1");
+		StdLogFlush();
+		ASSERT(FileExists(path + ".1"));
+		ASSERT(CheckLines(ReadParts(path, 3), 1, true, 2) == 2);
+		Cout() << "rotation by time OK\n";
+	}
+
+	{ // drop policy: lines are either written or counted as dropped
+		DeleteParts(path);
+		StdLogSetup(LOG_FILE|LOG_ASYNC|LOG_ASYNC_DROP|LOG_ROTATE(9), path, INT_MAX);
+		int64 dropped = GetStdLogDropped();
+		LogThreads(4, 50000);
+		StdLogFlush();
+		int64 d = GetStdLogDropped() - dropped;
+		int n = CheckLines(ReadParts(path, 9), 4, false, 50000);
+		ASSERT(n + d == 4 * 50000);
+		ASSERT(!d || LoadFile(path).Find("log lines dropped") >= 0);
+		Cout() << "dropped " << d << " lines, drop policy OK\n";
+	}
+
+	{ // synchronous logging still works after async
+		DeleteParts(path);
+		StdLogSetup(LOG_FILE, path);
+		LogThreads(4, 1000);
+		ASSERT(CheckLines(LoadFile(path), 4, true, 1000) == 4000);
+	}
+
+	DeleteParts(path);
+	StdLogSetup(LOG_FILE|LOG_COUT);
+	LOG("============ OK");
+}
@@ -0,0 +1,165 @@
+#include <plugin/zstd/zstd.h>
+#include <plugin/lz4/lz4.h>
+#include <plugin/bz2/bz2.h>
+#include <plugin/lzma/lzma.h>
+
+using namespace Upp;
+
+String TestData(int len)
+{
+	String s;
+	while(s.GetCount() < len)
+		s << "Line " << Random(1000) << " of test data " << FormatIntHex(Random()) << "\n";
+	s.Trim(len);
+	return s;
+}
+
+struct NonSeekableStream : Stream { // like pipe or socket, data arrive in small chunks
+	String data;
+	int    at = 0;
+	byte   chunk[100];
+
+	virtual int _Term() {
+		if(ptr < rdlim)
+			return *ptr;
+		pos += rdlim - buffer;
+		int n = min(data.GetCount() - at, (int)sizeof(chunk));
+		memcpy(chunk, ~data + at, n);
+		at += n;
+		ptr = buffer = chunk;
+		rdlim = chunk + n;
+		return n ? *ptr : -1;
+	}
+	virtual int _Get() {
+		int c = _Term();
+		if(c >= 0)
+			ptr++;
+		return c;
+	}
+	virtual dword _Get(void *data, dword size) {
+		dword n = 0;
+		while(n < size && _Term() >= 0)
+			((byte *)data)[n++] = *ptr++;
+		return n;
+	}
+	virtual bool IsOpen() const { return true; }
+
+	NonSeekableStream(const String& data) : data(data) {
+		style = STRM_READ|STRM_LOADING;
+		ptr = rdlim = buffer = chunk;
+	}
+};
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+	
+	SeedRandom(0);
+	
+	const char *name[] = { "gz", "zstd", "lz4", "bz2", "lzma" };
+	ASSERT(CodecRegistry::GetCount() == __countof(name));
+	for(const char *n : name) {
+		const StreamCodec *c = CodecRegistry::Find(n);
+		ASSERT(c && c->name == n);
+		ASSERT(CodecRegistry::Find(c->extension) == c);
+		ASSERT(CodecRegistry::Find(c->extension.Mid(1)) == c);
+	}
+	ASSERT(!CodecRegistry::Find("xyz"));
+	
+	String data = TestData(20 * 1024 * 1024 + 12345);
+	for(const char *n : name) {
+		const StreamCodec& c = *CodecRegistry::Find(n);
+		for(int len : { 0, 1, 1000, c.block_size, 3 * c.block_size + 17, data.GetCount() }) {
+			if(len > 8 * 1024 * 1024 && c.name == "lzma")
+				continue; // too slow for autotest
+			String src = data.Mid(0, len);
+			for(int threads : { 1, 4 }) {
+				String z = CodecCompress(src, n, Null, threads);
+				ASSERT(!z.IsVoid());
+				RLOG(n << ", threads " << threads << ": " << len << " -> " << z.GetCount());
+				ASSERT(CodecRegistry::Detect(~z, z.GetCount()) == &c);
+				StringStream ss(z);
+				ASSERT(CodecRegistry::Detect(ss) == &c && ss.GetPos() == 0);
+				for(int dthreads : { 1, 3 })
+					ASSERT(CodecDecompress(z, dthreads) == src);
+			}
+		}
+	}
+	
+	// multithreaded compression produces the same data as single threaded
+	for(const char *n : { "gz", "zstd", "lz4", "bz2" })
+		ASSERT(CodecCompress(data, n, Null, 1) == CodecCompress(data, n, Null, 4));
+
+	// output is readable by single-format decompressors
+	String src = data.Mid(0, 5 * 1024 * 1024);
+	ASSERT(GZDecompress(CodecCompress(src, "gz")) == src);
+	ASSERT(ZstdDecompress(CodecCompress(src, "zstd")) == src);
+	ASSERT(LZ4Decompress(CodecCompress(src, "lz4")) == src);
+	ASSERT(BZ2Decompress(CodecCompress(src, "bz2")) == src);
+	
+	// concatenated members / frames
+	String a = data.Mid(0, 1000);
+	String b = data.Mid(1000, 2000);
+	ASSERT(GZDecompress(GZCompress(a) + GZCompress(b)) == a + b);
+	ASSERT(LZ4Decompress(LZ4Compress(a) + LZ4Compress(b)) == a + b);
+	ASSERT(CodecDecompress(LZ4Compress(a) + LZ4Compress(b)) == a + b);
+	ASSERT(CodecDecompress(LZMACompress(a) + LZMACompress(b)) == a + b);
+	ASSERT(CodecDecompress(BZ2Compress(a) + BZ2Compress(b)) == a + b);
+
+	// streaming API
+	{
+		StringStream out;
+		One<Stream> s = OpenCompressStream(out, "zstd", 5, 2);
+		ASSERT(s);
+		for(int i = 0; i < 100000; i++)
+			*s << i << "\n";
+		s->Close();
+		StringStream in(out.GetResult());
+		One<Stream> d = OpenDecompressStream(in, 2);
+		ASSERT(d);
+		for(int i = 0; i < 100000; i++)
+			ASSERT(d->GetLine() == AsString(i));
+		ASSERT(d->IsEof());
+	}
+	
+	// non-seekable input
+	for(const char *n : name) {
+		String z = CodecCompress(src.Mid(0, 100000), n);
+		NonSeekableStream in(z);
+		ASSERT(CodecRegistry::Detect(in) == CodecRegistry::Find(n) && in.GetPos() == 0);
+		One<Stream> d = OpenDecompressStream(in);
+		ASSERT(d);
+		String r;
+		while(!d->IsEof())
+			r.Cat(d->Get(4096));
+		ASSERT(r == src.Mid(0, 100000));
+	}
+
+	// errors
+	{
+		StringStream in("not compressed data");
+		ASSERT(!OpenDecompressStream(in));
+	}
+	for(const char *n : name) {
+		String z = CodecCompress(src.Mid(0, 100000), n);
+		z.Trim(z.GetCount() / 2);
+		ASSERT(CodecDecompress(z).IsVoid());
+		ASSERT(CodecDecompress(z, 3).IsVoid());
+	}
+	
+	{ // replacing codec does not invalidate pointers already obtained
+		const StreamCodec *gz = CodecRegistry::Find("gz");
+		StreamCodec c = *gz;
+		c.block_size = 12345;
+		CodecRegistry::Register(c);
+		ASSERT(CodecRegistry::GetCount() == __countof(name));
+		const StreamCodec *gz2 = CodecRegistry::Find("gz");
+		ASSERT(gz2 != gz && gz2->block_size == 12345 && gz->block_size == 1024 * 1024);
+		ASSERT(gz->name == "gz" && gz->CompressBlock);
+		String z = GZCompress(a);
+		ASSERT(CodecRegistry::Detect(~z, z.GetCount()) == gz2);
+		ASSERT(CodecDecompress(CodecCompress(src, "gz")) == src);
+	}
+
+	LOG("============ OK");
+}
@@ -0,0 +1,176 @@
+#include <Core/Core.h>
+
+using namespace Upp;
+
+String Dump(const Vector<Vector<String>>& data)
+{
+	String r;
+	for(const Vector<String>& row : data)
+		r << Join(row, "|") << "\n";
+	return r;
+}
+
+Vector<Vector<String>> ReadFetch(CsvReader& csv)
+{
+	Vector<Vector<String>> r;
+	while(csv.Fetch())
+		r.Add(csv.GetRecord());
+	return r;
+}
+
+String Generate(int n)
+{
+	String r;
+	for(int i = 0; i < n; i++) {
+		r << i << ',' << i * 0.5 << ',';
+		switch(i % 5) {
+		case 0: r << "plain"; break;
+		case 1: r << "\"quoted, with separator\""; break;
+		case 2: r << "\"multi\nline \"\"text\"\"\""; break;
+		case 3: r << "\"\""; break;
+		case 4: r << "\"" << String('x', i % 300) << "\r\n\"\"\""; break;
+		}
+		r << (i % 3 ? "\n" : "\r\n");
+	}
+	return r;
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+	{ // basic parsing
+		String s = "a,b,c\r\n1,\"x,y\",\"say \"\"hi\"\"\"\n\n\"multi\nline\",,end";
+		CsvReader csv;
+		csv.Open(s);
+		String r = Dump(ReadFetch(csv));
+		LOG(r);
+		ASSERT(r == "a|b|c\n1|x,y|say \"hi\"\nmulti\nline||end\n");
+		ASSERT(csv.GetIndex() == 2);
+
+		StringStream ss(s);
+		ASSERT(Join(GetCsvLine(ss, ',', CHARSET_DEFAULT), "|") == "a|b|c");
+	}
+
+	{ // header, values by column name
+		CsvReader csv;
+		csv.Header().Separator(';').Open(String("id;value;name\n1;1.5;one\n2;x;two\n"));
+		ASSERT(Join(csv.GetHeader(), "|") == "id|value|name");
+		ASSERT(csv.FindColumn("name") == 2 && csv.FindColumn("none") < 0);
+		ASSERT(csv.Fetch());
+		ASSERT(csv.GetInt64(0) == 1 && csv.GetDouble(1) == 1.5 && csv["name"] == "one");
+		ASSERT(csv.Fetch());
+		ASSERT(csv.GetInt64(0) == 2 && IsNull(csv.GetDouble(1)) && csv["name"] == "two");
+		ASSERT(IsNull(csv.GetInt64(10)) && IsNull(csv.Get(10)));
+		ASSERT(!csv.Fetch());
+		ASSERT(csv.GetIndex() == 1);
+	}
+
+	String data = Generate(20000);
+
+	CsvReader csv;
+	csv.NoParallel().Open(data);
+	Vector<Vector<String>> ref = ReadFetch(csv);
+	ASSERT(ref.GetCount() == 20000);
+	for(int i = 0; i < ref.GetCount(); i++) {
+		ASSERT(ref[i].GetCount() == 3);
+		ASSERT(ref[i][0] == AsString(i));
+	}
+	ASSERT(ref[2][2] == "multi\nline \"text\"");
+	ASSERT(ref[3][2] == "");
+	ASSERT(ref[4][2] == "xxxx\n\"");
+	String dump = Dump(ref);
+
+	for(int chunk : { 64, 1000, 65536, 1024 * 1024 }) { // small chunks split quoted multiline fields
+		LOG("Chunk size " << chunk);
+		for(int parallel = 0; parallel < 2; parallel++) {
+			csv.ChunkSize(chunk).Parallel(parallel).Open(data);
+			ASSERT(csv.CountRecords() == ref.GetCount());
+
+			csv.Open(data);
+			ASSERT(Dump(csv.ReadAll()) == dump);
+
+			csv.Open(data);
+			Vector<int64> id = csv.ReadInt64(0);
+			ASSERT(id.GetCount() == ref.GetCount());
+			for(int i = 0; i < id.GetCount(); i++)
+				ASSERT(id[i] == i);
+
+			csv.Open(data);
+			Vector<double> x = csv.ReadDouble(1);
+			ASSERT(x.GetCount() == ref.GetCount());
+			for(int i = 0; i < x.GetCount(); i++)
+				ASSERT(x[i] == i * 0.5);
+
+			StringStream ss(data);
+			csv.Open(ss);
+			Vector<String> text = csv.ReadString(2);
+			ASSERT(text.GetCount() == ref.GetCount());
+			for(int i = 0; i < text.GetCount(); i++)
+				ASSERT(text[i] == ref[i][2]);
+			ASSERT(csv.GetIndex() == ref.GetCount() - 1);
+
+			StringStream ss2(data);
+			csv.Open(ss2);
+			ASSERT(Dump(ReadFetch(csv)) == dump);
+		}
+	}
+
+	{ // file mapping, fetch continues with bulk read
+		String path = GetHomeDirFile("csv_test.csv");
+		SaveFile(path, data);
+		CsvReader csv;
+		ASSERT(csv.OpenFile(path));
+		for(int i = 0; i < 100; i++)
+			ASSERT(csv.Fetch() && csv.GetInt64(0) == i);
+		ASSERT(csv.GetIndex() == 99);
+		Vector<int64> id = csv.ChunkSize(1000).ReadInt64(0);
+		ASSERT(id.GetCount() == ref.GetCount() - 100 && id[0] == 100 && id.Top() == ref.GetCount() - 1);
+		ASSERT(csv.GetIndex() == ref.GetCount() - 1);
+		csv.Close();
+		DeleteFile(path);
+
+		SaveFile(path, "");
+		ASSERT(csv.OpenFile(path) && !csv.Fetch() && csv.CountRecords() == 0);
+		csv.Close();
+		DeleteFile(path);
+		ASSERT(!csv.OpenFile(path));
+	}
+
+	{ // writer round trip
+		StringStream ss;
+		CsvWriter out(ss);
+		for(const Vector<String>& row : ref)
+			out.PutRow(row);
+		out << 123 << (int64)Null << 1.25 << Value(7) << Value("a;b") << Value() << "";
+		out.EndRow();
+		out.Put("");
+		out.EndRow();
+		String h = ss.GetResult();
+		ASSERT(h.EndsWith("\r\n123,,1.25,7,a;b,,\r\n\"\"\r\n"));
+
+		CsvReader csv;
+		csv.Open(h);
+		Vector<Vector<String>> r = ReadFetch(csv);
+		ASSERT(r.GetCount() == ref.GetCount() + 2);
+		ASSERT(Join(r[ref.GetCount()], "|") == "123||1.25|7|a;b||");
+		ASSERT(r.Top().GetCount() == 1 && r.Top()[0] == "");
+		r.SetCount(ref.GetCount());
+		ASSERT(Dump(r) == dump);
+
+		StringStream ss2;
+		CsvWriter(ss2).Separator(';').QuoteAll().LineEnd("\n").PutRow({ "a", "b\"c" });
+		ASSERT(ss2.GetResult() == "\"a\";\"b\"\"c\"\n");
+	}
+
+	{ // charset
+		CsvReader csv;
+		csv.Charset(CHARSET_ISO8859_1).Open(String("\xe1,b"));
+		ASSERT(csv.Fetch() && csv[0] == ToCharset(CHARSET_DEFAULT, "\xe1", CHARSET_ISO8859_1));
+		StringStream ss;
+		CsvWriter(ss).Charset(CHARSET_ISO8859_1).PutRow({ csv[0], "b" });
+		ASSERT(ss.GetResult() == "\xe1,b\r\n");
+	}
+
+	LOG("============ OK");
+}
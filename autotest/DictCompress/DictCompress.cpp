@@ -0,0 +1,159 @@
+#include <plugin/zstd/zstd.h>
+#include <plugin/lz4/lz4.h>
+
+using namespace Upp;
+
+String Record(int i)
+{
+	static const char *city[] = { "Prague", "Berlin", "Paris", "Vienna", "London", "Madrid" };
+	String r;
+	r << "{\"id\":" << i << ",\"name\":\"customer" << Random(100000) << "\",\"city\":\""
+	  << city[Random(__countof(city))] << "\",\"active\":" << (Random(2) ? "true" : "false")
+	  << ",\"orders\":[";
+	int n = Random(20);
+	for(int j = 0; j < n; j++)
+		r << (j ? "," : "") << "{\"item\":" << Random(1000) << ",\"price\":" << Random(10000) / 100.0 << "}";
+	r << "]}";
+	return r;
+}
+
+String StreamedFrame(const String& s, const ZSTD_CDict *cdict = NULL) // without content size
+{
+	ZSTD_CCtx *cc = ZSTD_createCCtx();
+	ZSTD_CCtx_setParameter(cc, ZSTD_c_contentSizeFlag, 0);
+	if(cdict)
+		ZSTD_CCtx_refCDict(cc, cdict);
+	ZSTD_inBuffer in = { ~s, (size_t)s.GetCount(), 0 };
+	Buffer<char> h(ZSTD_compressBound(s.GetCount()));
+	ZSTD_outBuffer out = { ~h, ZSTD_compressBound(s.GetCount()), 0 };
+	while(ZSTD_compressStream2(cc, &out, &in, ZSTD_e_end));
+	ZSTD_freeCCtx(cc);
+	String c(~h, (int)out.pos);
+	ASSERT(ZSTD_getFrameContentSize(~c, c.GetCount()) == ZSTD_CONTENTSIZE_UNKNOWN);
+	return c;
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+	
+	SeedRandom(0);
+
+	Vector<String> sample, data;
+	for(int i = 0; i < 2000; i++)
+		sample.Add(Record(i));
+	for(int i = 0; i < 2000; i++)
+		data.Add(Record(i));
+	data.Add(); // empty record
+
+	String d = ZstdTrainDictionary(sample, 16 * 1024);
+	ASSERT(!d.IsVoid() && d.GetCount() > 1024 && d.GetCount() <= 16 * 1024);
+	RLOG("Trained dictionary: " << d.GetCount() << " bytes");
+	
+	ZstdDictionary zd(d, 3);
+	ASSERT(!zd.IsEmpty());
+	ASSERT(zd.GetId());
+	
+	ZstdContext ctx;
+	int64 raw = 0, plain = 0, dict = 0;
+	for(const String& s : data) {
+		String c = ctx.Compress(s, zd);
+		ASSERT(!c.IsVoid());
+		ASSERT(ctx.Decompress(c, zd) == s);
+		ASSERT(ZstdDecompress(ZstdCompress(s, zd), zd) == s);
+		String p = ctx.Compress(s, 3);
+		ASSERT(ctx.Decompress(p) == s);
+		ASSERT(ZstdDecompress(p) == s); // regular zstd frame
+		raw += s.GetCount();
+		plain += p.GetCount();
+		dict += c.GetCount();
+	}
+	RLOG("zstd: raw " << raw << ", plain " << plain << ", dictionary " << dict);
+	ASSERT(dict < plain * 2 / 3);
+	
+	{ // wrong dictionary must be detected
+		ZstdDictionary other(ZstdTrainDictionary(data, 8 * 1024));
+		ASSERT(!other.IsEmpty() && other.GetId() != zd.GetId());
+		ASSERT(ctx.Decompress(ctx.Compress(data[0], zd), other).IsVoid());
+		ASSERT(ctx.Decompress(ctx.Compress(data[0], zd)).IsVoid());
+	}
+	
+	ASSERT(ctx.Decompress(String("garbage")).IsVoid());
+	ASSERT(ctx.Decompress(ctx.Compress(data[0], zd).Mid(0, 10), zd).IsVoid());
+	
+	{ // frame without content size, as produced by stream
+		String s;
+		for(int i = 0; i < 100; i++)
+			s << data[i];
+		ASSERT(ctx.Decompress(StreamedFrame(s)) == s);
+	}
+
+	{ // streamed frame with dictionary must not leave the dictionary referenced by context
+		String s = data[0] + data[1];
+		String c;
+		{
+			ZstdDictionary tmp(d, 3);
+			c = StreamedFrame(s, tmp.GetCDict());
+			ASSERT(ctx.Decompress(c, tmp) == s);
+			ASSERT(ZstdDecompress(c, tmp) == s);
+		}
+		String p = ctx.Compress(s, 3);
+		ASSERT(ctx.Decompress(p) == s);
+		ASSERT(ctx.Decompress(ctx.Compress(s, zd)).IsVoid());
+		ASSERT(ZstdDecompress(p, ZstdDictionary()) == s);
+		ASSERT(ZstdDecompress(ZstdCompress(s, zd), ZstdDictionary()).IsVoid());
+		ASSERT(ctx.Decompress(c).IsVoid());
+	}
+
+	{ // size in frame header does not force allocation, maximal size
+		String s('a', 10 * 1024 * 1024);
+		String c = ctx.Compress(s, 3);
+		ASSERT(c.GetCount() < 10000);
+		ASSERT(ctx.Decompress(c) == s);
+		ctx.MaxSize(1024 * 1024);
+		ASSERT(ctx.Decompress(c).IsVoid());
+		ASSERT(ctx.Decompress(StreamedFrame(String('b', 1024 * 1024 + 1))).IsVoid());
+		ASSERT(ctx.Decompress(StreamedFrame(String('b', 1024 * 1024))).GetCount() == 1024 * 1024);
+		ASSERT(ctx.Decompress(ctx.Compress(data[0], 3)) == data[0]);
+		ctx.MaxSize(data[0].GetCount() - 1);
+		ASSERT(ctx.Decompress(ctx.Compress(data[0], 3)).IsVoid());
+		ctx.MaxSize(INT_MAX);
+	}
+
+	Vector<String> cz = CoZstdCompress(data, zd);
+	Vector<String> dz = CoZstdDecompress(cz, zd);
+	ASSERT(dz == data);
+	
+	LZ4Dictionary ld(d);
+	ASSERT(!ld.IsEmpty());
+	LZ4Dictionary none;
+	int64 lplain = 0, ldict = 0;
+	for(const String& s : data) {
+		String c = LZ4CompressRecord(s, ld);
+		ASSERT(LZ4DecompressRecord(c, ld) == s);
+		String p = LZ4CompressRecord(s, none);
+		ASSERT(LZ4DecompressRecord(p, none) == s);
+		lplain += p.GetCount();
+		ldict += c.GetCount();
+	}
+	RLOG("lz4: raw " << raw << ", plain " << lplain << ", dictionary " << ldict);
+	ASSERT(ldict < lplain);
+	
+	ASSERT(LZ4DecompressRecord(String(), ld).IsVoid());
+	ASSERT(LZ4DecompressRecord(LZ4CompressRecord(data[0], ld).Mid(0, 10), ld).IsVoid());
+	
+	Vector<String> cl = CoLZ4CompressRecords(data, ld);
+	ASSERT(CoLZ4DecompressRecords(cl, ld) == data);
+	
+	{ // dictionary larger than LZ4 window
+		String big;
+		while(big.GetCount() < 200000)
+			big << Record(Random(1000));
+		LZ4Dictionary bd(big);
+		ASSERT(bd.Get().GetCount() == 65536);
+		for(int i = 0; i < 100; i++)
+			ASSERT(LZ4DecompressRecord(LZ4CompressRecord(data[i], bd), bd) == data[i]);
+	}
+
+	LOG("============ OK");
+}
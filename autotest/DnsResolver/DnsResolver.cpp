@@ -0,0 +1,241 @@
+#include <Core/Core.h>
+
+#ifdef PLATFORM_POSIX
+#include <arpa/inet.h>
+#endif
+
+using namespace Upp;
+
+const int PORT = 5354;
+
+std::atomic<int> queries;
+std::atomic<bool> quit;
+
+String Name(const char *s, int len, int& pos)
+{
+	String r;
+	while(pos < len && s[pos]) {
+		int l = (byte)s[pos++];
+		if(r.GetCount())
+			r << '.';
+		r.Cat(s + pos, l);
+		pos += l;
+	}
+	pos++;
+	return r;
+}
+
+void DnsServer() // simple stand-in DNS server
+{
+	auto Bind = [](int port) {
+		SOCKET s = socket(AF_INET, SOCK_DGRAM, 0);
+		sockaddr_in sin;
+		Zero(sin);
+		sin.sin_family = AF_INET;
+		sin.sin_port = htons(port);
+		sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		ASSERT(bind(s, (sockaddr *)&sin, sizeof(sin)) == 0);
+		return s;
+	};
+	SOCKET s = Bind(PORT);
+	SOCKET s2 = Bind(PORT + 2); // answers from unexpected port
+	while(!quit) {
+		SocketWaitEvent we;
+		we.Add(s, WAIT_READ);
+		if(we.Wait(10) <= 0)
+			continue;
+		char q[512];
+		sockaddr_in from;
+		socklen_t fromlen = sizeof(from);
+		int len = recvfrom(s, q, 512, 0, (sockaddr *)&from, &fromlen);
+		if(len < 12)
+			continue;
+		queries++;
+		int pos = 12;
+		String name = ToLower(Name(q, len, pos));
+		int type = Peek16be(q + pos);
+		pos += 4;
+		String r(q, pos);
+		r.Set(2, 0x81); // QR, RD
+		r.Set(3, 0x80); // RA
+		String answer;
+		auto Answer = [&](int type, const void *data, int len, int ttl = 100) {
+			answer.Cat("\xc0\x0c", 2); // pointer to question name
+			answer.Cat(0);
+			answer.Cat(type);
+			answer.Cat("\x00\x01", 2); // IN
+			answer.Cat(ttl >> 24);
+			answer.Cat(ttl >> 16);
+			answer.Cat(ttl >> 8);
+			answer.Cat(ttl);
+			answer.Cat(0);
+			answer.Cat(len);
+			answer.Cat((const char *)data, len);
+		};
+		int count = 0;
+		SOCKET out = s;
+		if(name == "test.example") {
+			byte ip4[] = { 10, 1, 2, 3 };
+			byte ip6[] = { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 };
+			if(type == 1)
+				Answer(1, ip4, 4);
+			if(type == 28)
+				Answer(28, ip6, 16);
+			count = 1;
+		}
+		else
+		if(name == "v4only.example") {
+			byte ip4[] = { 10, 4, 4, 4 };
+			if(type == 1) {
+				Answer(1, ip4, 4);
+				count = 1;
+			}
+		}
+		else
+		if(name == "spoof.example") {
+			byte ip4[] = { 10, 6, 6, 6 };
+			Answer(type, ip4, 4);
+			count = 1;
+			out = s2;
+		}
+		else
+		if(name == "longttl.example") {
+			byte ip4[] = { 10, 5, 5, 5 };
+			if(type == 1) {
+				Answer(1, ip4, 4, 0x7fffffff);
+				count = 1;
+			}
+		}
+		else
+			r.Set(3, 0x83); // NXDOMAIN
+		r.Set(7, count);
+		r.Cat(answer);
+		sendto(out, ~r, r.GetCount(), 0, (sockaddr *)&from, fromlen);
+	}
+#ifdef PLATFORM_WIN32
+	closesocket(s);
+	closesocket(s2);
+#else
+	close(s);
+	close(s2);
+#endif
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+	
+	Thread t;
+	t.Run([] { DnsServer(); });
+	Sleep(100);
+
+	DnsResolver dns;
+	dns.ClearNameServers().NameServer("127.0.0.1", PORT).ClearSearch().ClearHosts();
+	
+	Vector<String> r = dns.Resolve("test.example");
+	DUMP(r);
+	ASSERT(r.GetCount() == 2);
+	ASSERT(FindIndex(r, "10.1.2.3") >= 0);
+	ASSERT(FindIndex(r, "2001:db8::1") >= 0);
+	
+	r = dns.Resolve("test.example", IpAddrInfo::FAMILY_IPV4);
+	ASSERT(r.GetCount() == 1 && r[0] == "10.1.2.3");
+
+	r = dns.Resolve("v4only.example");
+	ASSERT(r.GetCount() == 1 && r[0] == "10.4.4.4");
+
+	r = dns.Resolve("unknown.example");
+	ASSERT(r.GetCount() == 0);
+	
+	dns.Search("example");
+	r = dns.Resolve("test");
+	DUMP(r);
+	ASSERT(r.GetCount() == 2);
+	
+	dns.Host("myhost", "192.168.1.1");
+	int n = queries;
+	r = dns.Resolve("myhost");
+	ASSERT(r.GetCount() == 1 && r[0] == "192.168.1.1");
+	ASSERT(dns.Resolve("10.0.0.1")[0] == "10.0.0.1");
+	ASSERT(queries == n);
+
+	LOG("-- Asynchronous");
+	int done = 0;
+	dns.WhenDone = [&](int h) { done++; ASSERT(dns.IsResolved(h)); };
+	Vector<int> h;
+	for(int i = 0; i < 20; i++)
+		h.Add(dns.Start(i & 1 ? "test.example" : "v4only.example"));
+	while(dns.InProgress() || done < h.GetCount()) {
+		SocketWaitEvent we;
+		dns.AddTo(we);
+		we.Wait(dns.GetWaitTimeout());
+		dns.Do();
+	}
+	ASSERT(done == 20);
+	for(int i = 0; i < h.GetCount(); i++) {
+		ASSERT(dns.GetTTL(h[i]) == 100);
+		ASSERT(dns.GetResult(h[i]).GetCount() == (i & 1 ? 2 : 1));
+		dns.Remove(h[i]);
+	}
+	dns.WhenDone.Clear();
+	
+	LOG("-- Timeout");
+	DnsResolver dead;
+	dead.ClearNameServers().NameServer("127.0.0.1", PORT + 1).ClearSearch().Timeout(100).Attempts(2);
+	TimeStop tm;
+	ASSERT(dead.Resolve("test.example").GetCount() == 0);
+	DUMP(tm);
+	ASSERT(tm.Seconds() >= 0.2 && tm.Seconds() < 1);
+
+	LOG("-- Answer from wrong address");
+	n = queries;
+	dead.ClearNameServers().NameServer("127.0.0.1", PORT).Attempts(1);
+	ASSERT(dead.Resolve("spoof.example", IpAddrInfo::FAMILY_IPV4).GetCount() == 0);
+	ASSERT(queries == n + 1);
+	
+	LOG("-- Cache");
+	IpAddrInfo::ClearCache();
+	dns.Resolve("test.example", IpAddrInfo::FAMILY_IPV4);
+	IpAddrInfo ai;
+	ASSERT(ai.Execute("test.example", 80, IpAddrInfo::FAMILY_IPV4));
+	ASSERT(IpAddrInfo::GetCacheHits() == 1);
+	sockaddr_in *sin = (sockaddr_in *)ai.GetResult()->ai_addr;
+	ASSERT(ntohs(sin->sin_port) == 80);
+	char ip[64];
+	ASSERT(String(inet_ntop(AF_INET, &sin->sin_addr, ip, 64)) == "10.1.2.3");
+
+	dns.Resolve("nothing.example", IpAddrInfo::FAMILY_IPV4);
+	ASSERT(!ai.Execute("nothing.example", 80, IpAddrInfo::FAMILY_IPV4));
+	ASSERT(IpAddrInfo::GetCacheHits() == 2);
+
+	int lh = dns.Start("longttl.example", IpAddrInfo::FAMILY_IPV4);
+	while(dns.InProgress(lh)) {
+		SocketWaitEvent we;
+		dns.AddTo(we);
+		we.Wait(dns.GetWaitTimeout());
+		dns.Do();
+	}
+	ASSERT(dns.GetTTL(lh) == 86400);
+	dns.Remove(lh);
+	ASSERT(ai.Execute("longttl.example", 80, IpAddrInfo::FAMILY_IPV4));
+	ASSERT(IpAddrInfo::GetCacheHits() == 3);
+	
+	LOG("-- Coalescing");
+	IpAddrInfo::ClearCache();
+	Array<IpAddrInfo> a;
+	for(int i = 0; i < 20; i++)
+		a.Add().Start("localhost", 1000 + i);
+	for(IpAddrInfo& ai : a) {
+		while(ai.InProgress())
+			Sleep(1);
+		ASSERT(ai.GetResult());
+	}
+	ASSERT(IpAddrInfo::GetCacheMisses() <= 20);
+	ASSERT(ai.Execute("localhost", 80));
+	ASSERT(IpAddrInfo::GetCacheHits() >= 1);
+	
+	quit = true;
+	t.Wait();
+	
+	LOG("============= OK");
+}
@@ -34,5 +34,59 @@ CONSOLE_APP_MAIN
 	TEST(xxHash64(""), -1205034819632174695);
 	TEST(xxHash64("Hello world"), -4251203670589081896);
 
+	TEST(SHA256StringS(String('a', 1000000)), "cdc76e5c 9914fb92 81a1c7e2 84d73e67 f1809a48 a497200e 046d39cc c7112cd0");
+
+	TEST(CRC32("123456789"), 0xcbf43926);
+	TEST(CRC32C("123456789"), 0xe3069283);
+
+	String data;
+	SeedRandom(0);
+	for(int i = 0; i < 3000; i++)
+		data.Cat(Random());
+	
+	for(dword mask : { 0xffffffff, 0u, (dword)HASH_AVX2 }) { // all hardware paths vs portable code
+		SetHashAcceleration(mask);
+		LOG("Hash acceleration: " << FormatIntHex(GetHashAcceleration()));
+		Vector<String> block;
+		for(int len = 0; len < 600; len++) {
+			int pos = len % 17;
+			const char *s = ~data + pos;
+			ASSERT(UpdateCRC32(0, s, len) == crc32(0, (const byte *)s, len));
+			SetHashAcceleration(0);
+			dword crc32c = CRC32C(s, len);
+			String sha256 = SHA256String(s, len);
+			SetHashAcceleration(mask);
+			ASSERT(CRC32C(s, len) == crc32c);
+			ASSERT(SHA256String(s, len) == sha256);
+			Crc32cStream c;
+			c.Put(s, len / 3);
+			c.Put(s + len / 3, len - len / 3);
+			ASSERT(c.Finish() == crc32c);
+			ASSERT(CombineCRC32C(CRC32C(s, len / 3), CRC32C(s + len / 3, len - len / 3), len - len / 3) == crc32c);
+			ASSERT(CombineCRC32(CRC32(s, len / 3), CRC32(s + len / 3, len - len / 3), len - len / 3) == CRC32(s, len));
+			block.Add(String(s, len));
+		}
+		Vector<String> h = SHA256Multi(block);
+		ASSERT(h.GetCount() == block.GetCount());
+		for(int i = 0; i < block.GetCount(); i++)
+			ASSERT(h[i] == SHA256String(block[i]));
+	}
+	SetHashAcceleration();
+	
+	String big;
+	for(int i = 0; i < 5000000; i++)
+		big.Cat(Random());
+	ASSERT(CoCRC32(big, big.GetCount()) == CRC32(big));
+	ASSERT(CoCRC32C(big, big.GetCount()) == CRC32C(big));
+	String fn = GetHomeDirFile("hashes_test.bin.tmp");
+	SaveFile(fn, big);
+	dword crc;
+	ASSERT(CoCRC32File(fn, crc) && crc == CRC32(big));
+	ASSERT(CoCRC32CFile(fn, crc) && crc == CRC32C(big));
+	Vector<String> h = CoSHA256Files({ fn, GetHomeDirFile("nonexistent_file.bin") });
+	ASSERT(h[0] == SHA256String(big));
+	ASSERT(h[1].IsVoid());
+	DeleteFile(fn);
+
 	LOG("===== Everything OK");
 }
@@ -0,0 +1,98 @@
+#include <PostgreSQL/PostgreSQL.h>
+
+using namespace Upp;
+
+const int N = 1000;
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+	const Vector<String>& cmd = CommandLine();
+	PostgreSQLSession db;
+	if(!db.Open(cmd.GetCount() ? cmd[0] : "host=localhost dbname=test user=test password=test")) {
+		LOG("Cannot open database: " << db.GetLastError());
+		Exit(1);
+	}
+	Sql sql(db);
+	ASSERT(sql.Execute("create temporary table PIPE_TEST (ID integer primary key, NAME text, D date)"));
+
+	{
+		PostgreSQLPipeline pipe;
+		ASSERT(pipe.Open(db));
+		int done = 0;
+		pipe.WhenDone = [&](int) { done++; };
+		for(int i = 0; i < N; i++)
+			pipe.Send("insert into PIPE_TEST values (?, ?, ?)",
+			          { i, i % 10 ? Value("Name '" + AsString(i) + "'?") : Value(), Date(2024, 1, 1) + i });
+		ASSERT(pipe.GetPending() == N);
+		pipe.Finish();
+		ASSERT(done == N && !pipe.InProgress());
+
+		Vector<int> h; // futures
+		for(int i = 0; i < N; i += 10)
+			h.Add(pipe.Send("select NAME, D, ID from PIPE_TEST where ID between ? and ? order by ID", { i, i + 9 }));
+		for(int i = 0; i < h.GetCount(); i++) {
+			const PostgreSQLResult& r = pipe.GetResult(h[i]);
+			ASSERT(!r.IsError());
+			ASSERT(r.GetCount() == 10 && r.GetColumns() == 3 && r.info[1].type == DATE_V);
+			for(int j = 0; j < 10; j++) {
+				int id = 10 * i + j;
+				ASSERT(r[j][2] == id);
+				ASSERT(j ? r[j][0] == "Name '" + AsString(id) + "'?" : IsNull(r[j][0]));
+				ASSERT(r.Get(j, 1) == Date(2024, 1, 1) + id);
+			}
+			pipe.Remove(h[i]);
+		}
+
+		int64 sum = 0; // callbacks
+		for(int i = 0; i < N; i++)
+			pipe.Send(Select(SqlId("ID")).From(SqlId("PIPE_TEST")).Where(SqlId("ID") == i),
+			          [&](const PostgreSQLResult& r) { ASSERT(r.GetCount() == 1); sum += (int)r[0][0]; });
+		pipe.Finish();
+		ASSERT(sum == N * (N - 1) / 2);
+
+		// statements up to the sync point form implicit transaction, error rolls it back
+		// and the rest of the statements is not executed
+		int ok1 = pipe.Send("update PIPE_TEST set NAME = 'X' where ID = 1");
+		int err = pipe.Send("insert into PIPE_TEST values (?, 'dup', NULL)", { 1 });
+		int ok2 = pipe.Send("update PIPE_TEST set NAME = 'Y' where ID = 2");
+		pipe.Sync();
+		int ok3 = pipe.Send("update PIPE_TEST set NAME = 'Z' where ID = 3");
+		int bad = pipe.Send("select ?", { 1, 2 });
+		ASSERT(!pipe.GetResult(ok1).IsError() && pipe.GetResult(ok1).rows_processed == 1);
+		ASSERT(pipe.GetResult(err).IsError() && pipe.GetResult(err).error_code == "23505");
+		ASSERT(pipe.GetResult(ok2).IsError());
+		ASSERT(!pipe.GetResult(ok3).IsError());
+		ASSERT(pipe.GetResult(bad).IsError());
+
+		// socket event loop
+		int count = 0;
+		for(int i = 0; i < N; i++)
+			pipe.Send("select ?", { i }, [&](const PostgreSQLResult& r) { ASSERT(r[0][0] == AsString(count++)); });
+		pipe.Sync();
+		while(pipe.InProgress()) {
+			SocketWaitEvent we;
+			pipe.AddTo(we);
+			we.Wait(1000);
+			pipe.Do();
+		}
+		ASSERT(count == N);
+
+		// results passed to callback or removed are not available
+		int cb = pipe.Send("select 1", Vector<Value>(), [](const PostgreSQLResult&) {});
+		int removed = pipe.Send("select 2");
+		ASSERT(!pipe.GetResult(removed).IsError());
+		pipe.Remove(removed);
+		ASSERT(pipe.GetResult(cb).IsError());
+		ASSERT(pipe.GetResult(removed).IsError());
+		ASSERT(pipe.GetResult(-5).IsError());
+	}
+
+	ASSERT(sql.Execute("select NAME from PIPE_TEST where ID in (1, 2, 3) order by ID"));
+	ASSERT(sql.Fetch() && sql[0] == "Name '1'?");
+	ASSERT(sql.Fetch() && sql[0] == "Name '2'?");
+	ASSERT(sql.Fetch() && sql[0] == "Z");
+
+	LOG("============ OK");
+}
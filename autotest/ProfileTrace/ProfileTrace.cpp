@@ -0,0 +1,153 @@
+#include <Core/Core.h>
+
+using namespace Upp;
+
+void Busy(int us)
+{
+	int64 end = tmGetTimeNs() + 1000 * us;
+	while(tmGetTimeNs() < end)
+		;
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+	{ // clock
+		int64 t0 = tmGetTimeNs();
+		int64 t1 = tmGetTimeNs();
+		ASSERT(t1 >= t0 && t1 - t0 < 1000000);
+		Sleep(20);
+		int64 t = tmGetTimeNs() - t1;
+		ASSERT(t >= 19000000 && t < 1000000000);
+	}
+
+	{ // histogram
+		TimingHistogram h;
+		ASSERT(h.GetPercentile(0.5) == 0);
+		for(int i = 1; i <= 1000; i++)
+			h.Add(1000 * i);
+		ASSERT(h.GetCount() == 1000);
+		DUMP(h.GetPercentile(0.5));
+		DUMP(h.GetPercentile(0.99));
+		ASSERT(abs(h.GetPercentile(0.5) - 500000) < 500000 / 8);
+		ASSERT(abs(h.GetPercentile(0.99) - 990000) < 990000 / 8);
+		ASSERT(h.GetPercentile(0) <= 1000 && h.GetPercentile(1) >= 900000);
+		TimingHistogram h2;
+		h2.Add(3);
+		h2.Merge(h);
+		ASSERT(h2.GetCount() == 1001 && h2.GetPercentile(0) == 3);
+		for(int64 ns : { 0, 1, 3, 4, 5, 7, 8, 1000, 123456789 }) {
+			TimingHistogram h;
+			h.Add(ns);
+			ASSERT(abs(h.GetPercentile(0.5) - ns) <= ns / 8 + 1);
+		}
+	}
+
+	{ // per-thread accumulation
+		static TimingInspector ti("test");
+		Array<Thread> t;
+		for(int i = 0; i < 4; i++)
+			t.Add().Run([] {
+				static thread_local TimingInspector::Slot *slot;
+				for(int j = 0; j < 100; j++) {
+					TimingInspector::Routine r(ti, slot);
+					Busy(10);
+					TimingInspector::Routine nested(ti, slot);
+				}
+			});
+		for(Thread& h : t)
+			h.Wait();
+		ASSERT(ti.GetCallCount() == 400);
+		ASSERT(ti.GetTotalTime() >= 400 * 10000);
+		TimingHistogram h = ti.GetHistogram();
+		ASSERT(h.GetCount() == 400 && h.GetPercentile(0.5) >= 8000);
+		String s = ti.Dump();
+		LOG(s);
+		ASSERT(s.Find("p99") >= 0 && s.Find("thread") >= 0 && s.Find("nesting: 2 - 800") >= 0);
+	}
+
+	{ // reading statistics while timed code runs
+		static TimingInspector ti("concurrent");
+		Array<Thread> t;
+		for(int i = 0; i < 4; i++)
+			t.Add().Run([] {
+				static thread_local TimingInspector::Slot *slot;
+				for(int j = 0; j < 100000; j++)
+					TimingInspector::Routine r(ti, slot);
+			});
+		int64 last = 0;
+		while(last < 400000) {
+			int64 n = ti.GetCallCount();
+			ASSERT(n >= last && n <= 400000);
+			last = n;
+			TimingHistogram h = ti.GetHistogram();
+			ASSERT(h.GetCount() <= 400000);
+			ti.Dump();
+		}
+		for(Thread& h : t)
+			h.Wait();
+		ASSERT(ti.GetHistogram().GetCount() == 400000);
+	}
+
+	{ // trace
+		StartTrace();
+		{
+			RZONE("main zone");
+			CoWork co;
+			for(int i = 0; i < 20; i++)
+				co & [] {
+					RZONE("job zone");
+					Busy(100);
+				};
+		}
+		{
+			RTIMING("timing zone");
+			Busy(10);
+		}
+		StopTrace();
+		{
+			RZONE("not traced");
+		}
+		ASSERT(GetTraceEventCount() >= 42);
+		String json = GetTraceJson();
+		Value v = ParseJSON(json);
+		ASSERT(!v.IsError());
+		Index<String> names;
+		int cowork_threads = 0;
+		for(Value e : v["traceEvents"]) {
+			if(e["ph"] == "M") {
+				ASSERT(e["name"] == "thread_name");
+				if(String(e["args"]["name"]).StartsWith("CoWork #"))
+					cowork_threads++;
+				continue;
+			}
+			ASSERT(e["ph"] == "X" && (double)e["ts"] >= 0 && (double)e["dur"] >= 0);
+			names.FindAdd(e["name"]);
+			if(e["name"] == "job zone")
+				ASSERT((double)e["dur"] >= 100);
+		}
+		ASSERT(cowork_threads > 0 || CPU_Cores() == 1);
+		ASSERT(names.Find("main zone") >= 0 && names.Find("job zone") >= 0 && names.Find("timing zone") >= 0);
+		ASSERT(names.Find("CoWork job") >= 0 || CPU_Cores() == 1);
+		ASSERT(names.Find("not traced") < 0);
+		String fn = GetHomeDirFile("ProfileTrace.json");
+		ASSERT(SaveTrace(fn));
+		ASSERT(LoadFile(fn) == json);
+		DeleteFile(fn);
+	}
+
+	{ // limits
+		StartTrace(10);
+		for(int i = 0; i < 25; i++)
+			RZONE("limited");
+		StopTrace();
+		ASSERT(GetTraceEventCount() == 10);
+		ASSERT(GetTraceDropped() == 15);
+		StartTrace();
+		StopTrace();
+		ASSERT(GetTraceEventCount() == 0);
+	}
+
+	LOG("============ OK");
+}
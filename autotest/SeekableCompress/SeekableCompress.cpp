@@ -0,0 +1,85 @@
+#include <plugin/zstd/zstd.h>
+#include <plugin/lz4/lz4.h>
+
+using namespace Upp;
+
+template <class C, class D>
+void Test(const char *name, const String& data, bool co)
+{
+	LOG("---- " << name << ", co: " << co);
+	StringStream ss;
+	{
+		C c;
+		c.Co(co);
+		c.Seekable();
+		c.Open(ss);
+		for(int i = 0; i < data.GetCount(); i += 77777)
+			c.Put(data.Mid(i, 77777));
+	}
+	String z = ss.GetResult();
+	LOG("Compressed " << data.GetCount() << " -> " << z.GetCount());
+	
+	{ // sequential reading still works and skips the seek table
+		StringStream in(z);
+		D d(in);
+		d.Co(co);
+		ASSERT(d.IsSeekable());
+		ASSERT(d.GetSize() == data.GetCount());
+		ASSERT(d.Get(data.GetCount() + 100) == data);
+		ASSERT(d.IsEof());
+		ASSERT(!d.IsError());
+	}
+	
+	StringStream in(z);
+	D d(in);
+	d.Co(co);
+	SeedRandom(0);
+	for(int i = 0; i < 300; i++) {
+		int pos = Random(data.GetCount() + 1);
+		int len = Random(i & 1 ? 3000000 : 3000);
+		d.Seek(pos);
+		ASSERT(d.GetPos() == pos);
+		String h = d.Get(len);
+		ASSERT(h == data.Mid(pos, len));
+		ASSERT(d.GetPos() == pos + h.GetCount());
+		ASSERT(!d.IsError());
+	}
+	d.Seek(data.GetCount());
+	ASSERT(d.IsEof());
+	d.Seek(0);
+	ASSERT(d.Get(1000) == data.Mid(0, 1000));
+	
+	{ // without seek table only forward skipping is possible
+		StringStream ss;
+		{
+			C c(ss);
+			c.Put(data);
+		}
+		StringStream in(ss.GetResult());
+		D d(in);
+		ASSERT(!d.IsSeekable());
+		d.Seek(2500000);
+		ASSERT(d.Get(100) == data.Mid(2500000, 100));
+		d.Seek(100);
+		ASSERT(d.IsError());
+	}
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+	
+	String data;
+	while(data.GetCount() < 20000000)
+		data << "Line " << data.GetCount() << ": " << Random(1000) << "\n";
+	
+	for(int co = 0; co < 2; co++) {
+		Test<ZstdCompressStream, ZstdDecompressStream>("Zstd", data, co);
+		Test<LZ4CompressStream, LZ4DecompressStream>("LZ4", data, co);
+	}
+	
+	ASSERT(ZstdDecompress(ZstdCompress(data)) == data);
+	ASSERT(LZ4Decompress(LZ4Compress(data)) == data);
+	
+	LOG("=========== OK");
+}
@@ -0,0 +1,138 @@
+#include <Core/Core.h>
+
+using namespace Upp;
+
+TcpSocket server;
+int       port;
+
+void Connect(TcpSocket& client, TcpSocket& accepted)
+{
+	ASSERT(client.Connect("127.0.0.1", port));
+	ASSERT(accepted.Accept(server));
+	client.Timeout(5000);
+	accepted.Timeout(5000);
+}
+
+String Pattern(int len)
+{
+	StringBuffer b(len);
+	for(int i = 0; i < len; i++)
+		b[i] = (char)(i * 7 + i / 251);
+	return String(b);
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+	for(port = 27310; port < 27400; port++)
+		if(server.Listen(port, 5))
+			break;
+	ASSERT(server.IsOpen());
+	DUMP(port);
+
+	{ // buffer size
+		TcpSocket s;
+		ASSERT(s.GetReadBufferSize() == 65536);
+		ASSERT(s.ReadBufferSize(1).GetReadBufferSize() == 512);
+		ASSERT(s.ReadBufferSize(100000).GetReadBufferSize() == 100000);
+	}
+
+	{ // GetLine across buffer boundaries, Peek, Get of the rest
+		TcpSocket a, b;
+		Connect(a, b);
+		b.ReadBufferSize(512);
+		String long_line = Pattern(3000);
+		long_line.Replace("\n", "");
+		long_line.Replace("\r", "");
+		ASSERT(a.PutAll("first\r\nsecond\n\n" + long_line + "\r\n" + String('y', 600) + "\ntail"));
+		a.Close();
+		ASSERT(b.GetLine() == "first");
+		ASSERT(b.GetLine() == "second");
+		ASSERT(b.GetLine() == "");
+		ASSERT(b.GetLine() == long_line);
+		ASSERT(b.Peek() == 'y' && b.Get() == 'y');
+		ASSERT(b.GetLine() == String('y', 599));
+		ASSERT(b.Peek() == 't');
+		ASSERT(b.Get(100) == "tail");
+		ASSERT(b.IsEof() && !b.IsError());
+		ASSERT(b.Get(1).IsVoid());
+	}
+
+	{ // GetLine limit
+		TcpSocket a, b;
+		Connect(a, b);
+		b.ReadBufferSize(512);
+		ASSERT(a.PutAll(String('x', 2000) + "\n"));
+		ASSERT(b.GetLine(1000).IsVoid() && b.IsError());
+	}
+
+	const int N = 4 * 1024 * 1024 + 17;
+	String data = Pattern(N);
+
+	for(int bufsize : { 512, 1000, 65536 }) { // Get and GetAll of various sizes vs. read ahead
+		TcpSocket a, b;
+		Connect(a, b);
+		b.ReadBufferSize(bufsize);
+		Thread t;
+		t.Run([&] {
+			for(int pos = 0; pos < N;) {
+				int len = min(N - pos, 1 + (int)Random(200000));
+				ASSERT(a.PutAll(data.Mid(pos, len)));
+				pos += len;
+			}
+			a.Close();
+		});
+		String r;
+		int i = 0;
+		while(r.GetCount() < N) {
+			int len = min(N - r.GetCount(), decode(i++ % 4, 0, 1, 1, 100, 2, 3000, 100000));
+			String s = i % 3 ? b.GetAll(len) : b.Get(len);
+			ASSERT(!s.IsVoid() && s.GetCount() > 0 && s.GetCount() <= len);
+			r.Cat(s);
+		}
+		t.Wait();
+		ASSERT(r == data);
+		ASSERT(b.Get() < 0 && b.IsEof());
+	}
+
+	{ // gather Put / PutAll
+		TcpSocket a, b;
+		Connect(a, b);
+		Vector<String> part = { "header\r\n", "", data.Mid(0, 1000000), "", "x", data.Mid(17, 3) };
+		String all = Join(part, "");
+		Thread t;
+		t.Run([&] {
+			ASSERT(a.PutAll(part));
+			ASSERT(a.PutAll("first ", "second"));
+			ASSERT(a.PutAll(Vector<String>{ "", "" }));
+			ASSERT(a.Put(part.begin(), 2) == part[0].GetCount());
+			a.Close();
+		});
+		ASSERT(b.GetLine() == "header");
+		ASSERT(b.GetAll(all.GetCount() - 8) == all.Mid(8));
+		ASSERT(b.GetAll(12) == "first second");
+		ASSERT(b.GetAll(8) == "header\r\n");
+		ASSERT(b.Get(1).IsVoid() && b.IsEof());
+		t.Wait();
+	}
+
+	{ // changing ReadBufferSize keeps data already received
+		TcpSocket a, b;
+		Connect(a, b);
+		String s = data.Mid(0, 30000);
+		ASSERT(a.PutAll(s));
+		a.Close();
+		ASSERT(b.Peek() == (byte)s[0]); // fills the buffer
+		ASSERT(b.GetAll(2) == s.Mid(0, 2));
+		b.ReadBufferSize(512); // pending data larger than new size are kept
+		ASSERT(b.GetAll(1000) == s.Mid(2, 1000));
+		b.ReadBufferSize(100000);
+		ASSERT(b.GetAll(100) == s.Mid(1002, 100));
+		b.ReadBufferSize(600);
+		ASSERT(b.GetAll(s.GetCount() - 1102) == s.Mid(1102));
+		ASSERT(b.Get(1).IsVoid());
+	}
+
+	LOG("============ OK");
+}
@@ -0,0 +1,111 @@
+#include <plugin/sqlite3/Sqlite3.h>
+
+using namespace Upp;
+
+const int N = 1000;
+
+void Check(Sqlite3Session& db, int n)
+{
+	Sql sql(db), bsql(db);
+	ASSERT(sql.Execute("select * from T order by ID"));
+	ASSERT(bsql.Execute("select * from T order by ID"));
+	SqlBatch batch;
+	int rows = 0;
+	for(;;) {
+		int count = bsql.FetchBatch(batch, n);
+		ASSERT(count == batch.GetCount());
+		if(count == 0)
+			break;
+		ASSERT(count <= n);
+		ASSERT(batch.GetColumns() == sql.GetColumns());
+		for(int i = 0; i < count; i++) {
+			ASSERT(sql.Fetch());
+			for(int c = 0; c < sql.GetColumns(); c++) {
+				Value v = sql[c];
+				Value h = batch.Get(i, c);
+				ASSERT(IsNull(v) == IsNull(h));
+				ASSERT(IsNull(v) == batch[c].IsNull(i));
+				if(!IsNull(v))
+					ASSERT(v == h);
+			}
+			rows++;
+		}
+	}
+	ASSERT(!sql.Fetch());
+	ASSERT(rows == N);
+	ASSERT(bsql.FetchBatch(batch, n) == 0);
+	LOG("batch " << n << " OK");
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+	Sqlite3Session db;
+	ASSERT(db.Open(":memory:"));
+	SQL = db;
+	Sql sql(db);
+	ASSERT(sql.Execute("create table T (ID integer primary key, I integer, D real, S text, B blob, DT date, N integer)"));
+	sql.Begin();
+	for(int i = 0; i < N; i++) {
+		String blob;
+		for(int j = 0; j < i % 20; j++)
+			blob.Cat(j * i);
+		sql.SetParam(0, i);
+		sql.SetParam(1, i % 5 ? Value(i * 1234567890123LL) : Value());
+		sql.SetParam(2, i % 7 ? Value(i / 3.0) : Value());
+		sql.SetParam(3, i % 11 ? Value("text " + AsString(i)) : Value());
+		sql.SetParam(4, i % 13 ? Value(blob) : Value());
+		sql.SetParam(5, i % 3 ? Value(Date(2024, 1, 1) + i) : Value());
+		sql.SetParam(6, Value());
+		ASSERT(sql.Execute("insert into T values(?, ?, ?, ?, ?, ?, ?)"));
+	}
+	sql.Commit();
+
+	{
+		SqlBatch batch;
+		ASSERT(sql.Execute("select ID, I, D, S, DT, N from T where ID between 1 and 100 order by ID"));
+		ASSERT(sql.FetchBatch(batch) == 100);
+		ASSERT(batch[0].type == INT64_V && batch[1].type == INT64_V);
+		ASSERT(batch[2].type == DOUBLE_V && batch[3].type == STRING_V);
+		ASSERT(batch[4].type == VOID_V && batch[5].type == VOID_V);
+		ASSERT(batch[0].i64.GetCount() == 100 && batch[0].i64[41] == 42);
+		ASSERT(batch[1].IsNull(4) && batch[1].i64[4] == 0 && batch[1].i64[0] == 1234567890123LL);
+		ASSERT(batch[2].dbl[2] == 1);
+		ASSERT(batch[3].str[11] == "text 12" && batch[3].IsNull(10) && batch[3].str[10].IsEmpty());
+		ASSERT(batch.FindColumn("DT") == 4 && batch.FindColumn("XX") < 0);
+		ASSERT(batch.Get(0, 4) == Date(2024, 1, 2) && IsNull(batch.Get(1, 5)));
+		ASSERT(batch.GetRow(11)[3] == "text 12");
+	}
+
+	for(int n : { 1, 7, 999, 1000, 1001, 4096 })
+		Check(db, n);
+
+	{ // SQLite dynamic typing: values not matching the column type are converted
+		ASSERT(sql.Execute("create table M (X)"));
+		ASSERT(sql.Execute("insert into M values (1)"));
+		ASSERT(sql.Execute("insert into M values ('12')"));
+		ASSERT(sql.Execute("insert into M values (NULL)"));
+		ASSERT(sql.Execute("insert into M values ('abc')"));
+		SqlBatch batch;
+		ASSERT(sql.Execute("select X from M order by rowid") && sql.FetchBatch(batch) == 4);
+		ASSERT(batch[0].type == INT64_V && batch[0].i64[1] == 12 && batch[0].IsNull(2));
+		ASSERT(!batch[0].IsError(1) && !batch[0].IsError(2));
+		ASSERT(batch[0].IsNull(3) && batch[0].IsError(3) && batch.Get(3, 0).IsError());
+		ASSERT(IsNull(batch.Get(2, 0)) && !batch.Get(2, 0).IsError());
+		ASSERT(sql.Execute("select X from M order by rowid") && sql.FetchBatch(batch) == 4);
+		ASSERT(batch[0].error.GetCount() == 1);
+	}
+
+	{ // whole table
+		SqlBatch batch;
+		batch *= Select(SqlAll()).From(SqlId("T")).Where(SqlId("ID") >= 500);
+		ASSERT(batch.GetCount() == 500 && batch.GetColumns() == 7);
+		int64 sum = 0;
+		for(int64 x : batch[0].i64)
+			sum += x;
+		ASSERT(sum == (500 + 999) * 500 / 2);
+	}
+
+	LOG("============ OK");
+}
@@ -0,0 +1,96 @@
+#include <plugin/sqlite3/Sqlite3.h>
+
+using namespace Upp;
+
+const int NCOL = 80; // more than 64 columns
+
+Value TestValue(int row, int col)
+{
+	if((row + col) % 7 == 0)
+		return Null;
+	switch(col % 4) {
+	case 0: return row * 1000 + col;
+	case 1: return "r" + AsString(row) + "c" + AsString(col) + "\t'\"\\";
+	case 2: return Date(2020, 1, 1) + row % 500;
+	}
+	return row / 4.0;
+}
+
+void Test(Sqlite3Session& db, bool bulk, int rows)
+{
+	Sql sql(db);
+	sql.Execute("delete from T");
+	{
+		SqlMassInsert mi(sql, SqlId("T"));
+		mi.Bulk(bulk);
+		for(int i = 0; i < rows; i++) {
+			mi("ID", i);
+			for(int c = 0; c < NCOL; c++)
+				mi(SqlId("C" + AsString(c)), TestValue(i, c));
+			mi.EndRow();
+		}
+		mi.Flush();
+		if(mi.IsError())
+			LOG(db.GetLastError() << " " << db.GetErrorStatement().Left(300));
+		ASSERT(!mi.IsError());
+	}
+	ASSERT(sql.Execute("select count(*) from T") && sql.Fetch() && sql[0] == rows);
+	ASSERT(sql.Execute("select * from T order by ID"));
+	int i = 0;
+	while(sql.Fetch()) {
+		ASSERT(sql[0] == i);
+		for(int c = 0; c < NCOL; c++) {
+			Value v = TestValue(i, c);
+			Value h = sql[c + 1];
+			ASSERT(IsNull(v) == IsNull(h));
+			if(!IsNull(v))
+				ASSERT(c % 4 == 2 ? Date(v) == Date(h) : v == h);
+		}
+		i++;
+	}
+	ASSERT(i == rows);
+	LOG((bulk ? "bulk" : "text") << ' ' << rows << " rows OK");
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+	Sqlite3Session db;
+	ASSERT(db.Open(":memory:"));
+	Sql sql(db);
+	String create = "create table T (ID integer primary key";
+	for(int c = 0; c < NCOL; c++)
+		create << ", C" << c << (c % 4 == 0 ? " integer" : c % 4 == 1 ? " text" : c % 4 == 2 ? " date" : " real");
+	create << ")";
+	ASSERT(sql.Execute(create));
+
+	for(int bulk = 0; bulk < 2; bulk++)
+		for(int rows : { 0, 1, 11, 12, 13, 5000 })
+			Test(db, bulk, rows);
+
+	{ // error is reported and the transaction rolled back
+		sql.Execute("delete from T");
+		SqlMassInsert mi(sql, SqlId("T"));
+		for(int i = 0; i < 100; i++)
+			mi("ID", i % 50).EndRow(); // duplicate key
+		mi.Flush();
+		ASSERT(mi.IsError());
+		db.ClearError();
+		ASSERT(sql.Execute("select count(*) from T") && sql.Fetch() && sql[0] == 0);
+	}
+
+	{ // remove condition
+		SqlMassInsert mi(sql, SqlId("T"));
+		for(int i = 0; i < 10; i++)
+			mi("ID", i)("C0", i).EndRow();
+		mi.Flush();
+		for(int i = 0; i < 10; i++)
+			mi("ID", i)("C0", 2 * i).EndRow(SqlId("ID") == i);
+		mi.Flush();
+		ASSERT(!mi.IsError());
+		ASSERT(sql.Execute("select sum(C0) from T") && sql.Fetch() && sql[0] == 90);
+	}
+
+	LOG("============ OK");
+}
@@ -0,0 +1,212 @@
+#include <plugin/sqlite3/Sqlite3.h>
+
+using namespace Upp;
+
+SqlId LOOKUP("LOOKUP"), OTHER("OTHER"), ID("ID"), NAME("NAME");
+
+Vector<Value> Rows(Sql& sql)
+{
+	Vector<Value> r;
+	while(sql.Fetch())
+		for(int i = 0; i < sql.GetColumns(); i++)
+			r.Add(sql[i]);
+	return r;
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+	Sqlite3Session db;
+	ASSERT(db.Open(":memory:"));
+	db.ResultCache(100000, 50);
+	Sql sql(db);
+	ASSERT(sql.Execute("create table LOOKUP (ID integer primary key, NAME text)"));
+	ASSERT(sql.Execute("create table OTHER (ID integer primary key, NAME text)"));
+	for(int i = 0; i < 10; i++) {
+		ASSERT(sql * Insert(LOOKUP)(ID, i)(NAME, "Name " + AsString(i)));
+		ASSERT(sql * Insert(OTHER)(ID, i)(NAME, "Other " + AsString(i)));
+	}
+
+	auto Lookup = [&] { return Select(ID, NAME).From(LOOKUP).OrderBy(ID).Cached(); };
+
+	ASSERT(sql * Lookup());
+	Vector<Value> r1 = Rows(sql);
+	ASSERT(r1.GetCount() == 20);
+	ASSERT(db.GetResultCacheMisses() == 1 && db.GetResultCacheHits() == 0);
+	ASSERT(db.GetResultCacheCount() == 1 && db.GetResultCacheSize() > 0);
+
+	ASSERT(sql * Lookup());
+	ASSERT(db.GetResultCacheHits() == 1);
+	ASSERT(sql.GetColumns() == 2 && sql.GetColumnInfo(1).name == "NAME");
+	ASSERT(Rows(sql) == r1);
+
+	{ // Fetch variants and FetchBatch over cached result
+		ASSERT(sql * Lookup());
+		int id;
+		String name;
+		ASSERT(sql.Fetch(id, name) && id == 0 && name == "Name 0");
+		ASSERT(sql[NAME] == "Name 0");
+		ASSERT(sql.Fetch() && sql[ID] == 1);
+		SqlBatch batch;
+		ASSERT(sql.FetchBatch(batch) == 8);
+		ASSERT(batch.Get(0, 1) == "Name 2" && batch[0].i64[7] == 9);
+		ASSERT(!sql.Fetch());
+		ASSERT((Value)(sql % Select(NAME).From(LOOKUP).Where(ID == 3).Cached()) == "Name 3");
+		ASSERT((Value)(sql % Select(NAME).From(LOOKUP).Where(ID == 3).Cached()) == "Name 3");
+	}
+
+	{ // statements without Cached and writes to unrelated tables keep the cache
+		int64 hits = db.GetResultCacheHits();
+		ASSERT(sql * Select(ID).From(LOOKUP));
+		ASSERT(sql * Update(OTHER)(NAME, "X").Where(ID == 1));
+		ASSERT(sql * Lookup());
+		ASSERT(db.GetResultCacheHits() == hits + 1);
+		ASSERT(db.GetResultCacheInvalidations() == 0);
+	}
+
+	{ // insert / update / delete through SqlExp invalidate
+		int count = db.GetResultCacheCount();
+		ASSERT(sql * Update(LOOKUP)(NAME, "Changed").Where(ID == 1));
+		ASSERT(db.GetResultCacheCount() < count && db.GetResultCacheInvalidations() > 0);
+		ASSERT(sql * Lookup());
+		Vector<Value> r = Rows(sql);
+		ASSERT(r[3] == "Changed");
+
+		ASSERT(sql * Lookup());
+		ASSERT(Rows(sql) == r);
+		ASSERT(sql * Insert(LOOKUP)(ID, 100)(NAME, "New"));
+		ASSERT(sql * Lookup());
+		ASSERT(Rows(sql).GetCount() == 22);
+		ASSERT(sql * Delete(LOOKUP).Where(ID == 100));
+		ASSERT(sql * Lookup());
+		ASSERT(Rows(sql).GetCount() == 20);
+	}
+
+	{ // tables referenced in joins and subselects
+		auto Join = [&] {
+			return Select(SqlId("LOOKUP.NAME"), SqlId("OTHER.NAME")).From(LOOKUP)
+			       .InnerJoin(OTHER).On(ID.Of(LOOKUP) == ID.Of(OTHER)).Cached();
+		};
+		auto Sub = [&] {
+			return Select(NAME).From(LOOKUP).Where(ID == Select(SqlMax(ID)).From(OTHER)).Cached();
+		};
+		ASSERT(sql * Join());
+		Vector<Value> j = Rows(sql);
+		ASSERT(j.GetCount() == 20);
+		ASSERT(sql * Sub());
+		ASSERT(Rows(sql)[0] == "Name 9");
+		int64 hits = db.GetResultCacheHits();
+		ASSERT(sql * Join());
+		ASSERT(sql * Sub());
+		ASSERT(db.GetResultCacheHits() == hits + 2);
+		ASSERT(sql * Delete(OTHER).Where(ID == 9));
+		ASSERT(sql * Join());
+		ASSERT(Rows(sql).GetCount() == 18);
+		ASSERT(sql * Sub());
+		ASSERT(Rows(sql)[0] == "Name 8");
+	}
+
+	{ // parameters are part of the key
+		SqlStatement st = SqlStatement(Select(NAME).From(LOOKUP).Where(ID == SqlVal("?", SqlS::HIGH)));
+		st.Cached();
+		sql.SetParam(0, 4);
+		ASSERT(sql * st);
+		ASSERT(Rows(sql)[0] == "Name 4");
+		sql.SetParam(0, 5);
+		ASSERT(sql * st);
+		ASSERT(Rows(sql)[0] == "Name 5");
+	}
+
+	{ // results are not stored inside transaction
+		int count = db.GetResultCacheCount();
+		db.Begin();
+		ASSERT(sql * Update(LOOKUP)(NAME, "Rolled back").Where(ID == 2));
+		ASSERT(sql * Lookup());
+		ASSERT(Rows(sql)[5] == "Rolled back");
+		db.Rollback();
+		ASSERT(db.GetResultCacheCount() < count);
+		ASSERT(sql * Lookup());
+		ASSERT(Rows(sql)[5] == "Name 2");
+	}
+
+	{ // plain text statements, SqlMassInsert and AutoBatch
+		auto Count = [&] {
+			ASSERT(sql * Lookup());
+			return Rows(sql).GetCount() / 2;
+		};
+		int n = Count();
+		ASSERT(sql.Execute("insert into LOOKUP (ID, NAME) values (200, 'Raw')"));
+		ASSERT(Count() == n + 1);
+		ASSERT(sql.Execute("update \"LOOKUP\" set NAME = 'Raw 2' where ID = 200"));
+		ASSERT(sql * Lookup());
+		ASSERT(Rows(sql).Top() == "Raw 2");
+		ASSERT(sql.Execute("delete from main.LOOKUP where ID = 200"));
+		ASSERT(Count() == n);
+
+		int64 hits = db.GetResultCacheHits();
+		ASSERT(sql.Execute("insert or replace into OTHER (ID, NAME) values (200, 'Raw')"));
+		ASSERT(Count() == n && db.GetResultCacheHits() == hits + 1);
+		ASSERT(sql.Execute("create index LOOKUP_NAME on LOOKUP (NAME)")); // not recognized, drops all
+		ASSERT(db.GetResultCacheCount() == 0);
+		Count();
+
+		for(int bulk = 0; bulk < 2; bulk++) {
+			SqlMassInsert mi(sql, LOOKUP);
+			mi.Bulk(bulk);
+			for(int i = 0; i < 3; i++)
+				mi(ID, 300 + i)(NAME, "Mass").EndRow();
+			mi.Flush();
+			ASSERT(Count() == n + 3);
+			ASSERT(sql * Delete(LOOKUP).Where(ID >= 300));
+			ASSERT(Count() == n);
+		}
+
+		db.AutoBatch(1000, 60000);
+		ASSERT(sql * Update(LOOKUP)(NAME, "Batch").Where(ID == 0));
+		ASSERT(db.IsBatchOpen() && db.GetTransactionLevel() == 0 && db.IsTransactionOpen());
+		int count = db.GetResultCacheCount();
+		ASSERT(sql * Lookup());
+		ASSERT(Rows(sql)[1] == "Batch");
+		ASSERT(db.GetResultCacheCount() == count); // batch could be rolled back
+		db.Rollback();
+		ASSERT(!db.IsBatchOpen() && !db.IsTransactionOpen());
+		ASSERT(sql * Lookup());
+		ASSERT(Rows(sql)[1] == "Name 0");
+		db.NoAutoBatch();
+	}
+
+	{ // row and size limits
+		ASSERT(sql * Select(ID).From(LOOKUP).Cached());
+		ASSERT(db.GetResultCacheCount() > 0);
+		db.ResultCache(100000, 5);
+		int count = db.GetResultCacheCount();
+		ASSERT(sql * Select(ID).From(LOOKUP).Where(ID > 0).Cached());
+		Vector<Value> r = Rows(sql);
+		ASSERT(r.GetCount() == 9 && r[0] == 1 && r[8] == 9);
+		ASSERT(db.GetResultCacheCount() == count);
+		ASSERT(sql * Select(ID).From(LOOKUP).Where(ID > 0).Cached()); // rows over the limit are streamed
+		ASSERT(sql.Fetch() && sql[ID] == 1);
+		SqlBatch batch;
+		ASSERT(sql.FetchBatch(batch, 3) == 3 && batch[0].i64[0] == 2 && batch[0].i64[2] == 4);
+		ASSERT(sql.FetchBatch(batch) == 5 && batch[0].i64[0] == 5 && batch[0].i64[1] == 6 && batch[0].i64[4] == 9);
+		ASSERT(!sql.Fetch());
+		ASSERT(sql * Select(ID).From(LOOKUP).Where(ID > 0).Cached());
+		ASSERT(sql.FetchBatch(batch, 5) == 5 && batch[0].i64[4] == 5);
+		ASSERT(sql.FetchBatch(batch, 1) == 1 && batch[0].i64[0] == 6);
+		ASSERT(sql.Fetch() && sql[ID] == 7);
+		ASSERT(Rows(sql).GetCount() == 2);
+		ASSERT(sql * Select(ID).From(LOOKUP).Where(ID > 4).Cached()); // exactly maxrows is stored
+		ASSERT(Rows(sql).GetCount() == 5);
+		ASSERT(db.GetResultCacheCount() == count + 1);
+		db.ResultCache(db.GetResultCacheSize() / 2);
+		ASSERT(db.GetResultCacheSize() <= db.GetResultCacheLimit());
+		db.ClearResultCache();
+		ASSERT(db.GetResultCacheCount() == 0 && db.GetResultCacheSize() == 0);
+		db.NoResultCache();
+		ASSERT(sql * Lookup());
+		ASSERT(db.GetResultCacheCount() == 0);
+	}
+
+	LOG("============ OK");
+}
@@ -0,0 +1,132 @@
+#include <plugin/sqlite3/Sqlite3.h>
+
+using namespace Upp;
+
+String db_path;
+
+SqlSession *CreateSession()
+{
+	One<Sqlite3Session> s;
+	s.Create();
+	if(!s->Open(db_path))
+		return NULL;
+	s->SetBusyTimeout(-1);
+	return s.Detach();
+}
+
+int Count(SqlSession& s)
+{
+	Sql sql(s);
+	return sql.Execute("select count(*) from T") && sql.Fetch() ? (int)sql[0] : -1;
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+	db_path = GetHomeDirFile("sqlpool_test.db");
+	DeleteFile(db_path);
+	{
+		Sqlite3Session db;
+		ASSERT(db.Open(db_path));
+		Sql sql(db);
+		ASSERT(sql.Execute("create table T (ID integer primary key, NAME text)"));
+	}
+
+	{
+		SqlSessionPool pool;
+		pool.Factory(CreateSession).MinSize(2).MaxSize(3).Timeout(100);
+		ASSERT(pool.Open());
+		ASSERT(pool.GetStats().size == 2 && pool.GetStats().idle == 2);
+
+		{
+			SqlPooledSession a(pool);
+			{ // nested checkout in the same thread gets the same session
+				SqlPooledSession b(pool);
+				ASSERT(a && b && &a.Get() == &b.Get());
+			}
+			ASSERT(pool.GetStats().idle == 1);
+
+			SqlSession *x = pool.Acquire();
+			SqlSession *y = pool.Acquire();
+			ASSERT(x && y && x != y && x != &a.Get());
+			ASSERT(pool.GetStats().size == 3 && pool.GetStats().idle == 0);
+			ASSERT(pool.Acquire() == NULL); // pool exhausted, timeout
+			SqlSessionPool::Stats st = pool.GetStats();
+			ASSERT(st.timeouts == 1 && st.waited == 1 && st.max_wait >= 90000);
+			pool.Release(x);
+			pool.Release(y);
+		}
+		ASSERT(pool.GetStats().idle == 3);
+
+		// transaction left open is rolled back when session returns to the pool
+		{
+			SqlPooledSession s(pool);
+			s->Begin();
+			Sql sql(s);
+			ASSERT(sql.Execute("insert into T (NAME) values (?)", "rolled back"));
+			ASSERT(s->GetTransactionLevel() == 1);
+		}
+		ASSERT(pool.GetStats().rollbacks == 1);
+		{
+			SqlPooledSession s(pool);
+			ASSERT(s->GetTransactionLevel() == 0);
+			ASSERT(Count(s) == 0);
+		}
+
+		// discarded session is closed
+		{
+			SqlPooledSession s(pool);
+			s.Discard();
+		}
+		ASSERT(pool.GetStats().size == 2 && pool.GetStats().discarded == 1);
+
+		// failed health check of idle session
+		pool.CheckIdle(0);
+		int checks = 0;
+		pool.WhenCheck = [&](SqlSession&) { return checks++ > 0; };
+		Sleep(2);
+		{
+			SqlPooledSession s(pool);
+			ASSERT(s);
+		}
+		ASSERT(checks == 2 && pool.GetStats().discarded == 2);
+		pool.WhenCheck.Clear();
+		pool.CheckIdle(10000);
+
+		// contention
+		ASSERT(pool.MinSize(3).Open()); // fills the pool again
+		ASSERT(pool.GetStats().size == 3);
+		pool.ResetStats();
+		pool.Timeout(-1);
+		CoWork co;
+		for(int t = 0; t < 8; t++)
+			co & [&, t] {
+				for(int i = 0; i < 50; i++) {
+					SqlPooledSession s(pool);
+					ASSERT(s);
+					ASSERT(pool.GetStats().size <= 3);
+					Sql sql(s);
+					ASSERT(sql.Execute("insert into T (NAME) values (?)", AsString(t)));
+				}
+			};
+		co.Finish();
+		SqlSessionPool::Stats st = pool.GetStats();
+		LOG("acquired " << st.acquired << ", waited " << st.waited << ", max wait " << st.max_wait << " us");
+		ASSERT(st.acquired == 400);
+		ASSERT(st.size <= 3 && st.idle == st.size && st.waiting == 0);
+		SqlPooledSession s(pool);
+		ASSERT(Count(s) == 400);
+	}
+
+	{
+		SqlSessionPool pool;
+		pool.Factory([] { return (SqlSession *)NULL; });
+		ASSERT(!pool.Open());
+		ASSERT(pool.Acquire() == NULL);
+	}
+
+	DeleteFile(db_path);
+
+	LOG("============ OK");
+}
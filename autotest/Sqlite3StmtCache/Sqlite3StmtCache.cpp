@@ -0,0 +1,96 @@
+#include <plugin/sqlite3/Sqlite3.h>
+
+using namespace Upp;
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+	Sqlite3Session db;
+	ASSERT(db.Open(":memory:"));
+	ASSERT(db.GetStatementCacheSize() > 0);
+	db.StatementCache(4);
+
+	Sql sql(db);
+	ASSERT(sql.Execute("create table T (ID integer primary key, NAME text, D date, B blob)"));
+
+	for(int i = 0; i < 100; i++)
+		ASSERT(sql.Execute("insert into T (ID, NAME, D, B) values (?, ?, ?, ?)",
+		                   i, AsString(i), Date(2020, 1, 1) + i, i & 1 ? Value(SqlRaw(String(i, 3))) : Value()));
+	ASSERT(db.GetStatementCacheMisses() == 2);
+	ASSERT(db.GetStatementCacheHits() == 99);
+
+	db.ResetStatementCacheStats();
+	for(int i = 0; i < 100; i++) {
+		ASSERT(sql.Execute("select NAME, D, B from T where ID = ?", i));
+		ASSERT(sql.Fetch());
+		ASSERT(sql[0] == AsString(i));
+		ASSERT(sql[1] == Date(2020, 1, 1) + i);
+		ASSERT(IsNull(sql[2]) == !(i & 1));
+		ASSERT(sql.Fetch() == false);
+	}
+	ASSERT(db.GetStatementCacheHits() == 99);
+
+	// bindings are cleared, NULL parameters work with reused statement
+	ASSERT(sql.Execute("select count(*) from T where NAME = ?", "1"));
+	ASSERT(sql.Fetch() && sql[0] == 1);
+	ASSERT(sql.Execute("select count(*) from T where NAME = ?", Value()));
+	ASSERT(sql.Fetch() && sql[0] == 0);
+
+	// two cursors running the same statement at once
+	Sql sql2(db);
+	ASSERT(sql.Execute("select ID from T where ID < ? order by ID", 10));
+	ASSERT(sql2.Execute("select ID from T where ID < ? order by ID", 5));
+	int n1 = 0, n2 = 0;
+	while(sql.Fetch())
+		ASSERT(sql[0] == n1++);
+	while(sql2.Fetch())
+		ASSERT(sql2[0] == n2++);
+	ASSERT(n1 == 10 && n2 == 5);
+
+	// interrupted fetch does not hold the statement
+	ASSERT(sql.Execute("select ID from T"));
+	ASSERT(sql.Fetch());
+	db.Begin();
+	ASSERT(sql.Execute("update T set NAME = ? where ID = ?", "X", 1));
+	db.Commit();
+	ASSERT(!db.WasError());
+
+	// eviction keeps at most 4 statements
+	db.ResetStatementCacheStats();
+	for(int pass = 0; pass < 2; pass++)
+		for(int i = 0; i < 10; i++) {
+			ASSERT(sql.Execute("select " + AsString(i) + " from T where ID = ?", i));
+			ASSERT(sql.Fetch() && sql[0] == i);
+		}
+	ASSERT(db.GetStatementCacheHits() == 0);
+	ASSERT(db.GetStatementCacheMisses() == 20);
+
+	// cached statement is recompiled after schema change
+	ASSERT(sql.Execute("select * from T where ID = ?", 2));
+	ASSERT(sql.GetColumnCount() == 4);
+	sql.Cancel();
+	ASSERT(sql.Execute("alter table T add column X integer"));
+	ASSERT(sql.Execute("select * from T where ID = ?", 2));
+	ASSERT(sql.GetColumnCount() == 5);
+
+	// errors do not poison the cache
+	ASSERT(!sql.Execute("select * from NONEXISTENT where ID = ?", 1));
+	db.ClearError();
+	ASSERT(sql.Execute("select NAME from T where ID = ?", 1));
+	ASSERT(sql.Fetch() && sql[0] == "X");
+
+	db.StatementCache(0);
+	db.ResetStatementCacheStats();
+	ASSERT(sql.Execute("select NAME from T where ID = ?", 1));
+	ASSERT(sql.Fetch() && sql[0] == "X");
+	ASSERT(db.GetStatementCacheHits() == 0);
+
+	db.StatementCache(16);
+	ASSERT(sql.Execute("select NAME from T where ID = ?", 3));
+	sql.Cancel();
+	sql2.Cancel();
+	db.Close(); // asserts that all statements were finalized
+
+	LOG("============ OK");
+}
@@ -0,0 +1,161 @@
+#include <plugin/sqlite3/Sqlite3.h>
+
+using namespace Upp;
+
+SqlId ITEM("ITEM"), ID("ID"), NAME("NAME");
+
+int Count(Sqlite3Session& s)
+{
+	Sql sql(s);
+	return sql % Select(SqlCountRows()).From(ITEM);
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+	String fn = GetHomeDirFile("Sqlite3Wal.db");
+	DeleteFile(fn);
+	DeleteFile(fn + "-wal");
+	DeleteFile(fn + "-shm");
+
+	Sqlite3Session db;
+	ASSERT(db.Open(fn));
+	db.Tuned();
+	Sql sql(db);
+	ASSERT(ToLower(String(sql % SqlStatement("pragma journal_mode"))) == "wal");
+	ASSERT((int)(sql % SqlStatement("pragma synchronous")) == 1);
+	ASSERT((int)(sql % SqlStatement("pragma cache_size")) == -65536);
+	ASSERT((int)(sql % SqlStatement("pragma temp_store")) == 2);
+	db.Synchronous(2);
+	ASSERT((int)(sql % SqlStatement("pragma synchronous")) == 2);
+
+	ASSERT(sql.Execute("create table ITEM (ID integer primary key, NAME text)"));
+	for(int i = 0; i < 10; i++)
+		ASSERT(sql * Insert(ITEM)(ID, i)(NAME, AsString(i)));
+
+	{ // reader is read-only connection of the calling thread
+		Sqlite3Session *r = db.Reader();
+		ASSERT(r && r != &db && r->IsReadOnly() && !db.IsReadOnly());
+		ASSERT(db.Reader() == r);
+		ASSERT(Count(*r) == 10);
+		ASSERT(!Sql(*r).Execute("insert into ITEM (ID, NAME) values (100, 'X')"));
+		ASSERT(Count(db) == 10);
+		db.CloseReader();
+	}
+
+	{ // in-memory database has no readers
+		Sqlite3Session mem;
+		ASSERT(mem.Open(":memory:"));
+		ASSERT(mem.Reader() == &mem);
+	}
+
+	{ // failure to open reader is reported
+		String fn2 = GetHomeDirFile("Sqlite3Wal2.db");
+		Sqlite3Session db2;
+		ASSERT(db2.Open(fn2));
+		DeleteFile(fn2);
+		Thread t;
+		t.Run([&] { ASSERT(!db2.Reader() && db2.WasError()); });
+		t.Wait();
+		db2.Close();
+		ASSERT(!db2.Reader());
+	}
+
+	{ // readers see committed data only
+		db.Begin();
+		ASSERT(sql * Insert(ITEM)(ID, 10)(NAME, "10"));
+		ASSERT(Count(*db.Reader()) == 10);
+		db.Commit();
+		ASSERT(Count(*db.Reader()) == 11);
+	}
+
+	{ // AutoBatch groups writes into implicit transactions
+		db.AutoBatch(5, 60000);
+		ASSERT(sql * Insert(ITEM)(ID, 11)(NAME, "11"));
+		ASSERT(db.IsBatchOpen() && db.GetTransactionLevel() == 0);
+		ASSERT(Count(db) == 12);
+		ASSERT(Count(*db.Reader()) == 11);
+		for(int i = 12; i < 16; i++)
+			ASSERT(sql * Insert(ITEM)(ID, i)(NAME, AsString(i)));
+		ASSERT(Count(*db.Reader()) == 11);
+		ASSERT(sql * Insert(ITEM)(ID, 16)(NAME, "16")); // limit reached, previous 5 committed
+		ASSERT(Count(*db.Reader()) == 16);
+		db.FlushBatch();
+		ASSERT(!db.IsBatchOpen());
+		ASSERT(Count(*db.Reader()) == 17);
+
+		ASSERT(sql * Insert(ITEM)(ID, 17)(NAME, "17"));
+		db.Begin(); // explicit transaction commits the batch first
+		ASSERT(!db.IsBatchOpen() && db.GetTransactionLevel() == 1);
+		ASSERT(Count(*db.Reader()) == 18);
+		ASSERT(sql * Insert(ITEM)(ID, 18)(NAME, "18"));
+		ASSERT(!db.IsBatchOpen());
+		db.Rollback();
+		ASSERT(Count(db) == 18);
+
+		ASSERT(sql * Select(ID).From(ITEM)); // reads do not open batch
+		ASSERT(!db.IsBatchOpen());
+
+		db.AutoBatch(1000, 0); // time limit
+		ASSERT(sql * Insert(ITEM)(ID, 18)(NAME, "18"));
+		ASSERT(sql * Insert(ITEM)(ID, 19)(NAME, "19"));
+		ASSERT(Count(*db.Reader()) == 19);
+		db.NoAutoBatch();
+		ASSERT(!db.IsBatchOpen() && Count(*db.Reader()) == 20);
+
+		db.AutoBatch(1000, 100); // time limit checked by reads and FlushDueBatch
+		ASSERT(sql * Insert(ITEM)(ID, 20)(NAME, "20"));
+		db.FlushDueBatch();
+		ASSERT(db.IsBatchOpen());
+		Sleep(150);
+		ASSERT(Count(db) == 21 && !db.IsBatchOpen());
+		ASSERT(Count(*db.Reader()) == 21);
+		ASSERT(sql * Delete(ITEM).Where(ID == 20));
+		ASSERT(db.IsBatchOpen());
+		Sleep(150);
+		db.FlushDueBatch();
+		ASSERT(!db.IsBatchOpen() && Count(*db.Reader()) == 20);
+		db.NoAutoBatch();
+	}
+
+	{ // concurrent readers while writing
+		std::atomic<int> failed(0), reads(0);
+		std::atomic<bool> done(false);
+		Array<Thread> t;
+		for(int i = 0; i < 4; i++)
+			t.Add().Run([&] {
+				Sqlite3Session *r = db.Reader();
+				ASSERT(r);
+				int last = 0;
+				while(!done) {
+					int n = Count(*r);
+					if(n < last || n < 20)
+						failed++;
+					last = n;
+					reads++;
+				}
+				db.CloseReader();
+			});
+		db.AutoBatch(50, 10);
+		for(int i = 20; i < 2000; i++)
+			ASSERT(sql * Insert(ITEM)(ID, i)(NAME, AsString(i)));
+		db.FlushBatch();
+		while(reads < 100)
+			Sleep(1);
+		done = true;
+		for(Thread& h : t)
+			h.Wait();
+		ASSERT(failed == 0);
+		ASSERT(Count(*db.Reader()) == 2000);
+		LOG("reads: " << (int)reads);
+	}
+
+	sql.Cancel();
+	db.Close();
+	DeleteFile(fn);
+	DeleteFile(fn + "-wal");
+	DeleteFile(fn + "-shm");
+
+	LOG("============ OK");
+}
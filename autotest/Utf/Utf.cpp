@@ -83,5 +83,41 @@ CONSOLE_APP_MAIN
 
 	LOG("Error escape test passed");
 
+	SeedRandom(0);
+	for(int i = 0; i < 30000; i++) { // mostly ASCII text exercises block conversions
+		int n = Random(300);
+		WString text;
+		while(text.GetCount() < n) {
+			int code = Random(20) ? Random(128) : Random(4) ? 128 + Random(0x800) : 0x10000 + Random(0x100000);
+			if(code < 0xee00 || code > 0xeeff)
+				text.Cat(code);
+		}
+
+		String s = ToUtf8(text);
+		ASSERT(Utf8Len(text) == s.GetCount());
+		ASSERT(CheckUtf8(s));
+		ASSERT(ToUtf32(s) == text);
+		ASSERT(Utf32Len(s) == text.GetCount());
+
+		Vector<char16> ws = ToUtf16(text);
+		ASSERT(Utf16Len(text) == ws.GetCount());
+		ASSERT(Utf16Len(s) == ws.GetCount());
+		ASSERT(ToUtf16(s) == ws);
+		ASSERT(ToUtf32(ws) == text);
+		ASSERT(Utf32Len(ws) == text.GetCount());
+		ASSERT(Utf8Len(ws) == s.GetCount());
+		ASSERT(ToUtf8(ws) == s);
+
+		if(s.GetCount()) {
+			String h = s;
+			h.Set(Random(h.GetCount()), 0xff);
+			ASSERT(!CheckUtf8(h));
+			ASSERT(ToUtf8(ToUtf32(h)) == h);
+			ASSERT(ToUtf8(ToUtf16(h)) == h);
+		}
+	}
+
+	LOG("Mixed ASCII test passed");
+
 	LOG("========== OK");
 }
@@ -0,0 +1,111 @@
+#include <Core/Core.h>
+
+using namespace Upp;
+
+std::atomic<int> made[200];
+
+Value Make(int i, int size = 100, int delay = 0)
+{
+	return MakeValue(
+		[&] { return AsString(i); },
+		[&](Value& v) {
+			if(delay)
+				Sleep(delay);
+			made[i]++;
+			v = i;
+			return size;
+		}
+	);
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+	SetupValueCache(100000000, 100000);
+
+	{ // concurrent requests of the same value make it only once
+		ClearValueCacheStats();
+		CoWork co;
+		for(int t = 0; t < 8; t++)
+			co & [] {
+				for(int i = 0; i < 100; i++)
+					ASSERT(Make(i, 100, 1) == i);
+			};
+		co.Finish();
+		for(int i = 0; i < 100; i++)
+			ASSERT(made[i] == 1);
+		ValueCacheStats st = GetValueCacheStats();
+		LOG("hits " << st.hits << ", misses " << st.misses << ", waits " << st.waits);
+		ASSERT(st.misses == 100);
+		ASSERT(st.hits + st.waits == 700);
+		ASSERT(st.count == 100 && GetValueCacheCount() == 100);
+		ASSERT(st.size > 100 * 100 && st.size == GetValueCacheSize());
+		ASSERT(st.evictions == 0);
+	}
+
+	{ // MakeValueSz reports the size including internal overhead
+		struct Maker : ValueMaker {
+			String Key() const override { return "sz"; }
+			int Make(Value& v) const override { v = "sz"; return 1000; }
+		} m;
+		int sz1 = 0, sz2 = 0;
+		ASSERT(MakeValueSz(m, sz1) == "sz");
+		ASSERT(MakeValueSz(m, sz2) == "sz");
+		ASSERT(sz1 > 1000 && sz1 == sz2);
+		ASSERT(ValueCacheRemove([](const Value& v) { return v == "sz"; }) == 1);
+	}
+
+	{ // Remove, RemoveOne, AdjustSize
+		ASSERT(ValueCacheRemoveOne([](const Value& v) { return v.Is<int>() && (int)v < 10; }) == 1);
+		ASSERT(GetValueCacheCount() == 99);
+		ASSERT(ValueCacheRemove([](const Value& v) { return v.Is<int>() && (int)v < 10; }) == 9);
+		ASSERT(GetValueCacheCount() == 90);
+		for(int i = 0; i < 10; i++)
+			ASSERT(Make(i) == i && made[i] == 2);
+
+		int64 size = GetValueCacheSize();
+		ValueCacheAdjustSize([](const Value& v) { return v.Is<int>() && (int)v < 50 ? 1100 : -1; });
+		ASSERT(GetValueCacheSize() == size + 50 * 1000);
+	}
+
+	{ // values are made again after failure
+		try {
+			MakeValue([] { return String("fail"); }, [](Value& v) -> int { throw Exc("failed"); });
+			NEVER();
+		}
+		catch(Exc e) {
+			ASSERT(e == "failed");
+		}
+		ASSERT(MakeValue([] { return String("fail"); }, [](Value& v) { v = 1; return 1; }) == 1);
+	}
+
+	{ // Make can request other values
+		Value v = MakeValue([] { return String("outer"); }, [](Value& v) {
+			v = (int)Make(150) + 1;
+			return 10;
+		});
+		ASSERT(v == 151 && made[150] == 1);
+	}
+
+	{ // limits
+		ClearValueCacheStats();
+		SetupValueCache(100000000, 20);
+		ASSERT(GetValueCacheCount() > 20);
+		ShrinkValueCache();
+		ASSERT(GetValueCacheCount() <= 20);
+		ValueCacheStats st = GetValueCacheStats();
+		ASSERT(st.evictions > 0);
+
+		SetupValueCache(100000000, 2);
+		ShrinkValueCache();
+		ASSERT(GetValueCacheCount() <= 2);
+
+		SetupValueCache(5000, 100000);
+		for(int i = 0; i < 100; i++)
+			Make(i, 1000);
+		ASSERT(GetValueCacheSize() <= 5000);
+	}
+
+	LOG("============ OK");
+}
@@ -0,0 +1,117 @@
+#include <Core/Core.h>
+
+using namespace Upp;
+
+Value exit_map; // destroyed at exit, possibly after function local statics in Core
+
+bool SameKeys(const ValueMap& a, const ValueMap& b)
+{
+	return &a.GetKeys() == &b.GetKeys();
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+	Value json = ParseJSON(R"([
+		{ "id": 1, "name": "one", "tags": { "a": 1, "b": 2 } },
+		{ "id": 2, "name": "two", "tags": { "a": 3, "b": 4 } },
+		{ "name": "three", "id": 3 },
+		{ "id": 4, "name": "four", "tags": { "a": 5, "b": 6 }, },
+		{ "id": 5, "id": 6 },
+		{}
+	])");
+	ASSERT(json.GetCount() == 6);
+	LOG(json);
+
+	ValueMap m1 = json[0];
+	ValueMap m2 = json[1];
+	ValueMap m3 = json[2];
+	ValueMap m4 = json[3];
+	ASSERT(SameKeys(m1, m2) && SameKeys(m1, m4) && !SameKeys(m1, m3));
+	ASSERT(SameKeys(m1["tags"], m2["tags"]) && SameKeys(m1["tags"], m4["tags"]));
+	ASSERT(m1["id"] == 1 && m2["name"] == "two" && m4["tags"]["b"] == 6);
+	ASSERT(m3["id"] == 3 && m3.GetKey(0) == "name");
+	ASSERT(json[4].GetCount() == 2 && json[4]["id"] == 5);
+	ASSERT(IsNull(json[5]));
+	ASSERT(AsJSON(json) == AsJSON(ParseJSON(AsJSON(json))));
+
+	{ // changing values keeps the keys shared
+		ValueMap m = m1;
+		m.SetAt(0, 10);
+		m.Set("name", "ten");
+		m.At(2) = 1;
+		m.GetAdd("id") = 11;
+		ASSERT(SameKeys(m, m1));
+		ASSERT(m["id"] == 11 && m["name"] == "ten" && m1["id"] == 1 && m1["name"] == "one");
+	}
+
+	{ // changing keys makes them private
+		ValueMap m = m1;
+		m.Add("extra", 1);
+		ASSERT(!SameKeys(m, m1) && m.GetCount() == 4 && m1.GetCount() == 3 && IsError(m1["extra"]));
+
+		m = m1;
+		m.SetKey(0, "ID");
+		ASSERT(!SameKeys(m, m1) && m["ID"] == 1 && m1["id"] == 1 && IsError(m1["ID"]));
+
+		m = m1;
+		m.RemoveKey("name");
+		ASSERT(!SameKeys(m, m1) && m.GetCount() == 2 && m1["name"] == "one");
+
+		m = m1;
+		m.Remove(0);
+		ASSERT(!SameKeys(m, m1) && m.GetCount() == 2 && m1.GetCount() == 3);
+
+		m = m1;
+		VectorMap<Value, Value> vm = m.Pick();
+		ASSERT(vm.GetCount() == 3 && m.GetCount() == 0 && m1.GetCount() == 3 && m1["id"] == 1);
+
+		Value v = m2;
+		v("new") = 1;
+		ASSERT(!SameKeys(v, m2) && v.GetCount() == 4 && m2.GetCount() == 3);
+		ASSERT(SameKeys(m1, m2) && m2["name"] == "two");
+	}
+
+	{ // explicitly shared keys, comparison, serialization
+		ValueMap m(m1, { 1, "one", m1["tags"] });
+		ASSERT(SameKeys(m, m1));
+		ASSERT(m == m1 && m.GetHashValue() == m1.GetHashValue() && m.Compare(m1) == 0);
+		ASSERT(m != m2 && m.Compare(m2) < 0);
+
+		ValueMap n(Index<Value>{ "id", "name", "tags" }, Vector<Value>{ 1, "one", m1["tags"] });
+		ASSERT(!SameKeys(n, m1) && n == m1 && n.GetHashValue() == m1.GetHashValue());
+
+		ValueMap h;
+		LoadFromString(h, StoreAsString(m));
+		ASSERT(h == m);
+		StoreAsString(m);
+		ASSERT(SameKeys(m, m1));
+
+		ValueMap x;
+		LoadFromXML(x, StoreAsXML(m, "test"));
+		ASSERT(x == m);
+		ASSERT(SameKeys(m, m1));
+
+		ValueMap j;
+		LoadFromJson(j, StoreAsJson(m));
+		ASSERT(j == m);
+	}
+
+	{ // LoadFromJson
+		struct Rec {
+			int    id;
+			String name;
+
+			void Jsonize(JsonIO& io) { io("id", id)("name", name); }
+		};
+		Array<Rec> rec;
+		ASSERT(LoadFromJson(rec, R"([{ "id": 1, "name": "one" }, { "name": "two", "id": 2 }, { "id": 3, "name": "three" }])"));
+		ASSERT(rec.GetCount() == 3 && rec[1].id == 2 && rec[1].name == "two" && rec[2].name == "three");
+	}
+
+	exit_map = ParseJSON("{}"); // keeps reference to the shared empty shape until exit
+	ASSERT(exit_map.Is<ValueMap>() && exit_map.GetCount() == 0);
+
+	LOG("============ OK");
+}
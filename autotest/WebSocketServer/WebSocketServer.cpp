@@ -0,0 +1,169 @@
+#include <Core/Core.h>
+
+using namespace Upp;
+
+const int PORT = 4013;
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+	
+	const int MAXSIZE = 1024 * 1024;
+
+	WebSocketServer server;
+	server.MaxMessageSize(MAXSIZE);
+	String msg;
+	server.WhenMessage = [&](WebSocket& ws, const String& data) {
+		msg << data;
+		if(!ws.IsFin())
+			return;
+		String s = pick(msg);
+		if(s == "broadcast")
+			server.Broadcast("hello all");
+		else
+			ws.SendText(s);
+	};
+	ASSERT(server.Listen(PORT));
+	
+	Thread t;
+	t.Run([&] { server.Run(); });
+	
+	Vector<String> data;
+	data << "Hello" << String('x', 100) << String('y', 70000);
+	for(int i = 0; i < 20000; i++)
+		data.Top() << i;
+	
+	for(int deflate = 0; deflate < 2; deflate++) {
+		LOG("-------------- deflate " << deflate);
+		WebSocket ws;
+		ws.Deflate(deflate);
+		ASSERT(ws.Connect("ws://127.0.0.1:" + AsString(PORT)));
+		ASSERT(ws.IsDeflate() == !!deflate);
+		for(String s : data) {
+			ws.SendText(s);
+			ASSERT(ws.Receive() == s);
+			ASSERT(ws.IsText());
+		}
+		ws.BeginText("fragmented ");
+		ws.Continue("message");
+		ws.Fin("!");
+		ASSERT(ws.Receive() == "fragmented message!");
+
+		WebSocket ws2;
+		ASSERT(ws2.Connect("ws://127.0.0.1:" + AsString(PORT)));
+		ws.SendText("broadcast");
+		ASSERT(ws.Receive() == "hello all");
+		ASSERT(ws2.Receive() == "hello all");
+		ws.Close();
+		ws2.Close();
+	}
+	
+	LOG("-------------- permessage-deflate negotiation");
+	auto Handshake = [](const char *extensions) {
+		TcpSocket s;
+		ASSERT(s.Connect("127.0.0.1", PORT));
+		s.Put("GET / HTTP/1.1\r\n"
+		      "Host: 127.0.0.1\r\n"
+		      "Upgrade: websocket\r\n"
+		      "Connection: Upgrade\r\n"
+		      "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+		      "Sec-WebSocket-Version: 13\r\n"
+		      "Sec-WebSocket-Extensions: " + String(extensions) + "\r\n\r\n");
+		HttpHeader h;
+		ASSERT(h.Read(s) && h.GetCode() == 101);
+		return h["sec-websocket-extensions"];
+	};
+	ASSERT(Handshake("permessage-deflate").StartsWith("permessage-deflate"));
+	ASSERT(Handshake("permessage-deflate; client_max_window_bits").GetCount());
+	ASSERT(Handshake("permessage-deflate; server_max_window_bits=15; client_no_context_takeover").GetCount());
+	ASSERT(Handshake("x-webkit-deflate-frame, permessage-deflate; server_max_window_bits=10, "
+	                 "permessage-deflate; client_max_window_bits=\"12\"").GetCount());
+	ASSERT(IsNull(Handshake("permessage-deflate; server_max_window_bits=10")));
+	ASSERT(IsNull(Handshake("permessage-deflate; server_max_window_bits=16")));
+	ASSERT(IsNull(Handshake("permessage-deflate; server_max_window_bits=015")));
+	ASSERT(IsNull(Handshake("permessage-deflate; server_max_window_bits")));
+	ASSERT(IsNull(Handshake("permessage-deflate; client_max_window_bits=7")));
+	ASSERT(IsNull(Handshake("permessage-deflate; server_no_context_takeover=1")));
+	ASSERT(IsNull(Handshake("permessage-deflate; client_no_context_takeover; client_no_context_takeover")));
+	ASSERT(IsNull(Handshake("permessage-deflate; unknown_parameter")));
+	ASSERT(IsNull(Handshake("x-webkit-deflate-frame")));
+
+	LOG("-------------- maximal message size");
+	auto Frame = [](int hdr, const String& payload) { // masked with zero key
+		String f;
+		f.Cat(hdr);
+		int len = payload.GetCount();
+		if(len < 126)
+			f.Cat(0x80 | len);
+		else {
+			f.Cat(0x80 | 126);
+			f.Cat(len >> 8);
+			f.Cat(len & 255);
+		}
+		f.Cat(0, 4);
+		return f + payload;
+	};
+	auto Deflate = [](const String& s) {
+		Zlib z;
+		z.NoHeader().Compress();
+		z.Put(s);
+		z.Flush();
+		return z.Get();
+	};
+	auto CloseCode = [&](const String& frame, int64 length = Null) {
+		TcpSocket s;
+		ASSERT(s.Connect("127.0.0.1", PORT));
+		s.Timeout(5000);
+		s.Put("GET / HTTP/1.1\r\n"
+		      "Host: 127.0.0.1\r\n"
+		      "Upgrade: websocket\r\n"
+		      "Connection: Upgrade\r\n"
+		      "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+		      "Sec-WebSocket-Version: 13\r\n"
+		      "Sec-WebSocket-Extensions: permessage-deflate\r\n\r\n");
+		HttpHeader h;
+		ASSERT(h.Read(s) && h.GetCode() == 101);
+		if(IsNull(length))
+			s.Put(frame);
+		else { // just the header announcing length
+			s.Put(String(0x82, 1) + String(0xff, 1));
+			for(int i = 7; i >= 0; i--)
+				s.Put(String((byte)(length >> (8 * i)), 1));
+			s.Put(String(0, 4));
+		}
+		String r = s.GetAll(2);
+		if((byte)r[0] != 0x88) { // not CLOSE, server replied with the message
+			ASSERT(((byte)r[0] & 0x8f) == 0x81);
+			return 0;
+		}
+		int len = r[1] & 127;
+		String key = s.GetAll(4);
+		String payload = s.GetAll(len);
+		ASSERT(len >= 2 && payload.GetCount() == len);
+		for(int i = 0; i < len; i++)
+			payload.Set(i, payload[i] ^ key[i & 3]);
+		ASSERT(s.Get() < 0); // server closed the connection
+		return ((byte)payload[0] << 8) | (byte)payload[1];
+	};
+	String small = Deflate(String('x', MAXSIZE));
+	String big = Deflate(String('x', MAXSIZE + 1));
+	ASSERT(big.GetCount() < 2000);
+	ASSERT(CloseCode(Frame(0x81|0x40, small)) == 0);
+	ASSERT(CloseCode(Frame(0x81|0x40, big)) == 1009);
+	ASSERT(CloseCode(Frame(0x01|0x40, small.Mid(0, 100)) + Frame(0x80, small.Mid(100))) == 0);
+	ASSERT(CloseCode(Frame(0x01|0x40, big.Mid(0, 100)) + Frame(0x80, big.Mid(100))) == 1009);
+	ASSERT(CloseCode(Null, MAXSIZE + 1) == 1009);
+	ASSERT(CloseCode(Null, INT64_MAX) == 1009);
+	{
+		WebSocket ws;
+		ASSERT(ws.Connect("ws://127.0.0.1:" + AsString(PORT)));
+		ws.SendText(String('a', MAXSIZE + 1));
+		ASSERT(ws.Receive().IsVoid());
+		ASSERT(ws.IsClosed());
+	}
+
+	server.Stop();
+	t.Wait();
+	
+	LOG("============= OK");
+}
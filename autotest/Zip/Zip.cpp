@@ -31,5 +31,179 @@ CONSOLE_APP_MAIN
 	ASSERT(unzip.ReadFile("file2") == "this is content of file2");
 	ASSERT(unzip.ReadFile("file3").IsVoid());
 	
+	String big;
+	for(int i = 0; i < 1000000; i++)
+		big << i << ' ';
+	StringZip cz;
+	cz.Co();
+	cz.WriteFile("small", "small");
+	cz.WriteFile(big, "big");
+	StringUnZip cunzip(cz.Finish());
+	ASSERT(cunzip.ReadFile("small") == "small");
+	ASSERT(cunzip.ReadFile("big") == big);
+	
+	{ // random access, parallel extraction, Zip64
+		StringZip z;
+		VectorMap<String, String> content;
+		z.WriteFolder("dir/");
+		for(int i = 0; i < 300; i++) {
+			String path = Format("dir/file%d.txt", i);
+			String data;
+			for(int j = 0; j < i * 37; j++)
+				data << j << ' ';
+			content.Add(path, data);
+			if(i % 3 == 0) {
+				z.BeginFile(path, GetSysTime(), i & 1, true);
+				z.Put(data, data.GetCount());
+				z.EndFile();
+			}
+			else
+				z.WriteFile(data, path, Null, GetSysTime(), i & 1);
+		}
+		String zip = z.Finish();
+		String tmp = GetHomeDirFile("UnZipTest.zip");
+		SaveFile(tmp, zip);
+
+		auto CheckUnZip = [&](UnZip& unzip) {
+			ASSERT(!unzip.IsError());
+			ASSERT(unzip.GetCount() == content.GetCount() + 1);
+			ASSERT(unzip.Find("nothing") < 0);
+			for(int i = content.GetCount() - 1; i >= 0; i--) {
+				int q = unzip.Find(content.GetKey(i));
+				ASSERT(q >= 0);
+				ASSERT(unzip.GetLength(q) == content[i].GetCount());
+				ASSERT(unzip.Extract(q) == content[i]);
+			}
+			Mutex mtx;
+			int n = 0;
+			ASSERT(unzip.CoRead([&](int i, const String& data) {
+				Mutex::Lock __(mtx);
+				ASSERT(content.Get(unzip.GetPath(i)) == data);
+				n++;
+			}));
+			ASSERT(n == content.GetCount());
+			ASSERT(unzip.ReadFile("dir/file7.txt") == content.Get("dir/file7.txt"));
+		};
+		
+		StringUnZip sunzip(zip);
+		CheckUnZip(sunzip);
+		MappedUnZip munzip(tmp);
+		CheckUnZip(munzip);
+		FileUnZip funzip(tmp);
+		CheckUnZip(funzip);
+		
+		String dir = GetHomeDirFile("UnZipTest");
+		DeleteFolderDeep(dir);
+		int last = 0;
+		ASSERT(munzip.CoExtract(dir, [&](int done, int total) { last = done; return false; }));
+		ASSERT(last == content.GetCount());
+		for(int i = 0; i < content.GetCount(); i++)
+			ASSERT(LoadFile(AppendFileName(dir, content.GetKey(i))) == content[i]);
+		DeleteFolderDeep(dir);
+		
+		StringZip evil;
+		evil.WriteFile("gotcha", "../evil.txt");
+		StringUnZip eunzip(evil.Finish());
+		ASSERT(!eunzip.CoExtract(dir));
+		ASSERT(IsNull(LoadFile(AppendFileName(GetFileFolder(dir), "evil.txt"))));
+		for(const char *path : { "C:evil.txt", "C:\\evil.txt", "dir/C:/evil.txt", "/evil.txt" }) {
+			StringZip evil;
+			evil.WriteFile("gotcha", path);
+			StringUnZip eunzip(evil.Finish());
+			ASSERT(!eunzip.IsError());
+			ASSERT(!eunzip.CoExtract(dir));
+		}
+
+		DeleteFolderDeep(dir);
+		DeleteFile(tmp);
+	}
+	
+	{ // hand-made ZIP64 archive, 32-bit fields replaced by values from ZIP64 extra field
+		StringStream ss;
+		ss.Put("self-extracting stub"); // local headers do not start at 0
+		String text[2] = { "sizes and offset in ZIP64 extra field", "only uncompressed size in ZIP64 extra field" };
+		const char *name[2] = { "zip64a.txt", "zip64b.txt" };
+		int64 offset[2];
+		for(int i = 0; i < 2; i++) {
+			offset[i] = ss.GetPos();
+			ss.Put32le(0x04034b50);
+			ss.Put16le(45); // version needed to extract
+			ss.Put16le(0); // general purpose bit flag
+			ss.Put16le(0); // stored
+			ss.Put32le(0); // time
+			ss.Put32le(CRC32(text[i]));
+			ss.Put32le(text[i].GetCount());
+			ss.Put32le(text[i].GetCount());
+			ss.Put16le((word)strlen(name[i]));
+			ss.Put16le(0);
+			ss.Put(name[i]);
+			ss.Put(text[i]);
+		}
+		int64 cd = ss.GetPos();
+		for(int i = 0; i < 2; i++) {
+			int len = text[i].GetCount();
+			ss.Put32le(0x02014b50);
+			ss.Put16le(45); // version made by
+			ss.Put16le(45); // version needed to extract
+			ss.Put16le(0); // general purpose bit flag
+			ss.Put16le(0); // stored
+			ss.Put32le(0); // time
+			ss.Put32le(CRC32(text[i]));
+			ss.Put32le(i ? len : 0xffffffff); // compressed size
+			ss.Put32le(0xffffffff); // uncompressed size
+			ss.Put16le((word)strlen(name[i]));
+			ss.Put16le(4 + 4 + 4 + (i ? 8 : 24)); // extra field length
+			ss.Put16le(0); // comment length
+			ss.Put16le(0); // disk number
+			ss.Put16le(0); // internal attributes
+			ss.Put32le(0); // external attributes
+			ss.Put32le(i ? (dword)offset[i] : 0xffffffff);
+			ss.Put(name[i]);
+			ss.Put16le(0xcafe); // unknown extra field is skipped
+			ss.Put16le(4);
+			ss.Put32le(0xffffffff);
+			ss.Put16le(1); // ZIP64 extra field
+			ss.Put16le(i ? 8 : 24);
+			ss.Put64le(len); // uncompressed size
+			if(i == 0) {
+				ss.Put64le(len); // compressed size
+				ss.Put64le(offset[i]);
+			}
+		}
+		int64 eocd64 = ss.GetPos();
+		ss.Put32le(0x06064b50); // ZIP64 end of central directory record
+		ss.Put64le(44);
+		ss.Put16le(45);
+		ss.Put16le(45);
+		ss.Put32le(0);
+		ss.Put32le(0);
+		ss.Put64le(2);
+		ss.Put64le(2);
+		ss.Put64le(eocd64 - cd);
+		ss.Put64le(cd);
+		ss.Put32le(0x07064b50); // ZIP64 end of central directory locator
+		ss.Put32le(0);
+		ss.Put64le(eocd64);
+		ss.Put32le(1);
+		ss.Put32le(0x06054b50); // end of central directory
+		ss.Put16le(0);
+		ss.Put16le(0);
+		ss.Put16le(0xffff);
+		ss.Put16le(0xffff);
+		ss.Put32le(0xffffffff);
+		ss.Put32le(0xffffffff);
+		ss.Put16le(0);
+
+		StringUnZip unzip(ss.GetResult());
+		ASSERT(!unzip.IsError());
+		ASSERT(unzip.GetCount() == 2);
+		for(int i = 0; i < 2; i++) {
+			int q = unzip.Find(name[i]);
+			ASSERT(q == i);
+			ASSERT(unzip.GetLength(q) == text[i].GetCount());
+			ASSERT(unzip.Extract(q) == text[i]);
+		}
+	}
+
 	LOG("================= OK");
 }
@@ -17,6 +17,8 @@ void Check(const String& data)
 {
 	ASSERT(ZDecompress(ZCompress(data)) == data);
 	ASSERT(GZDecompress(GZCompress(data)) == data);
+	ASSERT(ZDecompress(CoZCompress(data)) == data);
+	ASSERT(GZDecompress(CoGZCompress(data)) == data);
 	
 	String path = GetHomeDirFile("test.txt");
 	SaveFile(path, data);
@@ -35,6 +37,21 @@ CONSOLE_APP_MAIN
 		Check(RandomString(i));
 	Check(RandomString(20000));
 	Check(RandomString(2000000));
+	Check(RandomString(10000000)); // several concurrent batches
+	
+	{
+		String data = RandomString(5000000);
+		StringStream out;
+		ZCompressStream z(out);
+		z.Co();
+		for(int i = 0; i < data.GetCount(); i += 100000) {
+			z.Put(data.Mid(i, 100000));
+			if(i == 300000)
+				z.Flush();
+		}
+		z.Close();
+		ASSERT(ZDecompress(out.GetResult()) == data);
+	}
 	
 	String data = "Hello!";
 	StringStream in(data);
@@ -0,0 +1,70 @@
+#include <Core/Core.h>
+#include <Core/SSL/SSL.h>
+
+using namespace Upp;
+
+template <class F>
+void Benchmark(const char *name, int64 len, F fn)
+{
+	TimeStop tm;
+	fn();
+	double t = tm.Seconds();
+	RLOG(Format("%-40s %8.3f s, %6.2f GB/s", name, t, len / t / 1024 / 1024 / 1024));
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+	
+	const Vector<String>& cmd = CommandLine();
+	int mb = cmd.GetCount() ? max(Atoi(cmd[0]), 1) : 512;
+	
+	String data;
+	{
+		StringBuffer b(mb * 1024 * 1024);
+		for(int i = 0; i < b.GetCount(); i++)
+			b[i] = (char)Random(256);
+		data = b;
+	}
+	String password = "password";
+	RLOG("Data: " << mb << " MB, " << CPU_Cores() << " cores");
+	
+	String v1, v2, d;
+	Benchmark("AES256Encrypt", data.GetCount(), [&] { v1 = AES256Encrypt(data, password); });
+	Benchmark("AES256Decrypt", data.GetCount(), [&] { d = AES256Decrypt(v1, password); });
+	ASSERT(d == data);
+	for(int chunk : { 64 * 1024, 1024 * 1024 }) {
+		Aes256Gcm aes;
+		aes.ChunkSize(chunk);
+		Benchmark("Aes256Gcm, chunk " + AsString(chunk / 1024) + "KB", data.GetCount(),
+		          [&] { aes.Encrypt(data, password, v1); });
+	}
+	Benchmark("CoAES256Encrypt", data.GetCount(), [&] { v2 = CoAES256Encrypt(data, password); });
+	Benchmark("CoAES256Decrypt", data.GetCount(), [&] { d = CoAES256Decrypt(v2, password); });
+	ASSERT(d == data);
+	
+	{
+		Aes256Gcm aes;
+		aes.Co();
+		for(int i = 0; i < 3; i++) {
+			StringStream in(data);
+			StringStream out;
+			Benchmark("Aes256Gcm::Co, streams", data.GetCount(), [&] { aes.Encrypt(in, password, out); });
+		}
+	}
+
+	// key derivation per small message
+	const int N = 100;
+	String msg = data.Mid(0, 1000);
+	TimeStop tm;
+	for(int i = 0; i < N; i++) {
+		Aes256Gcm aes;
+		aes.Co().KeyCache(false);
+		aes.Encrypt(msg, password, v1);
+	}
+	RLOG("1KB messages, no key cache: " << int(tm.Seconds() * 1000000 / N) << " us / message");
+	tm.Reset();
+	for(int i = 0; i < N; i++)
+		v1 = CoAES256Encrypt(msg, password);
+	RLOG("1KB messages, key cache:    " << int(tm.Seconds() * 1000000 / N) << " us / message");
+}
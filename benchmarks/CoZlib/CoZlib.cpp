@@ -0,0 +1,63 @@
+#include <Core/Core.h>
+#include <plugin/zip/zip.h>
+
+using namespace Upp;
+
+String TestData(int len)
+{
+	StringBuffer r;
+	while(r.GetCount() < len)
+		r << "Line " << Random(1000000) << ", " << FormatIntHex(Random()) << " some text\n";
+	return String(r);
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+	String data = TestData(128 * 1024 * 1024);
+	double mb = data.GetCount() / 1024.0 / 1024;
+	
+	RLOG("Cores: " << CPU_Cores());
+	
+	String gz, cogz;
+	for(int pass = 0; pass < 2; pass++) {
+		TimeStop tm;
+		gz = GZCompress(data);
+		RLOG("GZCompress:     " << Format("%.1f MB/s", mb / tm.Seconds()) << ", " << gz.GetCount());
+		tm.Reset();
+		cogz = CoGZCompress(data);
+		RLOG("CoGZCompress:   " << Format("%.1f MB/s", mb / tm.Seconds()) << ", " << cogz.GetCount());
+	}
+	
+	if(GZDecompress(cogz) != data)
+		RLOG("CoGZCompress DATA MISMATCH!");
+	
+	String path = GetTempFileName();
+	SaveFile(path, data);
+	TimeStop tm;
+	{
+		FileZip zip(path + ".zip");
+		zip.WriteFile(data, "data");
+	}
+	RLOG("Zip:            " << Format("%.1f MB/s", mb / tm.Seconds()));
+	tm.Reset();
+	{
+		FileZip zip(path + ".co.zip");
+		zip.Co();
+		zip.WriteFile(data, "data");
+	}
+	RLOG("Zip.Co:         " << Format("%.1f MB/s", mb / tm.Seconds()));
+	
+	if(FileUnZip(path + ".co.zip").ReadFile("data") != data)
+		RLOG("Zip.Co DATA MISMATCH!");
+
+	tm.Reset();
+	CoGZCompressFile(path + ".gz", path);
+	RLOG("CoGZCompressFile: " << Format("%.1f MB/s", mb / tm.Seconds()));
+	
+	DeleteFile(path);
+	DeleteFile(path + ".zip");
+	DeleteFile(path + ".co.zip");
+	DeleteFile(path + ".gz");
+}
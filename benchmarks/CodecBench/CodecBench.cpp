@@ -0,0 +1,63 @@
+#include <plugin/zstd/zstd.h>
+#include <plugin/lz4/lz4.h>
+#include <plugin/bz2/bz2.h>
+#include <plugin/lzma/lzma.h>
+
+using namespace Upp;
+
+// All registered codecs on the same data through the same block pipeline
+
+String TestData(int len)
+{ // mix of text, repetitive records and incompressible bytes
+	static const char *word[] = { "lorem", "ipsum", "dolor", "sit", "amet", "consectetur",
+	                              "adipiscing", "elit", "sed", "do", "eiusmod", "tempor" };
+	StringBuffer s;
+	while(s.GetCount() < len) {
+		switch(Random(3)) {
+		case 0:
+			for(int i = 0; i < 200; i++)
+				s << word[Random(__countof(word))] << (Random(10) ? " " : ".\n");
+			break;
+		case 1:
+			for(int i = 0; i < 50; i++)
+				s << "{\"id\":" << Random(100000) << ",\"value\":" << Random(1000) / 10.0
+				  << ",\"time\":\"" << GetSysTime() - (int64)Random(100000) << "\"}\n";
+			break;
+		default:
+			for(int i = 0; i < 256; i++)
+				s.Cat(Random(256));
+		}
+	}
+	s.SetCount(len);
+	return String(s);
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+	const Vector<String>& cmd = CommandLine();
+	int mb = cmd.GetCount() ? max(Atoi(cmd[0]), 1) : 64;
+	
+	String data = TestData(mb * 1024 * 1024);
+	RLOG("Data: " << mb << " MB, " << CPU_Cores() << " cores");
+	
+	for(int i = 0; i < CodecRegistry::GetCount(); i++) {
+		const StreamCodec& c = CodecRegistry::Get(i);
+		for(int threads : { 1, CPU_Cores() }) {
+			TimeStop tm;
+			String z = CodecCompress(data, c.name, Null, threads);
+			double ct = tm.Seconds();
+			tm.Reset();
+			String d = CodecDecompress(z, threads);
+			double dt = tm.Seconds();
+			if(d != data)
+				Panic("Failed " + c.name);
+			RLOG(Format("%-5s level %d, %2d threads: ratio %5.2f, compress %7.1f MB/s, decompress %7.1f MB/s",
+			            c.name, c.default_level, threads, (double)data.GetCount() / z.GetCount(),
+			            mb / ct, mb / dt));
+			if(CPU_Cores() == 1)
+				break;
+		}
+	}
+}
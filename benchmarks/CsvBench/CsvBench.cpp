@@ -0,0 +1,93 @@
+#include <Core/Core.h>
+
+using namespace Upp;
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+#ifdef _DEBUG
+	const int N = 100000;
+#else
+	const int N = 2000000;
+#endif
+
+	String data;
+	for(int i = 0; i < N; i++) {
+		data << i << ',' << Random(1000000) * 0.01 << ",\"name " << i << "\",";
+		if(i % 10 == 0)
+			data << "\"text, with \"\"quotes\"\" and\nnew line\"";
+		else
+			data << "some plain text field";
+		data << "\r\n";
+	}
+
+	auto Measure = [&](const char *what, Function<int64 ()> fn) {
+		int64 t0 = tmGetTimeNs();
+		int64 n = fn();
+		double s = (tmGetTimeNs() - t0) / 1e9;
+		RLOG(Format("%-24s %8.1f MB/s (%d records)", what, data.GetCount() / s / 1e6, n));
+	};
+
+	Measure("GetCsvLine", [&] {
+		StringStream ss(data);
+		int64 n = 0;
+		while(!ss.IsEof())
+			n += GetCsvLine(ss, ',', CHARSET_DEFAULT).GetCount() > 0;
+		return n;
+	});
+
+	CsvReader csv;
+	Measure("Fetch, GetRecord", [&] {
+		csv.Open(data);
+		int64 n = 0;
+		while(csv.Fetch())
+			n += csv.GetRecord().GetCount() > 0;
+		return n;
+	});
+
+	Measure("Fetch, GetInt64", [&] {
+		csv.Open(data);
+		int64 n = 0;
+		while(csv.Fetch())
+			n += !IsNull(csv.GetInt64(0));
+		return n;
+	});
+
+	for(int parallel = 0; parallel < 2; parallel++) {
+		csv.Parallel(parallel);
+		String h = parallel ? " parallel" : "";
+		Measure("CountRecords" + h, [&] { csv.Open(data); return csv.CountRecords(); });
+		Measure("ReadInt64" + h, [&] { csv.Open(data); return csv.ReadInt64(0).GetCount(); });
+		Measure("ReadDouble" + h, [&] { csv.Open(data); return csv.ReadDouble(1).GetCount(); });
+		Measure("ReadAll" + h, [&] { csv.Open(data); return csv.ReadAll().GetCount(); });
+		Measure("ReadInt64 stream" + h, [&] {
+			StringStream ss(data);
+			csv.Open(ss);
+			return csv.ReadInt64(0).GetCount();
+		});
+	}
+
+	csv.Open(data);
+	Vector<Vector<String>> rows = csv.ReadAll();
+	Measure("CsvString", [&] {
+		StringStream ss;
+		for(const Vector<String>& row : rows) {
+			for(int i = 0; i < row.GetCount(); i++) {
+				if(i)
+					ss.Put(',');
+				ss.Put(CsvString(row[i]));
+			}
+			ss.Put("\r\n");
+		}
+		return (int64)rows.GetCount();
+	});
+
+	Measure("CsvWriter", [&] {
+		StringStream ss;
+		CsvWriter out(ss);
+		for(const Vector<String>& row : rows)
+			out.PutRow(row);
+		return (int64)rows.GetCount();
+	});
+}
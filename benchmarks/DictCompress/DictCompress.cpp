@@ -0,0 +1,100 @@
+#include <plugin/zstd/zstd.h>
+#include <plugin/lz4/lz4.h>
+
+using namespace Upp;
+
+// Synthetic corpus of 0.5 - 4KB JSON records
+
+String Record(int i)
+{
+	static const char *city[] = { "Prague", "Berlin", "Paris", "Vienna", "London", "Madrid" };
+	static const char *status[] = { "pending", "shipped", "delivered", "returned" };
+	String r;
+	r << "{\"id\":" << i << ",\"name\":\"customer" << Random(100000)
+	  << "\",\"email\":\"user" << Random(100000) << "@example.com\",\"city\":\""
+	  << city[Random(__countof(city))] << "\",\"active\":" << (Random(2) ? "true" : "false")
+	  << ",\"created\":\"" << AsString(GetSysTime() - (int64)Random(10000000)) << "\",\"orders\":[";
+	int n = 5 + Random(40);
+	for(int j = 0; j < n; j++)
+		r << (j ? "," : "") << "{\"item\":" << Random(1000) << ",\"quantity\":" << Random(10)
+		  << ",\"price\":" << Random(10000) / 100.0 << ",\"status\":\""
+		  << status[Random(__countof(status))] << "\"}";
+	r << "]}";
+	return r;
+}
+
+template <class C, class D>
+void Benchmark(const char *name, const Vector<String>& data, C compress, D decompress)
+{
+	int64 raw = 0, packed = 0;
+	for(const String& s : data)
+		raw += s.GetCount();
+	Vector<String> c;
+	c.SetCount(data.GetCount());
+	TimeStop tm;
+	for(int i = 0; i < data.GetCount(); i++)
+		c[i] = compress(data[i]);
+	double ct = tm.Seconds();
+	for(const String& s : c)
+		packed += s.GetCount();
+	tm.Reset();
+	for(int i = 0; i < c.GetCount(); i++)
+		if(decompress(c[i]).GetCount() != data[i].GetCount())
+			Panic("Failed");
+	double dt = tm.Seconds();
+	RLOG(Format("%-30s ratio %5.2f, compress %7.1f MB/s, decompress %7.1f MB/s",
+	            name, (double)raw / packed, raw / ct / 1024 / 1024, raw / dt / 1024 / 1024));
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+	Vector<String> sample, data;
+	for(int i = 0; i < 5000; i++)
+		sample.Add(Record(i));
+	int64 raw = 0;
+	for(int i = 0; i < 20000; i++) {
+		data.Add(Record(i));
+		raw += data.Top().GetCount();
+	}
+	RLOG(data.GetCount() << " records, average " << raw / data.GetCount() << " bytes");
+	
+	TimeStop tm;
+	String d = ZstdTrainDictionary(sample);
+	RLOG("Dictionary of " << d.GetCount() << " bytes trained in " << tm);
+	
+	ZstdDictionary zd(d, 3);
+	LZ4Dictionary ld(d);
+	LZ4Dictionary none;
+	ZstdContext ctx;
+	
+	Benchmark("ZstdCompress", data,
+	          [](const String& s) { return ZstdCompress(s); },
+	          [](const String& s) { return ZstdDecompress(s); });
+	Benchmark("ZstdContext, level 3", data,
+	          [&](const String& s) { return ctx.Compress(s, 3); },
+	          [&](const String& s) { return ctx.Decompress(s); });
+	Benchmark("ZstdContext, dictionary", data,
+	          [&](const String& s) { return ctx.Compress(s, zd); },
+	          [&](const String& s) { return ctx.Decompress(s, zd); });
+	Benchmark("LZ4Compress", data,
+	          [](const String& s) { return LZ4Compress(s); },
+	          [](const String& s) { return LZ4Decompress(s); });
+	Benchmark("LZ4CompressRecord", data,
+	          [&](const String& s) { return LZ4CompressRecord(s, none); },
+	          [&](const String& s) { return LZ4DecompressRecord(s, none); });
+	Benchmark("LZ4CompressRecord, dictionary", data,
+	          [&](const String& s) { return LZ4CompressRecord(s, ld); },
+	          [&](const String& s) { return LZ4DecompressRecord(s, ld); });
+	
+	tm.Reset();
+	Vector<String> cz = CoZstdCompress(data, zd);
+	double ct = tm.Seconds();
+	tm.Reset();
+	Vector<String> dz = CoZstdDecompress(cz, zd);
+	double dt = tm.Seconds();
+	RLOG(Format("CoZstdCompress, dictionary:  compress %7.1f MB/s, decompress %7.1f MB/s",
+	            raw / ct / 1024 / 1024, raw / dt / 1024 / 1024));
+	ASSERT(dz == data);
+}
@@ -0,0 +1,53 @@
+#include <Core/Core.h>
+
+using namespace Upp;
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+	
+	String data;
+	for(int i = 0; i < 64 * 1024 * 1024 / 4; i++)
+		data.Cat(Random());
+	
+	Vector<String> small;
+	for(int i = 0; i < 100000; i++)
+		small.Add(data.Mid(i * 16, 500));
+	int64 small_len = 500 * small.GetCount();
+	
+	RLOG("Cores: " << CPU_Cores() << ", available acceleration: " << FormatIntHex(GetHashAcceleration()));
+
+	auto Measure = [&](const char *name, int64 len, Function<void ()> fn) {
+		fn(); // warm up
+		TimeStop tm;
+		int n = 0;
+		while(tm.Seconds() < 1) {
+			fn();
+			n++;
+		}
+		RLOG(Format("%-32s %8.0f MB/s", name, n * len / 1024.0 / 1024 / tm.Seconds()));
+	};
+	
+	for(dword mask : { 0u, 0xffffffff }) {
+		SetHashAcceleration(mask);
+		RLOG("---- Acceleration " << FormatIntHex(GetHashAcceleration()));
+		Measure("CRC32", data.GetCount(), [&] { CRC32(data); });
+		Measure("CRC32C", data.GetCount(), [&] { CRC32C(data); });
+		Measure("SHA256", data.GetCount(), [&] { SHA256String(data); });
+		Measure("SHA256 500 bytes blocks", small_len, [&] { for(const String& s : small) SHA256String(s); });
+		Measure("SHA256Multi 500 bytes blocks", small_len, [&] { SHA256Multi(small); });
+		Measure("CoCRC32", data.GetCount(), [&] { CoCRC32(data, data.GetCount()); });
+		Measure("CoCRC32C", data.GetCount(), [&] { CoCRC32C(data, data.GetCount()); });
+	}
+	SetHashAcceleration(HASH_AVX2);
+	RLOG("---- Acceleration " << FormatIntHex(GetHashAcceleration()));
+	Measure("SHA256Multi 500 bytes blocks", small_len, [&] { SHA256Multi(small); });
+	SetHashAcceleration();
+	
+	RLOG("---- Reference");
+	Measure("zlib crc32", data.GetCount(), [&] { crc32(0, (const byte *)~data, data.GetCount()); });
+	Measure("xxHash", data.GetCount(), [&] { xxHash(data); });
+	Measure("xxHash64", data.GetCount(), [&] { xxHash64(data); });
+	Measure("MD5", data.GetCount(), [&] { MD5String(data); });
+	Measure("SHA1", data.GetCount(), [&] { SHA1String(data); });
+}
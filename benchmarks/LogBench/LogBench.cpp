@@ -0,0 +1,46 @@
+#include <Core/Core.h>
+
+using namespace Upp;
+
+#ifdef _DEBUG
+const int N = 20000;
+#else
+const int N = 200000;
+#endif
+
+CONSOLE_APP_MAIN
+{
+	String path = GetHomeDirFile("LogBench.log");
+
+	auto Run = [&](const char *name, dword options, int threads) {
+		StdLogSetup(options|LOG_FILE|LOG_TIMESTAMP|LOG_ROTATE(2), path, 100 * 1024 * 1024);
+		int64 dropped = GetStdLogDropped();
+		TimeStop tm;
+		Array<Thread> t;
+		for(int i = 0; i < threads; i++)
+			t.Add().Run([=] {
+				for(int j = 0; j < N; j++)
+					RLOG("Thread " << i << ", line " << j << ", some more text to make it longer");
+			});
+		for(Thread& h : t)
+			h.Wait();
+		double t0 = tm.Seconds();
+		StdLogFlush();
+		double t1 = tm.Seconds();
+		Cout() << Format("%-14s %2d threads: %10.0f lines/s, %10.0f lines/s including flush",
+		                 name, threads, threads * N / t0, threads * N / t1);
+		if(options & LOG_ASYNC_DROP)
+			Cout() << ", dropped " << GetStdLogDropped() - dropped;
+		Cout() << '\n';
+	};
+
+	for(int threads : { 1, 4, 16 }) {
+		Run("synchronous", 0, threads);
+		Run("async", LOG_ASYNC, threads);
+		Run("async drop", LOG_ASYNC|LOG_ASYNC_DROP, threads);
+	}
+
+	StdLogSetup(LOG_FILE);
+	for(int i = 0; i < 3; i++)
+		DeleteFile(i ? path + "." + AsString(i) : path);
+}
@@ -0,0 +1,51 @@
+#include <plugin/sqlite3/Sqlite3.h>
+
+using namespace Upp;
+
+#ifdef _DEBUG
+const int N = 20000;
+#else
+const int N = 200000;
+#endif
+
+void Bench(int ncol, bool bulk)
+{
+	Sqlite3Session db;
+	db.Open(":memory:");
+	Sql sql(db);
+	String create = "create table T (ID integer primary key";
+	for(int c = 0; c < ncol; c++)
+		create << ", C" << c << (c & 1 ? " text" : " integer");
+	create << ")";
+	sql.Execute(create);
+
+	Vector<SqlId> col;
+	for(int c = 0; c < ncol; c++)
+		col.Add(SqlId("C" + AsString(c)));
+
+	TimeStop tm;
+	{
+		SqlMassInsert mi(sql, SqlId("T"));
+		mi.Bulk(bulk);
+		for(int i = 0; i < N; i++) {
+			mi("ID", i);
+			for(int c = 0; c < ncol; c++)
+				mi(col[c], c & 1 ? Value("Text " + AsString(i)) : Value(i + c));
+			mi.EndRow();
+		}
+	}
+	double t = tm.Seconds();
+	sql.Execute("select count(*) from T");
+	sql.Fetch();
+	RLOG(Format("%2d columns, %s: %8.0f rows/s", ncol, bulk ? "bulk" : "text", N / t) << " (" << sql[0] << ")");
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+	for(int ncol : { 4, 16, 80 }) {
+		Bench(ncol, false);
+		Bench(ncol, true);
+	}
+}
@@ -0,0 +1,62 @@
+#include <PostgreSQL/PostgreSQL.h>
+
+using namespace Upp;
+
+#ifdef _DEBUG
+const int N = 2000;
+#else
+const int N = 20000;
+#endif
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+	const Vector<String>& cmd = CommandLine();
+	PostgreSQLSession db;
+	if(!db.Open(cmd.GetCount() ? cmd[0] : "host=localhost dbname=test user=test password=test")) {
+		RLOG("Cannot open database: " << db.GetLastError());
+		return;
+	}
+	Sql sql(db);
+	sql.Execute("create temporary table PIPE_BENCH (ID integer primary key, NAME text, D date)");
+
+	// every statement is one round trip without pipelining
+	TimeStop tm;
+	for(int i = 0; i < N; i++)
+		sql.Execute("insert into PIPE_BENCH values (?, ?, ?)", i, "Name " + AsString(i), Date(2024, 1, 1) + i);
+	double ins = tm.Seconds();
+	tm.Reset();
+	int64 sum = 0;
+	for(int i = 0; i < N; i++)
+		if(sql.Execute("select ID from PIPE_BENCH where ID = ?", i) && sql.Fetch())
+			sum += (int)sql[0];
+	double sel = tm.Seconds();
+	RLOG(Format("no pipeline:      insert %8.0f rows/s, select %8.0f rows/s", N / ins, N / sel));
+	ASSERT(sum == (int64)N * (N - 1) / 2);
+
+	for(int batch : { 10, 100, 1000 }) {
+		sql.Execute("delete from PIPE_BENCH");
+		PostgreSQLPipeline pipe(db);
+		tm.Reset();
+		for(int i = 0; i < N; i++) {
+			pipe.Send("insert into PIPE_BENCH values (?, ?, ?)", { i, "Name " + AsString(i), Date(2024, 1, 1) + i });
+			if(i % batch == batch - 1)
+				pipe.Sync();
+		}
+		pipe.Finish();
+		ins = tm.Seconds();
+		tm.Reset();
+		int64 sum = 0;
+		for(int i = 0; i < N; i++) {
+			pipe.Send("select ID from PIPE_BENCH where ID = ?", { i },
+			          [&](const PostgreSQLResult& r) { if(r.GetCount()) sum += (int)r[0][0]; });
+			if(i % batch == batch - 1)
+				pipe.Sync();
+		}
+		pipe.Finish();
+		sel = tm.Seconds();
+		RLOG(Format("pipeline by %4d: insert %8.0f rows/s, select %8.0f rows/s", batch, N / ins, N / sel));
+		ASSERT(sum == (int64)N * (N - 1) / 2);
+	}
+}
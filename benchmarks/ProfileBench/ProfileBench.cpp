@@ -0,0 +1,46 @@
+#include <Core/Core.h>
+
+using namespace Upp;
+
+#ifdef _DEBUG
+const int N = 200000;
+#else
+const int N = 1000000;
+#endif
+
+int64 sum;
+
+never_inline
+void Work(int i)
+{
+	sum += i;
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+	auto Measure = [](const char *name, int threads, Event<int> fn) {
+		int64 t0 = tmGetTimeNs();
+		CoWork co;
+		for(int t = 0; t < threads; t++)
+			co & [&] {
+				for(int i = 0; i < N; i++)
+					fn(i);
+			};
+		co.Finish();
+		RLOG(Format("%-28s %2d threads: %6.1f ns per zone", name, threads,
+		            double(tmGetTimeNs() - t0) / N));
+	};
+
+	for(int threads : { 1, 4 }) {
+		Measure("empty", threads, [](int i) { Work(i); });
+		Measure("tmGetTimeNs", threads, [](int i) { tmGetTimeNs(); Work(i); });
+		Measure("RTIMING", threads, [](int i) { RTIMING("RTIMING"); Work(i); });
+		Measure("RZONE, not tracing", threads, [](int i) { RZONE("RZONE"); Work(i); });
+		StartTrace(N);
+		Measure("RZONE, tracing", threads, [](int i) { RZONE("RZONE"); Work(i); });
+		StopTrace();
+		RLOG(GetTraceEventCount() << " events, trace JSON " << GetTraceJson().GetLength() / 1024 / 1024 << " MB");
+	}
+}
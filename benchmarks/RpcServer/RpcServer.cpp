@@ -0,0 +1,94 @@
+#include <Core/Core.h>
+#include <Core/Rpc/Rpc.h>
+
+using namespace Upp;
+
+const int PORT = 4021;
+const int COPORT = 4022;
+
+RPC_METHOD(Add)
+{
+	int a, b;
+	rpc >> a >> b;
+	rpc << a + b;
+}
+
+RPC_METHOD(Work) // simulates a method doing some work (database access etc.)
+{
+	int ms;
+	rpc >> ms;
+	Sleep(ms);
+	rpc << ms;
+}
+
+String Call(const char *method, int a, int b, int id)
+{
+	return Format("{\"jsonrpc\":\"2.0\",\"method\":\"%s\",\"params\":[%d,%d],\"id\":%d}", method, a, b, id);
+}
+
+String Post(int port, const String& body)
+{
+	HttpRequest r(Format("http://127.0.0.1:%d/", port));
+	r.Post(body).ContentType("application/json");
+	String s = r.Execute();
+	if(!r.IsSuccess())
+		RLOG("Error: " << r.GetErrorDesc() << " " << r.GetStatusCode());
+	return s;
+}
+
+double Bench(int port, int clients, int requests, Function<String (int)> body)
+{
+	TimeStop tm;
+	Array<Thread> t;
+	for(int c = 0; c < clients; c++)
+		t.Add().Run([&] {
+			for(int i = 0; i < requests; i++)
+				Post(port, body(i));
+		});
+	for(Thread& h : t)
+		h.Wait();
+	return clients * requests / tm.Seconds();
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+	
+	Thread::Start([] { RpcServerLoop(PORT); });
+	Thread::Start([] { CoRpcServerLoop(COPORT); });
+	Sleep(200);
+	
+	ASSERT(ParseJSON(Post(PORT, Call("Add", 1, 2, 1)))["result"] == 3);
+	ASSERT(ParseJSON(Post(COPORT, Call("Add", 1, 2, 1)))["result"] == 3);
+	
+	for(int clients : { 1, 4, 16 }) {
+		auto add = [](int i) { return Call("Add", i, i, i); };
+		RLOG("Add, " << clients << " clients, RpcServerLoop:   " << (int)Bench(PORT, clients, 500, add) << " req/s");
+		RLOG("Add, " << clients << " clients, CoRpcServerLoop: " << (int)Bench(COPORT, clients, 500, add) << " req/s");
+	}
+
+	for(int clients : { 1, 8 }) {
+		auto work = [](int i) { return Call("Work", 5, 0, i); };
+		RLOG("Work 5ms, " << clients << " clients, RpcServerLoop:   " << (int)Bench(PORT, clients, 40, work) << " req/s");
+		RLOG("Work 5ms, " << clients << " clients, CoRpcServerLoop: " << (int)Bench(COPORT, clients, 40, work) << " req/s");
+	}
+
+	String batch = "[";
+	for(int i = 0; i < 16; i++)
+		batch << (i ? "," : "") << Call("Work", 5, 0, i);
+	batch << "]";
+	Value r = ParseJSON(Post(COPORT, batch));
+	ASSERT(r.GetCount() == 16);
+	for(int i = 0; i < 16; i++)
+		ASSERT(r[i]["id"] == i && r[i]["result"] == 5);
+	auto b = [&](int) { return batch; };
+	RLOG("Batch of 16 x Work 5ms, RpcServerLoop:   " << Format("%.1f", Bench(PORT, 1, 10, b)) << " batches/s");
+	RLOG("Batch of 16 x Work 5ms, CoRpcServerLoop: " << Format("%.1f", Bench(COPORT, 1, 10, b)) << " batches/s");
+	
+	RLOG("---- Method statistics");
+	VectorMap<String, RpcMethodStats> stats = GetRpcMethodStats();
+	for(int i = 0; i < stats.GetCount(); i++)
+		RLOG(stats.GetKey(i) << ": " << stats[i]);
+	
+	Exit(0);
+}
@@ -0,0 +1,91 @@
+#include <Core/Core.h>
+#include <Core/SSH/SSH.h>
+
+using namespace Upp;
+
+// Usage: SFtpThroughput user:password@host[:port] [remote_dir] [size_mb]
+// Best run against a local sshd; use e.g. 'tc qdisc add dev lo root netem delay 20ms'
+// to emulate a high-latency link.
+
+String MBs(int64 bytes, const TimeStop& tm)
+{
+	return Format("%.1f MB/s", bytes / 1024.0 / 1024.0 / max(tm.Seconds(), 0.001));
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+	
+	const Vector<String>& cmd = CommandLine();
+	if(cmd.GetCount() < 1) {
+		RLOG("Usage: SFtpThroughput user:password@host[:port] [remote_dir] [size_mb]");
+		SetExitCode(1);
+		return;
+	}
+	
+	String dir = cmd.GetCount() > 1 ? cmd[1] : "/tmp";
+	int64 size = (cmd.GetCount() > 2 ? max(StrInt(cmd[2]), 1) : 64) * 1024 * 1024;
+	
+	SshSession session;
+	if(!session.Timeout(60000).Connect(cmd[0])) {
+		RLOG(session.GetErrorDesc());
+		SetExitCode(1);
+		return;
+	}
+	
+	String local = GetTempFileName();
+	{
+		FileOut out(local);
+		String block;
+		for(int i = 0; i < 65536; i++)
+			block.Cat(Random());
+		for(int64 n = 0; n < size; n += block.GetCount())
+			out.Put(block);
+	}
+	String remote = AppendFileName(dir, "sftp_throughput.bin");
+	String back = local + ".back";
+
+	for(int pipeline : { 1, 2, 8, 32 }) {
+		SFtp sftp(session);
+		sftp.Pipeline(pipeline);
+		FileIn in(local);
+		TimeStop tm;
+		sftp.SaveFile(remote, in);
+		RLOG("Pipeline " << pipeline << ", upload:   " << MBs(size, tm));
+		FileOut out(back);
+		tm.Reset();
+		sftp.LoadFile(out, remote);
+		RLOG("Pipeline " << pipeline << ", download: " << MBs(size, tm));
+		if(sftp.IsError())
+			RLOG(sftp.GetErrorDesc());
+	}
+	
+	for(int channels : { 1, 2, 4 }) {
+		const int FILES = 4;
+		SFtpBatch batch(session);
+		batch.Channels(channels);
+		for(int i = 0; i < FILES; i++)
+			batch.Put(local, remote + AsString(i));
+		TimeStop tm;
+		batch.Execute();
+		RLOG("Channels " << channels << ", upload:   " << MBs(batch.GetDone(), tm));
+		batch.Clear();
+		for(int i = 0; i < FILES; i++)
+			batch.Get(remote + AsString(i), back + AsString(i));
+		tm.Reset();
+		batch.Execute();
+		RLOG("Channels " << channels << ", download: " << MBs(batch.GetDone(), tm));
+		for(int i = 0; i < batch.GetCount(); i++)
+			if(batch.IsError(i))
+				RLOG(batch.GetRemote(i) << ": " << batch.GetErrorDesc(i));
+	}
+
+	SFtp sftp(session);
+	sftp.Delete(remote);
+	for(int i = 0; i < 4; i++) {
+		sftp.Delete(remote + AsString(i));
+		DeleteFile(back + AsString(i));
+	}
+	DeleteFile(local);
+	DeleteFile(back);
+}
@@ -0,0 +1,64 @@
+#include <plugin/zstd/zstd.h>
+#include <plugin/lz4/lz4.h>
+
+using namespace Upp;
+
+template <class C, class D>
+void Benchmark(const char *name, int64 total)
+{
+	String path = GetHomeDirFile("SeekableCompress.bin");
+	{
+		FileOut out(path);
+		C c;
+		c.Co();
+		c.Seekable();
+		c.Open(out);
+		int64 n = 0;
+		String line;
+		while(n < total) {
+			line.Clear();
+			line << "2026-10-18 12:00:00 INFO request " << n << " served in " << Random(1000) << " us\n";
+			c.Put(line);
+			n += line.GetCount();
+		}
+	}
+	RLOG("---- " << name << ": " << (total >> 20) << " MB compressed to " << (GetFileLength(path) >> 20) << " MB");
+	
+	const int N = 200;
+	Vector<int64> at;
+	for(int i = 0; i < N; i++)
+		at.Add((int64)(Randomf() * (total - 4096)));
+
+	{
+		FileIn in(path);
+		D d(in);
+		TimeStop tm;
+		for(int64 pos : at) {
+			d.Seek(pos);
+			d.Get(4096);
+		}
+		RLOG("Seek + 4KB read:             " << Format("%.3f ms", tm.Elapsed() / 1000.0 / N));
+	}
+	{
+		TimeStop tm;
+		int n = 10;
+		for(int i = 0; i < n; i++) {
+			FileIn in(path);
+			D d(in);
+			d.Seek(0);
+			while(d.GetPos() < at[i])
+				d.Get((int)min(at[i] - d.GetPos(), (int64)1024 * 1024));
+			d.Get(4096);
+		}
+		RLOG("Decompress from start + 4KB: " << Format("%.3f ms", tm.Elapsed() / 1000.0 / n));
+	}
+	DeleteFile(path);
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+	
+	Benchmark<ZstdCompressStream, ZstdDecompressStream>("Zstd", 256 * 1024 * 1024);
+	Benchmark<LZ4CompressStream, LZ4DecompressStream>("LZ4", 256 * 1024 * 1024);
+}
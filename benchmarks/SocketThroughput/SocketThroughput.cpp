@@ -0,0 +1,108 @@
+#include <Core/Core.h>
+
+using namespace Upp;
+
+const int PORT = 4011;
+const int LINES = 2000000;
+const int BLOCKS = 2000;
+
+String Line(int i)
+{
+	return "Line " + AsString(i) + " of the loopback throughput benchmark";
+}
+
+void LineServer(Socket& server)
+{
+	Socket s;
+	if(!s.Accept(server))
+		return;
+	String data;
+	for(int i = 0; i < LINES; i++) {
+		data << Line(i) << "\r\n";
+		if(data.GetCount() > 65536) {
+			s.PutAll(data);
+			data.Clear();
+		}
+	}
+	s.PutAll(data);
+}
+
+void BlockServer(Socket& server, String hdr, String body, bool gather)
+{
+	Socket s;
+	if(!s.Accept(server))
+		return;
+	for(int i = 0; i < BLOCKS; i++)
+		if(gather)
+			s.PutAll(hdr, body);
+		else {
+			s.PutAll(hdr);
+			s.PutAll(body);
+		}
+}
+
+void BenchLines(int readbuffer)
+{
+	Socket server;
+	if(!server.Listen(PORT, 5)) {
+		RLOG("Listen failed: " << server.GetErrorDesc());
+		return;
+	}
+	Thread t;
+	t.Run([&] { LineServer(server); });
+	Socket c;
+	c.ReadBufferSize(readbuffer);
+	c.Connect("127.0.0.1", PORT);
+	TimeStop tm;
+	int64 len = 0;
+	for(int i = 0; i < LINES; i++) {
+		String ln = c.GetLine();
+		ASSERT(ln == Line(i));
+		len += ln.GetCount() + 2;
+	}
+	double secs = tm.Seconds();
+	RLOG("GetLine, read buffer " << readbuffer << ": " << LINES / secs / 1000000 << " Mlines/s, "
+	     << len / secs / 1024 / 1024 << " MB/s");
+	t.Wait();
+}
+
+void BenchBlocks(bool gather, int readbuffer)
+{
+	Socket server;
+	if(!server.Listen(PORT, 5)) {
+		RLOG("Listen failed: " << server.GetErrorDesc());
+		return;
+	}
+	String hdr = "HTTP/1.1 200 OK\r\nContent-Length: 1000000\r\n\r\n";
+	String body(' ', 1000000);
+	Thread t;
+	t.Run([&] { BlockServer(server, hdr, body, gather); });
+	Socket c;
+	c.ReadBufferSize(readbuffer);
+	c.RecvBufferSize(1024 * 1024);
+	c.Connect("127.0.0.1", PORT);
+	TimeStop tm;
+	int64 len = 0;
+	for(int i = 0; i < BLOCKS; i++) {
+		String h = c.GetAll(hdr.GetCount());
+		String b = c.GetAll(body.GetCount());
+		ASSERT(h == hdr && b.GetCount() == body.GetCount());
+		len += h.GetCount() + b.GetCount();
+	}
+	RLOG((gather ? "PutAll(hdr, body)" : "PutAll(hdr); PutAll(body)") << ", read buffer " << readbuffer
+	     << ": " << len / tm.Seconds() / 1024 / 1024 << " MB/s");
+	t.Wait();
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+	
+	for(int sz : { 512, 4096, 65536, 256 * 1024 })
+		BenchLines(sz);
+
+	for(int sz : { 512, 65536 }) {
+		BenchBlocks(false, sz);
+		BenchBlocks(true, sz);
+	}
+}
@@ -0,0 +1,56 @@
+#include <plugin/sqlite3/Sqlite3.h>
+
+using namespace Upp;
+
+#ifdef _DEBUG
+const int N = 100000;
+#else
+const int N = 1000000;
+#endif
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+	Sqlite3Session db;
+	db.Open(":memory:");
+	Sql sql(db);
+	sql.Execute("create table T (ID integer primary key, A integer, B real, C text)");
+	{
+		SqlMassInsert mi(sql, SqlId("T"));
+		for(int i = 0; i < N; i++)
+			mi("ID", i)("A", i & 1023)("B", i / 7.0)("C", "Text " + AsString(i)).EndRow();
+	}
+
+	for(int pass = 0; pass < 3; pass++) {
+		int64 sa = 0;
+		double sb = 0;
+		int len = 0;
+		TimeStop tm;
+		sql.Execute("select A, B, C from T");
+		while(sql.Fetch()) {
+			sa += (int64)sql[0];
+			sb += (double)sql[1];
+			len += String(sql[2]).GetLength();
+		}
+		double t1 = tm.Seconds();
+
+		int64 sa2 = 0;
+		double sb2 = 0;
+		int len2 = 0;
+		tm.Reset();
+		SqlBatch batch;
+		sql.Execute("select A, B, C from T");
+		while(sql.FetchBatch(batch)) {
+			for(int64 x : batch[0].i64)
+				sa2 += x;
+			for(double x : batch[1].dbl)
+				sb2 += x;
+			for(const String& x : batch[2].str)
+				len2 += x.GetLength();
+		}
+		double t2 = tm.Seconds();
+		ASSERT(sa == sa2 && sb == sb2 && len == len2);
+		RLOG(Format("Fetch: %8.0f rows/s, FetchBatch: %8.0f rows/s", N / t1, N / t2));
+	}
+}
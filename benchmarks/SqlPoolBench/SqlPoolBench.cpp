@@ -0,0 +1,80 @@
+#include <plugin/sqlite3/Sqlite3.h>
+
+using namespace Upp;
+
+// Threads run short read transactions (and one write per 16 reads) against local SQLite
+// database through the pool; shows how throughput and waiting depends on pool size.
+
+const int ROWS = 10000;
+const int OPS = 20000;
+
+String db_path;
+
+SqlSession *CreateSession()
+{
+	One<Sqlite3Session> s;
+	s.Create();
+	if(!s->Open(db_path))
+		return NULL;
+	s->SetBusyTimeout(-1);
+	return s.Detach();
+}
+
+void Bench(int threads, int size)
+{
+	SqlSessionPool pool;
+	pool.Factory(CreateSession).MinSize(size).MaxSize(size).Timeout(-1);
+	pool.Open();
+
+	std::atomic<int> ii(0);
+	TimeStop tm;
+	CoWork co;
+	for(int t = 0; t < threads; t++)
+		co & [&] {
+			for(;;) {
+				int i = ii++;
+				if(i >= OPS)
+					break;
+				SqlPooledSession s(pool);
+				Sql sql(s);
+				if(i % 16 == 0)
+					sql.Execute("update T set HITS = HITS + 1 where ID = ?", i % ROWS);
+				else
+				if(sql.Execute("select NAME from T where ID = ?", i * 7 % ROWS))
+					sql.Fetch();
+			}
+		};
+	co.Finish();
+	double t = tm.Seconds();
+	SqlSessionPool::Stats st = pool.GetStats();
+	RLOG("threads " << threads << ", pool " << size << ": " << Format("%8.0f", OPS / t) << " ops/s"
+	     << ", waited " << Format("%5.1f%%", 100.0 * st.waited / max(st.acquired, (int64)1))
+	     << ", avg wait " << Format("%6.1f", st.waited ? st.wait_time / (double)st.waited : 0.0) << " us"
+	     << ", max wait " << st.max_wait << " us");
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+	db_path = GetHomeDirFile("sqlpoolbench.db");
+	DeleteFile(db_path);
+	{
+		Sqlite3Session db;
+		db.Open(db_path);
+		Sql sql(db);
+		sql.Execute("create table T (ID integer primary key, NAME text, HITS integer)");
+		db.Begin();
+		for(int i = 0; i < ROWS; i++)
+			sql.Execute("insert into T (ID, NAME, HITS) values (?, ?, 0)", i, "Name " + AsString(i));
+		db.Commit();
+	}
+
+	RLOG("CPU cores: " << CPU_Cores());
+	for(int threads : { 1, 4, 8 })
+		for(int size : { 1, 2, 4, 8 })
+			if(size <= threads)
+				Bench(threads, size);
+
+	DeleteFile(db_path);
+}
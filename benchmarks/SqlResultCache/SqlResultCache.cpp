@@ -0,0 +1,55 @@
+#include <plugin/sqlite3/Sqlite3.h>
+
+using namespace Upp;
+
+SqlId COUNTRY("COUNTRY"), ID("ID"), CODE("CODE"), NAME("NAME");
+
+#ifdef _DEBUG
+const int N = 20000;
+#else
+const int N = 200000;
+#endif
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+	String fn = GetHomeDirFile("SqlResultCache.db");
+	DeleteFile(fn);
+	Sqlite3Session db;
+	db.Open(fn);
+	Sql sql(db);
+	sql.Execute("create table COUNTRY (ID integer primary key, CODE text, NAME text)");
+	{
+		SqlMassInsert mi(sql, COUNTRY);
+		for(int i = 0; i < 250; i++)
+			mi(ID, i)(CODE, FormatIntAlpha(i + 1))(NAME, "Country name " + AsString(i)).EndRow();
+	}
+
+	auto Run = [&](bool cached) {
+		int64 sum = 0;
+		TimeStop tm;
+		for(int i = 0; i < N; i++) {
+			sql * Select(CODE, NAME).From(COUNTRY).Where(ID == i % 50).Cached(cached);
+			while(sql.Fetch())
+				sum += String(sql[NAME]).GetLength();
+		}
+		double t = tm.Seconds();
+		RLOG(Format("%-12s %8.0f lookups/s", cached ? "cached:" : "not cached:", N / t));
+		return sum;
+	};
+
+	for(int pass = 0; pass < 3; pass++) {
+		db.NoResultCache();
+		int64 a = Run(false);
+		db.ResultCache();
+		int64 b = Run(true);
+		ASSERT(a == b);
+		RLOG("hits: " << db.GetResultCacheHits() << ", misses: " << db.GetResultCacheMisses()
+		     << ", " << db.GetResultCacheCount() << " entries, " << db.GetResultCacheSize() << " bytes");
+		db.ResetResultCacheStats();
+	}
+
+	db.Close();
+	DeleteFile(fn);
+}
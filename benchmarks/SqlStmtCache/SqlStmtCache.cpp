@@ -0,0 +1,50 @@
+#include <plugin/sqlite3/Sqlite3.h>
+
+using namespace Upp;
+
+#ifdef _DEBUG
+const int N = 20000;
+#else
+const int N = 200000;
+#endif
+
+void Bench(int cache)
+{
+	Sqlite3Session db;
+	db.Open(":memory:");
+	db.StatementCache(cache);
+
+	Sql sql(db);
+	sql.Execute("create table T (ID integer primary key, NAME text, VAL real, D date)");
+
+	TimeStop tm;
+	db.Begin();
+	for(int i = 0; i < N; i++)
+		sql.Execute("insert into T (ID, NAME, VAL, D) values (?, ?, ?, ?)",
+		            i, "Name " + AsString(i), i / 3.0, Date(2020, 1, 1) + i % 1000);
+	db.Commit();
+	double ins = tm.Seconds();
+
+	tm.Reset();
+	int64 sum = 0;
+	for(int i = 0; i < N; i++)
+		if(sql.Execute("select NAME, VAL, D from T where ID = ?", i) && sql.Fetch())
+			sum += String(sql[0]).GetCount();
+	double sel = tm.Seconds();
+
+	int64 total = db.GetStatementCacheHits() + db.GetStatementCacheMisses();
+	RLOG("cache " << Format("%3d", cache) << ": insert " << Format("%7.0f", N / ins) << " rows/s"
+	     << ", select " << Format("%7.0f", N / sel) << " rows/s"
+	     << ", hit rate " << Format("%5.1f%%", total ? 100.0 * db.GetStatementCacheHits() / total : 0.0)
+	     << " (" << sum << ")");
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+	for(int pass = 0; pass < 2; pass++) {
+		Bench(0);
+		Bench(64);
+	}
+}
@@ -0,0 +1,85 @@
+#include <plugin/sqlite3/Sqlite3.h>
+
+using namespace Upp;
+
+SqlId ITEM("ITEM"), ID("ID"), NAME("NAME");
+
+#ifdef _DEBUG
+const int N = 2000;
+#else
+const int N = 20000;
+#endif
+
+const int READERS = 4;
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+	String fn = GetHomeDirFile("Sqlite3Concurrency.db");
+	auto Delete = [&] {
+		DeleteFile(fn);
+		DeleteFile(fn + "-wal");
+		DeleteFile(fn + "-shm");
+	};
+
+	auto Run = [&](const char *name, bool tuned, bool batch, bool readers) {
+		Delete();
+		Sqlite3Session db;
+		db.Open(fn);
+		if(tuned)
+			db.Tuned();
+		Sql sql(db);
+		sql.Execute("create table ITEM (ID integer primary key, NAME text)");
+		if(batch)
+			db.AutoBatch();
+
+		Mutex lock; // protects db when readers share it
+		std::atomic<bool> done(false);
+		std::atomic<int64> reads(0);
+		Array<Thread> t;
+		for(int i = 0; i < READERS; i++)
+			t.Add().Run([&] {
+				int64 n = 0;
+				while(!done) {
+					if(readers) {
+						Sql rsql(*db.Reader());
+						rsql * Select(NAME).From(ITEM).Where(ID == n % N);
+						rsql.Fetch();
+					}
+					else {
+						Mutex::Lock __(lock);
+						Sql rsql(db);
+						rsql * Select(NAME).From(ITEM).Where(ID == n % N);
+						rsql.Fetch();
+					}
+					n++;
+				}
+				reads += n;
+				if(readers)
+					db.CloseReader();
+			});
+
+		TimeStop tm;
+		for(int i = 0; i < N; i++) {
+			Mutex::Lock __(lock);
+			sql * Insert(ITEM)(ID, i)(NAME, AsString(i));
+		}
+		db.FlushBatch();
+		double t0 = tm.Seconds();
+		done = true;
+		for(Thread& h : t)
+			h.Wait();
+		double t1 = tm.Seconds();
+		RLOG(Format("%-36s writes: %8.0f/s, reads: %8.0f/s", name, N / t0, reads / t1));
+		sql.Cancel();
+		db.Close();
+	};
+
+	Run("default, shared session:", false, false, false);
+	Run("Tuned, shared session:", true, false, false);
+	Run("Tuned, AutoBatch, shared session:", true, true, false);
+	Run("Tuned, AutoBatch, Reader:", true, true, true);
+
+	Delete();
+}
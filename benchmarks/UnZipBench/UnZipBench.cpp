@@ -0,0 +1,75 @@
+#include <Core/Core.h>
+#include <plugin/zip/zip.h>
+
+using namespace Upp;
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+	
+	String path = GetHomeDirFile("UnZipBench.zip");
+	int64 total = 0;
+	{
+		FileZip zip(path);
+		for(int i = 0; i < 20000; i++) {
+			String data;
+			int n = i % 100 == 0 ? 100000 : 300;
+			for(int j = 0; j < n; j++)
+				data << i * j << ' ';
+			total += data.GetCount();
+			zip.WriteFile(data, Format("folder%d/file%d.txt", i / 1000, i), Null, GetSysTime(), true);
+		}
+	}
+	RLOG("Cores: " << CPU_Cores() << ", archive " << GetFileLength(path) << " bytes, "
+	     << total << " bytes uncompressed");
+	
+	auto Report = [&](const char *txt, TimeStop& tm) {
+		RLOG(txt << Format("%.1f MB/s", total / 1024.0 / 1024 / tm.Seconds()));
+	};
+
+	{
+		FileUnZip unzip(path);
+		TimeStop tm;
+		int64 len = 0;
+		while(!unzip.IsEof())
+			len += unzip.ReadFile().GetCount();
+		ASSERT(len == total);
+		Report("FileUnZip sequential:   ", tm);
+	}
+	{
+		FileUnZip unzip(path);
+		TimeStop tm;
+		std::atomic<int64> len(0);
+		unzip.CoRead([&](int, const String& data) { len += data.GetCount(); });
+		ASSERT(len == total);
+		Report("FileUnZip::CoRead:      ", tm);
+	}
+	{
+		MappedUnZip unzip(path);
+		TimeStop tm;
+		std::atomic<int64> len(0);
+		unzip.CoRead([&](int, const String& data) { len += data.GetCount(); });
+		ASSERT(len == total);
+		Report("MappedUnZip::CoRead:    ", tm);
+	}
+	{
+		String dir = GetHomeDirFile("UnZipBench");
+		DeleteFolderDeep(dir);
+		MappedUnZip unzip(path);
+		TimeStop tm;
+		unzip.CoExtract(dir);
+		Report("MappedUnZip::CoExtract: ", tm);
+		DeleteFolderDeep(dir);
+	}
+	{
+		MappedUnZip unzip(path);
+		TimeStop tm;
+		int64 len = 0;
+		for(int i = 0; i < 20000; i++)
+			len += unzip.Extract(unzip.Find(Format("folder%d/file%d.txt", i / 1000, i))).GetCount();
+		ASSERT(len == total);
+		Report("Extract by path:        ", tm);
+	}
+	
+	DeleteFile(path);
+}
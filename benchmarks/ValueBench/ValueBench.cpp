@@ -92,5 +92,53 @@ CONSOLE_APP_MAIN
 				sum += vv[i].To<String>().GetLength();
 		}
 	}
+
+	{ // JSON records with the same keys share them, compare with maps with private keys
+	#ifdef _DEBUG
+		const int RECORDS = 1000;
+	#else
+		const int RECORDS = 300000;
+	#endif
+		JsonArray ja;
+		for(int i = 0; i < RECORDS; i++)
+			ja << Json("id", i)("name", "name" + AsString(i))("value", i * 0.5)("flag", (bool)(i & 1))("group", i % 10);
+		String json = ja;
+
+		int kb = MemoryUsedKb();
+		Value shared;
+		{
+			RTIMING("ParseJSON records");
+			shared = ParseJSON(json);
+		}
+		RLOG("ParseJSON records: " << MemoryUsedKb() - kb << " KB");
+
+		kb = MemoryUsedKb();
+		ValueArray va;
+		{
+			RTIMING("ValueMap records with private keys");
+			for(int i = 0; i < shared.GetCount(); i++) {
+				ValueMap m, src = shared[i];
+				for(int j = 0; j < src.GetCount(); j++)
+					m.Add(src.GetKey(j), src.GetValue(j));
+				va.Add(m);
+			}
+		}
+		Value priv = va;
+		RLOG("ValueMap records with private keys: " << MemoryUsedKb() - kb << " KB");
+
+		for(int pass = 0; pass < 10; pass++) {
+			{
+				RTIMING("Lookup shared keys");
+				for(int i = 0; i < shared.GetCount(); i++)
+					sum += (int)shared[i]["group"];
+			}
+			{
+				RTIMING("Lookup private keys");
+				for(int i = 0; i < priv.GetCount(); i++)
+					sum += (int)priv[i]["group"];
+			}
+		}
+	}
+
 	Cout() << sum << "\n";
 }
@@ -0,0 +1,64 @@
+#include <Core/Core.h>
+
+using namespace Upp;
+
+#ifdef _DEBUG
+const int N = 100000;
+#else
+const int N = 2000000;
+#endif
+
+const int KEYS = 1000;
+
+Value MakeCached(int i)
+{
+	return MakeValue(
+		[&] { return AsString(i); },
+		[&](Value& v) { v = i; return 100; }
+	);
+}
+
+Value MakeLocked(int i)
+{ // single mutex around LRUCache, how the global cache worked before sharding
+	static StaticMutex lock;
+	static LRUCache<Value> cache;
+	struct Maker : ValueMaker {
+		int i;
+		String Key() const override { return AsString(i); }
+		int Make(Value& v) const override { v = i; return 100; }
+	} m;
+	m.i = i;
+	Mutex::Lock __(lock);
+	Value v = cache.Get(m, [] { lock.Leave(); }, [] { lock.Enter(); });
+	cache.Shrink(INT_MAX, 100000);
+	return v;
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+	SetupValueCache(100000000, 100000);
+
+	auto Measure = [](const char *name, int threads, Function<Value (int)> fn) {
+		int64 t0 = tmGetTimeNs();
+		CoWork co;
+		for(int t = 0; t < threads; t++)
+			co & [&, t] {
+				for(int i = 0; i < N; i++)
+					fn((i * 7 + t) % KEYS);
+			};
+		co.Finish();
+		double s = double(tmGetTimeNs() - t0) / 1e9;
+		RLOG(Format("%-16s %2d threads: %6.2f M lookups/s", name, threads, threads * N / s / 1e6));
+	};
+
+	for(int threads : { 1, 2, 4, 8 }) {
+		Measure("global mutex", threads, MakeLocked);
+		Measure("sharded", threads, MakeCached);
+	}
+
+	ValueCacheStats st = GetValueCacheStats();
+	RLOG("hits: " << st.hits << ", misses: " << st.misses << ", waits: " << st.waits
+	     << ", " << st.count << " values, " << st.size << " bytes");
+}
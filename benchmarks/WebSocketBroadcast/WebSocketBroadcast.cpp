@@ -0,0 +1,86 @@
+#include <Core/Core.h>
+
+using namespace Upp;
+
+const int PORT = 4012;
+
+void Bench(int clients, int messages, bool deflate)
+{
+	String msg;
+	for(int i = 0; i < 20; i++)
+		msg << "{\"id\":" << i << ",\"name\":\"sensor " << i << "\",\"value\":" << i * 3.14 << "},";
+	
+	WebSocketServer server;
+	server.Deflate(deflate);
+	if(!server.Listen(PORT)) {
+		RLOG("Listen failed: " << server.GetListener().GetErrorDesc());
+		return;
+	}
+	
+	std::atomic<bool> start(false);
+	std::atomic<bool> done(false);
+	int64 sent_bytes = 0;
+	double secs = 0;
+	Thread t;
+	t.Run([&] {
+		while(server.GetCount() < clients || !start)
+			server.Do(1);
+		TimeStop tm;
+		for(int i = 0; i < messages; i++) {
+			server.Broadcast(msg);
+			server.Do(0);
+		}
+		while(!done)
+			server.Do(1);
+		secs = tm.Seconds();
+	});
+
+	Array<WebSocket> ws;
+	for(int i = 0; i < clients; i++) {
+		WebSocket& w = ws.Add();
+		if(!w.Deflate(deflate).Connect("ws://127.0.0.1:" + AsString(PORT))) {
+			RLOG("Connect failed: " << w.GetError());
+			return;
+		}
+		w.NonBlocking();
+	}
+
+	start = true;
+	Vector<int> received;
+	received.SetCount(clients, 0);
+	int finished = 0;
+	SocketWaitEvent we;
+	while(finished < clients) {
+		we.Clear();
+		for(WebSocket& w : ws)
+			w.AddTo(we);
+		we.Wait(10);
+		for(int i = 0; i < clients; i++)
+			if(received[i] < messages) {
+				ws[i].Do();
+				for(;;) {
+					String s = ws[i].Receive();
+					if(s.IsVoid())
+						break;
+					ASSERT(s == msg);
+					if(++received[i] == messages)
+						finished++;
+				}
+			}
+	}
+	done = true;
+	t.Wait();
+	
+	RLOG(clients << " clients, deflate " << deflate << ": "
+	     << (double)clients * messages / secs / 1000 << " K messages/s delivered, "
+	     << messages / secs / 1000 << " K broadcasts/s");
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+	
+	for(bool deflate : { false, true })
+		for(int clients : { 1, 10, 100, 500 })
+			Bench(clients, 200000 / clients, deflate);
+}
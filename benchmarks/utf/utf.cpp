@@ -2,32 +2,59 @@
 
 using namespace Upp;
 
+WString MakeText(int n, int non_ascii_percent, int from, int count)
+{
+	WString r;
+	while(r.GetCount() < n)
+		r.Cat(Random(100) < non_ascii_percent ? from + Random(count) : Random(20) ? 'a' + Random(26) : ' ');
+	return r;
+}
+
 CONSOLE_APP_MAIN
 {
-	Vector<dword> data;
-	for(int i = 0; i < 20000; i++)
-		data.Add(Random(100));
-	
-	String utf8 = ToUtf8(data.begin(), 200000);
-	WString utf16 = utf8.ToWString();
-
-	int n = 0;
-	const int N = 2000;
-	for(int q = 0; q < N; q++) {
-		RTIMING("utf8 -> utf32");
-		n += ToUtf32(utf8).GetCount();
-	}
-	for(int q = 0; q < N; q++) {
-		RTIMING("utf8 -> utf16");
-		n += ToUtf16(utf8).GetCount();
-	}
-	for(int q = 0; q < N; q++) {
-		RTIMING("utf32 -> utf8");
-		n += ToUtf8(data.begin(), 200000).GetCount();
-	}
-	for(int q = 0; q < N; q++) {
-		RTIMING("utf16 -> utf8");
-		n += utf16.ToString().GetCount();
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+#ifdef _DEBUG
+	const int N = 20;
+#else
+	const int N = 200;
+#endif
+	const int LEN = 1000000;
+
+	auto Measure = [&](const char *text, const char *what, int bytes, Event<> fn) {
+		int64 t0 = tmGetTimeNs();
+		for(int i = 0; i < N; i++)
+			fn();
+		double s = (tmGetTimeNs() - t0) / 1e9;
+		RLOG(Format("%-10s %-16s %6.2f GB/s", text, what, (double)bytes * N / s / 1e9));
+	};
+
+	struct Text {
+		const char *name;
+		WString     text;
+	};
+
+	Text text[] = {
+		{ "ASCII", MakeText(LEN, 0, 0, 0) },
+		{ "Latin", MakeText(LEN, 10, 0xc0, 0x100) },
+		{ "Cyrillic", MakeText(LEN, 80, 0x400, 0x100) },
+		{ "CJK", MakeText(LEN, 90, 0x4e00, 0x5000) },
+		{ "Emoji", MakeText(LEN, 20, 0x1f600, 0x50) },
+	};
+
+	int64 n = 0;
+	for(const Text& t : text) {
+		String utf8 = ToUtf8(t.text);
+		Vector<char16> utf16 = ToUtf16(t.text);
+		const WString& utf32 = t.text;
+		Measure(t.name, "check utf8", utf8.GetCount(), [&] { n += CheckUtf8(utf8); });
+		Measure(t.name, "utf8 -> utf32", utf8.GetCount(), [&] { n += ToUtf32(utf8).GetCount(); });
+		Measure(t.name, "utf8 -> utf16", utf8.GetCount(), [&] { n += ToUtf16(utf8).GetCount(); });
+		Measure(t.name, "utf32 -> utf8", 4 * utf32.GetCount(), [&] { n += ToUtf8(utf32).GetCount(); });
+		Measure(t.name, "utf16 -> utf8", 2 * utf16.GetCount(), [&] { n += ToUtf8(utf16).GetCount(); });
+		Measure(t.name, "utf16 -> utf32", 2 * utf16.GetCount(), [&] { n += ToUtf32(utf16).GetCount(); });
+		Measure(t.name, "utf32 -> utf16", 4 * utf32.GetCount(), [&] { n += ToUtf16(utf32).GetCount(); });
+		Measure(t.name, "ToWString", utf8.GetCount(), [&] { n += utf8.ToWString().GetCount(); });
 	}
 	RDUMP(n);
 }
@@ -28,7 +28,13 @@ void CoWork::Pool::InitThreads(int nthreads)
 {
 	LLOG("Pool::InitThreads: " << nthreads);
 	for(int i = 0; i < nthreads; i++)
-		CHECK(threads.Add().RunNice([=] { worker_index = i; ThreadRun(i); }, true));
+		CHECK(threads.Add().RunNice([=] {
+			worker_index = i;
+			char h[32];
+			snprintf(h, 32, "CoWork #%d", i);
+			TraceThreadName(h);
+			ThreadRun(i);
+		}, true));
 }
 
 void CoWork::Pool::ExitThreads()
@@ -105,6 +111,7 @@ void CoWork::Pool::DoJob(MJob& job)
 	}
 
 	lock.Leave();
+	int64 trace_begin = IsTracing() ? tmGetTimeNs() : 0;
 	std::exception_ptr exc = nullptr;
 	try {
 		if(looper)
@@ -116,6 +123,8 @@ void CoWork::Pool::DoJob(MJob& job)
 		LLOG("DoJob caught exception");
 		exc = std::current_exception();
 	}
+	if(trace_begin)
+		TraceZone(looper ? "CoWork loop" : "CoWork job", trace_begin, tmGetTimeNs());
 	CoWork::current = NULL;
 	if(!finlock)
 		lock.Enter();
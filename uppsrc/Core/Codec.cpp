@@ -0,0 +1,430 @@
+#include "Core.h"
+
+namespace Upp {
+
+// All codecs share the same pipeline: input is split to blocks, each block is compressed
+// to the complete stream (gzip member, zstd / lz4 frame, bz2 stream...) in parallel and
+// blocks are written in order. All supported formats allow concatenation, so the result
+// is readable by standard tools. At most 2 * threads blocks are in memory.
+
+void sCompressStreamCopy_(Stream& out, Stream& in, Gate<int64, int64> progress, Stream& orig_in, int64 insz);
+
+static StaticMutex sCodecLock;
+
+Array<StreamCodec>& CodecRegistry::Codecs()
+{
+	static Array<StreamCodec> codecs;
+	ONCELOCK {
+		StreamCodec& c = codecs.Add();
+		c.name = "gz";
+		c.extension = ".gz";
+		c.default_level = 6;
+		c.Detect = [](const byte *h, int len) {
+			return len >= 3 && h[0] == 0x1f && h[1] == 0x8b && h[2] == 8;
+		};
+		c.CompressBlock = [](const void *data, int len, int level) -> String {
+			Zlib z;
+			z.GZip().Level(level);
+			z.Compress();
+			z.Put(data, len);
+			z.End();
+			return z.IsError() ? String::GetVoid() : z.Get();
+		};
+		c.CreateDecompressStream = [](Stream& in, bool) -> Stream * {
+			ZDecompressStream *s = new ZDecompressStream;
+			s->GZip();
+			s->Open(in);
+			return s;
+		};
+	}
+	return codecs;
+}
+
+void CodecRegistry::Register(const StreamCodec& codec)
+{ // registered codecs are never changed or destroyed, pointers returned by Find / Detect stay valid
+	Mutex::Lock __(sCodecLock);
+	static Array<StreamCodec> replaced;
+	Array<StreamCodec>& c = Codecs();
+	for(int i = 0; i < c.GetCount(); i++)
+		if(c[i].name == codec.name) {
+			replaced.Add(c.Detach(i));
+			c.Insert(i, codec);
+			return;
+		}
+	c.Add(codec);
+}
+
+int CodecRegistry::GetCount()
+{
+	Mutex::Lock __(sCodecLock);
+	return Codecs().GetCount();
+}
+
+const StreamCodec& CodecRegistry::Get(int i)
+{
+	Mutex::Lock __(sCodecLock);
+	return Codecs()[i];
+}
+
+const StreamCodec *CodecRegistry::Find(const char *name)
+{
+	Mutex::Lock __(sCodecLock);
+	String n = ToLower(String(name));
+	if(*n != '.')
+		for(const StreamCodec& c : Codecs())
+			if(c.name == n)
+				return &c;
+	if(*n != '.')
+		n = '.' + n;
+	for(const StreamCodec& c : Codecs())
+		if(c.extension == n)
+			return &c;
+	return NULL;
+}
+
+const StreamCodec *CodecRegistry::Detect(const void *header, int len)
+{
+	Mutex::Lock __(sCodecLock);
+	for(const StreamCodec& c : Codecs())
+		if(c.Detect && c.Detect((const byte *)header, len))
+			return &c;
+	return NULL;
+}
+
+const StreamCodec *CodecRegistry::Detect(Stream& in)
+{
+	in.Term(); // fill the buffer
+	if(const byte *h = in.PeekPtr(HEADER_SIZE))
+		return Detect(h, HEADER_SIZE);
+	if(!(in.GetStyle() & STRM_SEEK)) { // cannot seek back, use whatever is buffered
+		for(int n = HEADER_SIZE - 1; n > 0; n--)
+			if(const byte *h = in.PeekPtr(n))
+				return Detect(h, n);
+		return NULL;
+	}
+	int64 pos = in.GetPos();
+	byte h[HEADER_SIZE];
+	int n = in.Get(h, HEADER_SIZE);
+	in.ClearError();
+	in.Seek(pos);
+	return Detect(h, n);
+}
+
+CodecCompressStream::CodecCompressStream()
+{
+	style = STRM_WRITE;
+	out = NULL;
+	codec = NULL;
+	level = 1;
+	threads = 1;
+	current = 0;
+	batch.Alloc(2);
+	static byte h;
+	ptr = wrlim = buffer = &h;
+}
+
+CodecCompressStream::~CodecCompressStream()
+{
+	Close();
+}
+
+bool CodecCompressStream::Open(Stream& out_, const StreamCodec& codec_, int level_, int threads_)
+{
+	Close();
+	ClearError();
+	out = &out_;
+	codec = &codec_;
+	level = IsNull(level_) ? codec->default_level : level_;
+	threads = threads_ > 0 ? threads_ : CPU_Cores();
+	current = 0;
+	pos = 0;
+	Alloc();
+	return true;
+}
+
+bool CodecCompressStream::Open(Stream& out, const char *codec, int level, int threads)
+{
+	const StreamCodec *c = CodecRegistry::Find(codec);
+	if(c && c->CompressBlock)
+		return Open(out, *c, level, threads);
+	SetError();
+	return false;
+}
+
+void CodecCompressStream::Alloc()
+{
+	input.SetCount(codec->block_size);
+	Stream::buffer = ptr = (byte *)~input;
+	wrlim = ptr + codec->block_size;
+}
+
+void CodecCompressStream::Finish(Batch& b)
+{
+	b.co.Finish();
+	for(Block& k : b.block)
+		if(k.out.IsVoid())
+			SetError();
+		else
+			out->Put(k.out);
+	b.block.Clear();
+	if(out->IsError())
+		SetError();
+}
+
+void CodecCompressStream::FlushBlock()
+{
+	int len = int(ptr - buffer);
+	if(len == 0)
+		return;
+	pos += len;
+	input.SetCount(len);
+	String data = input;
+	Alloc();
+	if(threads <= 1) {
+		String o = codec->CompressBlock(~data, data.GetCount(), level);
+		if(o.IsVoid())
+			SetError();
+		else
+			out->Put(o);
+		return;
+	}
+	Batch& b = batch[current];
+	Block& k = b.block.Add();
+	k.data = data;
+	const StreamCodec *c = codec;
+	int l = level;
+	b.co & [c, l, &k] {
+		k.out = c->CompressBlock(~k.data, k.data.GetCount(), l);
+		k.data.Clear();
+	};
+	if(b.block.GetCount() >= threads) {
+		current = !current;
+		Finish(batch[current]); // write previous batch while this one is being compressed
+	}
+}
+
+void CodecCompressStream::_Put(int w)
+{
+	FlushBlock();
+	*ptr++ = w;
+}
+
+void CodecCompressStream::_Put(const void *data, dword size)
+{
+	const byte *s = (const byte *)data;
+	while(size) {
+		if(ptr == wrlim)
+			FlushBlock();
+		dword n = min(size, dword(wrlim - ptr));
+		memcpy8(ptr, s, n);
+		ptr += n;
+		s += n;
+		size -= n;
+	}
+}
+
+void CodecCompressStream::Close()
+{
+	if(!out)
+		return;
+	if(pos == 0 && ptr == buffer) { // empty input still has to produce valid stream
+		String o = codec->CompressBlock("", 0, level);
+		if(o.IsVoid())
+			SetError();
+		else
+			out->Put(o);
+	}
+	FlushBlock();
+	Finish(batch[!current]);
+	Finish(batch[current]);
+	out = NULL;
+	input.Clear();
+	static byte h;
+	ptr = wrlim = buffer = &h;
+}
+
+bool CodecCompressStream::IsOpen() const
+{
+	return out && out->IsOpen();
+}
+
+CodecDecompressStream::CodecDecompressStream()
+{
+	style = STRM_READ|STRM_LOADING;
+	codec = NULL;
+	threads = 1;
+	done = stop = error = false;
+	static byte h;
+	ptr = rdlim = buffer = &h;
+}
+
+CodecDecompressStream::~CodecDecompressStream()
+{
+	Stop();
+}
+
+void CodecDecompressStream::Stop()
+{
+	if(worker.IsOpen()) {
+		{
+			Mutex::Lock __(lock);
+			stop = true;
+			cv.Broadcast();
+		}
+		worker.Wait();
+	}
+	queue.Clear();
+}
+
+bool CodecDecompressStream::Open(Stream& in_, int threads_)
+{
+	Stop();
+	in.Clear();
+	ClearError();
+	pos = 0;
+	block.Clear();
+	ptr = rdlim = buffer = (byte *)~block;
+	done = stop = error = false;
+	codec = CodecRegistry::Detect(in_);
+	if(codec && codec->CreateDecompressStream) {
+		threads = threads_ > 0 ? threads_ : CPU_Cores();
+		in.Attach(codec->CreateDecompressStream(in_, threads > 1));
+	}
+	if(!in || in->IsError()) {
+		in.Clear();
+		SetError();
+		return false;
+	}
+	if(threads > 1)
+		worker.Run([=] { Work(); });
+	return true;
+}
+
+void CodecDecompressStream::Work()
+{ // decompression runs ahead of consumer, up to 'threads' blocks
+	for(;;) {
+		String b = in->Get(BLOCK_SIZE);
+		Mutex::Lock __(lock);
+		while(queue.GetCount() >= threads && !stop)
+			cv.Wait(lock);
+		if(stop)
+			return;
+		if(b.IsEmpty()) {
+			error = in->IsError();
+			done = true;
+			cv.Broadcast();
+			return;
+		}
+		queue.AddTail(pick(b));
+		cv.Broadcast();
+	}
+}
+
+bool CodecDecompressStream::Fetch()
+{
+	pos += rdlim - buffer;
+	block.Clear();
+	if(!in)
+		return false;
+	if(threads > 1) {
+		Mutex::Lock __(lock);
+		while(queue.IsEmpty() && !done)
+			cv.Wait(lock);
+		if(queue.GetCount()) {
+			block = queue.PopHead();
+			cv.Broadcast();
+		}
+		else
+		if(error)
+			SetError();
+	}
+	else {
+		block = in->Get(BLOCK_SIZE);
+		if(in->IsError())
+			SetError();
+	}
+	ptr = buffer = (byte *)~block;
+	rdlim = ptr + block.GetCount();
+	return ptr < rdlim;
+}
+
+bool CodecDecompressStream::IsOpen() const
+{
+	return in;
+}
+
+int CodecDecompressStream::_Term()
+{
+	return ptr < rdlim || Fetch() ? *ptr : -1;
+}
+
+int CodecDecompressStream::_Get()
+{
+	return ptr < rdlim || Fetch() ? *ptr++ : -1;
+}
+
+dword CodecDecompressStream::_Get(void *data, dword size)
+{
+	byte *t = (byte *)data;
+	while(size) {
+		if(ptr == rdlim && !Fetch())
+			break;
+		dword n = min(size, dword(rdlim - ptr));
+		memcpy8(t, ptr, n);
+		t += n;
+		ptr += n;
+		size -= n;
+	}
+	return dword(t - (byte *)data);
+}
+
+One<Stream> OpenCompressStream(Stream& out, const char *codec, int level, int threads)
+{
+	One<Stream> s;
+	if(!s.Create<CodecCompressStream>().Open(out, codec, level, threads))
+		s.Clear();
+	return s;
+}
+
+One<Stream> OpenDecompressStream(Stream& in, int threads)
+{
+	One<Stream> s;
+	if(!s.Create<CodecDecompressStream>().Open(in, threads))
+		s.Clear();
+	return s;
+}
+
+int64 CodecCompress(Stream& out, Stream& in, const char *codec, int level, int threads)
+{
+	CodecCompressStream outs;
+	if(!outs.Open(out, codec, level, threads))
+		return -1;
+	sCompressStreamCopy_(outs, in, Null, in, in.GetLeft());
+	outs.Close();
+	return out.IsError() || outs.IsError() || in.IsError() ? -1 : out.GetSize();
+}
+
+int64 CodecDecompress(Stream& out, Stream& in, int threads)
+{
+	CodecDecompressStream ins;
+	if(!ins.Open(in, threads))
+		return -1;
+	sCompressStreamCopy_(out, ins, Null, in, in.GetLeft());
+	return out.IsError() || ins.IsError() ? -1 : out.GetSize();
+}
+
+String CodecCompress(const String& data, const char *codec, int level, int threads)
+{
+	StringStream out;
+	StringStream in(data);
+	return CodecCompress(out, in, codec, level, threads) < 0 ? String::GetVoid() : out.GetResult();
+}
+
+String CodecDecompress(const String& data, int threads)
+{
+	StringStream out;
+	StringStream in(data);
+	return CodecDecompress(out, in, threads) < 0 ? String::GetVoid() : out.GetResult();
+}
+
+}
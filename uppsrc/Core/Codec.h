@@ -0,0 +1,108 @@
+struct StreamCodec {
+	String name;                      // "gz", "zstd", "lz4", "bz2", "lzma"...
+	String extension;                 // ".gz"
+	int    default_level = 1;
+	int    block_size = 1024 * 1024;  // uncompressed size of pipeline blocks
+
+	Function<bool (const byte *header, int len)>            Detect;
+	Function<String (const void *data, int len, int level)> CompressBlock; // complete stream/member
+	Function<Stream *(Stream& in, bool co)>                 CreateDecompressStream;
+};
+
+class CodecRegistry {
+	static Array<StreamCodec>& Codecs();
+
+public:
+	enum { HEADER_SIZE = 16 };
+
+	static void               Register(const StreamCodec& codec);
+	static int                GetCount();
+	static const StreamCodec& Get(int i);
+	static const StreamCodec *Find(const char *name);
+	static const StreamCodec *Detect(const void *header, int len);
+	static const StreamCodec *Detect(Stream& in);
+};
+
+class CodecCompressStream : public Stream {
+public:
+	virtual   void  Close();
+	virtual   bool  IsOpen() const;
+
+protected:
+	virtual   void  _Put(int w);
+	virtual   void  _Put(const void *data, dword size);
+
+private:
+	struct Block {
+		String data;
+		String out;
+	};
+	struct Batch {
+		CoWork       co;
+		Array<Block> block;
+	};
+
+	Stream            *out;
+	const StreamCodec *codec;
+	int                level;
+	int                threads;
+	StringBuffer       input;
+	Buffer<Batch>      batch; // 2 batches, one being compressed while the other is filled
+	int                current;
+
+	void Alloc();
+	void FlushBlock();
+	void Finish(Batch& b);
+
+public:
+	bool Open(Stream& out, const StreamCodec& codec, int level = Null, int threads = 0);
+	bool Open(Stream& out, const char *codec, int level = Null, int threads = 0);
+
+	CodecCompressStream();
+	~CodecCompressStream();
+};
+
+class CodecDecompressStream : public Stream {
+public:
+	virtual   bool  IsOpen() const;
+
+protected:
+	virtual   int   _Term();
+	virtual   int   _Get();
+	virtual   dword _Get(void *data, dword size);
+
+private:
+	enum { BLOCK_SIZE = 1024 * 1024 };
+
+	One<Stream>        in;
+	const StreamCodec *codec;
+	int                threads;
+	String             block;
+
+	Thread             worker; // decodes ahead to bounded queue
+	Mutex              lock;
+	ConditionVariable  cv;
+	BiVector<String>   queue;
+	bool               done;
+	bool               stop;
+	bool               error;
+
+	void Work();
+	bool Fetch();
+	void Stop();
+
+public:
+	bool               Open(Stream& in, int threads = 1);
+	const StreamCodec *GetCodec() const                    { return codec; }
+
+	CodecDecompressStream();
+	~CodecDecompressStream();
+};
+
+One<Stream> OpenCompressStream(Stream& out, const char *codec, int level = Null, int threads = 0);
+One<Stream> OpenDecompressStream(Stream& in, int threads = 1);
+
+int64  CodecCompress(Stream& out, Stream& in, const char *codec, int level = Null, int threads = 0);
+int64  CodecDecompress(Stream& out, Stream& in, int threads = 1);
+String CodecCompress(const String& data, const char *codec, int level = Null, int threads = 0);
+String CodecDecompress(const String& data, int threads = 1);
@@ -224,6 +224,7 @@
 #include <sys/un.h>
 #include <netdb.h>
 #include <netinet/in.h>
+#include <poll.h>
 //#include <libiberty.h>
 enum
 {
@@ -381,6 +382,7 @@ class JsonIO;
 #include "JSON.h"
 #include "XML.h"
 #include "Xmlize.h"
+#include "Csv.h"
 
 #include "Gtypes.h"
 #include "i18n.h"
@@ -393,6 +395,8 @@ class JsonIO;
 #include "CoAlgo.h"
 #include "CoSort.h"
 
+#include "Codec.h"
+
 #include "LocalProcess.h"
 
 #include "BinUndoRedo.h"
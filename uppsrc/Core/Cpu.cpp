@@ -31,15 +31,16 @@ static bool sHasSSE;
 static bool sHasSSE2;
 static bool sHasSSE3;
 static bool sHasAVX;
+static bool sHasSSE42;
+static bool sHasPCLMUL;
+static bool sHasAVX2;
+static bool sHasSHA;
 static bool sHypervisor;
 
 static void sCheckCPU()
 {
-	static bool done;
-	if(done) return;
-	done = true;
 	ONCELOCK {
-		unsigned int eax, ebx, ecx, edx;
+		unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
 		#ifdef COMPILER_MSC
 			int cpuInfo[4];
 			__cpuid(cpuInfo, 1);
@@ -57,8 +58,30 @@ static void sCheckCPU()
 				sHasSSE2 = edx & (1 << 26);
 				sHasSSE3 = ecx & 1;
 				sHasAVX = ecx & (1 << 28);
+				sHasSSE42 = ecx & (1 << 20);
+				sHasPCLMUL = ecx & (1 << 1);
 				sHypervisor = ecx & (1 << 31);
 			}
+		bool ymm = false; // OS saves AVX registers on context switch
+		#ifdef COMPILER_MSC
+			if(ecx & (1 << 27))
+				ymm = (_xgetbv(0) & 6) == 6;
+			__cpuidex(cpuInfo, 7, 0);
+			ebx = cpuInfo[1];
+			if(true)
+		#else
+			if(ecx & (1 << 27)) {
+				unsigned int xcr0, xcr0h;
+				__asm__("xgetbv" : "=a" (xcr0), "=d" (xcr0h) : "c" (0));
+				ymm = (xcr0 & 6) == 6;
+			}
+			if(__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+		#endif
+		// https://en.wikipedia.org/wiki/CPUID#EAX=7,_ECX=0:_Extended_Features
+			{
+				sHasAVX2 = ymm && (ebx & (1 << 5));
+				sHasSHA = ebx & (1 << 29);
+			}
 	}
 }
 
@@ -71,6 +94,10 @@ bool CpuSSE()        { sCheckCPU(); return sHasSSE; }
 bool CpuSSE2()       { sCheckCPU(); return sHasSSE2; }
 bool CpuSSE3()       { sCheckCPU(); return sHasSSE3; }
 bool CpuAVX()        { sCheckCPU(); return sHasAVX; }
+bool CpuSSE42()      { sCheckCPU(); return sHasSSE42; }
+bool CpuPCLMUL()     { sCheckCPU(); return sHasPCLMUL; }
+bool CpuAVX2()       { sCheckCPU(); return sHasAVX2; }
+bool CpuSHA()        { sCheckCPU(); return sHasSHA; }
 bool CpuHypervisor() { sCheckCPU(); return sHypervisor; }
 
 #endif
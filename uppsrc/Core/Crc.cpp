@@ -0,0 +1,379 @@
+#include "Core.h"
+
+#if defined(CPU_X86) && (defined(COMPILER_GCC) || defined(COMPILER_MSC))
+#define HASH_X86 1
+#endif
+
+#if defined(COMPILER_GCC)
+#define HASH_TARGET(x) __attribute__((target(x)))
+#else
+#define HASH_TARGET(x)
+#endif
+
+namespace Upp {
+
+static std::atomic<dword> sHashMask(0xffffffff);
+
+dword GetHashAcceleration()
+{
+	dword h = 0;
+#ifdef HASH_X86
+	if(CpuPCLMUL() && CpuSSE42())
+		h |= HASH_CLMUL;
+	if(CpuSSE42())
+		h |= HASH_CRC32C;
+	if(CpuSHA() && CpuSSE42())
+		h |= HASH_SHANI;
+	if(CpuAVX2())
+		h |= HASH_AVX2;
+#endif
+	return h & sHashMask;
+}
+
+void SetHashAcceleration(dword mask)
+{
+	sHashMask = mask;
+}
+
+static dword sCrc32Zlib(dword crc, const byte *s, size_t len)
+{
+	while(len) { // zlib takes uInt
+		uInt n = (uInt)min(len, (size_t)0x40000000);
+		crc = (dword)crc32(crc, s, n);
+		s += n;
+		len -= n;
+	}
+	return crc;
+}
+
+#ifdef HASH_X86
+
+// Folding with carry-less multiplication, see Intel's "Fast CRC Computation for Generic
+// Polynomials Using PCLMULQDQ Instruction". Constants are for bit-reflected CRC32.
+// len must be at least 64 and multiple of 16, crc is not inverted.
+HASH_TARGET("sse4.2,pclmul")
+static dword sCrc32Fold(dword crc, const byte *buf, size_t len)
+{
+	alignas(16) static const uint64 k1k2[] = { 0x0154442bd4, 0x01c6e41596 };
+	alignas(16) static const uint64 k3k4[] = { 0x01751997d0, 0x00ccaa009e };
+	alignas(16) static const uint64 k5k0[] = { 0x0163cd6124, 0x0000000000 };
+	alignas(16) static const uint64 poly[] = { 0x01db710641, 0x01f7011641 };
+
+	__m128i x0, x1, x2, x3, x4, x5, x6, x7, x8, y5, y6, y7, y8;
+
+	x1 = _mm_loadu_si128((__m128i *)(buf + 0x00));
+	x2 = _mm_loadu_si128((__m128i *)(buf + 0x10));
+	x3 = _mm_loadu_si128((__m128i *)(buf + 0x20));
+	x4 = _mm_loadu_si128((__m128i *)(buf + 0x30));
+
+	x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(crc));
+	x0 = _mm_load_si128((__m128i *)k1k2);
+
+	buf += 64;
+	len -= 64;
+
+	while(len >= 64) { // fold 4 x 128 bits in parallel
+		x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+		x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+		x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+		x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+		x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+		x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+
+		y5 = _mm_loadu_si128((__m128i *)(buf + 0x00));
+		y6 = _mm_loadu_si128((__m128i *)(buf + 0x10));
+		y7 = _mm_loadu_si128((__m128i *)(buf + 0x20));
+		y8 = _mm_loadu_si128((__m128i *)(buf + 0x30));
+
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), y5);
+		x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), y6);
+		x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), y7);
+		x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), y8);
+
+		buf += 64;
+		len -= 64;
+	}
+
+	x0 = _mm_load_si128((__m128i *)k3k4); // fold into 128 bits
+
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+	while(len >= 16) { // single fold of remaining 16 bytes blocks
+		x2 = _mm_loadu_si128((__m128i *)buf);
+
+		x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+		buf += 16;
+		len -= 16;
+	}
+
+	x2 = _mm_clmulepi64_si128(x1, x0, 0x10); // fold 128 bits to 64 bits
+	x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+	x1 = _mm_srli_si128(x1, 8);
+	x1 = _mm_xor_si128(x1, x2);
+
+	x0 = _mm_loadl_epi64((__m128i*)k5k0);
+
+	x2 = _mm_srli_si128(x1, 4);
+	x1 = _mm_and_si128(x1, x3);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+
+	x0 = _mm_load_si128((__m128i*)poly); // Barrett reduction to 32 bits
+
+	x2 = _mm_and_si128(x1, x3);
+	x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+	x2 = _mm_and_si128(x2, x3);
+	x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+
+	return _mm_extract_epi32(x1, 1);
+}
+
+HASH_TARGET("sse4.2")
+static dword sCrc32cHw(dword crc, const byte *s, size_t len)
+{
+	crc = ~crc;
+	while(len && ((uintptr_t)s & 7)) {
+		crc = _mm_crc32_u8(crc, *s++);
+		len--;
+	}
+#ifdef CPU_64
+	uint64 c = crc;
+	while(len >= 32) { // unrolled, crc32 has latency 3 and throughput 1
+		c = _mm_crc32_u64(c, *(const uint64 *)s);
+		c = _mm_crc32_u64(c, *(const uint64 *)(s + 8));
+		c = _mm_crc32_u64(c, *(const uint64 *)(s + 16));
+		c = _mm_crc32_u64(c, *(const uint64 *)(s + 24));
+		s += 32;
+		len -= 32;
+	}
+	while(len >= 8) {
+		c = _mm_crc32_u64(c, *(const uint64 *)s);
+		s += 8;
+		len -= 8;
+	}
+	crc = (dword)c;
+#endif
+	while(len >= 4) {
+		crc = _mm_crc32_u32(crc, *(const dword *)s);
+		s += 4;
+		len -= 4;
+	}
+	while(len--)
+		crc = _mm_crc32_u8(crc, *s++);
+	return ~crc;
+}
+
+#endif
+
+dword UpdateCRC32(dword crc, const void *ptr, size_t count)
+{
+	const byte *s = (const byte *)ptr;
+#ifdef HASH_X86
+	if(count >= 64 && (GetHashAcceleration() & HASH_CLMUL)) {
+		size_t n = count & ~(size_t)15;
+		crc = ~sCrc32Fold(~crc, s, n);
+		s += n;
+		count -= n;
+	}
+#endif
+	return sCrc32Zlib(crc, s, count);
+}
+
+enum { CRC32C_POLY = 0x82f63b78, CRC32_POLY = 0xedb88320 };
+
+static const dword *sCrc32cTable()
+{ // slicing-by-8 tables
+	static dword table[8][256];
+	ONCELOCK {
+		for(int i = 0; i < 256; i++) {
+			dword c = i;
+			for(int j = 0; j < 8; j++)
+				c = c & 1 ? (c >> 1) ^ CRC32C_POLY : c >> 1;
+			table[0][i] = c;
+		}
+		for(int i = 0; i < 256; i++)
+			for(int t = 1; t < 8; t++)
+				table[t][i] = (table[t - 1][i] >> 8) ^ table[0][table[t - 1][i] & 0xff];
+	}
+	return &table[0][0];
+}
+
+static dword sCrc32cSw(dword crc, const byte *s, size_t len)
+{
+	const dword *t = sCrc32cTable();
+	crc = ~crc;
+	while(len >= 8) {
+		dword a = crc ^ (s[0] | (s[1] << 8) | (s[2] << 16) | ((dword)s[3] << 24));
+		crc = t[7 * 256 + (a & 0xff)] ^ t[6 * 256 + ((a >> 8) & 0xff)] ^
+		      t[5 * 256 + ((a >> 16) & 0xff)] ^ t[4 * 256 + (a >> 24)] ^
+		      t[3 * 256 + s[4]] ^ t[2 * 256 + s[5]] ^ t[1 * 256 + s[6]] ^ t[s[7]];
+		s += 8;
+		len -= 8;
+	}
+	while(len--)
+		crc = (crc >> 8) ^ t[(crc ^ *s++) & 0xff];
+	return ~crc;
+}
+
+dword UpdateCRC32C(dword crc, const void *ptr, size_t count)
+{
+#ifdef HASH_X86
+	if(GetHashAcceleration() & HASH_CRC32C)
+		return sCrc32cHw(crc, (const byte *)ptr, count);
+#endif
+	return sCrc32cSw(crc, (const byte *)ptr, count);
+}
+
+dword CRC32C(const void *ptr, size_t count)
+{
+	return UpdateCRC32C(0, ptr, count);
+}
+
+dword CRC32C(const String& s)
+{
+	return CRC32C(~s, s.GetLength());
+}
+
+void Crc32cStream::Out(const void *ptr, dword count)
+{
+	crc = UpdateCRC32C(crc, ptr, count);
+}
+
+// crc of len2 zero bytes appended is a linear operator, computed by repeated squaring
+// of the single zero bit operator in GF(2) (same as zlib's crc32_combine)
+
+static dword sGf2Times(const dword *mat, dword vec)
+{
+	dword sum = 0;
+	while(vec) {
+		if(vec & 1)
+			sum ^= *mat;
+		vec >>= 1;
+		mat++;
+	}
+	return sum;
+}
+
+static void sGf2Square(dword *square, const dword *mat)
+{
+	for(int n = 0; n < 32; n++)
+		square[n] = sGf2Times(mat, mat[n]);
+}
+
+static dword sCrcCombine(dword crc1, dword crc2, int64 len2, dword poly)
+{
+	if(len2 <= 0)
+		return crc1;
+	dword even[32];
+	dword odd[32];
+	odd[0] = poly;
+	dword row = 1;
+	for(int n = 1; n < 32; n++) {
+		odd[n] = row;
+		row <<= 1;
+	}
+	sGf2Square(even, odd);
+	sGf2Square(odd, even);
+	do {
+		sGf2Square(even, odd);
+		if(len2 & 1)
+			crc1 = sGf2Times(even, crc1);
+		len2 >>= 1;
+		if(len2 == 0)
+			break;
+		sGf2Square(odd, even);
+		if(len2 & 1)
+			crc1 = sGf2Times(odd, crc1);
+		len2 >>= 1;
+	}
+	while(len2);
+	return crc1 ^ crc2;
+}
+
+dword CombineCRC32(dword crc1, dword crc2, int64 len2)
+{
+	return sCrcCombine(crc1, crc2, len2, CRC32_POLY);
+}
+
+dword CombineCRC32C(dword crc1, dword crc2, int64 len2)
+{
+	return sCrcCombine(crc1, crc2, len2, CRC32C_POLY);
+}
+
+static dword sCoCrc(const void *ptr, size_t count, dword (*update)(dword, const void *, size_t),
+                    dword (*combine)(dword, dword, int64))
+{
+	const size_t CHUNK = 4 * 1024 * 1024;
+	if(count < 2 * CHUNK || CPU_Cores() < 2)
+		return update(0, ptr, count);
+	int n = int((count + CHUNK - 1) / CHUNK);
+	Buffer<dword> crc(n);
+	CoFor(n, [&](int i) {
+		size_t pos = i * CHUNK;
+		crc[i] = update(0, (const byte *)ptr + pos, min(CHUNK, count - pos));
+	});
+	dword r = crc[0];
+	for(int i = 1; i < n; i++)
+		r = combine(r, crc[i], min(CHUNK, count - i * CHUNK));
+	return r;
+}
+
+dword CoCRC32(const void *ptr, size_t count)
+{
+	return sCoCrc(ptr, count, UpdateCRC32, CombineCRC32);
+}
+
+dword CoCRC32C(const void *ptr, size_t count)
+{
+	return sCoCrc(ptr, count, UpdateCRC32C, CombineCRC32C);
+}
+
+static bool sCoCrcFile(const char *path, dword& crc, bool c)
+{
+	FileMapping map;
+	if(map.Open(path) && (map.GetFileSize() == 0 || map.Map())) {
+		crc = c ? CoCRC32C(~map, map.GetCount()) : CoCRC32(~map, map.GetCount());
+		return true;
+	}
+	FileIn in(path); // mapping not possible (e.g. file too big for 32-bit address space)
+	if(!in)
+		return false;
+	Buffer<byte> buffer(1024 * 1024);
+	crc = 0;
+	for(;;) {
+		int n = in.Get(buffer, 1024 * 1024);
+		if(n <= 0)
+			break;
+		crc = c ? UpdateCRC32C(crc, buffer, n) : UpdateCRC32(crc, buffer, n);
+	}
+	return !in.IsError();
+}
+
+bool CoCRC32File(const char *path, dword& crc)
+{
+	return sCoCrcFile(path, crc, false);
+}
+
+bool CoCRC32CFile(const char *path, dword& crc)
+{
+	return sCoCrcFile(path, crc, true);
+}
+
+}
@@ -0,0 +1,470 @@
+#include "Core.h"
+
+namespace Upp {
+
+// Scanning for quotes, separators and line ends runs 16 bytes at a time with SIMD. Parallel
+// parsing first counts quotes in each chunk of input in parallel, which gives the quote state
+// at the start of each chunk, so that the first record boundary after the start of chunk can
+// be found without parsing the whole preceding input.
+
+force_inline
+const char *CsvFind(const char *s, const char *lim, int c1, int c2, int c3)
+{
+#ifdef CPU_SIMD
+	i8x16 a = i8all(c1);
+	i8x16 b = i8all(c2);
+	i8x16 c = i8all(c3);
+	while(lim - s >= 16) {
+		i8x16 v(s);
+		i8x16 m = (v == a) | (v == b) | (v == c);
+		if(AnyTrue(m))
+			return s + FirstTrue(m);
+		s += 16;
+	}
+#endif
+	while(s < lim && (byte)*s != c1 && (byte)*s != c2 && (byte)*s != c3)
+		s++;
+	return s;
+}
+
+static int CsvCountChar(const char *s, const char *lim, int c)
+{
+	int n = 0;
+#ifdef CPU_SIMD
+	i8x16 q = i8all(c);
+	while(lim - s >= 16) {
+		n += CountTrue(i8x16(s) == q);
+		s += 16;
+	}
+#endif
+	while(s < lim)
+		n += (byte)*s++ == c;
+	return n;
+}
+
+void CsvReader::Reset()
+{
+	record.Clear();
+	columns.Clear();
+	header_read = false;
+	index = -1;
+}
+
+bool CsvReader::OpenFile(const char *path)
+{
+	Close();
+	if(!mapping.Open(path))
+		return false;
+	if(mapping.GetFileSize()) {
+		pos = (const char *)mapping.Map();
+		if(!pos)
+			return false;
+		end = pos + mapping.GetCount();
+	}
+	return true;
+}
+
+void CsvReader::Open(const String& text)
+{
+	Close();
+	data = text;
+	pos = data.begin();
+	end = data.end();
+}
+
+void CsvReader::Open(Stream& s)
+{
+	Close();
+	in = &s;
+	eof = false;
+}
+
+void CsvReader::Close()
+{
+	mapping.Close();
+	data.Clear();
+	in = NULL;
+	pos = end = NULL;
+	eof = true;
+	Reset();
+}
+
+bool CsvReader::Refill(int size)
+{ // keeps unparsed data, appends next block from the stream
+	if(!in || eof)
+		return false;
+	String h = in->Get(size);
+	eof = h.GetCount() < size || in->IsEof();
+	data = String(pos, end) + h;
+	pos = data.begin();
+	end = data.end();
+	return true;
+}
+
+const char *CsvReader::ParseRecord(const char *s, const char *lim, Vector<Field>& f, bool final) const
+{ // returns the start of next record or NULL if more data is needed, skips empty lines
+	f.Clear();
+	while(s < lim && (*s == '\n' || *s == '\r'))
+		s++;
+	if(s >= lim)
+		return final ? lim : NULL;
+	Field *fld = &f.Add();
+	fld->ptr = s;
+	fld->quoted = false;
+	bool instring = false;
+	for(;;) {
+		s = instring ? CsvFind(s, lim, quote, quote, quote) : CsvFind(s, lim, separator, quote, '\n');
+		if(s >= lim) {
+			if(!final)
+				return NULL;
+			fld->len = int(lim - fld->ptr);
+			return lim;
+		}
+		int c = (byte)*s;
+		if(c == quote) {
+			instring = !instring;
+			fld->quoted = true;
+			s++;
+		}
+		else
+		if(c == separator) {
+			fld->len = int(s - fld->ptr);
+			fld = &f.Add();
+			fld->ptr = ++s;
+			fld->quoted = false;
+		}
+		else {
+			fld->len = int(s - fld->ptr);
+			if(fld->len && fld->ptr[fld->len - 1] == '\r')
+				fld->len--;
+			return s + 1;
+		}
+	}
+}
+
+const char *CsvReader::Boundary(const char *s, const char *lim, bool instring) const
+{ // returns the start of first record after s
+	for(;;) {
+		s = instring ? CsvFind(s, lim, quote, quote, quote) : CsvFind(s, lim, quote, '\n', '\n');
+		if(s >= lim)
+			return lim;
+		if((byte)*s++ == quote)
+			instring = !instring;
+		else
+			return s;
+	}
+}
+
+Vector<const char *> CsvReader::Split(const char *s, const char *lim) const
+{
+	int64 len = lim - s;
+	int n = parallel ? (int)minmax(len / chunk_size, (int64)1, (int64)65536) : 1;
+	Vector<const char *> b;
+	b.SetCount(n + 1);
+	b[0] = s;
+	b[n] = lim;
+	if(n > 1) {
+		auto ChunkBegin = [&](int i) { return s + len * i / n; };
+		Vector<int> quotes;
+		quotes.SetCount(n);
+		CoFor(n, [&](int i) { quotes[i] = CsvCountChar(ChunkBegin(i), ChunkBegin(i + 1), quote); });
+		Vector<bool> instring;
+		instring.SetCount(n);
+		bool q = false;
+		for(int i = 0; i < n; i++) {
+			instring[i] = q;
+			q ^= quotes[i] & 1;
+		}
+		CoFor(n - 1, [&](int i) { b[i + 1] = Boundary(ChunkBegin(i + 1), lim, instring[i + 1]); });
+		for(int i = 1; i <= n; i++)
+			b[i] = max(b[i], b[i - 1]);
+	}
+	return b;
+}
+
+void CsvReader::ReadHeader()
+{
+	if(header && !header_read) {
+		header_read = true;
+		if(Fetch())
+			columns = GetRecord();
+		index = -1;
+	}
+}
+
+void CsvReader::Bulk(Event<int> chunks, Function<void (int, const Vector<Field>&)> fn)
+{
+	ReadHeader();
+	int base = 0;
+	for(;;) {
+		Refill(chunk_size * max(CPU_Cores(), 1));
+		if(pos >= end)
+			break;
+		Vector<const char *> b = Split(pos, end);
+		int n = b.GetCount() - 1;
+		chunks(n);
+		Vector<int64> count;
+		count.SetCount(n, 0);
+		const char *stop = end;
+		CoFor(parallel && n > 1, n, [&](int i) {
+			Vector<Field> f;
+			const char *s = b[i];
+			const char *lim = b[i + 1];
+			bool last = lim == end; // can end with incomplete record if reading from stream
+			while(s < lim) {
+				const char *e = ParseRecord(s, lim, f, !last || eof);
+				if(!e)
+					break;
+				if(f.GetCount()) {
+					fn(base + i, f);
+					count[i]++;
+				}
+				s = e;
+			}
+			if(last && b[i] < end)
+				stop = s;
+		});
+		for(int64 c : count)
+			index += c;
+		pos = stop;
+		base += n;
+		if(eof)
+			break;
+	}
+	record.Clear();
+}
+
+bool CsvReader::Fetch()
+{
+	ReadHeader();
+	for(;;) {
+		if(pos >= end && eof) {
+			record.Clear();
+			return false;
+		}
+		const char *e = ParseRecord(pos, end, record, eof);
+		if(e) {
+			pos = e;
+			if(record.GetCount()) {
+				index++;
+				return true;
+			}
+			return false;
+		}
+		Refill(max(chunk_size, int(end - pos)));
+	}
+}
+
+String CsvReader::Unescape(const Field& f) const
+{
+	StringBuffer r;
+	bool instring = false;
+	const char *s = f.ptr;
+	const char *lim = s + f.len;
+	while(s < lim) {
+		int c = (byte)*s++;
+		if(c == quote) {
+			if(instring && s < lim && (byte)*s == quote) {
+				r.Cat(quote);
+				s++;
+			}
+			else
+				instring = !instring;
+		}
+		else
+		if(c != '\r')
+			r.Cat(c);
+	}
+	return String(r);
+}
+
+String CsvReader::Text(const Field& f) const
+{
+	String s = f.quoted ? Unescape(f) : String(f.ptr, f.len);
+	return charset == CHARSET_DEFAULT ? s : ToCharset(GetDefaultCharset(), s, charset);
+}
+
+int64 CsvReader::Int64(const Field& f) const
+{
+	char h[64];
+	if(f.quoted || f.len >= 64)
+		return ScanInt64(~Unescape(f));
+	memcpy(h, f.ptr, f.len);
+	h[f.len] = 0;
+	return ScanInt64(h);
+}
+
+double CsvReader::Double(const Field& f) const
+{
+	char h[64];
+	if(f.quoted || f.len >= 64)
+		return ScanDouble(~Unescape(f));
+	memcpy(h, f.ptr, f.len);
+	h[f.len] = 0;
+	return ScanDouble(h);
+}
+
+int64 CsvReader::GetInt64(int i) const
+{
+	return i >= 0 && i < record.GetCount() ? Int64(record[i]) : (int64)Null;
+}
+
+double CsvReader::GetDouble(int i) const
+{
+	return i >= 0 && i < record.GetCount() ? Double(record[i]) : (double)Null;
+}
+
+Vector<String> CsvReader::GetRecord() const
+{
+	Vector<String> r;
+	for(const Field& f : record)
+		r.Add(Text(f));
+	return r;
+}
+
+int CsvReader::FindColumn(const char *name)
+{
+	ReadHeader();
+	for(int i = 0; i < columns.GetCount(); i++)
+		if(columns[i] == name)
+			return i;
+	return -1;
+}
+
+int64 CsvReader::CountRecords()
+{
+	int64 n = index;
+	Bulk([](int) {}, [](int, const Vector<Field>&) {});
+	return index - n;
+}
+
+Vector<int64> CsvReader::ReadInt64(int column)
+{
+	Vector<Vector<int64>> part;
+	Bulk([&](int n) { part.InsertN(part.GetCount(), n); },
+	     [&](int i, const Vector<Field>& f) { part[i].Add(column >= 0 && column < f.GetCount() ? Int64(f[column]) : (int64)Null); });
+	Vector<int64> r;
+	for(Vector<int64>& p : part)
+		r.AppendPick(pick(p));
+	return r;
+}
+
+Vector<double> CsvReader::ReadDouble(int column)
+{
+	Vector<Vector<double>> part;
+	Bulk([&](int n) { part.InsertN(part.GetCount(), n); },
+	     [&](int i, const Vector<Field>& f) { part[i].Add(column >= 0 && column < f.GetCount() ? Double(f[column]) : (double)Null); });
+	Vector<double> r;
+	for(Vector<double>& p : part)
+		r.AppendPick(pick(p));
+	return r;
+}
+
+Vector<String> CsvReader::ReadString(int column)
+{
+	Vector<Vector<String>> part;
+	Bulk([&](int n) { part.InsertN(part.GetCount(), n); },
+	     [&](int i, const Vector<Field>& f) { part[i].Add(column >= 0 && column < f.GetCount() ? Text(f[column]) : String()); });
+	Vector<String> r;
+	for(Vector<String>& p : part)
+		r.AppendPick(pick(p));
+	return r;
+}
+
+Vector<Vector<String>> CsvReader::ReadAll()
+{
+	Vector<Vector<Vector<String>>> part;
+	Bulk([&](int n) { part.InsertN(part.GetCount(), n); },
+	     [&](int i, const Vector<Field>& f) {
+	         Vector<String>& r = part[i].Add();
+	         for(const Field& h : f)
+	             r.Add(Text(h));
+	     });
+	Vector<Vector<String>> r;
+	for(Vector<Vector<String>>& p : part)
+		r.AppendPick(pick(p));
+	return r;
+}
+
+void CsvWriter::Field(const char *s, int len)
+{
+	if(next) {
+		out->Put(separator);
+		row_empty = false;
+	}
+	next = true;
+	String h;
+	if(charset != CHARSET_DEFAULT) {
+		h = ToCharset(charset, String(s, len), CHARSET_DEFAULT);
+		s = ~h;
+		len = h.GetCount();
+	}
+	const char *lim = s + len;
+	if(!quote_all && CsvFind(s, lim, separator, quote, '\n') >= lim) {
+		out->Put(s, len);
+		row_empty = row_empty && len == 0;
+		return;
+	}
+	out->Put(quote);
+	for(;;) {
+		const char *e = CsvFind(s, lim, quote, quote, quote);
+		out->Put(s, int(e - s));
+		if(e >= lim)
+			break;
+		out->Put(quote);
+		out->Put(quote);
+		s = e + 1;
+	}
+	out->Put(quote);
+	row_empty = false;
+}
+
+CsvWriter& CsvWriter::Put(int64 n)
+{
+	if(IsNull(n))
+		return PutNull();
+	String h = AsString(n);
+	Field(h, h.GetCount());
+	return *this;
+}
+
+CsvWriter& CsvWriter::Put(double x)
+{
+	if(IsNull(x))
+		return PutNull();
+	String h = FormatDouble(x);
+	Field(h, h.GetCount());
+	return *this;
+}
+
+CsvWriter& CsvWriter::Put(const Value& v)
+{
+	if(IsNull(v))
+		return PutNull();
+	if(v.Is<int>() || v.Is<int64>() || v.Is<bool>())
+		return Put((int64)v);
+	if(IsNumber(v))
+		return Put((double)v);
+	return Put(AsString(v));
+}
+
+CsvWriter& CsvWriter::EndRow()
+{
+	if(next && row_empty) { // row with single empty field would be read as empty line
+		out->Put(quote);
+		out->Put(quote);
+	}
+	out->Put(line_end);
+	next = false;
+	row_empty = true;
+	return *this;
+}
+
+CsvWriter& CsvWriter::PutRow(const Vector<String>& row)
+{
+	for(const String& s : row)
+		Put(s);
+	return EndRow();
+}
+
+}
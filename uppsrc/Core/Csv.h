@@ -0,0 +1,113 @@
+class CsvReader : NoCopy {
+	struct Field {
+		const char *ptr;
+		int         len;
+		bool        quoted;
+	};
+
+	int            separator = ',';
+	int            quote = '\"';
+	byte           charset = CHARSET_DEFAULT;
+	bool           header = false;
+	bool           parallel = true;
+	int            chunk_size = 1024 * 1024;
+
+	FileMapping    mapping;
+	String         data;
+	Stream        *in = NULL;
+	const char    *pos = NULL;
+	const char    *end = NULL;
+	bool           eof = true;
+
+	Vector<Field>  record;
+	Vector<String> columns;
+	bool           header_read = false;
+	int64          index = -1;
+
+	void           Reset();
+	bool           Refill(int size);
+	void           ReadHeader();
+	const char    *ParseRecord(const char *s, const char *lim, Vector<Field>& f, bool final) const;
+	const char    *Boundary(const char *s, const char *lim, bool instring) const;
+	Vector<const char *> Split(const char *s, const char *lim) const;
+	void           Bulk(Event<int> chunks, Function<void (int, const Vector<Field>&)> fn);
+	String         Unescape(const Field& f) const;
+	String         Text(const Field& f) const;
+	int64          Int64(const Field& f) const;
+	double         Double(const Field& f) const;
+
+public:
+	CsvReader&     Separator(int c)                  { separator = c; return *this; }
+	CsvReader&     Quote(int c)                      { quote = c; return *this; }
+	CsvReader&     Charset(byte cs)                  { charset = cs; return *this; }
+	CsvReader&     Header(bool b = true)             { header = b; return *this; }
+	CsvReader&     Parallel(bool b = true)           { parallel = b; return *this; }
+	CsvReader&     NoParallel()                      { return Parallel(false); }
+	CsvReader&     ChunkSize(int bytes)              { chunk_size = max(bytes, 64); return *this; }
+
+	bool           OpenFile(const char *path);
+	void           Open(const String& text);
+	void           Open(Stream& s);
+	void           Close();
+
+	bool           Fetch();
+	int64          GetIndex() const                  { return index; }
+
+	int            GetCount() const                  { return record.GetCount(); }
+	String         Get(int i) const                  { return i >= 0 && i < record.GetCount() ? Text(record[i]) : String(); }
+	String         operator[](int i) const           { return Get(i); }
+	String         Get(const char *column)           { return Get(FindColumn(column)); }
+	String         operator[](const char *column)    { return Get(column); }
+	int64          GetInt64(int i) const;
+	double         GetDouble(int i) const;
+	Vector<String> GetRecord() const;
+
+	const Vector<String>& GetHeader()                { ReadHeader(); return columns; }
+	int            FindColumn(const char *name);
+
+	int64          CountRecords();
+	Vector<int64>  ReadInt64(int column);
+	Vector<double> ReadDouble(int column);
+	Vector<String> ReadString(int column);
+	Vector<Vector<String>> ReadAll();
+
+	CsvReader()                                      {}
+	CsvReader(Stream& s)                             { Open(s); }
+};
+
+class CsvWriter : NoCopy {
+	Stream *out;
+	int     separator = ',';
+	int     quote = '\"';
+	byte    charset = CHARSET_DEFAULT;
+	bool    quote_all = false;
+	String  line_end = "\r\n";
+	bool    next = false;
+	bool    row_empty = true;
+
+	void    Field(const char *s, int len);
+
+public:
+	CsvWriter& Separator(int c)                      { separator = c; return *this; }
+	CsvWriter& Quote(int c)                          { quote = c; return *this; }
+	CsvWriter& Charset(byte cs)                      { charset = cs; return *this; }
+	CsvWriter& QuoteAll(bool b = true)               { quote_all = b; return *this; }
+	CsvWriter& LineEnd(const char *s)                { line_end = s; return *this; }
+
+	CsvWriter& Put(const char *s, int len)           { Field(s, len); return *this; }
+	CsvWriter& Put(const String& s)                  { Field(s, s.GetCount()); return *this; }
+	CsvWriter& Put(const char *s)                    { Field(s, (int)strlen(s)); return *this; }
+	CsvWriter& Put(int64 n);
+	CsvWriter& Put(int n)                            { return Put((int64)n); }
+	CsvWriter& Put(double x);
+	CsvWriter& Put(const Value& v);
+	CsvWriter& PutNull()                             { Field(NULL, 0); return *this; }
+
+	template <class T>
+	CsvWriter& operator<<(const T& x)                { return Put(x); }
+
+	CsvWriter& EndRow();
+	CsvWriter& PutRow(const Vector<String>& row);
+
+	CsvWriter(Stream& out) : out(&out) {}
+};
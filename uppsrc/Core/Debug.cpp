@@ -58,65 +58,128 @@ static TimingInspector s_zero; // time of Start / End without actual body to mea
 
 TimingInspector::TimingInspector(const char *_name) {
 	name = _name ? _name : "";
-	all_count = call_count = max_nesting = min_time = max_time = total_time = 0;
-	static bool init;
-	if(!init) {
-#if defined(PLATFORM_WIN32) && !defined(PLATFORM_WINCE)
-		timeBeginPeriod(1);
-#endif
-		init = true;
-	}
+	slots = NULL;
 }
 
 TimingInspector::~TimingInspector() {
 	if(this == &s_zero) return;
-	Mutex::Lock __(mutex);
 	StdLog() << Dump() << "\r\n";
 }
 
-void TimingInspector::Add(dword time, int nesting)
+TimingInspector::Slot *TimingInspector::NewSlot()
 {
-	time = tmGetTime() - time;
 	Mutex::Lock __(mutex);
+	Slot *s = new(MemoryAllocPermanent(sizeof(Slot))) Slot; // might be used until the very end
+	s->thread = GetProfileThreadIndex();
+	s->nesting = 0;
+	s->max_nesting = 0;
+	s->call_count = 0;
+	s->all_count = 0;
+	s->total_time = 0;
+	s->min_time = 0;
+	s->max_time = 0;
+	s->next = slots;
+	slots = s;
+	return s;
+}
+
+void TimingInspector::Add(Slot& s, int64 start_time, int64 end_time)
+{
 	if(!active) return;
-	all_count++;
-	if(nesting > max_nesting)
-		max_nesting = nesting;
-	if(nesting == 0) {
-		total_time += time;
-		if(call_count++ == 0)
-			min_time = max_time = time;
+	int64 time = end_time - start_time;
+	s.all_count++;
+	if(s.nesting >= s.max_nesting)
+		s.max_nesting = s.nesting + 1;
+	if(s.nesting == 0) {
+		s.total_time += time;
+		if(s.call_count++ == 0)
+			s.min_time = s.max_time = time;
 		else {
-			if(time < min_time)
-				min_time = time;
-			if(time > max_time)
-				max_time = time;
+			if(time < s.min_time)
+				s.min_time = time;
+			if(time > s.max_time)
+				s.max_time = time;
 		}
+		s.histogram.Add(time);
 	}
+	if(IsTracing() && this != &s_zero)
+		TraceZone(name, start_time, end_time);
 }
 
-String TimingInspector::Dump() {
+int64 TimingInspector::GetCallCount()
+{
 	Mutex::Lock __(mutex);
-	String s = Sprintf("TIMING %-15s: ", name);
-	if(call_count == 0)
-		return s + "No active hit";
+	int64 n = 0;
+	for(Slot *s = slots; s; s = s->next)
+		n += s->call_count;
+	return n;
+}
+
+int64 TimingInspector::GetTotalTime()
+{
+	Mutex::Lock __(mutex);
+	int64 n = 0;
+	for(Slot *s = slots; s; s = s->next)
+		n += s->total_time;
+	return n;
+}
+
+TimingHistogram TimingInspector::GetHistogram()
+{
+	Mutex::Lock __(mutex);
+	TimingHistogram h;
+	for(Slot *s = slots; s; s = s->next)
+		h.Merge(s->histogram);
+	return h;
+}
+
+String TimingInspector::Dump() {
 	ONCELOCK {
 		int w = GetTickCount();
 		while(GetTickCount() - w < 200) { // measure profiling overhead
-			thread_local int nesting = 0;
-			TimingInspector::Routine __(s_zero, nesting);
+			static thread_local Slot *slot;
+			TimingInspector::Routine __(s_zero, slot);
 		}
 	}
-	double tm = max(0.0, double(total_time) / call_count / 1000 -
-			             double(s_zero.total_time) / s_zero.call_count / 1000);
-	return s
-	       + timeFormat(tm * call_count)
-	       + " - " + timeFormat(tm)
-	       + " (" + timeFormat((double)total_time  / 1000) + " / "
-	       + Sprintf("%d )", call_count)
-		   + ", min: " + timeFormat((double)min_time / 1000)
-		   + ", max: " + timeFormat((double)max_time / 1000)
-		   + Sprintf(", nesting: %d - %d", max_nesting, all_count);
+	double zero = s_zero.GetCallCount() ? 1e-9 * s_zero.GetTotalTime() / s_zero.GetCallCount() : 0;
+	Mutex::Lock __(mutex);
+	String s = Sprintf("TIMING %-15s: ", name);
+	int64 call_count = 0, all_count = 0, total_time = 0, min_time = INT64_MAX, max_time = 0;
+	int   max_nesting = 0, threads = 0;
+	TimingHistogram h;
+	for(Slot *q = slots; q; q = q->next)
+		if(q->call_count) {
+			call_count += q->call_count;
+			all_count += q->all_count;
+			total_time += q->total_time;
+			min_time = min(min_time, (int64)q->min_time);
+			max_time = max(max_time, (int64)q->max_time);
+			max_nesting = max(max_nesting, (int)q->max_nesting);
+			h.Merge(q->histogram);
+			threads++;
+		}
+	if(call_count == 0)
+		return s + "No active hit";
+	double tm = max(0.0, 1e-9 * total_time / call_count - zero);
+	s = s
+	    + timeFormat(tm * call_count)
+	    + " - " + timeFormat(tm)
+	    + " (" + timeFormat(1e-9 * total_time)
+	    + " / " + AsString(call_count) + " )"
+	    + ", min: " + timeFormat(1e-9 * min_time)
+	    + ", max: " + timeFormat(1e-9 * max_time)
+	    + ", p50: " + timeFormat(1e-9 * h.GetPercentile(0.5))
+	    + ", p99: " + timeFormat(1e-9 * h.GetPercentile(0.99))
+	    + ", nesting: " + AsString(max_nesting) + " - " + AsString(all_count);
+	if(threads > 1)
+		for(Slot *q = slots; q; q = q->next)
+			if(q->call_count)
+				s << Sprintf("\r\n    thread %3d: ", q->thread)
+				  << timeFormat(1e-9 * q->total_time)
+				  << " / " << (int64)q->call_count
+				  << ", p50: " << timeFormat(1e-9 * q->histogram.GetPercentile(0.5))
+				  << ", p99: " << timeFormat(1e-9 * q->histogram.GetPercentile(0.99));
+	return s;
 }
 
 HitCountInspector::~HitCountInspector()
@@ -300,6 +300,10 @@ bool CpuSSE2();
 bool CpuSSE3();
 bool CpuHypervisor();
 bool CpuAVX();
+bool CpuSSE42();
+bool CpuPCLMUL();
+bool CpuAVX2();
+bool CpuSHA();
 #endif
 
 int  CPU_Cores();
@@ -10,14 +10,17 @@ const char LOG_END = '\x1f';
 enum LogOptions {
 	LOG_FILE = 1, LOG_COUT = 2, LOG_CERR = 4, LOG_DBG = 8, LOG_SYS = 16, LOG_ELAPSED = 128,
 	LOG_TIMESTAMP = 256, LOG_TIMESTAMP_UTC = 512, LOG_APPEND = 1024, LOG_ROTATE_GZIP = 2048,
-	LOG_COUTW = 4096, LOG_CERRW = 8192, LOG_PROCESS_ID = 16384
+	LOG_COUTW = 4096, LOG_CERRW = 8192, LOG_PROCESS_ID = 16384, LOG_ASYNC = 32768,
+	LOG_ASYNC_DROP = 65536, LOG_ROTATE_ZSTD = 131072
 };
 
 inline int LOG_ROTATE(int x) { return x << 24; }
 
 void     StdLogSetup(dword options, const char *filepath = NULL,
-                     int filesize_limit = 10 * 1024 * 1024);
+                     int filesize_limit = 10 * 1024 * 1024, int rotate_interval = 0);
 Stream&  StdLog();
+void     StdLogFlush();
+int64    GetStdLogDropped();
 
 String   GetStdLogPath();
 
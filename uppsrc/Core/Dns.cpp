@@ -0,0 +1,547 @@
+#include "Core.h"
+
+#ifdef PLATFORM_WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#endif
+
+#ifdef PLATFORM_POSIX
+#include <arpa/inet.h>
+#endif
+
+namespace Upp {
+
+#define LLOG(x)  // DLOG("DNS " << x)
+
+void SocketInit();
+
+enum {
+	DNS_TYPE_A = 1,
+	DNS_TYPE_AAAA = 28,
+	DNS_CLASS_IN = 1,
+	DNS_RCODE_NXDOMAIN = 3,
+	DNS_MAX_TTL = 86400, // one day, keeps cache expiry in milliseconds within int
+};
+
+static String sSockAddr(const String& ip, int port)
+{
+	sockaddr_in sin;
+	Zero(sin);
+	if(inet_pton(AF_INET, ~ip, &sin.sin_addr) == 1) {
+		sin.sin_family = AF_INET;
+		sin.sin_port = htons(port);
+		return String((const char *)&sin, sizeof(sin));
+	}
+	sockaddr_in6 sin6;
+	Zero(sin6);
+	if(inet_pton(AF_INET6, ~ip, &sin6.sin6_addr) == 1) {
+		sin6.sin6_family = AF_INET6;
+		sin6.sin6_port = htons(port);
+		return String((const char *)&sin6, sizeof(sin6));
+	}
+	return Null;
+}
+
+static int sIpFamily(const String& ip)
+{
+	byte h[16];
+	return inet_pton(AF_INET, ~ip, h) == 1 ? IpAddrInfo::FAMILY_IPV4 :
+	       inet_pton(AF_INET6, ~ip, h) == 1 ? IpAddrInfo::FAMILY_IPV6 : -1;
+}
+
+static String sEncodeName(const String& name)
+{ // DNS wire format, empty on invalid name
+	String r;
+	const char *s = name;
+	for(;;) {
+		const char *e = strchr(s, '.');
+		int len = int(e ? e - s : strlen(s));
+		if(len == 0 && !e && r.GetCount()) // trailing dot
+			break;
+		if(len <= 0 || len > 63)
+			return Null;
+		r.Cat(len);
+		r.Cat(ToLower(String(s, len)));
+		if(!e)
+			break;
+		s = e + 1;
+	}
+	r.Cat(0);
+	return r.GetCount() > 255 ? String() : r;
+}
+
+static bool sSameAddr(const String& ns, const sockaddr *b)
+{ // ns is raw sockaddr of nameserver
+	const sockaddr *a = (const sockaddr *)~ns;
+	if(a->sa_family != b->sa_family)
+		return false;
+	if(a->sa_family == AF_INET6) {
+		const sockaddr_in6 *x = (const sockaddr_in6 *)a;
+		const sockaddr_in6 *y = (const sockaddr_in6 *)b;
+		return x->sin6_port == y->sin6_port && memcmp(&x->sin6_addr, &y->sin6_addr, sizeof(x->sin6_addr)) == 0;
+	}
+	const sockaddr_in *x = (const sockaddr_in *)a;
+	const sockaddr_in *y = (const sockaddr_in *)b;
+	return x->sin_port == y->sin_port && x->sin_addr.s_addr == y->sin_addr.s_addr;
+}
+
+static void sCloseSocket(SOCKET& s)
+{
+	if(s == INVALID_SOCKET)
+		return;
+#ifdef PLATFORM_WIN32
+	closesocket(s);
+#else
+	close(s);
+#endif
+	s = INVALID_SOCKET;
+}
+
+static int sSkipName(const byte *data, int len, int pos)
+{
+	while(pos < len) {
+		int c = data[pos];
+		if(c == 0)
+			return pos + 1;
+		if((c & 0xc0) == 0xc0)
+			return pos + 2;
+		pos += c + 1;
+	}
+	return -1;
+}
+
+DnsResolver::DnsResolver()
+{
+	SocketInit();
+	LoadResolvConf();
+	LoadHosts();
+}
+
+DnsResolver::~DnsResolver()
+{
+	for(Query& q : query)
+		sCloseSocket(q.sock);
+}
+
+DnsResolver& DnsResolver::NameServer(const String& ip, int port)
+{
+	String a = sSockAddr(ip, port);
+	if(a.GetCount())
+		nameserver.Add(a);
+	return *this;
+}
+
+DnsResolver& DnsResolver::Host(const String& name, const String& ip)
+{
+	hosts.GetAdd(ToLower(name)).Add(ip);
+	return *this;
+}
+
+bool DnsResolver::LoadResolvConf(const char *path)
+{
+	FileIn in(path);
+	if(!in)
+		return false;
+	nameserver.Clear();
+	search.Clear();
+	while(!in.IsEof()) {
+		Vector<String> w = Split(in.GetLine(), [](int c) { return c == ' ' || c == '\t' ? c : 0; });
+		if(w.GetCount() < 2 || *w[0] == '#' || *w[0] == ';')
+			continue;
+		if(w[0] == "nameserver")
+			NameServer(w[1]);
+		if(w[0] == "search" || w[0] == "domain") {
+			search.Clear();
+			search.Append(w, 1, w.GetCount() - 1);
+		}
+		if(w[0] == "options")
+			for(int i = 1; i < w.GetCount(); i++) {
+				auto Opt = [&](const char *id, int& v) {
+					if(w[i].StartsWith(id))
+						v = Nvl(ScanInt(~w[i] + strlen(id)), v);
+				};
+				Opt("ndots:", ndots);
+				int t = Null;
+				Opt("timeout:", t);
+				if(!IsNull(t))
+					timeout = 1000 * t;
+				Opt("attempts:", attempts);
+			}
+	}
+	if(nameserver.GetCount() == 0)
+		NameServer("127.0.0.1");
+	return true;
+}
+
+bool DnsResolver::LoadHosts(const char *path)
+{
+	FileIn in(path);
+	if(!in)
+		return false;
+	hosts.Clear();
+	while(!in.IsEof()) {
+		String ln = in.GetLine();
+		int q = ln.Find('#');
+		if(q >= 0)
+			ln.Trim(q);
+		Vector<String> w = Split(ln, [](int c) { return c == ' ' || c == '\t' ? c : 0; });
+		if(w.GetCount() >= 2 && sIpFamily(w[0]) >= 0)
+			for(int i = 1; i < w.GetCount(); i++)
+				Host(w[i], w[0]);
+	}
+	return true;
+}
+
+SOCKET DnsResolver::Sock(Query& q, int family)
+{
+	SOCKET& s = q.sock;
+	if(s != INVALID_SOCKET && q.sock_family != family)
+		sCloseSocket(s);
+	if(s == INVALID_SOCKET) {
+		s = socket(family, SOCK_DGRAM, 0);
+		if(s == INVALID_SOCKET)
+			return s;
+		q.sock_family = family;
+	#ifdef PLATFORM_WIN32
+		u_long arg = 1;
+		ioctlsocket(s, FIONBIO, &arg);
+	#else
+		fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK);
+	#endif
+		for(int i = 0; i < 8; i++) { // random source port, so that spoofed answers have to guess it too
+			String a = sSockAddr(family == AF_INET6 ? "::" : "0.0.0.0", 1024 + Random(65536 - 1024));
+			if(bind(s, (const sockaddr *)~a, a.GetCount()) == 0)
+				break;
+		}
+	}
+	return s;
+}
+
+word DnsResolver::NewId(int handle)
+{
+	word id;
+	do
+		id = (word)Random();
+	while(id == 0 || pending.Find(id) >= 0);
+	pending.Add(id, handle);
+	return id;
+}
+
+void DnsResolver::Release(Query& q)
+{
+	for(int i = 0; i < 2; i++) {
+		if(q.id[i])
+			pending.RemoveKey(q.id[i]);
+		q.id[i] = 0;
+	}
+	sCloseSocket(q.sock);
+}
+
+void DnsResolver::Send(Query& q)
+{
+	if(nameserver.GetCount() == 0) {
+		Finish(q, false);
+		return;
+	}
+	const String& ns = nameserver[q.server % nameserver.GetCount()];
+	const sockaddr *sa = (const sockaddr *)~ns;
+	SOCKET s = Sock(q, sa->sa_family);
+	for(int i = 0; i < 2; i++)
+		if(q.id[i]) {
+			String packet;
+			packet.Cat(q.id[i] >> 8);
+			packet.Cat(q.id[i] & 255);
+			packet.Cat("\x01\x00\x00\x01\x00\x00\x00\x00\x00\x00", 10); // RD, single question
+			packet.Cat(q.qname);
+			int type = i ? DNS_TYPE_AAAA : DNS_TYPE_A;
+			packet.Cat(type >> 8);
+			packet.Cat(type & 255);
+			packet.Cat(0);
+			packet.Cat(DNS_CLASS_IN);
+			if(s != INVALID_SOCKET)
+				sendto(s, ~packet, packet.GetCount(), 0, sa, ns.GetCount());
+			LLOG("Sent query " << q.id[i] << " " << q.name[q.name_i] << " type " << type);
+		}
+	q.deadline = msecs() + timeout;
+}
+
+int DnsResolver::Start(const String& host, int family)
+{
+	int handle = ++next_handle;
+	Query& q = query.Add(handle);
+	q.host = host;
+	q.family = family;
+	q.status = WORKING;
+	q.notified = false;
+	q.ttl = 0;
+	q.id[0] = q.id[1] = 0;
+	q.sock = INVALID_SOCKET;
+	q.sock_family = 0;
+
+	if(host.IsEmpty()) {
+		q.status = FAILED;
+		return handle;
+	}
+
+	int f = sIpFamily(host);
+	if(f >= 0) { // IP literal
+		if(family == IpAddrInfo::FAMILY_ANY || family == f)
+			q.ip.Add(host);
+		q.status = q.ip.GetCount() ? RESOLVED : FAILED;
+		return handle;
+	}
+
+	bool absolute = *host.Last() == '.';
+	int hi = hosts.Find(ToLower(absolute ? host.Mid(0, host.GetCount() - 1) : host));
+	if(hi >= 0) {
+		for(const String& ip : hosts[hi])
+			if(family == IpAddrInfo::FAMILY_ANY || sIpFamily(ip) == family)
+				q.ip.Add(ip);
+		if(q.ip.GetCount()) {
+			q.status = RESOLVED;
+			return handle;
+		}
+	}
+
+	int dots = 0;
+	for(const char *s = host; *s; s++)
+		dots += *s == '.';
+	if(!absolute && dots >= ndots)
+		q.name.Add(host);
+	if(!absolute)
+		for(const String& s : search)
+			q.name.Add(host + '.' + s);
+	if(absolute || dots < ndots)
+		q.name.Add(host);
+	q.name_i = -1;
+	NextName(handle);
+	return handle;
+}
+
+void DnsResolver::NextName(int handle)
+{
+	Query& q = query.Get(handle);
+	for(;;) {
+		if(++q.name_i >= q.name.GetCount()) {
+			Finish(q, false);
+			return;
+		}
+		q.qname = sEncodeName(q.name[q.name_i]);
+		if(q.qname.GetCount())
+			break;
+	}
+	q.attempt = 0;
+	q.server = 0;
+	q.ip.Clear();
+	q.ttl = INT_MAX;
+	for(int i = 0; i < 2; i++) {
+		if(q.id[i])
+			pending.RemoveKey(q.id[i]);
+		q.id[i] = 0;
+	}
+	if(q.family != IpAddrInfo::FAMILY_IPV6)
+		q.id[0] = NewId(handle);
+	if(q.family != IpAddrInfo::FAMILY_IPV4)
+		q.id[1] = NewId(handle);
+	Send(q);
+}
+
+void DnsResolver::Finish(Query& q, bool ok)
+{
+	Release(q);
+	q.status = ok ? RESOLVED : FAILED;
+	if(!ok)
+		q.ip.Clear();
+	if(q.ttl == INT_MAX)
+		q.ttl = 0;
+	LLOG("Finished " << q.host << ": " << q.ip << ", ttl " << q.ttl);
+	if(cache)
+		IpAddrInfo::AddToCache(q.host, q.family, q.ip, ok ? 1000 * q.ttl : negative_ttl);
+}
+
+void DnsResolver::Process(int handle, const byte *data, int len, const sockaddr *from)
+{
+	Query& q = query.Get(handle);
+	if(len < 12 || nameserver.GetCount() == 0 ||
+	   !sSameAddr(nameserver[q.server % nameserver.GetCount()], from)) { // answer has to come from the queried server
+		LLOG("Ignored packet for " << q.host);
+		return;
+	}
+	word id = Peek16be(data);
+	int flags = (word)Peek16be(data + 2);
+	int qdcount = (word)Peek16be(data + 4);
+	int ancount = (word)Peek16be(data + 6);
+	int pi = pending.Find(id);
+	if(pi < 0 || pending[pi] != handle || !(flags & 0x8000) || qdcount != 1)
+		return;
+	int type = q.id[0] == id ? 0 : 1;
+	int pos = 12;
+	int qlen = q.qname.GetCount();
+	if(len < pos + qlen + 4 || // answer has to be for our question
+	   ToLower(String((const char *)data + pos, qlen)) != q.qname ||
+	   (word)Peek16be(data + pos + qlen) != (type ? DNS_TYPE_AAAA : DNS_TYPE_A) ||
+	   (word)Peek16be(data + pos + qlen + 2) != DNS_CLASS_IN)
+		return;
+	pos += qlen + 4;
+
+	int rcode = flags & 15;
+	if(rcode != 0 && rcode != DNS_RCODE_NXDOMAIN) { // SERVFAIL, REFUSED etc., try next server
+		LLOG("Server error " << rcode);
+		if(++q.attempt < nameserver.GetCount() * attempts) {
+			q.server++;
+			Send(q);
+		}
+		else
+			Finish(q, false);
+		return;
+	}
+
+	for(int i = 0; i < ancount && pos >= 0; i++) {
+		pos = sSkipName(data, len, pos);
+		if(pos < 0 || pos + 10 > len)
+			break;
+		int rtype = (word)Peek16be(data + pos);
+		int ttl = Peek32be(data + pos + 4);
+		int rdlen = (word)Peek16be(data + pos + 8);
+		pos += 10;
+		if(pos + rdlen > len)
+			break;
+		char h[64];
+		if(rtype == DNS_TYPE_A && rdlen == 4 && type == 0 ||
+		   rtype == DNS_TYPE_AAAA && rdlen == 16 && type == 1) {
+			if(inet_ntop(rdlen == 4 ? AF_INET : AF_INET6, (void *)(data + pos), h, sizeof(h))) {
+				q.ip.Add(h);
+				q.ttl = min(q.ttl, minmax(ttl, 0, (int)DNS_MAX_TTL));
+			}
+		}
+		pos += rdlen;
+	}
+
+	pending.Remove(pi);
+	q.id[type] = 0;
+	if(q.id[0] || q.id[1]) // waiting for the other address family
+		return;
+	if(q.ip.GetCount())
+		Finish(q, true);
+	else
+		NextName(handle);
+}
+
+void DnsResolver::Receive(int handle)
+{
+	Buffer<byte> buffer(4096);
+	const Query& q = query.Get(handle);
+	while(q.sock != INVALID_SOCKET) { // socket is closed when the lookup finishes
+		sockaddr_in6 from; // large enough for IPv4 too
+		socklen_t fromlen = sizeof(from);
+		int len = recvfrom(q.sock, (char *)~buffer, 4096, 0, (sockaddr *)&from, &fromlen);
+		if(len < 0)
+			break;
+		Process(handle, buffer, len, (const sockaddr *)&from);
+	}
+}
+
+void DnsResolver::Do()
+{
+	for(int i = 0; i < query.GetCount(); i++)
+		if(query[i].sock != INVALID_SOCKET)
+			Receive(query.GetKey(i));
+	int tm = msecs();
+	for(Query& q : query)
+		if(q.status == WORKING && tm - q.deadline >= 0) {
+			LLOG("Timeout " << q.host);
+			if(++q.attempt < nameserver.GetCount() * attempts) {
+				q.server++;
+				Send(q);
+			}
+			else
+				Finish(q, false);
+		}
+	Vector<int> done;
+	for(int i = 0; i < query.GetCount(); i++) {
+		Query& q = query[i];
+		if(q.status != WORKING && !q.notified) {
+			q.notified = true;
+			done.Add(query.GetKey(i));
+		}
+	}
+	for(int h : done)
+		WhenDone(h);
+}
+
+int DnsResolver::GetWaitTimeout() const
+{
+	int tm = msecs();
+	int t = timeout;
+	for(const Query& q : query)
+		if(q.status == WORKING)
+			t = min(t, q.deadline - tm);
+		else
+		if(!q.notified)
+			t = 0;
+	return max(t, 0);
+}
+
+void DnsResolver::AddTo(SocketWaitEvent& e)
+{
+	for(const Query& q : query)
+		if(q.sock != INVALID_SOCKET)
+			e.Add(q.sock, WAIT_READ);
+}
+
+bool DnsResolver::InProgress(int handle) const
+{
+	int q = query.Find(handle);
+	return q >= 0 && query[q].status == WORKING;
+}
+
+bool DnsResolver::InProgress() const
+{
+	for(const Query& q : query)
+		if(q.status == WORKING)
+			return true;
+	return false;
+}
+
+bool DnsResolver::IsResolved(int handle) const
+{
+	int q = query.Find(handle);
+	return q >= 0 && query[q].status == RESOLVED;
+}
+
+void DnsResolver::Remove(int handle)
+{
+	int q = query.Find(handle);
+	if(q >= 0) {
+		Release(query[q]);
+		query.Remove(q);
+	}
+}
+
+Vector<String> DnsResolver::GetResult(int handle) const
+{
+	int q = query.Find(handle);
+	return q >= 0 ? clone(query[q].ip) : Vector<String>();
+}
+
+int DnsResolver::GetTTL(int handle) const
+{
+	int q = query.Find(handle);
+	return q >= 0 ? query[q].ttl : 0;
+}
+
+Vector<String> DnsResolver::Resolve(const String& host, int family)
+{
+	int h = Start(host, family);
+	while(InProgress(h)) {
+		SocketWaitEvent we;
+		AddTo(we);
+		we.Wait(GetWaitTimeout());
+		Do();
+	}
+	Vector<String> r = GetResult(h);
+	Remove(h);
+	return r;
+}
+
+}
@@ -88,6 +88,21 @@ String  SHA256String(const String& data);
 String  SHA256StringS(const void *data, dword size);
 String  SHA256StringS(const String& data);
 
+void           SHA256Multi(byte *const *hash32, const void *const *data, const size_t *size, int count);
+Vector<String> SHA256Multi(const Vector<String>& data);
+
+Vector<String> CoSHA256Files(const Vector<String>& path);
+
+enum {
+	HASH_CLMUL  = 0x01, // PCLMULQDQ folded CRC32
+	HASH_CRC32C = 0x02, // SSE4.2 CRC32C instruction
+	HASH_SHANI  = 0x04, // SHA extensions SHA256
+	HASH_AVX2   = 0x08, // 8 lanes multi-buffer SHA256
+};
+
+dword GetHashAcceleration();
+void  SetHashAcceleration(dword mask = 0xffffffff);
+
 class xxHashStream : public OutStream {
 	byte context[8 * 8];
 	
@@ -43,6 +43,7 @@ class IpAddrInfo {
 		const char *port;
 		int         family;
 		int         status;
+		bool        waiting; // coalesced with lookup of another entry
 		addrinfo   *addr;
 	};
 	static Entry     pool[COUNT];
@@ -60,6 +61,13 @@ class IpAddrInfo {
 	static void LeavePool();
 	static auxthread_t auxthread__ Thread(void *ptr);
 
+	static String    CacheKey(const char *host, int family);
+	static bool      CacheGet(Entry *e);
+	static void      CachePut(const String& key, addrinfo *result);
+	static void      CachePut(const String& key, Vector<String>&& addr, int ttl);
+	static addrinfo *MakeAddrInfo(const Vector<String>& addr, const char *port);
+	static void      FreeAddrInfo(addrinfo *ai);
+
 	void Start();
 	
 	IpAddrInfo(const IpAddrInfo&);
@@ -74,6 +82,15 @@ public:
 	addrinfo *GetResult() const;
 	void      Clear();
 
+	static void CacheTTL(int ms);
+	static void CacheNegativeTTL(int ms);
+	static void CacheMaxCount(int n);
+	static void NoCache()                            { CacheTTL(0); CacheNegativeTTL(0); }
+	static void ClearCache();
+	static void AddToCache(const String& host, int family, const Vector<String>& ip, int ttl_ms);
+	static int  GetCacheHits();
+	static int  GetCacheMisses();
+
 	IpAddrInfo();
 	~IpAddrInfo()           { Clear(); }
 };
@@ -93,11 +110,12 @@ struct SSLInfo {
 enum { WAIT_READ = 1, WAIT_WRITE = 2, WAIT_IS_EXCEPTION = 4 };
 
 class Socket : NoCopy {
-	enum { BUFFERSIZE = 512 };
+	enum { DEFAULT_BUFFERSIZE = 65536 };
 	enum { NONE, CONNECT, ACCEPT, SSL_CONNECTED };
 	SOCKET                  socket;
 	int                     mode;
-	char                    buffer[BUFFERSIZE];
+	Buffer<char>            buffer;
+	int                     buffersize;
 	char                   *ptr;
 	char                   *end;
 	bool                    is_eof;
@@ -119,6 +137,11 @@ class Socket : NoCopy {
 
 	int                     errorcode;
 	String                  errordesc;
+
+	int                     rcvbuf;
+	int                     sndbuf;
+	bool                    quickack;
+	int                     fastopen;
 	
 	struct SSL {
 		virtual bool  Start() = 0;
@@ -157,9 +180,12 @@ class Socket : NoCopy {
 	int                     Recv(void *buffer, int maxlen);
 	int                     RawSend(const void *buffer, int maxlen);
 	int                     Send(const void *buffer, int maxlen);
+	int                     RawSendV(const char **data, const int *len, int count);
 	bool                    RawConnect(addrinfo *arp);
 	void                    RawClose();
 
+	void                    ApplyOptions();
+	void                    RecvBuffer();
 	void                    ReadBuffer(int end_time);
 	int                     Get_();
 	int                     Peek_();
@@ -231,6 +257,13 @@ public:
 	void            Linger(int msecs);
 	void            NoLinger()                               { Linger(Null); }
 	
+	Socket&         ReadBufferSize(int bytes);
+	int             GetReadBufferSize() const                { return buffersize; }
+	Socket&         RecvBufferSize(int bytes);
+	Socket&         SendBufferSize(int bytes);
+	Socket&         QuickAck(bool b = true);
+	Socket&         FastOpen(int queue_length = 256);
+	
 	bool            Wait(dword events);
 	bool            WaitRead()                               { return Wait(WAIT_READ); }
 	bool            WaitWrite()                              { return Wait(WAIT_WRITE); }
@@ -250,6 +283,11 @@ public:
 
 	bool            PutAll(const void *s, int len);
 	bool            PutAll(const String& s);
+
+	int             Put(const String *s, int count);
+	bool            PutAll(const String *s, int count);
+	bool            PutAll(const Vector<String>& s)          { return PutAll(s.begin(), s.GetCount()); }
+	bool            PutAll(const String& s1, const String& s2);
 	
 	bool            StartSSL();
 	bool            IsSSL() const                            { return ssl; }
@@ -279,7 +317,11 @@ using TcpSocket = Socket; // Backward compatibility
 
 class SocketWaitEvent {
 	Vector<Tuple<int, dword>> socket;
+#ifdef PLATFORM_POSIX
+	Vector<pollfd> pfd;
+#else
 	fd_set read[1], write[1], exception[1];
+#endif
 	SocketWaitEvent(const SocketWaitEvent &);
 
 public:
@@ -293,6 +335,88 @@ public:
 	SocketWaitEvent();
 };
 
+class DnsResolver { // asynchronous resolver using UDP DNS queries directly
+	enum { WORKING, RESOLVED, FAILED };
+
+	struct Query {
+		String         host;
+		int            family;
+		Vector<String> name;       // candidate names (search list)
+		int            name_i;
+		String         qname;      // encoded name of current candidate
+		word           id[2];      // A, AAAA query ids, 0 if not used or answered
+		int            attempt;
+		int            server;
+		int            deadline;
+		int            ttl;
+		int            status;
+		bool           notified;
+		Vector<String> ip;
+		SOCKET         sock;       // own socket with random source port
+		int            sock_family;
+	};
+
+	ArrayMap<int, Query> query;
+	VectorMap<word, int> pending;   // query id -> handle
+	int                  next_handle = 0;
+
+	Vector<String>       nameserver; // raw sockaddr
+	Vector<String>       search;
+	int                  ndots = 1;
+	int                  timeout = 5000;
+	int                  attempts = 2;
+	bool                 cache = true;
+	int                  negative_ttl = 5000;
+	VectorMap<String, Vector<String>> hosts;
+
+	SOCKET Sock(Query& q, int family);
+	word   NewId(int handle);
+	void   Release(Query& q);
+	void   Send(Query& q);
+	void   NextName(int handle);
+	void   Finish(Query& q, bool ok);
+	void   Receive(int handle);
+	void   Process(int handle, const byte *data, int len, const sockaddr *from);
+
+	DnsResolver(const DnsResolver&);
+
+public:
+	Event<int>     WhenDone;
+
+	DnsResolver&   NameServer(const String& ip, int port = 53);
+	DnsResolver&   ClearNameServers()                     { nameserver.Clear(); return *this; }
+	DnsResolver&   Search(const String& domain)           { search.Add(domain); return *this; }
+	DnsResolver&   ClearSearch()                          { search.Clear(); return *this; }
+	DnsResolver&   Timeout(int ms)                        { timeout = ms; return *this; }
+	DnsResolver&   Attempts(int n)                        { attempts = max(n, 1); return *this; }
+	DnsResolver&   Cache(bool b = true)                   { cache = b; return *this; }
+	DnsResolver&   NoCache()                              { return Cache(false); }
+	DnsResolver&   NegativeTTL(int ms)                    { negative_ttl = ms; return *this; }
+	DnsResolver&   Host(const String& name, const String& ip);
+	DnsResolver&   ClearHosts()                           { hosts.Clear(); return *this; }
+
+	bool           LoadResolvConf(const char *path = "/etc/resolv.conf");
+	bool           LoadHosts(const char *path = "/etc/hosts");
+
+	int            Start(const String& host, int family = IpAddrInfo::FAMILY_ANY);
+	bool           InProgress(int handle) const;
+	bool           InProgress() const;
+	bool           IsResolved(int handle) const;
+	Vector<String> GetResult(int handle) const;
+	int            GetTTL(int handle) const;
+	void           Remove(int handle);
+	
+	void           Do();
+	dword          GetWaitEvents() const                  { return WAIT_READ; }
+	int            GetWaitTimeout() const;
+	void           AddTo(SocketWaitEvent& e);
+
+	Vector<String> Resolve(const String& host, int family = IpAddrInfo::FAMILY_ANY);
+
+	DnsResolver();
+	~DnsResolver();
+};
+
 struct UrlInfo {
 	String                            url;
 
@@ -632,6 +756,8 @@ bool HttpResponse(TcpSocket& socket, bool scgi, int code, const char *phrase = N
 
 #include <Core/Core.h>
 
+class WebSocketFrame;
+
 class WebSocket {
 	String     error;
 
@@ -671,6 +797,14 @@ class WebSocket {
 	
 	int              redirect = 0;
 
+	bool             deflate_enabled;   // accept / request permessage-deflate
+	bool             deflate;           // permessage-deflate negotiated
+	bool             inflate_reset;     // peer does not use context takeover
+	One<Zlib>        inflater;
+	String           deflated;          // compressed message being received
+	dword            deflated_opcode;
+	int              max_message_size;
+
 	enum {
 		HTTP_REQUEST_HEADER = -100,
 		HTTP_RESPONSE_HEADER = -101,
@@ -679,6 +813,7 @@ class WebSocket {
 		SSL_HANDSHAKE = -104,
 
 		FIN = 0x80,
+		RSV1 = 0x40,
 		TEXT = 0x1,
 		BINARY = 0x2,
 		CLOSE = 0x8,
@@ -686,6 +821,8 @@ class WebSocket {
 		PONG = 0xa,
 		
 		MASK = 0x80,
+		
+		DEFLATE_MIN = 64,
 	};
 
 	void Clear();
@@ -702,15 +839,25 @@ class WebSocket {
 	bool ReadHttpHeader();
 	void ResponseHeader();
 	void RequestHeader();
+	bool AcceptRequest(const HttpHeader& hdr);
+	String Inflate(const String& data);
+	void MessageTooBig();
+	void Message(dword opcode, const String& data);
 	void FrameHeader();
 	void FrameData();
 
 	int GetFinIndex() const;
+	bool IsConnected() const                            { return opcode >= 0 || opcode == READING_FRAME_HEADER; }
 
 	void   SendRaw(int hdr, const String& data, dword mask = 0);
 	void   Do0();
 	
 	static String FormatBlock(const String& s);
+	static String MakeFrameHeader(int hdr, int len, dword mask = 0);
+	static String DeflateMessage(const String& data);
+
+	friend class WebSocketFrame;
+	friend class WebSocketServer;
 
 public:
 	WebSocket& NonBlocking(bool b = true)               { socket->Timeout(b ? 0 : Null); return *this; }
@@ -719,6 +866,11 @@ public:
 	WebSocket&  ClearHeaders()                          { return Headers(Null); }
 	WebSocket&  AddHeaders(const String& h)             { request_headers.Cat(h); return *this; }
 	WebSocket&  Header(const char *id, const String& data);
+	WebSocket&  Deflate(bool b = true)                  { deflate_enabled = b; return *this; }
+	WebSocket&  NoDeflate()                             { return Deflate(false); }
+	bool        IsDeflate() const                       { return deflate; }
+	WebSocket&  MaxMessageSize(int bytes)               { max_message_size = bytes; return *this; }
+	int         GetMaxMessageSize() const               { return max_message_size; }
 
 	String      GetHeaders()                            { return request_headers; }
 	
@@ -748,6 +900,8 @@ public:
 	void   BeginBinary(const String& data)              { SendRaw(BINARY, data); }
 	void   Continue(const String& data)                 { SendRaw(0, data); }
 	void   Fin(const String& data)                      { SendRaw(FIN, data); }
+	
+	void   Send(WebSocketFrame& frame);
 
 	void   Close(const String& msg = Null, bool wait_reply = false);
 	bool   IsOpen() const                               { return socket->IsOpen(); }
@@ -780,4 +934,54 @@ public:
 	String Recieve()    { return Receive(); }
 };
 
+class WebSocketFrame { // message framed (and compressed) only once, to be sent to many WebSockets
+	String data;
+	int    hdr;
+	String frame[2];
+
+public:
+	const String& Get(bool deflate);
+	int           GetLength() const                     { return data.GetCount(); }
+
+	WebSocketFrame(const String& data, bool text = true);
+};
+
+class WebSocketServer {
+	TcpSocket        listener;
+	Array<WebSocket> ws;
+	SocketWaitEvent  we;
+	bool             deflate = true;
+	bool             quit = false;
+	int              max_connections = 100000;
+	int              read_buffer_size = 4096; // many mostly idle connections, small messages
+	int              max_message_size = 64 * 1024 * 1024;
+
+	void Accept();
+
+public:
+	Event<WebSocket&>                WhenAccept;
+	Event<WebSocket&, const String&> WhenMessage;
+	Event<WebSocket&>                WhenClose;
+
+	bool       Listen(int port, int listen_count = 1024, bool ipv6 = false);
+	void       Do(int timeout = 10);
+	void       Run();
+	void       Stop()                                   { quit = true; }
+	bool       IsRunning() const                        { return !quit; }
+
+	int        GetCount() const                         { return ws.GetCount(); }
+	WebSocket& operator[](int i)                        { return ws[i]; }
+	TcpSocket& GetListener()                            { return listener; }
+
+	int        Broadcast(WebSocketFrame& frame);
+	int        Broadcast(const String& data, bool text = true);
+	int        Broadcast(const String& data, Gate<WebSocket&> filter, bool text = true);
+
+	WebSocketServer& Deflate(bool b = true)             { deflate = b; return *this; }
+	WebSocketServer& NoDeflate()                        { return Deflate(false); }
+	WebSocketServer& MaxConnections(int n)              { max_connections = n; return *this; }
+	WebSocketServer& ReadBufferSize(int bytes)          { read_buffer_size = bytes; return *this; }
+	WebSocketServer& MaxMessageSize(int bytes)          { max_message_size = bytes; return *this; }
+};
+
 void ParseProxyUrl(const char *p, String& proxy_host, int& proxy_port);
@@ -667,9 +667,7 @@ bool HttpResponse(TcpSocket& socket, bool scgi, int code, const char *phrase,
 	if(gzip)
 		r << "Content-Encoding: gzip\r\n";
 	r << "\r\n";
-	if(!socket.PutAll(r))
-		return false;
-	return data.GetCount() == 0 || socket.PutAll(data);
+	return socket.PutAll(r, data);
 }
 
 String UrlInfo::operator[](const char *id) const
@@ -2,7 +2,37 @@
 
 namespace Upp {
 
-Value ParseJSON(CParser& p)
+struct JsonShapes { // objects with the same keys (typically records in array) share them
+	Index<hash_t>    hash;
+	Vector<ValueMap> map;
+
+	ValueMap Get(Vector<Value>&& key, Vector<Value>&& value);
+};
+
+ValueMap JsonShapes::Get(Vector<Value>&& key, Vector<Value>&& value)
+{
+	if(key.GetCount() == 0)
+		return ValueMap();
+	CombineHash h;
+	for(const Value& k : key)
+		h.Put(k.GetHashValue());
+	for(int q = hash.Find(h); q >= 0; q = hash.FindNext(q)) {
+		const Index<Value>& k = map[q].GetKeys();
+		if(k.GetCount() == key.GetCount()) {
+			int i = 0;
+			while(i < key.GetCount() && k[i] == key[i])
+				i++;
+			if(i == key.GetCount())
+				return ValueMap(map[q], pick(value));
+		}
+	}
+	ValueMap m(Index<Value>(pick(key)), pick(value));
+	hash.Add(h);
+	map.Add(m);
+	return m;
+}
+
+static Value ParseJSON(CParser& p, JsonShapes& shapes)
 {
 	p.UnicodeEscape();
 	if(p.IsDouble())
@@ -27,21 +57,21 @@ Value ParseJSON(CParser& p)
 	if(p.Id("false"))
 		return false;
 	if(p.Char('{')) {
-		ValueMap m;
+		Vector<Value> key, value;
 		while(!p.Char('}')) {
-			String key = p.ReadString();
+			key.Add(p.ReadString());
 			p.PassChar(':');
-			m.Add(key, ParseJSON(p));
+			value.Add(ParseJSON(p, shapes));
 			if(p.Char('}')) // Stray ',' at the end of list is allowed...
 				break;
 			p.PassChar(',');
 		}
-		return m;
+		return shapes.Get(pick(key), pick(value));
 	}
 	if(p.Char('[')) {
 		ValueArray va;
 		while(!p.Char(']')) {
-			va.Add(ParseJSON(p));
+			va.Add(ParseJSON(p, shapes));
 			if(p.Char(']')) // Stray ',' at the end of list is allowed...
 				break;
 			p.PassChar(',');
@@ -52,6 +82,12 @@ Value ParseJSON(CParser& p)
 	return Null;
 }
 
+Value ParseJSON(CParser& p)
+{
+	JsonShapes shapes;
+	return ParseJSON(p, shapes);
+}
+
 Value ParseJSON(const char *s)
 {
 	try {
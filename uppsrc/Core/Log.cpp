@@ -4,6 +4,127 @@ namespace Upp {
 
 StaticMutex log_mutex;
 
+// With LOG_ASYNC, each thread formats lines into its own single producer / single consumer
+// ring buffer and background writer thread drains all rings under log_mutex, writing to the
+// file in large blocks. Rings are never freed, but are reused when thread ends, so memory is
+// bounded by the maximum number of threads logging at the same time. Lines of single thread
+// keep their order, lines of different threads are interleaved in the order of draining.
+
+struct LogRing {
+	enum { SIZE = 64 * 1024, HEADER = 2 * sizeof(word) };
+
+	std::atomic<dword> head; // written by producer
+	std::atomic<dword> tail; // written by consumer
+	std::atomic<bool>  used; // owned by some thread
+	LogRing           *next;
+	char               data[SIZE];
+
+	int  GetUsed() const              { return int(head.load(std::memory_order_relaxed) - tail.load(std::memory_order_relaxed)); }
+	void Write(dword pos, const void *src, int len);
+	void Read(dword pos, void *dst, int len) const;
+	bool Put(const char *h, int count, int prefix);
+};
+
+void LogRing::Write(dword pos, const void *src, int len)
+{
+	int i = pos & (SIZE - 1);
+	int n = min(len, SIZE - i);
+	memcpy(data + i, src, n);
+	memcpy(data, (const char *)src + n, len - n);
+}
+
+void LogRing::Read(dword pos, void *dst, int len) const
+{
+	int i = pos & (SIZE - 1);
+	int n = min(len, SIZE - i);
+	memcpy(dst, data + i, n);
+	memcpy((char *)dst + n, data, len - n);
+}
+
+bool LogRing::Put(const char *h, int count, int prefix)
+{
+	dword pos = head.load(std::memory_order_relaxed);
+	if(SIZE - int(pos - tail.load(std::memory_order_acquire)) < HEADER + count)
+		return false;
+	word hdr[2] = { (word)count, (word)prefix };
+	Write(pos, hdr, HEADER);
+	Write(pos + HEADER, h, count);
+	head.store(pos + HEADER + count, std::memory_order_release);
+	return true;
+}
+
+struct LogThread {
+	LogRing *ring = NULL;
+	bool     line_begin = true;
+	int64    stamp_time = -1; // cached timestamp text
+	bool     stamp_utc;
+	int      stamp_len;
+	char     stamp[32];
+
+	~LogThread() { if(ring) ring->used.store(false, std::memory_order_release); }
+};
+
+static thread_local LogThread sLogThread;
+static thread_local bool      sLogWriter; // true in the writer thread
+
+static std::atomic<LogRing *> sLogRings;
+static std::atomic<int64>     sLogDropped;
+static std::atomic<int>       sLogPrevMsecs;
+static std::atomic<bool>      sLogWriterRunning;
+static std::atomic<bool>      sLogWriterStop;
+static std::atomic<bool>      sLogWakePending;
+
+static Semaphore& sLogWake()
+{
+	alignas(Semaphore) static byte h[sizeof(Semaphore)];
+	static Semaphore *s = new(h) Semaphore; // not destroyed, used by EXITBLOCK
+	return *s;
+}
+
+static Semaphore& sLogWriterDone()
+{
+	alignas(Semaphore) static byte h[sizeof(Semaphore)];
+	static Semaphore *s = new(h) Semaphore; // not destroyed, used by EXITBLOCK
+	return *s;
+}
+
+static void sWakeLogWriter()
+{
+	if(!sLogWakePending.exchange(true))
+		sLogWake().Release();
+}
+
+static LogRing *sGetLogRing()
+{
+	for(LogRing *r = sLogRings.load(std::memory_order_acquire); r; r = r->next) {
+		bool f = false;
+		if(r->used.compare_exchange_strong(f, true))
+			return r;
+	}
+	LogRing *r = new(MemoryAllocPermanent(sizeof(LogRing))) LogRing;
+	r->head = r->tail = 0;
+	r->used = true;
+	r->next = sLogRings.load();
+	while(!sLogRings.compare_exchange_weak(r->next, r))
+		;
+	return r;
+}
+
+static int sLogStamp(char *p, bool utc)
+{
+	LogThread& t = sLogThread;
+	int64 now = (int64)time(NULL);
+	if(now != t.stamp_time || utc != t.stamp_utc) {
+		Time tm = utc ? GetUtcTime() : GetSysTime();
+		t.stamp_len = max(snprintf(t.stamp, 32, "%02d.%02d.%04d %02d:%02d:%02d ",
+		                           tm.day, tm.month, tm.year, tm.hour, tm.minute, tm.second), 0);
+		t.stamp_time = (int64)time(NULL) == now ? now : -1; // second has changed meanwhile
+		t.stamp_utc = utc;
+	}
+	memcpy(p, t.stamp, t.stamp_len);
+	return t.stamp_len;
+}
+
 struct LogOut {
 	dword options;
 	int   sizelimit;
@@ -23,14 +144,27 @@ struct LogOut {
 	
 	bool  line_begin;
 	
-	int   prev_msecs;
-	
+	int   rotate_interval; // seconds, 0: no time based rotation
+	int64 rotate_at;
+
+	bool  batching; // file output is collected in batch, written by FlushFile
+	int   batch_len;
+	char  batch[64 * 1024];
+
+	int64 dropped_reported;
+
 	void  Create(bool append);
 	void  Create()                                     { Create(options & LOG_APPEND); }
 	void  Close();
+	void  Shift(int rotn);
+	void  Rotate();
+	int   Format(char *h, const char *s, int len, int depth, bool& line_begin, int& prefix);
+	void  Out(const char *h, int count, int prefix);
+	void  FileWrite(const char *s, int count);
+	void  FlushFile();
+	void  Drain();
 	void  Line(const char *buffer, int len, int depth);
 	bool  IsOpen() const;
-	void  Rotate();
 };
 
 bool LogOut::IsOpen() const
@@ -42,8 +176,52 @@ bool LogOut::IsOpen() const
 #endif
 }
 
+void LogOut::Shift(int rotn)
+{
+	const StreamCodec *codec = NULL; // older parts are compressed
+	if(options & LOG_ROTATE_ZSTD)
+		codec = CodecRegistry::Find("zstd"); // requires plugin/zstd
+	if(!codec && (options & (LOG_ROTATE_GZIP|LOG_ROTATE_ZSTD)))
+		codec = CodecRegistry::Find("gz");
+	char next[512];
+	for(int rot = rotn; rot >= 0; rot--) {
+		char current[512];
+		if(rot == 0)
+			strcpy(current, filepath);
+		else
+			snprintf(current, 512, rot > 1 && codec ? "%s.%d%s" : "%s.%d",
+			         filepath, rot, codec ? ~codec->extension : "");
+		if(FileExists(current)) {
+			if(rot == rotn)
+				FileDelete(current);
+			else
+			if(codec && rot == 1 && !IsPanicMode()) { // Should be OK to use heap in Create...
+				bool ok;
+				{
+					FileIn in(current);
+					FileOut out(next);
+					ok = in && out && CodecCompress(out, in, codec->name, Null, 1) >= 0;
+					out.Close();
+					ok = ok && !out.IsError();
+				}
+				if(!ok)
+					FileMove(current, next);
+			}
+			else
+				FileMove(current, next);
+		}
+		strcpy(next, current);
+	}
+}
+
 void LogOut::Rotate()
 {
+	FlushFile();
+	Close();
+	if(!(options >> 24))
+		Shift(1); // keep at least the previous part
+	part++;
+	Create(false);
 }
 
 void LogOut::Create(bool append)
@@ -53,30 +231,13 @@ void LogOut::Create(bool append)
 	line_begin = true;
 	
 	int rotn = options >> 24;
-	if(rotn) {
-		char next[512];
-		for(int rot = rotn; rot >= 0; rot--) {
-			char current[512];
-			if(rot == 0)
-				strcpy(current, filepath);
-			else
-				snprintf(current, 512, rot > 1 && (options & LOG_ROTATE_GZIP) ? "%s.%d.gz" : "%s.%d",
-				        filepath, rot);
-			if(FileExists(current)) {
-				if(rot == rotn)
-					FileDelete(current);
-				else
-				if((options & LOG_ROTATE_GZIP) && rot == 1 && !IsPanicMode()) {
-					GZCompressFile(next, current); // Should be OK to use heap in Create...
-				}
-				else
-					FileMove(current, next);
-			}
-			strcpy(next, current);
-		}
-	}
+	if(rotn)
+		Shift(rotn);
 	
 	filesize = 0;
+	rotate_at = 0;
+	if(rotate_interval > 0)
+		rotate_at = ((int64)time(NULL) / rotate_interval + 1) * rotate_interval;
 
 #ifdef PLATFORM_WIN32
 	hfile = CreateFile(filepath,
@@ -156,49 +317,76 @@ void LogOut::Close()
 #endif
 }
 
-void LogOut::Line(const char *s, int len, int depth)
+int LogOut::Format(char *h, const char *s, int len, int depth, bool& line_begin, int& prefix)
 {
-	Mutex::Lock __(log_mutex);
-	
 	ASSERT(len < 600);
 
-	char h[1200]; // 2 * 600 to make snprintf easier
 	char *p = h;
 	int   ll = 0;
 	if(options & LOG_ELAPSED) {
 		int t = msecs();
-		int e = prev_msecs ? t - prev_msecs : 0;
-		ll = snprintf(p, 600, "[+%6d ms] ", e);
+		int prev = sLogPrevMsecs.exchange(t);
+		ll = snprintf(p, 600, "[+%6d ms] ", prev ? t - prev : 0);
 		if(ll < 0)
-			return;
+			return 0;
 		p += ll;
-		prev_msecs = t;
 	}
 #ifdef PLATFORM_POSIX
 	if((options & LOG_PROCESS_ID) && line_begin) {
 		ll = snprintf(p, 600, "PID %d ", getpid());
 		if(ll < 0)
-			return;
+			return 0;
 		p += ll;
 	}
 #endif
-	if((options & (LOG_TIMESTAMP|LOG_TIMESTAMP_UTC)) && line_begin) {
-		Time t = (options & LOG_TIMESTAMP_UTC) ? GetUtcTime() : GetSysTime();
-		ll = snprintf(p, 600, "%02d.%02d.%04d %02d:%02d:%02d ",
-		              t.day, t.month, t.year, t.hour, t.minute, t.second);
-		if(ll < 0)
-			return;
-		p += ll;
-	}
-	char *beg = p;
+	if((options & (LOG_TIMESTAMP|LOG_TIMESTAMP_UTC)) && line_begin)
+		p += sLogStamp(p, options & LOG_TIMESTAMP_UTC);
+	prefix = int(p - h);
 	for(int q = min(depth, 99); q--;)
 		*p++ = '\t';
 	line_begin = len && s[len - 1] == '\n';
 	memcpy(p, s, len);
 	p += len;
 	*p = '\0';
-	int count = (int)(p - h);
-	if(count == 0) return;
+	return int(p - h);
+}
+
+void LogOut::FileWrite(const char *s, int count)
+{
+	if(batching) {
+		if(batch_len + count > (int)sizeof(batch))
+			FlushFile();
+		memcpy(batch + batch_len, s, count);
+		batch_len += count;
+		return;
+	}
+#ifdef PLATFORM_WIN32
+	if(hfile != INVALID_HANDLE_VALUE) {
+		dword n;
+		WriteFile(hfile, s, count, &n, NULL);
+	}
+#else
+	if(hfile >= 0)
+		IGNORE_RESULT(
+			write(hfile, s, count)
+		);
+#endif
+}
+
+void LogOut::FlushFile()
+{
+	if(batch_len) {
+		bool b = batching;
+		batching = false;
+		FileWrite(batch, batch_len);
+		batching = b;
+		batch_len = 0;
+	}
+}
+
+void LogOut::Out(const char *h, int count, int prefix)
+{
+	const char *beg = h + prefix; // h is zero terminated
 	if(options & LOG_COUT)
 		for(const char *s = beg; *s; s++)
 			putchar(*s);
@@ -209,30 +397,86 @@ void LogOut::Line(const char *s, int len, int depth)
 		Cout().Put(h, count);
 	if(options & LOG_CERRW)
 		Cerr().Put(h, count);
-#ifdef PLATFORM_WIN32
 	if(options & LOG_FILE)
-		if(hfile != INVALID_HANDLE_VALUE) {
-			dword n;
-			WriteFile(hfile, h, count, &n, NULL);
-		}
-	if(options & LOG_DBG) {
-		*p = 0;
+		FileWrite(h, count);
+#ifdef PLATFORM_WIN32
+	if(options & LOG_DBG)
 		::OutputDebugString((LPCSTR)h);
-	}
 #else
-	if(options & LOG_FILE)
-		if(hfile >= 0)
-			IGNORE_RESULT(
-				write(hfile, h, count)
-			);
 	if(options & LOG_DBG)
 		Cerr().Put(h, count);
 	if(options & LOG_SYS)
 		syslog(LOG_INFO|LOG_USER, "%s", beg);
 #endif
 	filesize += count;
-	if(sizelimit > 0 && filesize > sizelimit)
-		Create(false);
+	if(sizelimit > 0 && filesize > sizelimit || rotate_at && (int64)time(NULL) >= rotate_at)
+		Rotate();
+}
+
+void LogOut::Drain()
+{
+	batching = true;
+	for(LogRing *r = sLogRings.load(std::memory_order_acquire); r; r = r->next) {
+		dword pos = r->tail.load(std::memory_order_relaxed);
+		dword end = r->head.load(std::memory_order_acquire);
+		while(pos != end) {
+			word hdr[2];
+			char h[1200];
+			r->Read(pos, hdr, LogRing::HEADER);
+			r->Read(pos + LogRing::HEADER, h, hdr[0]);
+			h[hdr[0]] = '\0';
+			Out(h, hdr[0], hdr[1]);
+			pos += LogRing::HEADER + hdr[0];
+			r->tail.store(pos, std::memory_order_release);
+		}
+	}
+	int64 dropped = sLogDropped;
+	if(dropped != dropped_reported) {
+		char h[100];
+		int n = snprintf(h, 100, "*** %lld log lines dropped\n", (long long)(dropped - dropped_reported));
+		dropped_reported = dropped;
+		Out(h, n, 0);
+	}
+	FlushFile();
+	batching = false;
+}
+
+void LogOut::Line(const char *s, int len, int depth)
+{
+	char h[1200]; // 2 * 600 to make snprintf easier
+	int  prefix;
+	if((options & LOG_ASYNC) && sLogWriterRunning && !sLogWriter && !IsPanicMode()) {
+		LogThread& t = sLogThread;
+		int count = Format(h, s, len, depth, t.line_begin, prefix);
+		if(count == 0)
+			return;
+		if(!t.ring)
+			t.ring = sGetLogRing();
+		while(!t.ring->Put(h, count, prefix)) {
+			if(options & LOG_ASYNC_DROP) {
+				sLogDropped++;
+				return;
+			}
+			if(!sLogWriterRunning) {
+				Mutex::Lock __(log_mutex);
+				Drain();
+				Out(h, count, prefix);
+				return;
+			}
+			sWakeLogWriter();
+			Sleep(1);
+		}
+		if(t.ring->GetUsed() > LogRing::SIZE / 2)
+			sWakeLogWriter();
+		return;
+	}
+
+	Mutex::Lock __(log_mutex);
+	if(options & LOG_ASYNC)
+		Drain(); // keep the order with lines already buffered (panic, writer thread)
+	int count = Format(h, s, len, depth, line_begin, prefix);
+	if(count)
+		Out(h, count, prefix);
 }
 
 #ifdef PLATFORM_POSIX
@@ -394,24 +638,76 @@ LogStream& StdLogStream()
 
 void CloseStdLog()
 {
+	StdLogFlush();
 	StdLogStream().Close();
 }
 
 void ReopenLog()
 {
+	Mutex::Lock __(log_mutex);
 	if(sLog.IsOpen()) {
 		sLog.Close();
 		sLog.Create();
 	}
 }
 
-void StdLogSetup(dword options, const char *filepath, int filesize_limit)
+static void sStartLogWriter()
+{
+	if(sLogWriterRunning)
+		return;
+	sLogWriterStop = false;
+	sLogWriterRunning = true;
+	Thread::Start([] {
+		sLogWriter = true;
+		while(!sLogWriterStop) {
+			sLogWake().Wait(50);
+			sLogWakePending = false;
+			Mutex::Lock __(log_mutex);
+			sLog.Drain();
+		}
+		sLogWriterDone().Release();
+	}, true);
+}
+
+static void sStopLogWriter()
+{
+	if(!sLogWriterRunning)
+		return;
+	sLogWriterRunning = false;
+	sLogWriterStop = true;
+	sLogWake().Release();
+	sLogWriterDone().Wait();
+	StdLogFlush();
+}
+
+EXITBLOCK {
+	sStopLogWriter();
+}
+
+void StdLogFlush()
 {
+	Mutex::Lock __(log_mutex);
+	sLog.Drain();
+}
+
+int64 GetStdLogDropped()
+{
+	return sLogDropped;
+}
+
+void StdLogSetup(dword options, const char *filepath, int filesize_limit, int rotate_interval)
+{
+	StdLogFlush();
 	sLog.options = options;
 	sLog.sizelimit = filesize_limit;
+	sLog.rotate_interval = rotate_interval;
 	if(filepath)
 		strcpy(sLog.filepath, filepath);
 	ReopenLog();
+	if(options & LOG_ASYNC)
+		sStartLogWriter();
+	else
+		sStopLogWriter();
 }
 
 String GetStdLogPath()
@@ -0,0 +1,287 @@
+#include "Core.h"
+
+namespace Upp {
+
+#ifndef PLATFORM_POSIX
+int64 tmGetTimeNs()
+{
+	static int64 freq;
+	ONCELOCK {
+		LARGE_INTEGER f;
+		QueryPerformanceFrequency(&f);
+		freq = f.QuadPart;
+	}
+	LARGE_INTEGER t;
+	QueryPerformanceCounter(&t);
+	return t.QuadPart / freq * 1000000000 + t.QuadPart % freq * 1000000000 / freq;
+}
+#endif
+
+int GetProfileThreadIndex()
+{
+	static std::atomic<int> count;
+	static thread_local int index;
+	if(!index)
+		index = ++count;
+	return index;
+}
+
+int TimingHistogram::Bucket(int64 ns)
+{
+	if(ns < SUB)
+		return (int)max(ns, (int64)0);
+	int e = SignificantBits64(ns) - 1; // ns >= 1 << e, e >= SHIFT
+	return (e - SHIFT + 1) * SUB + int((ns >> (e - SHIFT)) & (SUB - 1));
+}
+
+int64 TimingHistogram::Lower(int i)
+{
+	if(i < SUB)
+		return i;
+	return (int64)(SUB + i % SUB) << (i / SUB - 1);
+}
+
+void TimingHistogram::Add(int64 ns)
+{
+	bucket[Bucket(ns)]++;
+	if(count++ == 0)
+		min_time = max_time = ns;
+	else {
+		min_time = min((int64)min_time, ns);
+		max_time = max((int64)max_time, ns);
+	}
+}
+
+void TimingHistogram::Merge(const TimingHistogram& h)
+{
+	int64 n = h.count; // h can be updated meanwhile, buckets then can be ahead of count
+	if(n == 0)
+		return;
+	for(int i = 0; i < COUNT; i++)
+		bucket[i] += h.bucket[i];
+	min_time = count ? min((int64)min_time, (int64)h.min_time) : (int64)h.min_time;
+	max_time = count ? max((int64)max_time, (int64)h.max_time) : (int64)h.max_time;
+	count += n;
+}
+
+void TimingHistogram::Clear()
+{
+	for(int i = 0; i < COUNT; i++)
+		bucket[i] = 0;
+	count = 0;
+	min_time = max_time = 0;
+}
+
+int64 TimingHistogram::GetPercentile(double p) const
+{
+	int64 n = count;
+	if(n == 0)
+		return 0;
+	int64 rank = min(n - 1, (int64)(p * n));
+	for(int i = 0; i < COUNT - 1; i++) {
+		rank -= bucket[i];
+		if(rank < 0) // middle of the bucket
+			return minmax((Lower(i) + Lower(i + 1)) / 2, (int64)min_time, (int64)max_time);
+	}
+	return max_time;
+}
+
+// Events are stored to chunks allocated by MemoryAllocPermanent and kept in free list when
+// trace is restarted, so events of finished threads stay available for export and recording
+// thread never has to lock, except when it needs a new chunk.
+
+struct TraceEvent__ {
+	const char *name;
+	int64       begin;
+	int64       end;
+};
+
+struct TraceChunk__ {
+	enum { N = 4096 };
+
+	TraceChunk__     *next;
+	std::atomic<int>  count;
+	TraceEvent__      event[N];
+};
+
+struct TraceBuffer__ {
+	TraceBuffer__              *next;
+	int                         thread;
+	char                        name[32];
+	int64                       generation;
+	int64                       count;
+	std::atomic<TraceChunk__ *> first;
+	TraceChunk__               *last;
+};
+
+std::atomic<bool> trace_active__;
+
+static StaticMutex                    sTraceLock;
+static std::atomic<TraceBuffer__ *>   sTraceBuffers;
+static TraceChunk__                  *sTraceFree;
+static std::atomic<int64>             sTraceGeneration;
+static std::atomic<int64>             sTraceDropped;
+static int64                          sTraceStart;
+static int64                          sTraceMax;
+static thread_local TraceBuffer__    *sTraceBuffer;
+static thread_local char              sTraceThreadName[32];
+
+static TraceChunk__ *sTraceNewChunk()
+{
+	Mutex::Lock __(sTraceLock);
+	TraceChunk__ *c = sTraceFree;
+	if(c)
+		sTraceFree = c->next;
+	else
+		c = new(MemoryAllocPermanent(sizeof(TraceChunk__))) TraceChunk__;
+	c->next = NULL;
+	c->count = 0;
+	return c;
+}
+
+static void sTraceSetName(TraceBuffer__& b)
+{
+	if(*sTraceThreadName)
+		strcpy(b.name, sTraceThreadName);
+	else
+		snprintf(b.name, sizeof(b.name), Thread::IsMain() ? "Main" : "Thread #%d", b.thread);
+}
+
+void TraceThreadName(const char *name)
+{
+	strncpy(sTraceThreadName, name, sizeof(sTraceThreadName) - 1);
+	if(sTraceBuffer)
+		sTraceSetName(*sTraceBuffer);
+}
+
+void TraceZone(const char *name, int64 begin, int64 end)
+{
+	TraceBuffer__ *b = sTraceBuffer;
+	if(!b) {
+		b = new(MemoryAllocPermanent(sizeof(TraceBuffer__))) TraceBuffer__;
+		b->thread = GetProfileThreadIndex();
+		sTraceSetName(*b);
+		b->generation = -1;
+		b->first = NULL;
+		b->next = sTraceBuffers.load();
+		while(!sTraceBuffers.compare_exchange_weak(b->next, b))
+			;
+		sTraceBuffer = b;
+	}
+	int64 generation = sTraceGeneration.load(std::memory_order_acquire);
+	if(b->generation != generation) { // chunks were released by StartTrace
+		b->generation = generation;
+		b->count = 0;
+		b->last = NULL;
+	}
+	if(b->count >= sTraceMax) {
+		sTraceDropped++;
+		return;
+	}
+	TraceChunk__ *c = b->last;
+	if(!c || c->count.load(std::memory_order_relaxed) == TraceChunk__::N) {
+		TraceChunk__ *n = sTraceNewChunk();
+		if(c)
+			c->next = n;
+		else
+			b->first.store(n, std::memory_order_release);
+		b->last = c = n;
+	}
+	int i = c->count.load(std::memory_order_relaxed);
+	TraceEvent__& e = c->event[i];
+	e.name = name;
+	e.begin = begin;
+	e.end = end;
+	c->count.store(i + 1, std::memory_order_release);
+	b->count++;
+}
+
+void StartTrace(int max_events_per_thread)
+{
+	Mutex::Lock __(sTraceLock);
+	trace_active__ = false;
+	for(TraceBuffer__ *b = sTraceBuffers; b; b = b->next) {
+		TraceChunk__ *c = b->first.exchange(NULL);
+		while(c) {
+			TraceChunk__ *n = c->next;
+			c->next = sTraceFree;
+			sTraceFree = c;
+			c = n;
+		}
+	}
+	sTraceMax = max_events_per_thread;
+	sTraceDropped = 0;
+	sTraceStart = tmGetTimeNs();
+	sTraceGeneration++;
+	trace_active__ = true;
+}
+
+void StopTrace()
+{
+	trace_active__ = false;
+}
+
+template <class F>
+static void sTraceEvents(F fn)
+{
+	for(TraceBuffer__ *b = sTraceBuffers; b; b = b->next)
+		for(TraceChunk__ *c = b->first.load(std::memory_order_acquire); c; c = c->next) {
+			int n = c->count.load(std::memory_order_acquire);
+			for(int i = 0; i < n; i++)
+				fn(*b, c->event[i]);
+		}
+}
+
+int64 GetTraceEventCount()
+{
+	Mutex::Lock __(sTraceLock);
+	int64 n = 0;
+	sTraceEvents([&](const TraceBuffer__&, const TraceEvent__&) { n++; });
+	return n;
+}
+
+int64 GetTraceDropped()
+{
+	return sTraceDropped;
+}
+
+String GetTraceJson()
+{
+	Mutex::Lock __(sTraceLock);
+	StringBuffer r;
+	r << "{\"traceEvents\":[";
+	bool next = false;
+	auto Sep = [&] {
+		if(next)
+			r << ",\n";
+		next = true;
+	};
+	for(TraceBuffer__ *b = sTraceBuffers; b; b = b->next)
+		if(b->first) {
+			Sep();
+			r << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << b->thread
+			  << ",\"args\":{\"name\":" << AsJSON(b->name) << "}}";
+		}
+	const char *name = NULL;
+	String json_name;
+	sTraceEvents([&](const TraceBuffer__& b, const TraceEvent__& e) {
+		if(e.name != name) {
+			name = e.name;
+			json_name = AsJSON(name);
+		}
+		Sep();
+		char h[200];
+		snprintf(h, 200, ",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+		         b.thread, 0.001 * (e.begin - sTraceStart), 0.001 * (e.end - e.begin));
+		r << "{\"name\":" << json_name << h;
+	});
+	r << "],\"displayTimeUnit\":\"ns\"}\n";
+	return String(r);
+}
+
+bool SaveTrace(const char *path)
+{
+	return SaveFile(path, GetTraceJson());
+}
+
+}
@@ -10,49 +10,145 @@ inline int tmGetTime() {
 }
 #endif
 
+#ifdef PLATFORM_POSIX
+inline int64 tmGetTimeNs() { // monotonic nanoseconds
+	timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (int64)t.tv_sec * 1000000000 + t.tv_nsec;
+}
+#else
+int64 tmGetTimeNs();
+#endif
+
+int    GetProfileThreadIndex(); // 1, 2, 3... in order of first use
+
+template <class T>
+class RelaxedAtomic { // written by single thread, read by any thread; plain load / store on common CPUs
+	std::atomic<T> v;
+
+public:
+	operator T() const                           { return v.load(std::memory_order_relaxed); }
+	T    operator=(T x)                          { v.store(x, std::memory_order_relaxed); return x; }
+	void operator+=(T x)                         { *this = *this + x; } // not atomic with other writers
+	T    operator++(int)                         { T x = *this; *this = x + 1; return x; }
+
+	void operator=(const RelaxedAtomic& a)       { *this = (T)a; }
+	RelaxedAtomic(const RelaxedAtomic& a)        { *this = (T)a; }
+	RelaxedAtomic()                              {}
+};
+
+class TimingHistogram { // log-linear buckets of nanoseconds, 8 per power of two
+public:
+	enum { SHIFT = 3, SUB = 1 << SHIFT, COUNT = 64 * SUB };
+
+private:
+	RelaxedAtomic<int64> bucket[COUNT];
+	RelaxedAtomic<int64> count;
+	RelaxedAtomic<int64> min_time;
+	RelaxedAtomic<int64> max_time;
+
+	static int   Bucket(int64 ns);
+	static int64 Lower(int i);
+
+public:
+	void  Add(int64 ns); // single writer, can be read or merged by other threads meanwhile
+	void  Merge(const TimingHistogram& h);
+	void  Clear();
+
+	int64 GetCount() const                       { return count; }
+	int64 GetMin() const                         { return min_time; }
+	int64 GetMax() const                         { return max_time; }
+	int64 GetPercentile(double p) const; // p in 0..1, result in ns
+
+	TimingHistogram()                            { Clear(); }
+};
+
 class TimingInspector {
+public:
+	struct Slot { // statistics of single thread, updated without locking, read by Dump etc.
+		Slot                 *next;
+		int                   thread;
+		int                   nesting;
+		RelaxedAtomic<int>    max_nesting;
+		RelaxedAtomic<int64>  call_count;
+		RelaxedAtomic<int64>  all_count;
+		RelaxedAtomic<int64>  total_time; // ns
+		RelaxedAtomic<int64>  min_time;
+		RelaxedAtomic<int64>  max_time;
+		TimingHistogram       histogram;
+	};
+
 protected:
 	static bool active;
 
 	const char *name;
-	int         call_count;
-	dword       total_time;
-	dword       min_time;
-	dword       max_time;
-	int         max_nesting;
-	int         all_count;
+	Slot       *slots;
 	StaticMutex mutex;
 
 public:
 	TimingInspector(const char *name = NULL); // Not String !!!
 	~TimingInspector();
 
-	void   Add(dword time, int nesting);
+	Slot  *NewSlot();
+	void   Add(Slot& slot, int64 start_time, int64 end_time);
+
+	int64           GetCallCount();
+	int64           GetTotalTime(); // ns
+	TimingHistogram GetHistogram();
 
 	String Dump();
 
 	class Routine {
 	public:
-		Routine(TimingInspector& stat, int& nesting)
-		: nesting(nesting), stat(stat) {
-			start_time = tmGetTime();
-			nesting++;
+		Routine(TimingInspector& stat, Slot *& slot_)
+		: stat(stat) {
+			if(!slot_)
+				slot_ = stat.NewSlot();
+			slot = slot_;
+			slot->nesting++;
+			start_time = tmGetTimeNs();
 		}
 
 		~Routine() {
-			nesting--;
-			stat.Add(start_time, nesting);
+			int64 end_time = tmGetTimeNs();
+			slot->nesting--;
+			stat.Add(*slot, start_time, end_time);
 		}
 
 	protected:
-		dword start_time;
-		int& nesting;
+		int64            start_time;
+		Slot            *slot;
 		TimingInspector& stat;
 	};
 
 	static void Activate(bool b)                    { active = b; }
 };
 
+// Trace of zones (RTIMING, RZONE, CoWork jobs) exportable to Chrome Trace Event format
+// (chrome://tracing, https://ui.perfetto.dev). Events are recorded to per-thread buffers.
+
+extern std::atomic<bool> trace_active__;
+
+inline bool IsTracing()                             { return trace_active__.load(std::memory_order_relaxed); }
+
+void   StartTrace(int max_events_per_thread = 1000000); // clears events, must not run concurrently with zones
+void   StopTrace();
+void   TraceZone(const char *name, int64 begin_ns, int64 end_ns); // name must be static
+void   TraceThreadName(const char *name);
+int64  GetTraceEventCount();
+int64  GetTraceDropped();
+String GetTraceJson();
+bool   SaveTrace(const char *path);
+
+class TraceScope {
+	const char *name;
+	int64       begin;
+
+public:
+	TraceScope(const char *name) : name(name) { begin = IsTracing() ? tmGetTimeNs() : 0; }
+	~TraceScope()                             { if(begin) TraceZone(name, begin, tmGetTimeNs()); }
+};
+
 class HitCountInspector
 {
 public:
@@ -71,8 +167,10 @@ private:
 
 #define RTIMING(x) \
 	static UPP::TimingInspector COMBINE(sTmStat, __LINE__)(x); \
-	static thread_local int COMBINE(sTmStatNesting, __LINE__); \
-	UPP::TimingInspector::Routine COMBINE(sTmStatR, __LINE__)(COMBINE(sTmStat, __LINE__), COMBINE(sTmStatNesting, __LINE__))
+	static thread_local UPP::TimingInspector::Slot *COMBINE(sTmStatSlot, __LINE__); \
+	UPP::TimingInspector::Routine COMBINE(sTmStatR, __LINE__)(COMBINE(sTmStat, __LINE__), COMBINE(sTmStatSlot, __LINE__))
+
+#define RZONE(x)              UPP::TraceScope COMBINE(sTrZone, __LINE__)(x)
 
 #define RACTIVATE_TIMING()    TimingInspector::Activate(true);
 #define RDEACTIVATE_TIMING()  TimingInspector::Activate(false);
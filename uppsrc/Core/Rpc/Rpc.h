@@ -269,6 +269,20 @@ struct RpcError {
 void   SetRpcMethodFilter(String (*filter)(const String& methodname));
 bool   RpcPerform(TcpSocket& http, const char *group);
 bool   RpcServerLoop(int port, const char *group = NULL);
+bool   CoRpcPerform(TcpSocket& http, const char *group);
+bool   CoRpcServerLoop(int port, const char *group = NULL, int max_requests = 256);
+
+struct RpcMethodStats : Moveable<RpcMethodStats> {
+	int64 count = 0;
+	int64 errors = 0;
+	int64 time = 0; // in microseconds
+	int64 max_time = 0;
+
+	String ToString() const;
+};
+
+VectorMap<String, RpcMethodStats> GetRpcMethodStats();
+void   ResetRpcMethodStats();
 
 void   ThrowRpcError(int code, const char *s);
 void   ThrowRpcError(const char *s);
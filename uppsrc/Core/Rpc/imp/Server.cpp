@@ -73,6 +73,43 @@ void SuppressRpcServerTraceForMethodCall()
 	rpc_trace = NULL;
 }
 
+static StaticMutex RpcStatsMutex;
+
+static VectorMap<String, RpcMethodStats>& sRpcStats()
+{
+	static VectorMap<String, RpcMethodStats> x;
+	return x;
+}
+
+static void AddRpcStats(const String& methodname, int64 time, bool error)
+{
+	Mutex::Lock __(RpcStatsMutex);
+	RpcMethodStats& m = sRpcStats().GetAdd(methodname);
+	m.count++;
+	m.errors += error;
+	m.time += time;
+	m.max_time = max(m.max_time, time);
+}
+
+String RpcMethodStats::ToString() const
+{
+	return Format("%d calls, %d errors, total %.3f ms, avg %.3f ms, max %.3f ms",
+	              count, errors, time / 1000.0, count ? time / 1000.0 / count : 0.0,
+	              max_time / 1000.0);
+}
+
+VectorMap<String, RpcMethodStats> GetRpcMethodStats()
+{
+	Mutex::Lock __(RpcStatsMutex);
+	return clone(sRpcStats());
+}
+
+void ResetRpcMethodStats()
+{
+	Mutex::Lock __(RpcStatsMutex);
+	sRpcStats().Clear();
+}
+
 bool CallRpcMethod(RpcData& data, const char *group, String methodname, const String& request)
 {
 	LLOG("method name: " << methodname);
@@ -89,7 +126,15 @@ bool CallRpcMethod(RpcData& data, const char *group, String methodname, const St
 	void (*fn)(RpcData&) = RpcMapGet(group, methodname);
 	if(!fn)
 		return false;
-	(*fn)(data);
+	int64 t0 = usecs();
+	try {
+		(*fn)(data);
+	}
+	catch(...) {
+		AddRpcStats(methodname, usecs(t0), true);
+		throw;
+	}
+	AddRpcStats(methodname, usecs(t0), false);
 	return true;
 }
 
@@ -102,23 +147,25 @@ struct XmlRpcDo {
 	Value      id;
 	bool       json;
 	bool       shorted;
+	bool       parallel;
 
 	String XmlResult();
 	String DoXmlRpc();
 	String JsonRpcError(int code, const char *text, const Value& id);
 	String JsonResult();
 	String ProcessJsonRpc(const Value& v);
+	String ProcessJsonRpcBatch(const Value& v);
 	String DoJsonRpc();
 	String RpcExecute();
 	void   RpcResponse(const String& r);
 	void   EndRpc();
 	bool   Perform();
 	
-	XmlRpcDo(TcpSocket& http, const char *group);
+	XmlRpcDo(TcpSocket& http, const char *group, bool parallel = false);
 };
 
-XmlRpcDo::XmlRpcDo(TcpSocket& http, const char *group)
-:	http(http), group(group)
+XmlRpcDo::XmlRpcDo(TcpSocket& http, const char *group, bool parallel)
+:	http(http), group(group), parallel(parallel)
 {
 	shorted = false;
 }
@@ -224,6 +271,11 @@ String XmlRpcDo::ProcessJsonRpc(const Value& v)
 	id = v["id"];
 	methodname = AsString(v["method"]);
 	Value param = v["params"];
+	data.ii = 0;
+	data.in.Clear();
+	data.in_map.Clear();
+	data.out.Clear();
+	data.out_map.Clear();
 	if(param.Is<ValueMap>())
 		data.in_map = param;
 	else
@@ -250,18 +302,40 @@ String XmlRpcDo::ProcessJsonRpc(const Value& v)
 	}
 }
 
+String XmlRpcDo::ProcessJsonRpcBatch(const Value& v)
+{
+	int n = v.GetCount();
+	if(n == 0)
+		return String();
+	Vector<String> r;
+	if(parallel && n > 1 && !rpc_trace) { // trace output would get interleaved
+		r.SetCount(n);
+		CoFor(n, [&](int i) {
+			XmlRpcDo h(http, group);
+			h.request = request;
+			h.json = true;
+			h.shorted = true; // EndRpc is not available for batch items
+			h.data.peeraddr = data.peeraddr;
+			r[i] = h.ProcessJsonRpc(v[i]);
+		});
+	}
+	else
+		for(int i = 0; i < n; i++)
+			r.Add(ProcessJsonRpc(v[i]));
+	JsonArray a;
+	for(const String& s : r)
+		a.CatRaw(s);
+	return ~a;
+}
+
 String XmlRpcDo::DoJsonRpc()
 {
 	try {
 		Value v = ParseJSON(request);
 		if(v.Is<ValueMap>())
 			return ProcessJsonRpc(v);
-		if(v.Is<ValueArray>()) {
-			JsonArray a;
-			for(int i = 0; i < v.GetCount(); i++)
-				a.CatRaw(ProcessJsonRpc(v[i]));
-			return v.GetCount() ? ~a : String();
-		}
+		if(v.Is<ValueArray>())
+			return ProcessJsonRpcBatch(v);
 	}
 	catch(CParser::Error e) {}	
 	return AsJSON(JsonRpcError(RPC_SERVER_JSON_ERROR, "Parse error", Null));
@@ -306,19 +380,18 @@ String XmlRpcDo::RpcExecute()
 void XmlRpcDo::RpcResponse(const String& r)
 {
 	LLOG("--------- Server response:\n" << r << "=============");
-	String response;
-	String ts = WwwFormat(GetUtcTime());
-	response <<
+	if(r.IsEmpty())
+		return;
+	String hdr;
+	hdr <<
 		"HTTP/1.0 200 OK\r\n"
-		"Date: " << ts << "\r\n"
+		"Date: " << WwwFormat(GetUtcTime()) << "\r\n"
 		"Server: U++ RPC server\r\n"
 		"Content-Length: " << r.GetCount() << "\r\n"
 		"Connection: close\r\n"
-		"Content-Type: application/" << (json ? "json" : "xml") << "\r\n\r\n"
-		<< r;
-	LLOG(response);
-	if(r.GetCount())
-		http.Put(response);
+		"Content-Type: application/" << (json ? "json" : "xml") << "\r\n\r\n";
+	LLOG(hdr);
+	http.PutAll(hdr, r); // single gathered write, the body is not copied
 }
 
 void XmlRpcDo::EndRpc()
@@ -360,6 +433,11 @@ bool RpcPerform(TcpSocket& http, const char *group)
 	return XmlRpcDo(http, group).Perform();
 }
 
+bool CoRpcPerform(TcpSocket& http, const char *group)
+{
+	return XmlRpcDo(http, group, true).Perform();
+}
+
 String RpcExecuteShorted(const String& request_)
 {
 	HttpRequest dummy;
@@ -382,4 +460,32 @@ bool RpcServerLoop(int port, const char *group)
 	}
 }
 
+bool CoRpcServerLoop(int port, const char *group, int max_requests)
+{
+	TcpSocket rpc;
+	if(!rpc.Listen(port, 64))
+		return false;
+	String g = group;
+	Atomic pending(0);
+	CoWork co;
+	while(!Thread::IsShutdownThreads()) {
+		One<TcpSocket> http;
+		http.Create();
+		http->Timeout(500); // to check for shutdown
+		if(!http->Accept(rpc))
+			continue;
+		http->Blocking();
+		if(pending >= max_requests) // too many requests in progress, serve inline and stop accepting meanwhile
+			CoRpcPerform(*http, g);
+		else {
+			pending++;
+			co & [=, &pending, http = pick(http)]() mutable {
+				CoRpcPerform(*http, g);
+				pending--;
+			};
+		}
+	}
+	return true;
+}
+
 }
@@ -9,9 +9,6 @@ namespace Upp {
  * clean-up.
  */
 
-// DBL_INT_ADD treats two unsigned ints a and b as one 64-bit integer and adds
-// c to it
-#define DBL_INT_ADD(a,b,c) if (a > 0xffffffff - (c)) ++b; a += c;
 #define ROTLEFT(a,b) (((a) << (b)) | ((a) >> (32-(b))))
 #define ROTRIGHT(a,b) (((a) >> (b)) | ((a) << (32-(b))))
 
@@ -24,10 +21,10 @@ namespace Upp {
 
 struct SHA256_CTX
 {
-   byte  data[64];
-   dword datalen;
-   dword bitlen[2];
-   dword state[8];
+   byte   data[64];
+   dword  datalen;
+   uint64 bitlen;
+   dword  state[8];
 };
 
 dword k[64] =
@@ -45,7 +42,11 @@ dword k[64] =
 	0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
 };
 
-static void sha256_transform(SHA256_CTX *ctx, const byte *data)
+static const dword sha256_h0[8] = {
+	0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+static void sha256_transform(dword *state, const byte *data)
 {
 	dword a, b, c, d, e, f, g, h, i, j, t1, t2, m[64];
 	
@@ -54,14 +55,14 @@ static void sha256_transform(SHA256_CTX *ctx, const byte *data)
 	for (; i < 64; ++i)
 		m[i] = SIG1(m[i-2]) + m[i-7] + SIG0(m[i-15]) + m[i-16];
 
-	a = ctx->state[0];
-	b = ctx->state[1];
-	c = ctx->state[2];
-	d = ctx->state[3];
-	e = ctx->state[4];
-	f = ctx->state[5];
-	g = ctx->state[6];
-	h = ctx->state[7];
+	a = state[0];
+	b = state[1];
+	c = state[2];
+	d = state[3];
+	e = state[4];
+	f = state[5];
+	g = state[6];
+	h = state[7];
  
 	for (i = 0; i < 64; ++i)
 	{
@@ -77,96 +78,221 @@ static void sha256_transform(SHA256_CTX *ctx, const byte *data)
 		a = t1 + t2;
 	}
  
-	ctx->state[0] += a;
-	ctx->state[1] += b;
-	ctx->state[2] += c;
-	ctx->state[3] += d;
-	ctx->state[4] += e;
-	ctx->state[5] += f;
-	ctx->state[6] += g;
-	ctx->state[7] += h;
+	state[0] += a;
+	state[1] += b;
+	state[2] += c;
+	state[3] += d;
+	state[4] += e;
+	state[5] += f;
+	state[6] += g;
+	state[7] += h;
 }
 
-static void sha256_init(SHA256_CTX *ctx)
+#if defined(CPU_X86) && (defined(COMPILER_GCC) || defined(COMPILER_MSC))
+#define SHA256_X86 1
+
+#ifdef COMPILER_GCC
+#define SHA256_TARGET(x) __attribute__((target(x)))
+#else
+#define SHA256_TARGET(x)
+#endif
+
+// Intel SHA extensions, state is kept as ABEF / CDGH pairs required by sha256rnds2
+SHA256_TARGET("sse4.1,ssse3,sha")
+static void sha256_blocks_shani(dword *state, const byte *data, size_t n)
 {
-	ctx->datalen = 0;
-	ctx->bitlen[0] = 0;
-	ctx->bitlen[1] = 0;
-	ctx->state[0] = 0x6a09e667;
-	ctx->state[1] = 0xbb67ae85;
-	ctx->state[2] = 0x3c6ef372;
-	ctx->state[3] = 0xa54ff53a;
-	ctx->state[4] = 0x510e527f;
-	ctx->state[5] = 0x9b05688c;
-	ctx->state[6] = 0x1f83d9ab;
-	ctx->state[7] = 0x5be0cd19;
+	const __m128i MASK = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+	__m128i tmp = _mm_loadu_si128((const __m128i *)&state[0]);
+	__m128i state1 = _mm_loadu_si128((const __m128i *)&state[4]);
+	tmp = _mm_shuffle_epi32(tmp, 0xB1);              // CDAB
+	state1 = _mm_shuffle_epi32(state1, 0x1B);        // EFGH
+	__m128i state0 = _mm_alignr_epi8(tmp, state1, 8); // ABEF
+	state1 = _mm_blend_epi16(state1, tmp, 0xF0);      // CDGH
+
+	while(n--) {
+		__m128i abef = state0;
+		__m128i cdgh = state1;
+		__m128i w[4];
+#ifdef COMPILER_GCC
+		#pragma GCC unroll 16
+#endif
+		for(int g = 0; g < 16; g++) { // 4 rounds per step
+			__m128i& wg = w[g & 3];
+			if(g < 4)
+				wg = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 16 * g)), MASK);
+			__m128i msg = _mm_add_epi32(wg, _mm_loadu_si128((const __m128i *)&k[4 * g]));
+			state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+			if(g >= 3 && g <= 14) {
+				__m128i& wn = w[(g + 1) & 3];
+				wn = _mm_add_epi32(wn, _mm_alignr_epi8(wg, w[(g - 1) & 3], 4));
+				wn = _mm_sha256msg2_epu32(wn, wg);
+			}
+			msg = _mm_shuffle_epi32(msg, 0x0E);
+			state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+			if(g >= 1 && g <= 12)
+				w[(g - 1) & 3] = _mm_sha256msg1_epu32(w[(g - 1) & 3], wg);
+		}
+		state0 = _mm_add_epi32(state0, abef);
+		state1 = _mm_add_epi32(state1, cdgh);
+		data += 64;
+	}
+
+	tmp = _mm_shuffle_epi32(state0, 0x1B);      // FEBA
+	state1 = _mm_shuffle_epi32(state1, 0xB1);   // DCHG
+	state0 = _mm_blend_epi16(tmp, state1, 0xF0); // DCBA
+	state1 = _mm_alignr_epi8(state1, tmp, 8);    // ABEF
+	_mm_storeu_si128((__m128i *)&state[0], state0);
+	_mm_storeu_si128((__m128i *)&state[4], state1);
 }
 
-static void sha256_update(SHA256_CTX *ctx, const byte *data, dword len)
+// 8 independent messages in AVX2 lanes, block[i] == NULL means the lane is idle
+SHA256_TARGET("avx2")
+static void sha256_transform_x8(dword (*state)[8], const byte *const *block)
 {
-	dword i;
- 
-	for (i=0; i < len; ++i)
-	{
-		ctx->data[ctx->datalen] = data[i];
-		ctx->datalen++;
-		if (ctx->datalen == 64)
-		{
-			sha256_transform(ctx,ctx->data);
-			DBL_INT_ADD(ctx->bitlen[0],ctx->bitlen[1],512);
-			ctx->datalen = 0;
+	static const byte zero[64] = { 0 };
+	const byte *p[8];
+	for(int i = 0; i < 8; i++)
+		p[i] = block[i] ? block[i] : zero;
+
+	#define SHA256_ROR(x, n) _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - (n)))
+
+	__m256i m[16];
+	for(int i = 0; i < 16; i++)
+		m[i] = _mm256_setr_epi32(Peek32be(p[0] + 4 * i), Peek32be(p[1] + 4 * i), Peek32be(p[2] + 4 * i),
+		                         Peek32be(p[3] + 4 * i), Peek32be(p[4] + 4 * i), Peek32be(p[5] + 4 * i),
+		                         Peek32be(p[6] + 4 * i), Peek32be(p[7] + 4 * i));
+
+	__m256i s[8];
+	for(int j = 0; j < 8; j++)
+		s[j] = _mm256_setr_epi32(state[0][j], state[1][j], state[2][j], state[3][j],
+		                         state[4][j], state[5][j], state[6][j], state[7][j]);
+
+	__m256i a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+	for(int i = 0; i < 64; i++) {
+		__m256i w;
+		if(i < 16)
+			w = m[i];
+		else {
+			__m256i w15 = m[(i - 15) & 15];
+			__m256i w2 = m[(i - 2) & 15];
+			__m256i s0 = _mm256_xor_si256(_mm256_xor_si256(SHA256_ROR(w15, 7), SHA256_ROR(w15, 18)),
+			                              _mm256_srli_epi32(w15, 3));
+			__m256i s1 = _mm256_xor_si256(_mm256_xor_si256(SHA256_ROR(w2, 17), SHA256_ROR(w2, 19)),
+			                              _mm256_srli_epi32(w2, 10));
+			w = m[i & 15] = _mm256_add_epi32(_mm256_add_epi32(m[i & 15], s0),
+			                                 _mm256_add_epi32(m[(i - 7) & 15], s1));
 		}
+		__m256i ep1 = _mm256_xor_si256(_mm256_xor_si256(SHA256_ROR(e, 6), SHA256_ROR(e, 11)), SHA256_ROR(e, 25));
+		__m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+		__m256i t1 = _mm256_add_epi32(_mm256_add_epi32(_mm256_add_epi32(h, ep1), ch),
+		                              _mm256_add_epi32(_mm256_set1_epi32(k[i]), w));
+		__m256i ep0 = _mm256_xor_si256(_mm256_xor_si256(SHA256_ROR(a, 2), SHA256_ROR(a, 13)), SHA256_ROR(a, 22));
+		__m256i maj = _mm256_xor_si256(_mm256_xor_si256(_mm256_and_si256(a, b), _mm256_and_si256(a, c)),
+		                               _mm256_and_si256(b, c));
+		__m256i t2 = _mm256_add_epi32(ep0, maj);
+		h = g;
+		g = f;
+		f = e;
+		e = _mm256_add_epi32(d, t1);
+		d = c;
+		c = b;
+		b = a;
+		a = _mm256_add_epi32(t1, t2);
 	}
+	s[0] = _mm256_add_epi32(s[0], a);
+	s[1] = _mm256_add_epi32(s[1], b);
+	s[2] = _mm256_add_epi32(s[2], c);
+	s[3] = _mm256_add_epi32(s[3], d);
+	s[4] = _mm256_add_epi32(s[4], e);
+	s[5] = _mm256_add_epi32(s[5], f);
+	s[6] = _mm256_add_epi32(s[6], g);
+	s[7] = _mm256_add_epi32(s[7], h);
+
+	#undef SHA256_ROR
+
+	alignas(32) dword out[8][8];
+	for(int j = 0; j < 8; j++)
+		_mm256_store_si256((__m256i *)out[j], s[j]);
+	for(int i = 0; i < 8; i++)
+		if(block[i])
+			for(int j = 0; j < 8; j++)
+				state[i][j] = out[j][i];
 }
 
-static void sha256_final(SHA256_CTX *ctx, byte *hash)
+#endif
+
+static void sha256_blocks(dword *state, const byte *data, size_t n)
 {
-	dword i;
- 
-	i = ctx->datalen;
- 
-	// Pad whatever data is left in the buffer.
-	if (ctx->datalen < 56)
-	{
-		ctx->data[i++] = 0x80;
-		while (i < 56)
-			ctx->data[i++] = 0x00;
+#ifdef SHA256_X86
+	if(GetHashAcceleration() & HASH_SHANI) {
+		sha256_blocks_shani(state, data, n);
+		return;
 	}
-	else
-	{
-		ctx->data[i++] = 0x80;
-		while (i < 64)
-			ctx->data[i++] = 0x00;
-		sha256_transform(ctx,ctx->data);
-		memset(ctx->data,0,56);
+#endif
+	while(n--) {
+		sha256_transform(state, data);
+		data += 64;
 	}
- 
-	// Append to the padding the total message's length in bits and transform.
-	DBL_INT_ADD(ctx->bitlen[0],ctx->bitlen[1],ctx->datalen * 8);
-	ctx->data[63] = byte(ctx->bitlen[0]);
-	ctx->data[62] = byte(ctx->bitlen[0] >> 8);
-	ctx->data[61] = byte(ctx->bitlen[0] >> 16);
-	ctx->data[60] = byte(ctx->bitlen[0] >> 24);
-	ctx->data[59] = byte(ctx->bitlen[1]);
-	ctx->data[58] = byte(ctx->bitlen[1] >> 8);
-	ctx->data[57] = byte(ctx->bitlen[1] >> 16);
-	ctx->data[56] = byte(ctx->bitlen[1] >> 24);
-	sha256_transform(ctx,ctx->data);
- 
+}
+
+static void sha256_init(SHA256_CTX *ctx)
+{
+	ctx->datalen = 0;
+	ctx->bitlen = 0;
+	memcpy(ctx->state, sha256_h0, sizeof(ctx->state));
+}
+
+static void sha256_update(SHA256_CTX *ctx, const byte *data, size_t len)
+{
+	ctx->bitlen += 8 * (uint64)len;
+	if(ctx->datalen) {
+		size_t n = min(len, size_t(64 - ctx->datalen));
+		memcpy(ctx->data + ctx->datalen, data, n);
+		ctx->datalen += (dword)n;
+		data += n;
+		len -= n;
+		if(ctx->datalen < 64)
+			return;
+		sha256_blocks(ctx->state, ctx->data, 1);
+		ctx->datalen = 0;
+	}
+	if(len >= 64) {
+		sha256_blocks(ctx->state, data, len / 64);
+		data += len & ~(size_t)63;
+		len &= 63;
+	}
+	memcpy(ctx->data, data, len);
+	ctx->datalen = (dword)len;
+}
+
+// Returns the number (1 or 2) of final blocks with the padding and length
+static int sha256_tail(byte *tail, const byte *data, size_t len, uint64 bitlen)
+{
+	memset(tail, 0, 128);
+	memcpy(tail, data, len);
+	tail[len] = 0x80;
+	int n = len < 56 ? 1 : 2;
+	byte *t = tail + 64 * n - 8;
+	for(int i = 0; i < 8; i++)
+		t[i] = byte(bitlen >> (56 - 8 * i));
+	return n;
+}
+
+static void sha256_hash(const dword *state, byte *hash)
+{
 	// Since this implementation uses little endian byte ordering and SHA uses
 	// big endian, reverse all the bytes when copying the final state to the
 	// output hash.
-	for (i=0; i < 4; ++i)
-	{
-		hash[i]	= (ctx->state[0] >> (24-i*8)) & 0x000000ff;
-		hash[i+4]  = (ctx->state[1] >> (24-i*8)) & 0x000000ff;
-		hash[i+8]  = (ctx->state[2] >> (24-i*8)) & 0x000000ff;
-		hash[i+12] = (ctx->state[3] >> (24-i*8)) & 0x000000ff;
-		hash[i+16] = (ctx->state[4] >> (24-i*8)) & 0x000000ff;
-		hash[i+20] = (ctx->state[5] >> (24-i*8)) & 0x000000ff;
-		hash[i+24] = (ctx->state[6] >> (24-i*8)) & 0x000000ff;
-		hash[i+28] = (ctx->state[7] >> (24-i*8)) & 0x000000ff;
-   }
+	for(int i = 0; i < 8; i++)
+		Poke32be(hash + 4 * i, state[i]);
+}
+
+static void sha256_final(SHA256_CTX *ctx, byte *hash)
+{
+	byte tail[128];
+	sha256_blocks(ctx->state, tail, sha256_tail(tail, ctx->data, ctx->datalen, ctx->bitlen));
+	sha256_hash(ctx->state, hash);
 }
 
 void Sha256Stream::Cleanup()
@@ -252,4 +378,97 @@ String  SHA256StringS(const String& data)
 	return SHA256StringS(~data, data.GetLength());
 }
 
+void SHA256Multi(byte *const *hash32, const void *const *data, const size_t *size, int count)
+{
+#ifdef SHA256_X86
+	if((GetHashAcceleration() & (HASH_AVX2|HASH_SHANI)) == HASH_AVX2 && count > 1) {
+		Buffer<int> order(count); // similar lengths in the same batch keep all lanes busy
+		for(int i = 0; i < count; i++)
+			order[i] = i;
+		Sort(SubRange(~order, count), [&](int a, int b) { return size[a] < size[b]; });
+		for(int q = 0; q < count; q += 8) {
+			int n = min(8, count - q);
+			dword state[8][8];
+			byte tail[8][128];
+			size_t full[8], blocks[8];
+			size_t maxblocks = 0;
+			for(int i = 0; i < n; i++) {
+				int ii = order[q + i];
+				full[i] = size[ii] / 64;
+				blocks[i] = full[i] + sha256_tail(tail[i], (const byte *)data[ii] + 64 * full[i],
+				                                  size[ii] & 63, 8 * (uint64)size[ii]);
+				maxblocks = max(maxblocks, blocks[i]);
+				memcpy(state[i], sha256_h0, sizeof(sha256_h0));
+			}
+			for(size_t b = 0; b < maxblocks; b++) {
+				const byte *block[8];
+				for(int i = 0; i < 8; i++)
+					block[i] = i >= n || b >= blocks[i] ? NULL
+					           : b < full[i] ? (const byte *)data[order[q + i]] + 64 * b
+					           : tail[i] + 64 * (b - full[i]);
+				sha256_transform_x8(state, block);
+			}
+			for(int i = 0; i < n; i++)
+				sha256_hash(state[i], hash32[order[q + i]]);
+		}
+		return;
+	}
+#endif
+	for(int i = 0; i < count; i++) {
+		SHA256_CTX ctx;
+		sha256_init(&ctx);
+		sha256_update(&ctx, (const byte *)data[i], size[i]);
+		sha256_final(&ctx, hash32[i]);
+	}
+}
+
+Vector<String> SHA256Multi(const Vector<String>& data)
+{
+	int n = data.GetCount();
+	Buffer<byte> hash(32 * n);
+	Buffer<byte *> h(n);
+	Buffer<const void *> d(n);
+	Buffer<size_t> sz(n);
+	for(int i = 0; i < n; i++) {
+		h[i] = ~hash + 32 * i;
+		d[i] = ~data[i];
+		sz[i] = data[i].GetCount();
+	}
+	SHA256Multi(h, d, sz, n);
+	Vector<String> r;
+	for(int i = 0; i < n; i++)
+		r.Add(HexString(h[i], 32));
+	return r;
+}
+
+Vector<String> CoSHA256Files(const Vector<String>& path)
+{
+	Vector<String> r;
+	r.SetCount(path.GetCount());
+	CoFor(path.GetCount(), [&](int i) {
+		FileIn in(path[i]);
+		if(!in) {
+			r[i] = String::GetVoid();
+			return;
+		}
+		SHA256_CTX ctx;
+		sha256_init(&ctx);
+		Buffer<byte> buffer(1024 * 1024);
+		for(;;) {
+			int n = in.Get(buffer, 1024 * 1024);
+			if(n <= 0)
+				break;
+			sha256_update(&ctx, buffer, n);
+		}
+		if(in.IsError()) {
+			r[i] = String::GetVoid();
+			return;
+		}
+		byte hash[32];
+		sha256_final(&ctx, hash);
+		r[i] = HexString(hash, 32);
+	});
+	return r;
+}
+
 }
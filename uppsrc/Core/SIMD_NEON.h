@@ -266,6 +266,7 @@ force_inline i8x16 Pack16(i16x8 l, i16x8 h)       { return vreinterpretq_s8_u8(v
 force_inline i8x16 Pack16(i16x8 l)                { return vreinterpretq_s8_u8(vcombine_u8(vqmovun_s16(l), vdup_n_u8(0))); }
 
 force_inline i16x8 Pack32(i32x4 a)                { return vcombine_s16(vqmovn_s32(a), vdup_n_s16(0)); }
+force_inline i16x8 Pack32(i32x4 l, i32x4 h)       { return vcombine_s16(vqmovn_s32(l), vqmovn_s32(h)); }
 
 force_inline i16x8 BroadcastLH0(i16x8 a)          {
 	return vcombine_s16(vdup_n_s16(vgetq_lane_s16(a, 0)), vdup_n_s16(vgetq_lane_s16(a, 4)));
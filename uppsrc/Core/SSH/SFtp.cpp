@@ -131,14 +131,17 @@ int64 SFtp::GetPos(SFtpHandle handle)
 	return pos;
 }
 
-int SFtp::Get(SFtpHandle handle, void *ptr, int size)
+int SFtp::Read(SFtpHandle handle, void *ptr, int size, bool progress)
 {
 	done = 0;
 
 	Run([=]() mutable {
 		while(done < size && !IsTimeout()) {
+			// Passing libssh2 more than a single chunk lets it keep several
+			// FXP_READ requests in flight (read-ahead), instead of a single
+			// round-trip per chunk.
 			int rc = static_cast<int>(
-				libssh2_sftp_read(handle, (char*) ptr + done, min(size - done, ssh->chunk_size))
+				libssh2_sftp_read(handle, (char*) ptr + done, min(size - done, GetBlockSize()))
 			);
 			if(rc < 0) {
 				if(!WouldBlock(rc))
@@ -152,6 +155,8 @@ int SFtp::Get(SFtpHandle handle, void *ptr, int size)
 			}
 			done += rc;
 			ssh->start_time = msecs();
+			if(progress && WhenProgress(done, size))
+				ThrowError(-1, "Operation aborted.");
 			UpdateClient();
 		}
 		return true;
@@ -160,14 +165,16 @@ int SFtp::Get(SFtpHandle handle, void *ptr, int size)
 	return GetDone();
 }
 
-int SFtp::Put(SFtpHandle handle, const void *ptr, int size)
+int SFtp::Write(SFtpHandle handle, const void *ptr, int size, bool progress)
 {
 	done = 0;
 
 	Run([=]() mutable {
 		while(done < size && !IsTimeout()) {
+			// libssh2 splits the block into FXP_WRITE requests, sends them all
+			// and only then waits for the acknowledgements.
 			int rc = static_cast<int>(
-				libssh2_sftp_write(handle, (const char*) ptr + done, min(size - done, ssh->chunk_size))
+				libssh2_sftp_write(handle, (const char*) ptr + done, min(size - done, GetBlockSize()))
 			);
 			if(rc < 0) {
 				if(!WouldBlock(rc))
@@ -181,6 +188,8 @@ int SFtp::Put(SFtpHandle handle, const void *ptr, int size)
 			}
 			done += rc;
 			ssh->start_time = msecs();
+			if(progress && WhenProgress(done, size))
+				ThrowError(-1, "Operation aborted.");
 			UpdateClient();
 		}
 		return true;
@@ -189,18 +198,29 @@ int SFtp::Put(SFtpHandle handle, const void *ptr, int size)
 	return GetDone();
 }
 
+int SFtp::Get(SFtpHandle handle, void *ptr, int size)
+{
+	return Read(handle, ptr, size, true);
+}
+
+int SFtp::Put(SFtpHandle handle, const void *ptr, int size)
+{
+	return Write(handle, ptr, size, true);
+}
+
 bool SFtp::CopyData(Stream& dest, Stream& src, int64 maxsize)
 {
 	if(IsError())
 		return false;
 
 	int64 size = src.GetSize(), count = 0;
-	Buffer<byte> chunk(ssh->chunk_size, 0);
+	int   block = GetBlockSize();
+	Buffer<byte> chunk(block, 0);
 
 	WhenProgress(0, size);
 
 	while(!src.IsEof()) {
-		int n = src.Get(chunk, (int) min<int64>(size - count, ssh->chunk_size));
+		int n = src.Get(chunk, (int) min<int64>(size - count, block));
 		if(n > 0) {
 			dest.Put(chunk, n);
 			if(dest.IsError()) {
@@ -506,6 +526,7 @@ bool SFtp::ModifyAttr(const String& path, int attr, const Value& v)
 SFtp::SFtp(SshSession& session)
 : Ssh()
 , done(0)
+, pipeline(8)
 {
 	ssh->otype		= SFTP;
 	ssh->session	= session.GetHandle();
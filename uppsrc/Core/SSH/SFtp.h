@@ -82,6 +82,9 @@ public:
 public:
     SFtp&                   Timeout(int ms)                                         { ssh->timeout = ms; return *this; }
     SFtp&                   ChunkSize(int sz)                                       { ssh->chunk_size = clamp(sz, 1, INT_MAX); return *this; }
+    SFtp&                   Pipeline(int n)                                         { pipeline = clamp(n, 1, 256); return *this; }
+    int                     GetChunkSize() const                                    { return ssh->chunk_size; }
+    int                     GetPipeline() const                                     { return pipeline; }
 
     // File
     SFtpHandle              Open(const String& path, dword flags, long mode);
@@ -156,12 +159,16 @@ private:
     Value                   QueryAttr(const String& path, int attr);
     bool                    ModifyAttr(const String& path, int attr, const Value& v);
     bool                    SymLink(const String& path, String& target, int type);
-    int                     Read(SFtpHandle handle, void* ptr, int size);
-    int                     Write(SFtpHandle handle, const void* ptr, int size);
+    int                     Read(SFtpHandle handle, void* ptr, int size, bool progress = false);
+    int                     Write(SFtpHandle handle, const void* ptr, int size, bool progress = false);
+    int                     GetBlockSize() const                                    { return (int) min<int64>((int64) ssh->chunk_size * pipeline, INT_MAX); }
     bool                    CopyData(Stream& dest, Stream& src, int64 maxsize = INT64_MAX);
   
     One<LIBSSH2_SFTP*>      sftp_session;
     int                     done;
+    int                     pipeline;
+
+    friend class SFtpStream;
 
     enum FileAttributes {
         SFTP_ATTR_FILE,
@@ -246,3 +253,51 @@ private:
     SFtp *browser = nullptr;
 };
 
+class SFtpBatch {
+public:
+    SFtpBatch&              Get(const String& remote, const String& local);
+    SFtpBatch&              Put(const String& local, const String& remote);
+    SFtpBatch&              Channels(int n)                                         { channels = clamp(n, 1, 64); return *this; }
+    SFtpBatch&              Pipeline(int n)                                         { pipeline = clamp(n, 1, 256); return *this; }
+    SFtpBatch&              ChunkSize(int sz)                                       { chunk_size = clamp(sz, 1, INT_MAX); return *this; }
+    void                    Clear()                                                 { job.Clear(); }
+
+    bool                    Execute();
+    void                    Abort()                                                 { aborted = true; }
+
+    int                     GetCount() const                                        { return job.GetCount(); }
+    bool                    IsUpload(int i) const                                   { return job[i].upload; }
+    String                  GetLocal(int i) const                                   { return job[i].local; }
+    String                  GetRemote(int i) const                                  { return job[i].remote; }
+    bool                    IsError(int i) const                                    { return !IsNull(job[i].error); }
+    String                  GetErrorDesc(int i) const                               { return job[i].error; }
+    int                     GetErrorCount() const;
+    int64                   GetDone() const                                         { return done; }
+
+    Gate<int64, int64>      WhenProgress;
+    Event<int>              WhenDone;
+
+    SFtpBatch(SshSession& session);
+
+private:
+    struct Job : Moveable<Job> {
+        String local;
+        String remote;
+        bool   upload;
+        String error;
+    };
+
+    SshSession&             session;
+    Vector<Job>             job;
+    int                     channels;
+    int                     pipeline;
+    int                     chunk_size;
+    std::atomic<int>        next;
+    std::atomic<int64>      done;
+    std::atomic<int64>      total;
+    std::atomic<bool>       aborted;
+    Mutex                   mutex;
+
+    void                    Worker();
+    void                    Transfer(SFtp& sftp, Job& j);
+};
@@ -0,0 +1,119 @@
+#include "SSH.h"
+
+namespace Upp {
+
+SFtpBatch& SFtpBatch::Get(const String& remote, const String& local)
+{
+	Job& j = job.Add();
+	j.remote = remote;
+	j.local = local;
+	j.upload = false;
+	return *this;
+}
+
+SFtpBatch& SFtpBatch::Put(const String& local, const String& remote)
+{
+	Job& j = job.Add();
+	j.remote = remote;
+	j.local = local;
+	j.upload = true;
+	return *this;
+}
+
+int SFtpBatch::GetErrorCount() const
+{
+	int n = 0;
+	for(const Job& j : job)
+		n += !IsNull(j.error);
+	return n;
+}
+
+void SFtpBatch::Transfer(SFtp& sftp, Job& j)
+{
+	int64 last = 0;
+	sftp.WhenProgress = [&](int64 count, int64 size) {
+		if(count == 0)
+			total += size;
+		done += count - last;
+		last = count;
+		Mutex::Lock __(mutex);
+		if(WhenProgress(done, total))
+			aborted = true;
+		return (bool) aborted;
+	};
+
+	bool ok;
+	if(j.upload) {
+		FileIn in(j.local);
+		if(!in) {
+			j.error = "Unable to open file '" + j.local + "'.";
+			return;
+		}
+		ok = sftp.SaveFile(j.remote, in);
+	}
+	else {
+		FileOut out(j.local);
+		if(!out) {
+			j.error = "Unable to create file '" + j.local + "'.";
+			return;
+		}
+		ok = sftp.LoadFile(out, j.remote);
+		out.Close();
+		if(out.IsError())
+			ok = false;
+	}
+	if(!ok)
+		j.error = aborted ? String("Operation aborted.")
+		        : sftp.IsError() ? sftp.GetErrorDesc()
+		        : String("Stream error.");
+}
+
+void SFtpBatch::Worker()
+{
+	SFtp sftp(session);
+	sftp.ChunkSize(chunk_size).Pipeline(pipeline);
+	for(;;) {
+		int i = next++;
+		if(i >= job.GetCount())
+			break;
+		Job& j = job[i];
+		if(aborted)
+			j.error = "Operation aborted.";
+		else
+			Transfer(sftp, j);
+		Mutex::Lock __(mutex);
+		WhenDone(i);
+	}
+}
+
+bool SFtpBatch::Execute()
+{
+	for(Job& j : job)
+		j.error = Null;
+	next = 0;
+	done = 0;
+	total = 0;
+	aborted = false;
+
+	// Each worker opens its own SFTP channel on the shared session, so that
+	// transfers of different files proceed concurrently.
+	int n = min(channels, job.GetCount());
+	Array<Thread> thread;
+	for(int i = 1; i < n; i++)
+		thread.Add().Run([=] { Worker(); });
+	Worker();
+	for(Thread& t : thread)
+		t.Wait();
+
+	return !aborted && GetErrorCount() == 0;
+}
+
+SFtpBatch::SFtpBatch(SshSession& session)
+: session(session)
+, channels(4)
+, pipeline(8)
+, chunk_size(64 * 1024)
+{
+}
+
+}
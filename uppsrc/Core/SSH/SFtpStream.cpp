@@ -4,7 +4,9 @@ namespace Upp {
 
 void SFtpStream::SetPos(int64 pos)
 {
-	sftp->Seek(handle, pos);
+	// Seeking discards libssh2's read-ahead, so avoid it for sequential access.
+	if(sftp->GetPos(handle) != pos)
+		sftp->Seek(handle, pos);
 }
 
 void SFtpStream::SetStreamSize(int64 size)
@@ -15,7 +17,7 @@ void SFtpStream::SetStreamSize(int64 size)
 dword SFtpStream::Read(int64 at, void *ptr, dword size)
 {
 	SetPos(at);
-	int n = sftp->Get(handle, ptr, size);
+	int n = sftp->Read(handle, ptr, size);
 	if(sftp->IsError()) SetError();
 	return dword(n);
 }
@@ -23,7 +25,7 @@ dword SFtpStream::Read(int64 at, void *ptr, dword size)
 void SFtpStream::Write(int64 at, const void *data, dword size)
 {
 	SetPos(at);
-	sftp->Put(handle, data, size);
+	sftp->Write(handle, data, size);
 	if(sftp->IsError()) SetError();
 }
 
@@ -65,6 +67,7 @@ bool SFtpStream::Open(SFtp& sftp_, const char *filename, dword mode, int acm)
 			return false;
 		}
 		OpenInit(mode, attrs.filesize);
+		SetBufferSize(sftp->GetChunkSize());
 	}
 	return handle;
 }
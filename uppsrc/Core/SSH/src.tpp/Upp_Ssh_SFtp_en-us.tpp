@@ -38,6 +38,22 @@ to Null puts the SFtp object into blocking mode&]
 default chunk size is 64K Returns `*this for method chaining.&]
 [s3; &]
 [s4;%- &]
+[s5;:Upp`:`:SFtp`:`:Pipeline`(int`):%- [_^Upp`:`:SFtp^ SFtp][@(0.0.255) `&]_[* Pipeline]([@(0.0.255) i
+nt]_[*@3 n])&]
+[s2; Allows up to [%-*@3 n] chunks of data to be requested from or 
+sent to the server before waiting for the replies. Pipelining 
+hides the network latency, which otherwise limits the throughput 
+to a single chunk per round`-trip. The default value is 8. Pipeline(1) 
+disables pipelining. Returns `*this for method chaining.&]
+[s3; &]
+[s4;%- &]
+[s5;:Upp`:`:SFtp`:`:GetChunkSize`(`)const:%- [@(0.0.255) int]_[* GetChunkSize]()_[@(0.0.255) c
+onst]&]
+[s5;:Upp`:`:SFtp`:`:GetPipeline`(`)const:%- [@(0.0.255) int]_[* GetPipeline]()_[@(0.0.255) c
+onst]&]
+[s2; Returns the chunk size, resp. pipeline depth.&]
+[s3; &]
+[s4;%- &]
 [s5;:Upp`:`:SFtp`:`:GetHandle`(`)const:%- [_^LIBSSH2`_SFTP`_HANDLE^ LIBSSH2`_SFTP`_HAND
 LE][@(0.0.255) `*]_[* GetHandle]()_[@(0.0.255) const]&]
 [s2; Returns a pointer to the libssh2 sftp session handle on success, 
@@ -333,7 +349,8 @@ MAX)&]
 [s2; Reads at most [%-*@3 size] bytes data from the remote file object 
 associated with [%-*@3 handle] into the buffer pointed by [%-*@3 ptr], 
 trying to do so at most for a specified timeout. Returns the 
-number of bytes actually written.&]
+number of bytes actually transferred. [^topic`:`/`/Core`/SSH`/src`/Upp`_Ssh`_SFtp`_en`-us`#Upp`:`:SFtp`:`:WhenProgress^ W
+henProgress ]gate can be used to track data transfer.&]
 [s3; &]
 [s4;%- &]
 [s5;:Upp`:`:SFtp`:`:Put`(Upp`:`:SFtpHandle`,const void`*`,int`):%- [@(0.0.255) int]_[* Pu
@@ -342,7 +359,8 @@ t]([_^Upp`:`:SFtpHandle^ SFtpHandle]_[*@3 handle], [@(0.0.255) const]_[@(0.0.255
 [s2; Writes at most [%-*@3 size] bytes data from the buffer pointed 
 by [%-*@3 ptr] into the remote file object associated with [%-*@3 handle], 
 trying to do so at most for a specified timeout. Returns the 
-number of bytes actually written.&]
+number of bytes actually transferred. [^topic`:`/`/Core`/SSH`/src`/Upp`_Ssh`_SFtp`_en`-us`#Upp`:`:SFtp`:`:WhenProgress^ W
+henProgress ]gate can be used to track data transfer.&]
 [s3; &]
 [s4;%- &]
 [s5;:Upp`:`:SFtp`:`:SaveFile`(const char`*`,const Upp`:`:String`&`):%- [@(0.0.255) bool
@@ -592,4 +610,94 @@ yle]()_[@(0.0.255) const]_override&]
 temInfo]([_^Upp`:`:SFtp^ SFtp][@(0.0.255) `&]_[*@3 sftp])&]
 [s2; Constructor. Mounts a valid [%-*@3 sftp] file system to be enumerated.&]
 [s3; &]
-[s0; ]]
\ No newline at end of file
+[s0; &]
+[ {{10000@(113.42.0) [s0; [*@7;4 SFtpBatch]]}}&]
+[s3;%- &]
+[s1;:Upp`:`:SFtpBatch`:`:class:%- [@(0.0.255)3 class][3 _][*3 SFtpBatch]&]
+[s2; Transfers multiple files in parallel, over several SFTP channels 
+opened on the same ssh session. Each channel is served by its 
+own worker thread and uses pipelined reads and writes.&]
+[s3;%- &]
+[ {{10000F(128)G(128)@1 [s0; [* Public Method List]]}}&]
+[s3;%- &]
+[s5;:Upp`:`:SFtpBatch`:`:Get`(const Upp`:`:String`&`,const Upp`:`:String`&`):%- [_^Upp`:`:SFtpBatch^ S
+FtpBatch][@(0.0.255) `&]_[* Get]([@(0.0.255) const]_[_^Upp`:`:String^ String][@(0.0.255) `&
+]_[*@3 remote], [@(0.0.255) const]_[_^Upp`:`:String^ String][@(0.0.255) `&]_[*@3 local])&]
+[s2; Adds the download of [%-*@3 remote] file to [%-*@3 local] file.&]
+[s3; &]
+[s4;%- &]
+[s5;:Upp`:`:SFtpBatch`:`:Put`(const Upp`:`:String`&`,const Upp`:`:String`&`):%- [_^Upp`:`:SFtpBatch^ S
+FtpBatch][@(0.0.255) `&]_[* Put]([@(0.0.255) const]_[_^Upp`:`:String^ String][@(0.0.255) `&
+]_[*@3 local], [@(0.0.255) const]_[_^Upp`:`:String^ String][@(0.0.255) `&]_[*@3 remote])&]
+[s2; Adds the upload of [%-*@3 local] file to [%-*@3 remote] file.&]
+[s3; &]
+[s4;%- &]
+[s5;:Upp`:`:SFtpBatch`:`:Channels`(int`):%- [_^Upp`:`:SFtpBatch^ SFtpBatch][@(0.0.255) `&
+]_[* Channels]([@(0.0.255) int]_[*@3 n])&]
+[s2; Sets the maximum number of concurrent transfers. Default is 4.&]
+[s3; &]
+[s4;%- &]
+[s5;:Upp`:`:SFtpBatch`:`:Pipeline`(int`):%- [_^Upp`:`:SFtpBatch^ SFtpBatch][@(0.0.255) `&
+]_[* Pipeline]([@(0.0.255) int]_[*@3 n])&]
+[s5;:Upp`:`:SFtpBatch`:`:ChunkSize`(int`):%- [_^Upp`:`:SFtpBatch^ SFtpBatch][@(0.0.255) `&
+]_[* ChunkSize]([@(0.0.255) int]_[*@3 sz])&]
+[s2; Sets the pipeline depth and chunk size of channels (see SFtp).&]
+[s3; &]
+[s4;%- &]
+[s5;:Upp`:`:SFtpBatch`:`:Clear`(`):%- [@(0.0.255) void]_[* Clear]()&]
+[s2; Removes all transfers.&]
+[s3; &]
+[s4;%- &]
+[s5;:Upp`:`:SFtpBatch`:`:Execute`(`):%- [@(0.0.255) bool]_[* Execute]()&]
+[s2; Performs all transfers, returns after all of them are finished. 
+Returns true if all transfers were successful.&]
+[s3; &]
+[s4;%- &]
+[s5;:Upp`:`:SFtpBatch`:`:Abort`(`):%- [@(0.0.255) void]_[* Abort]()&]
+[s2; Aborts the running transfers, can be called from any thread.&]
+[s3; &]
+[s4;%- &]
+[s5;:Upp`:`:SFtpBatch`:`:GetCount`(`)const:%- [@(0.0.255) int]_[* GetCount]()_[@(0.0.255) c
+onst]&]
+[s5;:Upp`:`:SFtpBatch`:`:IsUpload`(int`)const:%- [@(0.0.255) bool]_[* IsUpload]([@(0.0.255) i
+nt]_[*@3 i])_[@(0.0.255) const]&]
+[s5;:Upp`:`:SFtpBatch`:`:GetLocal`(int`)const:%- [_^Upp`:`:String^ String]_[* GetLocal]([@(0.0.255) i
+nt]_[*@3 i])_[@(0.0.255) const]&]
+[s5;:Upp`:`:SFtpBatch`:`:GetRemote`(int`)const:%- [_^Upp`:`:String^ String]_[* GetRemote](
+[@(0.0.255) int]_[*@3 i])_[@(0.0.255) const]&]
+[s2; Information about transfer [%-*@3 i].&]
+[s3; &]
+[s4;%- &]
+[s5;:Upp`:`:SFtpBatch`:`:IsError`(int`)const:%- [@(0.0.255) bool]_[* IsError]([@(0.0.255) i
+nt]_[*@3 i])_[@(0.0.255) const]&]
+[s5;:Upp`:`:SFtpBatch`:`:GetErrorDesc`(int`)const:%- [_^Upp`:`:String^ String]_[* GetErro
+rDesc]([@(0.0.255) int]_[*@3 i])_[@(0.0.255) const]&]
+[s2; Returns true, resp. error description, if transfer [%-*@3 i] failed.&]
+[s3; &]
+[s4;%- &]
+[s5;:Upp`:`:SFtpBatch`:`:GetErrorCount`(`)const:%- [@(0.0.255) int]_[* GetErrorCount]()_[@(0.0.255) c
+onst]&]
+[s2; Returns the number of failed transfers.&]
+[s3; &]
+[s4;%- &]
+[s5;:Upp`:`:SFtpBatch`:`:GetDone`(`)const:%- [_^Upp`:`:int64^ int64]_[* GetDone]()_[@(0.0.255) c
+onst]&]
+[s2; Returns the total number of bytes transferred.&]
+[s3; &]
+[s4;%- &]
+[s5;:Upp`:`:SFtpBatch`:`:WhenProgress:%- [_^Upp`:`:Gate^ Gate]<[_^Upp`:`:int64^ int64], 
+[_^Upp`:`:int64^ int64]>_[* WhenProgress]&]
+[s2; Reports the number of bytes transferred and the total size of 
+transfers started so far. Returning true aborts all transfers. 
+Called from worker threads, serialized.&]
+[s3; &]
+[s4;%- &]
+[s5;:Upp`:`:SFtpBatch`:`:WhenDone:%- [_^Upp`:`:Event^ Event]<[@(0.0.255) int]>_[* WhenDone]&]
+[s2; Called (serialized, from worker thread) when transfer of given 
+index is finished.&]
+[s3; &]
+[s4;%- &]
+[s5;:Upp`:`:SFtpBatch`:`:SFtpBatch`(Upp`:`:SshSession`&`):%- [* SFtpBatch]([_^Upp`:`:SshSession^ S
+shSession][@(0.0.255) `&]_[*@3 session])&]
+[s2; Constructor. Binds the instance to [%-*@3 session].&]
+[s3; ]]
\ No newline at end of file
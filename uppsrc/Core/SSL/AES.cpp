@@ -1,7 +1,15 @@
 #include "SSL.h"
 
+#include <openssl/hmac.h>
+
 // Encrypts a string using AES-256-GCM with PBKDF2 key derivation
 // Format of encrypted data: "GCMv1__" + salt(16) + iv(12) + ciphertext + tag(16)
+// Segmented format (Co): "GCMv2__" + segment size(4) + salt(16) + stream salt(16) + nonce prefix(7),
+// followed by segments of ciphertext + tag(16). Segments are encrypted by HKDF of PBKDF2 key and
+// random stream salt, so every stream has its own key even if PBKDF2 salt is shared through the key
+// cache. Segment IV is nonce prefix + big endian segment counter(4) + last segment flag(1) and the
+// header is authenticated with each segment, so segments cannot be reordered, dropped or truncated
+// (STREAM construction). Segments are independent and encrypted in parallel.
 
 #define LLOG(x)  // DLOG(x)
 
@@ -15,6 +23,92 @@ namespace {
 	constexpr const int AES_GCM_IV_SIZE           = 12;                // GCM standard IV size
 	constexpr const int AES_GCM_TAG_SIZE          = 16;
 	constexpr const int AES_GCM_ENVELOPE_SIZE     = AES_GCM_PREFIX_LEN + AES_GCM_SALT_SIZE + AES_GCM_IV_SIZE + AES_GCM_TAG_SIZE;
+	constexpr const char* AES_GCM_SEGMENTED_PREFIX = "GCMv2__";
+	constexpr const int AES_GCM_NONCE_PREFIX_SIZE = 7;
+	constexpr const int AES_GCM_SEGMENTED_HEADER  = AES_GCM_PREFIX_LEN + 4 + 2 * AES_GCM_SALT_SIZE + AES_GCM_NONCE_PREFIX_SIZE;
+	constexpr const int AES_GCM_KEY_CACHE_SIZE    = 8;
+
+	struct AesKeyCacheEntry {
+		byte pwd[32]; // HMAC of password with per-process random key
+		byte salt[AES_GCM_SALT_SIZE];
+		byte key[AES_GCM_KEY_SIZE];
+		int  iteration;
+	};
+
+	struct AesCipherCtx {
+		EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
+		~AesCipherCtx() { if(ctx) EVP_CIPHER_CTX_free(ctx); }
+	};
+}
+
+// PBKDF2 is deliberately slow, so derived keys are cached to pay it once per password, not
+// per stream. Segmented encryption with the same password reuses the PBKDF2 salt (and key), but
+// never encrypts with it directly, see sStreamKey. GCMv1 has no stream salt, so its encryption
+// always derives the key with new salt.
+
+static StaticMutex      sKeyCacheLock;
+static AesKeyCacheEntry sKeyCache[AES_GCM_KEY_CACHE_SIZE];
+static int              sKeyCacheNext;
+
+static bool sPasswordId(const String& password, byte *id)
+{
+	static byte secret[32];
+	static bool ok;
+	ONCELOCK {
+		ok = RAND_bytes(secret, sizeof(secret));
+	}
+	unsigned int len = 32;
+	return ok && HMAC(EVP_sha256(), secret, sizeof(secret), (const byte *)~password, password.GetLength(), id, &len);
+}
+
+void ClearAES256KeyCache()
+{
+	Mutex::Lock __(sKeyCacheLock);
+	OPENSSL_cleanse(sKeyCache, sizeof(sKeyCache));
+}
+
+bool Aes256Gcm::DeriveKey(const String& password, byte *salt, byte *key, bool newsalt, bool reusesalt)
+{
+	byte id[32];
+	bool cache = keycache && (!newsalt || reusesalt) && sPasswordId(password, id);
+	if(cache) {
+		Mutex::Lock __(sKeyCacheLock);
+		for(const AesKeyCacheEntry& e : sKeyCache)
+			if(e.iteration == iteration && memcmp(e.pwd, id, sizeof(id)) == 0 &&
+			   (newsalt || memcmp(e.salt, salt, AES_GCM_SALT_SIZE) == 0)) {
+				if(newsalt)
+					memcpy(salt, e.salt, AES_GCM_SALT_SIZE);
+				memcpy(key, e.key, AES_GCM_KEY_SIZE);
+				OPENSSL_cleanse(id, sizeof(id));
+				return true;
+			}
+	}
+	if(newsalt && !RAND_bytes(salt, AES_GCM_SALT_SIZE))
+		return false;
+	if(!PKCS5_PBKDF2_HMAC(~password, password.GetLength(), salt, AES_GCM_SALT_SIZE, iteration, EVP_sha256(), AES_GCM_KEY_SIZE, key))
+		return false;
+	if(cache) {
+		Mutex::Lock __(sKeyCacheLock);
+		AesKeyCacheEntry& e = sKeyCache[sKeyCacheNext++ % AES_GCM_KEY_CACHE_SIZE];
+		memcpy(e.pwd, id, sizeof(id));
+		memcpy(e.salt, salt, AES_GCM_SALT_SIZE);
+		memcpy(e.key, key, AES_GCM_KEY_SIZE);
+		e.iteration = iteration;
+		OPENSSL_cleanse(id, sizeof(id));
+	}
+	return true;
+}
+
+static bool sStreamKey(const byte *key, const byte *salt, byte *stream_key)
+{ // HKDF-SHA256 (RFC 5869), single block of output
+	byte prk[32], info[AES_GCM_PREFIX_LEN + 1];
+	memcpy(info, AES_GCM_SEGMENTED_PREFIX, AES_GCM_PREFIX_LEN);
+	info[AES_GCM_PREFIX_LEN] = 1;
+	unsigned int len = 32;
+	bool ok = HMAC(EVP_sha256(), salt, AES_GCM_SALT_SIZE, key, AES_GCM_KEY_SIZE, prk, &len) &&
+	          HMAC(EVP_sha256(), prk, sizeof(prk), info, sizeof(info), stream_key, &len);
+	OPENSSL_cleanse(prk, sizeof(prk));
+	return ok;
 }
 
 Aes256Gcm::Aes256Gcm()
@@ -22,6 +116,9 @@ Aes256Gcm::Aes256Gcm()
 , cipher(nullptr)
 , chunksize(1024)
 , iteration(AES_GCM_DEFAULT_ITERATION)
+, segmentsize(AES_GCM_DEFAULT_SEGMENT)
+, co(false)
+, keycache(true)
 {
 	SslInitThread();
 	
@@ -53,6 +150,9 @@ bool Aes256Gcm::Encrypt(Stream& in, const String& password, Stream& out)
 {
 	err.Clear();
 
+	if(co)
+		return EncryptSegments(in, password, out);
+
 	byte key[AES_GCM_KEY_SIZE];
 
 	if(!ctx) {
@@ -75,16 +175,12 @@ bool Aes256Gcm::Encrypt(Stream& in, const String& password, Stream& out)
 	int64 processed = 0;
 
 	try {
-		// Generate random salt
-		if(!RAND_bytes(salt, sizeof(salt)))
-			throw Exc("Salt generation failed");
-		
 		// Generate random initialization vector
 		if(!RAND_bytes(iv, sizeof(iv)))
 			throw Exc("IV generation failed");
 
-		// Derive key from password (can be Null)
-		if(!PKCS5_PBKDF2_HMAC(~password, password.GetLength(), salt, sizeof(salt), iteration, EVP_sha256(), sizeof(key), key))
+		// Derive key from password (can be Null) with new random salt
+		if(!DeriveKey(password, salt, key, true))
 			throw Exc("PBKDF2: Key derivation failed");
 
 		// Initialize cipher
@@ -191,14 +287,19 @@ bool Aes256Gcm::Decrypt(Stream& in, const String& password, Stream& out)
 		return false;
 	}
 	
+	// Read and validate header
+	String header = in.Get(AES_GCM_PREFIX_LEN);
+	
+	// Segmented format does not need size information
+	if(header == AES_GCM_SEGMENTED_PREFIX)
+		return DecryptSegments(in, password, out);
+
 	// Require size information
 	if(in.GetSize() <= 0) {
 		SetError("Invalid stream size or no data to decrypt");
 		return false;
 	}
 		
-	// Read and validate header
-	String header = in.Get(AES_GCM_PREFIX_LEN);
 	if(header.GetLength() < AES_GCM_PREFIX_LEN || !header.StartsWith(AES_GCM_FORMAT_PREFIX)) {
 		SetError("Invalid format");
 		return false;
@@ -227,7 +328,7 @@ bool Aes256Gcm::Decrypt(Stream& in, const String& password, Stream& out)
 
 	try {
 		// Derive key from password (can be Null)
-		if(!PKCS5_PBKDF2_HMAC(~password, password.GetLength(), salt, AES_GCM_SALT_SIZE, iteration, EVP_sha256(), sizeof(key), key))
+		if(!DeriveKey(password, (byte *)~salt, key, false))
 			throw Exc("PBKDF2: Key derivation failed");
 		
 		// Init decryption
@@ -314,6 +415,168 @@ bool Aes256Gcm::Decrypt(Stream& in, const String& password, Stream& out)
 	return false;
 }
 
+static bool sGcmSegment(bool enc, EVP_CIPHER_CTX *ctx, const EVP_CIPHER *cipher, const byte *key,
+                        const byte *iv, const byte *header, const String& in, String& out)
+{
+	int len = in.GetLength() - (enc ? 0 : AES_GCM_TAG_SIZE);
+	if(!ctx || len < 0)
+		return false;
+	const byte *s = (const byte *)~in;
+	StringBuffer r(len + (enc ? AES_GCM_TAG_SIZE : 0));
+	byte *t = (byte *)~r;
+	int n = 0, m = 0;
+	if(!EVP_CipherInit_ex(ctx, cipher, nullptr, key, iv, enc) ||
+	   !EVP_CipherUpdate(ctx, nullptr, &n, header, AES_GCM_SEGMENTED_HEADER) ||
+	   len && !EVP_CipherUpdate(ctx, t, &n, s, len) ||
+	   !enc && !EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_TAG, AES_GCM_TAG_SIZE, (void *)(s + len)) ||
+	   !EVP_CipherFinal_ex(ctx, t + n, &m) ||
+	   enc && !EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_GET_TAG, AES_GCM_TAG_SIZE, t + len))
+		return false;
+	out = r;
+	return true;
+}
+
+void Aes256Gcm::Segments(bool enc, Stream& in, Stream& out, const byte *key, const byte *header)
+{
+	struct Segment {
+		String data;
+		byte   iv[AES_GCM_IV_SIZE];
+		bool   ok = false;
+	};
+
+	const byte *nonce = header + AES_GCM_PREFIX_LEN + 4 + 2 * AES_GCM_SALT_SIZE;
+	int    insize = segmentsize + (enc ? 0 : AES_GCM_TAG_SIZE);
+	int    batch = co ? 2 * CPU_Cores() : 1; // bounds memory to 2 * batch segments
+	int64  total = in.GetSize();
+	int64  processed = in.GetPos();
+	dword  counter = 0;
+	bool   last = false;
+	CoWorkerResources<AesCipherCtx> ctx;
+	while(!last) {
+		Array<Segment> segment;
+		CoWork cw;
+		while(segment.GetCount() < batch && !last) {
+			Segment& sg = segment.Add();
+			sg.data = in.Get(insize);
+			if(in.IsError())
+				throw Exc("Failed to read input");
+			last = in.IsEof();
+			if(!last && counter == 0xffffffff)
+				throw Exc("Too many segments");
+			memcpy(sg.iv, nonce, AES_GCM_NONCE_PREFIX_SIZE);
+			Poke32be(sg.iv + AES_GCM_NONCE_PREFIX_SIZE, counter++);
+			sg.iv[AES_GCM_IV_SIZE - 1] = last;
+			processed += sg.data.GetLength();
+			auto job = [=, &sg, &ctx] {
+				SslInitThread();
+				sg.ok = sGcmSegment(enc, ctx.Get().ctx, cipher, key, sg.iv, header, sg.data, sg.data);
+			};
+			if(co)
+				cw & job;
+			else
+				job();
+		}
+		cw.Finish();
+		for(Segment& sg : segment) {
+			if(!sg.ok)
+				throw Exc(enc ? "Encryption failed" : "Authentication failed");
+			out.Put(sg.data);
+		}
+		if(out.IsError())
+			throw Exc("Failed to write output");
+		if(WhenProgress(processed, total))
+			throw Exc(enc ? "Encryption aborted" : "Decryption aborted");
+	}
+}
+
+bool Aes256Gcm::EncryptSegments(Stream& in, const String& password, Stream& out)
+{
+	byte key[AES_GCM_KEY_SIZE];
+	byte header[AES_GCM_SEGMENTED_HEADER];
+	
+	if(!cipher) {
+		SetError("Failed to fetch AES-256-GCM cipher");
+		return false;
+	}
+
+	try {
+		memcpy(header, AES_GCM_SEGMENTED_PREFIX, AES_GCM_PREFIX_LEN);
+		Poke32le(header + AES_GCM_PREFIX_LEN, segmentsize);
+		byte *salt = header + AES_GCM_PREFIX_LEN + 4;
+		
+		// Derive key from password (can be Null) with new random salt (or cached one)
+		if(!DeriveKey(password, salt, key, true, true))
+			throw Exc("PBKDF2: Key derivation failed");
+		
+		// Random stream salt and nonce prefix, unique per stream
+		byte *stream_salt = salt + AES_GCM_SALT_SIZE;
+		if(!RAND_bytes(stream_salt, AES_GCM_SALT_SIZE + AES_GCM_NONCE_PREFIX_SIZE))
+			throw Exc("Nonce generation failed");
+		
+		if(!sStreamKey(key, stream_salt, key))
+			throw Exc("HKDF: Key derivation failed");
+
+		out.Put(header, sizeof(header));
+		Segments(true, in, out, key, header);
+
+		OPENSSL_cleanse(&key, sizeof(key));
+		return true;
+	}
+	catch(const Exc& e) {
+		SetError(e);
+	}
+
+	OPENSSL_cleanse(&key, sizeof(key));
+	return false;
+}
+
+bool Aes256Gcm::DecryptSegments(Stream& in, const String& password, Stream& out)
+{
+	byte key[AES_GCM_KEY_SIZE];
+	byte header[AES_GCM_SEGMENTED_HEADER];
+
+	if(!cipher) {
+		SetError("Failed to fetch AES-256-GCM cipher");
+		return false;
+	}
+	
+	memcpy(header, AES_GCM_SEGMENTED_PREFIX, AES_GCM_PREFIX_LEN); // already read by Decrypt
+	if(!in.GetAll(header + AES_GCM_PREFIX_LEN, sizeof(header) - AES_GCM_PREFIX_LEN)) {
+		SetError("Invalid format");
+		return false;
+	}
+	
+	int sz = Peek32le(header + AES_GCM_PREFIX_LEN);
+	if(sz < 1024 || sz > 64 * 1024 * 1024) {
+		SetError("Invalid segment size");
+		return false;
+	}
+
+	int segsz = segmentsize;
+	try {
+		byte *salt = header + AES_GCM_PREFIX_LEN + 4;
+		if(!DeriveKey(password, salt, key, false))
+			throw Exc("PBKDF2: Key derivation failed");
+		
+		if(!sStreamKey(key, salt + AES_GCM_SALT_SIZE, key))
+			throw Exc("HKDF: Key derivation failed");
+
+		segmentsize = sz;
+		Segments(false, in, out, key, header);
+		segmentsize = segsz;
+
+		OPENSSL_cleanse(&key, sizeof(key));
+		return true;
+	}
+	catch(const Exc& e) {
+		SetError(e);
+	}
+
+	segmentsize = segsz;
+	OPENSSL_cleanse(&key, sizeof(key));
+	return false;
+}
+
 bool Aes256Gcm::EncDec(bool enc, const String& in, const String& pwd, String& out)
 {
 	StringStream sin(in), sout;
@@ -357,6 +620,40 @@ bool AES256Decrypt(Stream& in, const String& password, Stream& out, Gate<int64,
 	aes.WhenProgress = WhenProgress;
 	return aes.Decrypt(in, password, out);
 }
+
+String CoAES256Encrypt(const String& in, const String& password, Gate<int64, int64> WhenProgress)
+{
+	String out;
+	Aes256Gcm aes;
+	aes.Co();
+	aes.WhenProgress = WhenProgress;
+	return aes.Encrypt(in, password, out) ? out : String::GetVoid();
+}
+
+String CoAES256Decrypt(const String& in, const String& password, Gate<int64, int64> WhenProgress)
+{
+	String out;
+	Aes256Gcm aes;
+	aes.Co();
+	aes.WhenProgress = WhenProgress;
+	return aes.Decrypt(in, password, out) ? out : String::GetVoid();
+}
+
+bool CoAES256Encrypt(Stream& in, const String& password, Stream& out, Gate<int64, int64> WhenProgress)
+{
+	Aes256Gcm aes;
+	aes.Co();
+	aes.WhenProgress = WhenProgress;
+	return aes.Encrypt(in, password, out);
+}
+
+bool CoAES256Decrypt(Stream& in, const String& password, Stream& out, Gate<int64, int64> WhenProgress)
+{
+	Aes256Gcm aes;
+	aes.Co();
+	aes.WhenProgress = WhenProgress;
+	return aes.Decrypt(in, password, out);
+}
 	
 	
 }
@@ -149,6 +149,7 @@ String Asn1ToString(ASN1_STRING *s);
 constexpr const int AES_GCM_MIN_ITERATION     = 10000;
 constexpr const int AES_GCM_MAX_ITERATION     = 1000000;
 constexpr const int AES_GCM_DEFAULT_ITERATION = 100000;
+constexpr const int AES_GCM_DEFAULT_SEGMENT   = 1024 * 1024;
 
 class Aes256Gcm : NoCopy {
 public:
@@ -157,6 +158,9 @@ public:
 
     Aes256Gcm& Iteration(int n)                                         { iteration = clamp(n, AES_GCM_MIN_ITERATION, AES_GCM_MAX_ITERATION); return *this; }
     Aes256Gcm& ChunkSize(int sz)                                        { chunksize = clamp(sz, 128, INT_MAX); return *this; }
+    Aes256Gcm& Co(bool b = true)                                        { co = b; return *this; }
+    Aes256Gcm& SegmentSize(int sz)                                      { segmentsize = clamp(sz, 1024, 64 * 1024 * 1024); return *this; }
+    Aes256Gcm& KeyCache(bool b = true)                                  { keycache = b; return *this; }
 
     bool Encrypt(Stream& in, const String& password, Stream& out);
     bool Encrypt(const String& in, const String& password, String& out) { return EncDec(true, in, password, out); }
@@ -170,11 +174,18 @@ public:
 private:
     bool   EncDec(bool enc, const String& in, const String& pwd, String& out);
     void   SetError(const String& txt);
+    bool   DeriveKey(const String& password, byte *salt, byte *key, bool newsalt, bool reusesalt = false);
+    bool   EncryptSegments(Stream& in, const String& password, Stream& out);
+    bool   DecryptSegments(Stream& in, const String& password, Stream& out);
+    void   Segments(bool enc, Stream& in, Stream& out, const byte *key, const byte *header);
 
     EVP_CIPHER_CTX* ctx;
     EVP_CIPHER*     cipher;
     int             chunksize;
     int             iteration;
+    int             segmentsize;
+    bool            co;
+    bool            keycache;
     String          err;
 };
 
@@ -183,6 +194,13 @@ String AES256Decrypt(const String& in, const String& password, Gate<int64, int64
 bool AES256Encrypt(Stream& in, const String& password, Stream& out, Gate<int64, int64> WhenProgress = Null);
 bool AES256Decrypt(Stream& in, const String& password, Stream& out, Gate<int64, int64> WhenProgress = Null);
 
+String CoAES256Encrypt(const String& in, const String& password, Gate<int64, int64> WhenProgress = Null);
+String CoAES256Decrypt(const String& in, const String& password, Gate<int64, int64> WhenProgress = Null);
+bool CoAES256Encrypt(Stream& in, const String& password, Stream& out, Gate<int64, int64> WhenProgress = Null);
+bool CoAES256Decrypt(Stream& in, const String& password, Stream& out, Gate<int64, int64> WhenProgress = Null);
+
+void ClearAES256KeyCache();
+
 // Secure buffer
 #include "Buffer.hpp"
 
@@ -39,6 +39,30 @@ end.&]
 Authentication is enforced via the GCM tag; tampering or wrong 
 passwords result in decryption failure.&]
 [s2; &]
+[s2; When [^topic`:`/`/Core`/SSL`/src`/Upp`_SSL`_AES256GCM`_en`-us`#Upp`:`:Aes256Gcm`:`:Co`(bool`)^ C
+o] is active, data are encrypted in the segmented format:&]
+[s2; &]
+[s0;=l288; [C `[GCMv2`_`_`]`[SEGMENT SIZE`]`[SALT`]`[STREAM SALT`]`[NONCE`]`[SEGMENT`]...]&]
+[s0;=l288;C &]
+[s0;l288;i150;O0; [C SEGMENT SIZE]: 4`-byte little endian size of plaintext 
+segment.&]
+[s0;l288;i150;O0; [C STREAM SALT]: 16`-byte random salt of HKDF.&]
+[s0;l288;i150;O0; [C NONCE]: 7`-byte random nonce prefix.&]
+[s0;l288;i150;O0; [C SEGMENT]: AES`-GCM encrypted segment followed by 
+its 16`-byte tag. All segments but the last one have full size.&]
+[s0; &]
+[s2; Segments are encrypted with the key derived by HKDF`-SHA256 
+from PBKDF2 key and the stream salt, so every stream uses its own 
+key. IV of each segment is the nonce prefix, 4`-byte big endian segment 
+counter and the byte that is 1 for the last segment, the header 
+is authenticated with each segment. Segments therefore cannot 
+be reordered, removed or truncated without detection. Segments 
+are independent and are encrypted and decrypted in parallel. 
+Note that decrypted segments are written to the output as soon 
+as they are authenticated, so the output of failed decryption 
+should be discarded. Unlike GCMv1, segmented format does not 
+require the size of input stream. Decrypt accepts both formats.&]
+[s2; &]
 [s2; [* Thread Safety]&]
 [s2; &]
 [s0;l288;i150;O0; Instances of Aes256Gcm are [/_ not thread`-safe].&]
@@ -48,7 +72,12 @@ passwords result in decryption failure.&]
 [s2; &]
 [s0;l288;i150;O0; Key derivation (PBKDF2) is intentionally CPU`-expensive 
 to resist brute`-force attacks. The default iteration count balances 
-security and responsiveness.&]
+security and responsiveness. Derived keys are cached (for last 
+8 passwords), so the cost is paid once per password, not per 
+stream; segmented encryption with the same password then reuses 
+the PBKDF2 salt, while the stream salt and therefore the key of 
+segments are always new. GCMv1 encryption does not use the cache, 
+as its key is used directly.&]
 [s2;i150;O0; Use [^topic`:`/`/Core`/SSL`/src`/Upp`_SSL`_AES256GCM`_en`-us`#Upp`:`:Aes256Gcm`:`:Iteration`(int`)^ I
 teration()] method to configure the number of PBKDF2 rounds.&]
 [s2;i150;O0; [^topic`:`/`/Core`/SSL`/src`/Upp`_SSL`_AES256GCM`_en`-us`#Upp`:`:Aes256Gcm`:`:Chunksize`(int`)^ C
@@ -82,6 +111,26 @@ method chaining.&]
 Must be at least 128 bytes. Returns `*this for method chaining.&]
 [s3;%- &]
 [s4;%- &]
+[s5;:Upp`:`:Aes256Gcm`:`:Co`(bool`):%- Aes256Gcm[@(0.0.255) `&] [* Co]([@(0.0.255) bool] 
+[*@3 b] [@(0.0.255) `=] [@(0.0.255) true])&]
+[s2; Encrypt uses the segmented format, segments are encrypted and 
+decrypted in parallel using CoWork. Returns `*this for method chaining.&]
+[s3;%- &]
+[s4;%- &]
+[s5;:Upp`:`:Aes256Gcm`:`:SegmentSize`(int`):%- Aes256Gcm[@(0.0.255) `&] 
+[* SegmentSize]([@(0.0.255) int] [*@3 sz])&]
+[s2; Sets the plaintext size of segments of segmented format (default 
+is 1MB, range is 1KB `- 64MB). Returns `*this for method chaining.&]
+[s3;%- &]
+[s4;%- &]
+[s5;:Upp`:`:Aes256Gcm`:`:KeyCache`(bool`):%- Aes256Gcm[@(0.0.255) `&] 
+[* KeyCache]([@(0.0.255) bool] [*@3 b] [@(0.0.255) `=] [@(0.0.255) true])&]
+[s2; Enables the cache of derived keys (default is true). Without 
+the cache, every segmented encryption derives the PBKDF2 key with 
+new random salt. 
+Returns `*this for method chaining.&]
+[s3;%- &]
+[s4;%- &]
 [s5;:Upp`:`:Aes256Gcm`:`:Encrypt`(Stream`&`,const String`&`,Stream`&`):%- [@(0.0.255) b
 ool] [* Encrypt](Stream[@(0.0.255) `&] [*@3 in], [@(0.0.255) const] String[@(0.0.255) `&] 
 [*@3 password], Stream[@(0.0.255) `&] [*@3 out])&]
@@ -173,4 +222,28 @@ writes the decrypted chunks into ][*@3 out][%%  stream. Returns true
 on success. ][*@3 password ][%% can be empty or null. ]WhenProgress 
 event can be used to track or abort the process.&]
 [s3;%- &]
+[s4;%- &]
+[s5;:Upp`:`:CoAES256Encrypt`(const String`&`,const String`&`,Gate`):%- String 
+[* CoAES256Encrypt]([@(0.0.255) const] String[@(0.0.255) `&] [*@3 in], 
+[@(0.0.255) const] String[@(0.0.255) `&] [*@3 password], Gate<int64, 
+int64> WhenProgress [@(0.0.255) `=] [*@3 Null])&]
+[s5;:Upp`:`:CoAES256Decrypt`(const String`&`,const String`&`,Gate`):%- String 
+[* CoAES256Decrypt]([@(0.0.255) const] String[@(0.0.255) `&] [*@3 in], 
+[@(0.0.255) const] String[@(0.0.255) `&] [*@3 password], Gate<int64, 
+int64> WhenProgress [@(0.0.255) `=] [*@3 Null])&]
+[s5;:Upp`:`:CoAES256Encrypt`(Stream`&`,const String`&`,Stream`&`,Gate`):%- [@(0.0.255) b
+ool] [* CoAES256Encrypt](Stream[@(0.0.255) `&] [*@3 in], [@(0.0.255) const] 
+String[@(0.0.255) `&] [*@3 password], Stream[@(0.0.255) `&] [*@3 out], 
+Gate<int64, int64> WhenProgress [@(0.0.255) `=] [*@3 Null])&]
+[s5;:Upp`:`:CoAES256Decrypt`(Stream`&`,const String`&`,Stream`&`,Gate`):%- [@(0.0.255) b
+ool] [* CoAES256Decrypt](Stream[@(0.0.255) `&] [*@3 in], [@(0.0.255) const] 
+String[@(0.0.255) `&] [*@3 password], Stream[@(0.0.255) `&] [*@3 out], 
+Gate<int64, int64> WhenProgress [@(0.0.255) `=] [*@3 Null])&]
+[s2; Same as AES256Encrypt / AES256Decrypt, but using the segmented 
+format in parallel.&]
+[s3;%- &]
+[s4;%- &]
+[s5;:Upp`:`:ClearAES256KeyCache`(`):%- [@(0.0.255) void] [* ClearAES256KeyCache]()&]
+[s2; Wipes all cached derived keys.&]
+[s3;%- &]
 [s0; ]]
\ No newline at end of file
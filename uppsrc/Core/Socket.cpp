@@ -11,6 +11,14 @@
 
 #ifdef PLATFORM_POSIX
 #include <arpa/inet.h>
+#include <sys/uio.h>
+#endif
+
+#ifdef PLATFORM_LINUX
+#include <netinet/tcp.h>
+#ifndef TCP_FASTOPEN_CONNECT
+#define TCP_FASTOPEN_CONNECT 30
+#endif
 #endif
 
 namespace Upp {
@@ -49,6 +57,180 @@ int sGetAddrInfo(const char *host, const char *port, int family, addrinfo **resu
 	return getaddrinfo(host, port, &hints, result);
 }
 
+struct sDnsCacheEntry : Moveable<sDnsCacheEntry> {
+	Vector<String> addr; // raw sockaddr data, empty means negative entry
+	int            expires;
+};
+
+static VectorMap<String, sDnsCacheEntry> sDnsCache; // guarded by IpAddrInfoPoolMutex
+static int sDnsTTL = 30000;
+static int sDnsNegativeTTL = 5000;
+static int sDnsMaxCount = 4096;
+static int sDnsHits;
+static int sDnsMisses;
+
+String IpAddrInfo::CacheKey(const char *host, int family)
+{
+	return String() << family << ':' << ToLower(host);
+}
+
+void IpAddrInfo::FreeAddrInfo(addrinfo *ai)
+{
+	MemoryFree(ai);
+}
+
+addrinfo *IpAddrInfo::MakeAddrInfo(const Vector<String>& addr, const char *port)
+{ // single block with addrinfo list and addresses, released by FreeAddrInfo
+	if(addr.GetCount() == 0)
+		return NULL;
+	int sz = addr.GetCount() * sizeof(addrinfo);
+	for(const String& a : addr)
+		sz += (a.GetCount() + 15) & ~15;
+	byte *block = (byte *)MemoryAlloc(sz);
+	memset(block, 0, sz);
+	addrinfo *ai = (addrinfo *)block;
+	byte *sa = block + addr.GetCount() * sizeof(addrinfo);
+	int p = atoi(port);
+	for(int i = 0; i < addr.GetCount(); i++) {
+		const String& a = addr[i];
+		memcpy(sa, ~a, a.GetCount());
+		addrinfo& h = ai[i];
+		h.ai_addr = (sockaddr *)sa;
+		h.ai_addrlen = a.GetCount();
+		h.ai_family = h.ai_addr->sa_family;
+		h.ai_socktype = SOCK_STREAM;
+		h.ai_protocol = IPPROTO_TCP;
+		if(h.ai_family == AF_INET6)
+			((sockaddr_in6 *)sa)->sin6_port = htons(p);
+		else
+			((sockaddr_in *)sa)->sin_port = htons(p);
+		h.ai_next = i + 1 < addr.GetCount() ? ai + i + 1 : NULL;
+		sa += (a.GetCount() + 15) & ~15;
+	}
+	return ai;
+}
+
+static void sDnsCacheShrink()
+{
+	if(sDnsCache.GetCount() < sDnsMaxCount)
+		return;
+	int tm = msecs();
+	Vector<int> expired;
+	for(int i = 0; i < sDnsCache.GetCount(); i++)
+		if(sDnsCache[i].expires - tm <= 0)
+			expired.Add(i);
+	sDnsCache.Remove(expired);
+	if(sDnsCache.GetCount() >= sDnsMaxCount) // still too many, drop the oldest half
+		sDnsCache.Remove(0, sDnsCache.GetCount() / 2);
+}
+
+void IpAddrInfo::CachePut(const String& key, Vector<String>&& addr, int ttl)
+{ // call in pool lock
+	if(ttl <= 0)
+		return;
+	sDnsCacheShrink();
+	int q = sDnsCache.Find(key);
+	if(q >= 0) // keep order of insertion for shrinking
+		sDnsCache.Remove(q);
+	sDnsCacheEntry& e = sDnsCache.Add(key);
+	e.addr = pick(addr);
+	e.expires = msecs() + ttl;
+}
+
+void IpAddrInfo::CachePut(const String& key, addrinfo *result)
+{ // call in pool lock
+	Vector<String> addr;
+	for(addrinfo *rp = result; rp; rp = rp->ai_next)
+		if(rp->ai_addr && rp->ai_addrlen)
+			addr.Add(String((const char *)rp->ai_addr, (int)rp->ai_addrlen));
+	CachePut(key, pick(addr), result ? sDnsTTL : sDnsNegativeTTL);
+}
+
+bool IpAddrInfo::CacheGet(Entry *e)
+{ // call in pool lock
+	int q = sDnsCache.Find(CacheKey(e->host, e->family));
+	if(q >= 0) {
+		const sDnsCacheEntry& c = sDnsCache[q];
+		if(c.expires - msecs() > 0) {
+			e->addr = MakeAddrInfo(c.addr, e->port);
+			e->status = e->addr ? RESOLVED : FAILED;
+			sDnsHits++;
+			return true;
+		}
+		sDnsCache.Remove(q);
+	}
+	sDnsMisses++;
+	return false;
+}
+
+void IpAddrInfo::AddToCache(const String& host, int family, const Vector<String>& ip, int ttl)
+{
+	Vector<String> addr;
+	for(const String& s : ip) {
+		sockaddr_in sin;
+		sockaddr_in6 sin6;
+		Zero(sin);
+		Zero(sin6);
+		if(inet_pton(AF_INET, ~s, &sin.sin_addr) == 1) {
+			sin.sin_family = AF_INET;
+			addr.Add(String((const char *)&sin, sizeof(sin)));
+		}
+		else
+		if(inet_pton(AF_INET6, ~s, &sin6.sin6_addr) == 1) {
+			sin6.sin6_family = AF_INET6;
+			addr.Add(String((const char *)&sin6, sizeof(sin6)));
+		}
+	}
+	EnterPool();
+	CachePut(CacheKey(host, family), pick(addr), ttl);
+	LeavePool();
+}
+
+void IpAddrInfo::CacheTTL(int ms)
+{
+	EnterPool();
+	sDnsTTL = ms;
+	LeavePool();
+}
+
+void IpAddrInfo::CacheNegativeTTL(int ms)
+{
+	EnterPool();
+	sDnsNegativeTTL = ms;
+	LeavePool();
+}
+
+void IpAddrInfo::CacheMaxCount(int n)
+{
+	EnterPool();
+	sDnsMaxCount = max(n, 1);
+	LeavePool();
+}
+
+void IpAddrInfo::ClearCache()
+{
+	EnterPool();
+	sDnsCache.Clear();
+	sDnsHits = sDnsMisses = 0;
+	LeavePool();
+}
+
+int IpAddrInfo::GetCacheHits()
+{
+	EnterPool();
+	int n = sDnsHits;
+	LeavePool();
+	return n;
+}
+
+int IpAddrInfo::GetCacheMisses()
+{
+	EnterPool();
+	int n = sDnsMisses;
+	LeavePool();
+	return n;
+}
+
 auxthread_t auxthread__ IpAddrInfo::Thread(void *ptr)
 {
 	Entry *entry = (Entry *)ptr;
@@ -61,24 +243,33 @@ auxthread_t auxthread__ IpAddrInfo::Thread(void *ptr)
 		strcpy(port, entry->port);
 		LeavePool();
 		addrinfo *result;
-		if(sGetAddrInfo(host, port, family, &result) == 0 && result) {
-			EnterPool();
-			if(entry->status == WORKING) {
-				entry->addr = result;
-				entry->status = RESOLVED;
-			}
-			else {
-				freeaddrinfo(result);
-				entry->status = EMPTY;
+		if(sGetAddrInfo(host, port, family, &result) != 0)
+			result = NULL;
+		EnterPool();
+		String key = CacheKey(host, family);
+		CachePut(key, result);
+		Vector<String> addr;
+		if(sDnsCache.Find(key) >= 0)
+			addr = clone(sDnsCache.Get(key).addr);
+		else // cache is disabled
+			for(addrinfo *rp = result; rp; rp = rp->ai_next)
+				addr.Add(String((const char *)rp->ai_addr, (int)rp->ai_addrlen));
+		if(result)
+			freeaddrinfo(result);
+		for(int i = 0; i < COUNT; i++) { // finish this entry and all entries waiting for the same lookup
+			Entry *e = pool + i;
+			if(e == entry || e->waiting && e->status == WORKING && e->family == family &&
+			                 CacheKey(e->host, e->family) == key) {
+				if(e->status == WORKING) {
+					e->addr = MakeAddrInfo(addr, e->port);
+					e->status = e->addr ? RESOLVED : FAILED;
+				}
+				else
+				if(e->status == CANCELED)
+					e->status = EMPTY;
+				e->waiting = false;
 			}
 		}
-		else {
-			EnterPool();
-			if(entry->status == CANCELED)
-				entry->status = EMPTY;
-			else
-				entry->status = FAILED;
-		}
 	}
 	LeavePool();
 	return 0;
@@ -88,9 +279,29 @@ bool IpAddrInfo::Execute(const String& host, int port, int family)
 {
 	Clear();
 	entry = exe;
-	addrinfo *result;
-	entry->addr = sGetAddrInfo(~host, ~AsString(port), family, &result) == 0 ? result : NULL;
-	entry->status = entry->addr ? RESOLVED : FAILED;
+	String p = AsString(port);
+	entry->host = host;
+	entry->port = p;
+	entry->family = family;
+	EnterPool();
+	bool cached = CacheGet(entry);
+	LeavePool();
+	if(!cached) {
+		addrinfo *result;
+		if(sGetAddrInfo(~host, ~p, family, &result) != 0)
+			result = NULL;
+		Vector<String> addr;
+		for(addrinfo *rp = result; rp; rp = rp->ai_next)
+			addr.Add(String((const char *)rp->ai_addr, (int)rp->ai_addrlen));
+		entry->addr = MakeAddrInfo(addr, p);
+		entry->status = entry->addr ? RESOLVED : FAILED;
+		EnterPool();
+		CachePut(CacheKey(host, family), result);
+		LeavePool();
+		if(result)
+			freeaddrinfo(result);
+	}
+	entry->host = entry->port = NULL;
 	return entry->addr;
 }
 
@@ -104,6 +315,7 @@ void IpAddrInfo::Start()
 		if(e->status == EMPTY) {
 			entry = e;
 			e->addr = NULL;
+			e->waiting = false;
 			if(host.GetCount() > 1024 || port.GetCount() > 256)
 				e->status = FAILED;
 			else {
@@ -111,7 +323,19 @@ void IpAddrInfo::Start()
 				e->host = host;
 				e->port = port;
 				e->family = family;
-				StartAuxThread(&IpAddrInfo::Thread, e);
+				if(CacheGet(e))
+					break;
+				String key = CacheKey(host, family);
+				for(int j = 0; j < COUNT; j++) {
+					Entry *w = pool + j;
+					if(w != e && w->status == WORKING && !w->waiting && w->family == family &&
+					   CacheKey(w->host, w->family) == key) {
+						e->waiting = true; // the same lookup is already running
+						break;
+					}
+				}
+				if(!e->waiting)
+					StartAuxThread(&IpAddrInfo::Thread, e);
 			}
 			break;
 		}
@@ -153,8 +377,8 @@ void IpAddrInfo::Clear()
 	EnterPool();
 	if(entry) {
 		if(entry->status == RESOLVED && entry->addr)
-			freeaddrinfo(entry->addr);
-		if(entry->status == WORKING)
+			FreeAddrInfo(entry->addr);
+		if(entry->status == WORKING && !entry->waiting)
 			entry->status = CANCELED;
 		else
 			entry->status = EMPTY;
@@ -270,7 +494,7 @@ void Socket::Reset()
 	is_eof = false;
 	socket = INVALID_SOCKET;
 	ipv6 = false;
-	ptr = end = buffer;
+	ptr = end = ~buffer;
 	is_error = false;
 	is_abort = false;
 	is_timeout = false;
@@ -291,6 +515,68 @@ Socket::Socket()
 	timeout = global_timeout = start_time = Null;
 	waitstep = 10;
 	asn1 = false;
+	buffersize = DEFAULT_BUFFERSIZE;
+	rcvbuf = sndbuf = Null;
+	quickack = false;
+	fastopen = 0;
+}
+
+Socket& Socket::ReadBufferSize(int bytes)
+{
+	bytes = max(bytes, 512);
+	int pending = int(end - ptr);
+	if(buffer && bytes != buffersize) {
+		if(pending > 0) { // keep data that were already received
+			Buffer<char> h(max(bytes, pending));
+			memcpy(~h, ptr, pending);
+			buffer = pick(h);
+			bytes = max(bytes, pending);
+		}
+		else
+			buffer.Clear();
+		ptr = ~buffer;
+		end = ptr + max(pending, 0);
+	}
+	buffersize = bytes;
+	return *this;
+}
+
+Socket& Socket::RecvBufferSize(int bytes)
+{
+	rcvbuf = bytes;
+	if(IsOpen())
+		ApplyOptions();
+	return *this;
+}
+
+Socket& Socket::SendBufferSize(int bytes)
+{
+	sndbuf = bytes;
+	if(IsOpen())
+		ApplyOptions();
+	return *this;
+}
+
+Socket& Socket::QuickAck(bool b)
+{
+	quickack = b;
+	return *this;
+}
+
+Socket& Socket::FastOpen(int queue_length)
+{
+	fastopen = queue_length;
+	return *this;
+}
+
+void Socket::ApplyOptions()
+{
+	if(!IsNull(rcvbuf) &&
+	   setsockopt(socket, SOL_SOCKET, SO_RCVBUF, (const char *)&rcvbuf, sizeof(rcvbuf)))
+		SetSockError("setsockopt(SO_RCVBUF)");
+	if(!IsNull(sndbuf) &&
+	   setsockopt(socket, SOL_SOCKET, SO_SNDBUF, (const char *)&sndbuf, sizeof(sndbuf)))
+		SetSockError("setsockopt(SO_SNDBUF)");
 }
 
 bool Socket::SetupSocket()
@@ -311,7 +597,8 @@ bool Socket::SetupSocket()
 		return false;
 	}
 #endif
-	return true;
+	ApplyOptions();
+	return !IsError();
 }
 
 bool Socket::Open(int family, int type, int protocol)
@@ -360,6 +647,10 @@ bool Socket::Listen(int port, int listen_count, bool ipv6_, bool reuse, void *ad
 		int optval = 1;
 		setsockopt(socket, SOL_SOCKET, SO_REUSEADDR, (const char *)&optval, sizeof(optval));
 	}
+#ifdef PLATFORM_LINUX
+	if(fastopen) // just a hint, kernel can have it disabled
+		setsockopt(socket, IPPROTO_TCP, TCP_FASTOPEN, (const char *)&fastopen, sizeof(fastopen));
+#endif
 	if(bind(socket, ipv6 ? (const sockaddr *)&sin6 : (const sockaddr *)&sin,
 	        ipv6 ? sizeof(sin6) : sizeof(sin))) {
 		SetSockError(Format("bind(port=%d)", port));
@@ -458,6 +749,12 @@ bool Socket::RawConnect(addrinfo *arp)
 		while(rp) {
 			if(rp->ai_family == AF_INET == !pass && // Try to connect IPv4 in the first pass
 			   Open(rp->ai_family, rp->ai_socktype, rp->ai_protocol)) {
+			#ifdef PLATFORM_LINUX
+				if(fastopen) {
+					int optval = 1;
+					setsockopt(socket, IPPROTO_TCP, TCP_FASTOPEN_CONNECT, (const char *)&optval, sizeof(optval));
+				}
+			#endif
 				if(connect(socket, rp->ai_addr, (int)rp->ai_addrlen) == 0 ||
 				   GetErrorCode() == SOCKERR(EINPROGRESS) || GetErrorCode() == SOCKERR(EWOULDBLOCK)
 				) {
@@ -585,6 +882,42 @@ int Socket::Send(const void *buf, int amount)
 	return ssl ? ssl->Send(buf, amount) : RawSend(buf, amount);
 }
 
+int Socket::RawSendV(const char **data, const int *len, int count)
+{ // gather write of count blocks with single syscall
+	enum { MAXV = 64 };
+	count = min((int)MAXV, count);
+#ifdef PLATFORM_WIN32
+	WSABUF v[MAXV];
+	for(int i = 0; i < count; i++) {
+		v[i].buf = (CHAR *)data[i];
+		v[i].len = len[i];
+	}
+	DWORD sent = 0;
+	int res = WSASend(socket, v, count, &sent, 0, NULL, NULL) ? -1 : (int)sent;
+#else
+	iovec v[MAXV];
+	for(int i = 0; i < count; i++) {
+		v[i].iov_base = (void *)data[i];
+		v[i].iov_len = len[i];
+	}
+	msghdr msg;
+	Zero(msg);
+	msg.msg_iov = v;
+	msg.msg_iovlen = count;
+#ifdef PLATFORM_LINUX
+	int res = (int)sendmsg(socket, &msg, MSG_NOSIGNAL);
+#else
+	int res = (int)sendmsg(socket, &msg, 0);
+#endif
+#endif
+	if(res < 0 && WouldBlock())
+		res = 0;
+	else
+	if(res == 0 || res < 0)
+		SetSockError("sendmsg");
+	return res;
+}
+
 void Socket::Shutdown()
 {
 	ASSERT(IsOpen());
@@ -742,9 +1075,87 @@ bool Socket::PutAll(const String& s)
 	return true;
 }
 
+int Socket::Put(const String *s, int count)
+{
+	LLOG("Put " << socket << ": " << count << " parts");
+	ASSERT(IsOpen());
+	if(ssl) { // SSL has to encrypt parts anyway, no gain in gathering
+		int total = 0;
+		for(int i = 0; i < count; i++) {
+			int n = Put(s[i]);
+			total += n;
+			if(n != s[i].GetCount())
+				break;
+		}
+		done = total;
+		return total;
+	}
+	if(IsError() || IsAbort())
+		return 0;
+	Buffer<const char *> data(count);
+	Buffer<int> len(count);
+	int n = 0;
+	for(int i = 0; i < count; i++)
+		if(s[i].GetCount()) {
+			data[n] = s[i].begin();
+			len[n++] = s[i].GetCount();
+		}
+	int total = 0;
+	int i = 0;
+	bool peek = false;
+	int end_time = GetEndTime();
+	while(i < n) {
+		if(peek && !Wait(WAIT_WRITE, end_time))
+			break;
+		peek = false;
+		int count = RawSendV(~data + i, ~len + i, n - i);
+		if(IsError())
+			break;
+		if(count > 0) {
+			total += count;
+			while(i < n && count >= len[i])
+				count -= len[i++];
+			if(i < n) {
+				data[i] += count;
+				len[i] -= count;
+			}
+		}
+		else
+			peek = true;
+	}
+	done = total;
+	LLOG("//Put() -> " << total);
+	return total;
+}
+
+bool Socket::PutAll(const String *s, int count)
+{
+	int len = 0;
+	for(int i = 0; i < count; i++)
+		len += s[i].GetCount();
+	if(Put(s, count) != len) {
+		if(!IsError())
+			SetSockError("GePutAll", -1, "timeout");
+		return false;
+	}
+	return true;
+}
+
+bool Socket::PutAll(const String& s1, const String& s2)
+{
+	String h[2] = { s1, s2 };
+	return PutAll(h, 2);
+}
+
 int Socket::RawRecv(void *buf, int amount)
 {
 	int res = recv(socket, (char *)buf, amount, 0);
+#ifdef PLATFORM_LINUX
+	if(quickack && res > 0) { // TCP_QUICKACK is not permanent, has to be renewed
+		int optval = 1;
+		setsockopt(socket, IPPROTO_TCP, TCP_QUICKACK, (const char *)&optval, sizeof(optval));
+	}
+#endif
 	if(res == 0)
 		is_eof = true;
 	else
@@ -766,11 +1177,19 @@ int Socket::Recv(void *buffer, int maxlen)
 	return ssl ? ssl->Recv(buffer, maxlen) : RawRecv(buffer, maxlen);
 }
 
+void Socket::RecvBuffer()
+{
+	if(!buffer)
+		buffer.Alloc(buffersize);
+	ptr = end = ~buffer;
+	end += max(Recv(~buffer, buffersize), 0);
+}
+
 void Socket::ReadBuffer(int end_time)
 {
-	ptr = end = buffer;
+	ptr = end = ~buffer;
 	if(Wait(WAIT_READ, end_time))
-		end = buffer + Recv(buffer, BUFFERSIZE);
+		RecvBuffer();
 }
 
 bool Socket::IsEof() const
@@ -824,7 +1243,15 @@ int Socket::Get(void *buffer, int count)
 	while(done < count && !IsError() && !IsEof()) {
 		if(!Wait(WAIT_READ, end_time))
 			break;
-		int part = Recv((char *)buffer + done, count - done);
+		int part;
+		if(count - done < buffersize) { // small remainder, read ahead to save recv calls
+			RecvBuffer();
+			part = min(int(end - ptr), count - done);
+			memcpy((char *)buffer + done, ptr, part);
+			ptr += part;
+		}
+		else
+			part = Recv((char *)buffer + done, count - done);
 		if(part > 0)
 			done += part;
 		if(timeout == 0)
@@ -883,16 +1310,25 @@ String Socket::GetLine(int maxlen)
 			}
 			return String::GetVoid();
 		}
-		Get();
-		if(c == '\n')
+		const char *eol = (const char *)memchr(ptr, '\n', end - ptr);
+		const char *e = eol ? eol : end;
+		for(const char *s = ptr; s < e;) { // copy the whole chunk of buffer, skip '\r'
+			const char *q = (const char *)memchr(s, '\r', e - s);
+			if(!q)
+				q = e;
+			if(ln.GetCount() + (q - s) > maxlen) {
+				if(!IsError())
+					SetSockError("GetLine", -1, "maximal length exceeded");
+				return String::GetVoid();
+			}
+			ln.Cat(s, int(q - s));
+			s = q + (q < e);
+		}
+		ptr = (char *)e;
+		if(eol) {
+			ptr++;
 			return ln;
-		if(ln.GetCount() >= maxlen) {
-			if(!IsError())
-				SetSockError("GetLine", -1, "maximal length exceeded");
-			return String::GetVoid();
 		}
-		if(c != '\r')
-			ln.Cat(c);
 	}
 }
 
@@ -1138,6 +1574,50 @@ bool Socket::ListenAbstract(const String& path, int listen_count, bool reuse)
 	return NixListen(path, listen_count, reuse, true);
 }
 
+#ifdef PLATFORM_POSIX
+
+int SocketWaitEvent::Wait(int timeout)
+{ // poll has no FD_SETSIZE limit, so this scales to thousands of sockets
+	pfd.SetCount(socket.GetCount());
+	for(int i = 0; i < socket.GetCount(); i++) {
+		const Tuple<int, dword>& s = socket[i];
+		pollfd& p = pfd[i];
+		p.fd = s.a; // negative fd is ignored by poll
+		p.events = 0;
+		p.revents = 0;
+		if(s.b & WAIT_READ)
+			p.events |= POLLIN;
+		if(s.b & WAIT_WRITE)
+			p.events |= POLLOUT;
+	}
+	int n;
+	do
+		n = poll(pfd, pfd.GetCount(), IsNull(timeout) ? -1 : timeout);
+	while(n < 0 && errno == EINTR);
+	return n;
+}
+
+dword SocketWaitEvent::Get(int i) const
+{
+	if(i >= pfd.GetCount() || pfd[i].fd < 0)
+		return 0;
+	dword events = 0;
+	int r = pfd[i].revents;
+	if(r & (POLLIN|POLLHUP))
+		events |= WAIT_READ;
+	if(r & POLLOUT)
+		events |= WAIT_WRITE;
+	if(r & (POLLERR|POLLPRI|POLLNVAL))
+		events |= WAIT_IS_EXCEPTION;
+	return events;
+}
+
+SocketWaitEvent::SocketWaitEvent()
+{
+}
+
+#else
+
 int SocketWaitEvent::Wait(int timeout)
 {
 	FD_ZERO(read);
@@ -1188,4 +1668,6 @@ SocketWaitEvent::SocketWaitEvent()
 	FD_ZERO(exception);
 }
 
+#endif
+
 }
@@ -2,141 +2,249 @@
 
 namespace Upp {
 
+// Conversions process the input in blocks of 16 (or 32) code units. Blocks that contain only
+// ASCII characters are validated and converted with SIMD, other blocks are converted one code
+// point at a time.
+
+#ifdef CPU_SIMD
+
+force_inline bool IsAsciiBlock(const char *s, int n)
+{
+	return !AnyTrue((n == 32 ? i8x16(s) | i8x16(s + 16) : i8x16(s)) < i8all(0));
+}
+
+force_inline bool IsAsciiBlock(const char16 *s, int)
+{
+	return AllTrue(((i16x8(s) | i16x8(s + 8)) & i16all(~0x7f)) == i16all(0));
+}
+
+force_inline bool IsAsciiBlock(const wchar *s, int)
+{
+	return AllTrue(((i32x4(s) | i32x4(s + 4) | i32x4(s + 8) | i32x4(s + 12)) & i32all(~0x7f)) == i32all(0));
+}
+
+force_inline void AsciiBlock(char *t, const char16 *s)
+{
+	Pack16(i16x8(s), i16x8(s + 8)).Store(t);
+}
+
+force_inline void AsciiBlock(char *t, const wchar *s)
+{
+	Pack16(Pack32(i32x4(s), i32x4(s + 4)), Pack32(i32x4(s + 8), i32x4(s + 12))).Store(t);
+}
+
+force_inline void AsciiBlock(char16 *t, const char *s)
+{
+	i8x16 v(s);
+	Unpack8L(v).Store(t);
+	Unpack8H(v).Store(t + 8);
+}
+
+force_inline void AsciiBlock(char16 *t, const wchar *s)
+{
+	Pack32(i32x4(s), i32x4(s + 4)).Store(t);
+	Pack32(i32x4(s + 8), i32x4(s + 12)).Store(t + 8);
+}
+
+force_inline void AsciiBlock(wchar *t, const char *s)
+{
+	i8x16 v(s);
+	i16x8 l = Unpack8L(v);
+	i16x8 h = Unpack8H(v);
+	Unpack16L(l).Store(t);
+	Unpack16H(l).Store(t + 4);
+	Unpack16L(h).Store(t + 8);
+	Unpack16H(h).Store(t + 12);
+}
+
+force_inline void AsciiBlock(wchar *t, const char16 *s)
+{
+	i16x8 l(s);
+	i16x8 h(s + 8);
+	Unpack16L(l).Store(t);
+	Unpack16H(l).Store(t + 4);
+	Unpack16L(h).Store(t + 8);
+	Unpack16H(h).Store(t + 12);
+}
+
+#else
+
+template <class T, class S>
+force_inline void AsciiBlock(T *t, const S *s)
+{ // not used without SIMD
+	for(int i = 0; i < 16; i++)
+		t[i] = (T)s[i];
+}
+
+#endif
+
+template <int N, class T, class Ascii, class Slow>
+force_inline void Utf_Blocks(const T *s, const T *lim, Ascii ascii, Slow slow)
+{ // ascii(s) handles N ASCII characters, slow(s) handles single code point and advances s
+#ifdef CPU_SIMD
+	while(lim - s >= N)
+		if(IsAsciiBlock(s, N)) {
+			ascii(s);
+			s += N;
+		}
+		else {
+			const T *e = s + N;
+			while(s < e)
+				slow(s);
+		}
+#endif
+	while(s < lim)
+		slow(s);
+}
+
+template <class T, class S, class Slow>
+force_inline T *Utf_Convert(T *t, const S *s, int len, Slow slow)
+{
+	Utf_Blocks<16>(s, s + len, [&](const S *s) { AsciiBlock(t, s); t += 16; }, [&](const S *&s) { slow(t, s); });
+	return t;
+}
+
 bool CheckUtf8(const char *s, int len)
 {
-	return FromUtf8_([](wchar) {}, s, len);
+	bool ok = true;
+	const char *lim = s + len;
+	Utf_Blocks<32>(s, lim, [](const char *) {}, [&](const char *&s) { FetchUtf8(s, lim, ok); });
+	return ok;
 }
 
 int Utf8Len(const wchar *s, int len)
 {
 	int rlen = 0;
-	for(const wchar *lim = s + len; s < lim; s++)
-		ToUtf8_([&](char) { rlen++; }, *s);
+	Utf_Blocks<16>(s, s + len, [&](const wchar *) { rlen += 16; },
+	               [&](const wchar *&s) { ToUtf8_([&](char) { rlen++; }, *s++); });
 	return rlen;
 }
 
 void ToUtf8(char *t, const wchar *s, int len)
 {
-	for(const wchar *lim = s + len; s < lim; s++)
-		ToUtf8_([&](char c) { *t++ = c; }, *s);
+	Utf_Convert(t, s, len, [](char *&t, const wchar *&s) { ToUtf8_([&](char c) { *t++ = c; }, *s++); });
 }
 
 String ToUtf8(const wchar *s, int len)
 {
-	String r;
-	for(const wchar *lim = s + len; s < lim; s++)
-		ToUtf8_([&](char c) { r.Cat(c); }, *s);
-	return r;
+	StringBuffer r(Utf8Len(s, len));
+	ToUtf8(r, s, len);
+	return String(r);
 }
 
 int Utf8Len(const char16 *s, int len)
 {
 	int rlen = 0;
-	FromUtf16_([&](wchar code) { ToUtf8_([&](char c) { rlen++; }, code); }, s, len);
+	const char16 *lim = s + len;
+	Utf_Blocks<16>(s, lim, [&](const char16 *) { rlen += 16; },
+	               [&](const char16 *&s) { ToUtf8_([&](char) { rlen++; }, FetchUtf16(s, lim)); });
 	return rlen;
 }
 
 void ToUtf8(char *t, const char16 *s, int len)
 {
-	FromUtf16_([&](wchar code) { ToUtf8_([&](char c) { *t++ = c; }, code); }, s, len);
+	const char16 *lim = s + len;
+	Utf_Convert(t, s, len, [&](char *&t, const char16 *&s) { ToUtf8_([&](char c) { *t++ = c; }, FetchUtf16(s, lim)); });
 }
 
 String ToUtf8(const char16 *s, int len)
 {
-	StringBuffer r;
-	r.Reserve(len);
-	FromUtf16_([&](wchar code) { ToUtf8_([&](char c) { r.Cat(c); }, code); }, s, len);
+	StringBuffer r(Utf8Len(s, len));
+	ToUtf8(r, s, len);
 	return String(r);
 }
 
 int Utf16Len(const wchar *s, int len)
 {
 	int rlen = 0;
-	for(const wchar *lim = s + len; s < lim; s++)
-		ToUtf16_([&](char16) { rlen++; }, *s);
+	Utf_Blocks<16>(s, s + len, [&](const wchar *) { rlen += 16; },
+	               [&](const wchar *&s) { ToUtf16_([&](char16) { rlen++; }, *s++); });
 	return rlen;
 }
 
 int ToUtf16(char16 *t, const wchar *s, int len)
 {
 	char16 *t0 = t;
-	for(const wchar *lim = s + len; s < lim; s++)
-		ToUtf16_([&](char16 c) { *t++ = c; }, *s);
+	t = Utf_Convert(t, s, len, [](char16 *&t, const wchar *&s) { ToUtf16_([&](char16 c) { *t++ = c; }, *s++); });
 	return int(t - t0);
 }
 
 Vector<char16> ToUtf16(const wchar *s, int len)
 {
 	Vector<char16> r;
-	r.Reserve(len);
-	for(const wchar *lim = s + len; s < lim; s++)
-		ToUtf16_([&](char16 c) { r.Add(c); }, *s);
+	r.SetCount(Utf16Len(s, len));
+	ToUtf16(r, s, len);
 	return r;
 }
 
 int Utf16Len(const char *s, int len)
 {
 	int rlen = 0;
-	FromUtf8_([&](wchar code) {
-		ToUtf16_([&](char16) { rlen++; }, code);
-	}, s, len);
+	const char *lim = s + len;
+	Utf_Blocks<32>(s, lim, [&](const char *) { rlen += 32; },
+	               [&](const char *&s) { ToUtf16_([&](char16) { rlen++; }, FetchUtf8(s, lim)); });
 	return rlen;
 }
 
 int ToUtf16(char16 *t, const char *s, int len)
 {
 	char16 *t0 = t;
-	FromUtf8_([&](wchar code) {
-		ToUtf16_([&](char16 c) { *t++ = c; }, code);
-	}, s, len);
+	const char *lim = s + len;
+	t = Utf_Convert(t, s, len, [&](char16 *&t, const char *&s) { ToUtf16_([&](char16 c) { *t++ = c; }, FetchUtf8(s, lim)); });
 	return int(t - t0);
 }
 
 Vector<char16> ToUtf16(const char *s, int len)
-{
+{ // UTF-16 never has more code units than UTF-8 bytes
 	Vector<char16> r;
-	FromUtf8_([&](wchar code) {
-		ToUtf16_([&](char16 c) { r.Add(c); } , code);
-	}, s, len);
+	r.SetCount(len);
+	r.Trim(ToUtf16(r, s, len));
 	return r;
 }
 
 int Utf32Len(const char *s, int len)
 {
 	int rlen = 0;
-	FromUtf8_([&](wchar) { rlen++; }, s, len);
+	const char *lim = s + len;
+	Utf_Blocks<32>(s, lim, [&](const char *) { rlen += 32; }, [&](const char *&s) { FetchUtf8(s, lim); rlen++; });
 	return rlen;
 }
 
 void ToUtf32(wchar *t, const char *s, int len)
 {
-	FromUtf8_([&](wchar c) { *t++ = c; }, s, len);
+	const char *lim = s + len;
+	Utf_Convert(t, s, len, [&](wchar *&t, const char *&s) { *t++ = FetchUtf8(s, lim); });
 }
 
 WString ToUtf32(const char *s, int len)
-{
-	WStringBuffer r;
-	FromUtf8_([&](wchar c) { r.Cat(c); }, s, len);
+{ // UTF-32 never has more code units than UTF-8 bytes
+	WStringBuffer r(len);
+	const char *lim = s + len;
+	wchar *t = Utf_Convert(~r, s, len, [&](wchar *&t, const char *&s) { *t++ = FetchUtf8(s, lim); });
+	r.SetLength(int(t - ~r));
 	return WString(r);
 }
 
 int Utf32Len(const char16 *s, int len)
 {
 	int rlen = 0;
-	FromUtf16_([&](wchar) { rlen++; }, s, len);
+	const char16 *lim = s + len;
+	Utf_Blocks<16>(s, lim, [&](const char16 *) { rlen += 16; }, [&](const char16 *&s) { FetchUtf16(s, lim); rlen++; });
 	return rlen;
 }
 
 void ToUtf32(wchar *t, const char16 *s, int len)
 {
-	FromUtf16_([&](wchar c) { *t++ = c; }, s, len);
+	const char16 *lim = s + len;
+	Utf_Convert(t, s, len, [&](wchar *&t, const char16 *&s) { *t++ = FetchUtf16(s, lim); });
 }
 
 WString ToUtf32(const char16 *s, int len)
 {
-	WStringBuffer r;
-	r.Reserve(len);
-	FromUtf16_([&](wchar c) { r.Cat(c); }, s, len);
+	WStringBuffer r(len);
+	const char16 *lim = s + len;
+	wchar *t = Utf_Convert(~r, s, len, [&](wchar *&t, const char16 *&s) { *t++ = FetchUtf16(s, lim); });
+	r.SetLength(int(t - ~r));
 	return WString(r);
 }
 
@@ -111,19 +111,20 @@ force_inline wchar ReadSurrogatePair(const char16 *s, const char16 *lim)
 		   ((wchar(s[0] & 0x3ff) << 10) | (s[1] & 0x3ff)) + 0x10000 : 0;
 }
 
+force_inline wchar FetchUtf16(const char16 *&s, const char16 *lim)
+{
+	wchar c = ReadSurrogatePair(s, lim);
+	if(c) {
+		s += 2;
+		return c;
+	}
+	return *s++;
+}
+
 template <class Target>
 force_inline void FromUtf16_(Target t, const char16 *s, size_t len)
 {
 	const char16 *lim = s + len;
-	while(s < lim) {
-		wchar c = ReadSurrogatePair(s, lim);
-		if(c) {
-			t(c);
-			s += 2;
-		}
-		else {
-			t(*s);
-			s++;
-		}
-	}
-}
+	while(s < lim)
+		t(FetchUtf16(s, lim));
+}
\ No newline at end of file
@@ -8,16 +8,120 @@ StaticMutex ValueCacheMutex;
 
 std::atomic<bool> sValueCacheFinished;
 
-struct ValueMakeCacheClass : LRUCache<Value> {
-	~ValueMakeCacheClass() { sValueCacheFinished = true; }
+// Cache is split to shards selected by the hash of key, each shard has its own RWMutex, so that
+// lookups of cached values run in parallel. Eviction uses CLOCK (second chance) algorithm,
+// which only needs to set 'referenced' flag on hit instead of relinking LRU list. Values
+// that are being made are registered as pending, other threads requesting the same value wait
+// for the result instead of making it again. Make itself runs without any lock held.
+
+struct ValueCacheKey : Moveable<ValueCacheKey> {
+	String      key;
+	const char *type;
+
+	bool operator==(const ValueCacheKey& b) const { return key == b.key && strcmp(type, b.type) == 0; }
+	hash_t GetHashValue() const { return CombineHash(key, memhash(type, strlen(type))); }
+};
+
+struct ValueCacheEntry {
+	Value             value;
+	int               size;
+	std::atomic<bool> referenced;
+};
+
+struct ValueCachePending {
+	Mutex             mutex;
+	ConditionVariable cv;
+	Value             value;
+	int               size = 0;
+	int               waiters = 0;
+	bool              done = false;
+	bool              failed = false;
+};
+
+struct ValueCacheShard {
+	RWMutex                                       lock;
+	Index<ValueCacheKey>                          key;
+	Array<ValueCacheEntry>                        entry;
+	VectorMap<ValueCacheKey, ValueCachePending *> pending;
+	int                                           hand = 0;
+
+	std::atomic<int64>                            hits;
+	std::atomic<int64>                            misses;
+	std::atomic<int64>                            waits;
+	std::atomic<int64>                            evictions;
+
+	bool Get(const ValueCacheKey& k, Value& v, int& sz);
+	void Drop(int i);
+	bool Evict();
+};
+
+struct ValueCacheClass {
+	enum { SHARDS = 16 };
+
+	ValueCacheShard    shard[SHARDS];
+	std::atomic<int64> size;
+	std::atomic<int>   count;
+	int                shrink_hand = 0;
+
+	ValueCacheShard& For(const ValueCacheKey& k) { hash_t h = k.GetHashValue(); return shard[(h ^ (h >> 16)) % SHARDS]; }
+
+	~ValueCacheClass() { sValueCacheFinished = true; }
 };
 
-LRUCache<Value>& TheValueCache()
+static const int ValueCacheInternalSize = 3 * (sizeof(ValueCacheEntry) + sizeof(ValueCacheKey) + 24) / 2;
+
+static ValueCacheClass& sValueCache()
 {
-	static ValueMakeCacheClass m;
+	static ValueCacheClass m;
 	return m;
 }
 
+bool ValueCacheShard::Get(const ValueCacheKey& k, Value& v, int& sz)
+{ // called with lock held for reading or writing
+	int q = key.Find(k);
+	if(q < 0)
+		return false;
+	ValueCacheEntry& e = entry[q];
+	if(!e.referenced.load(std::memory_order_relaxed)) // avoid writing to shared cache line
+		e.referenced.store(true, std::memory_order_relaxed);
+	v = e.value;
+	sz = e.size;
+	hits.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
+
+void ValueCacheShard::Drop(int i)
+{ // called with lock held for writing
+	ValueCacheClass& c = sValueCache();
+	ValueCacheEntry& e = entry[i];
+	c.size -= e.size;
+	c.count--;
+	key.Unlink(i);
+	e.value = Value();
+	e.size = 0;
+}
+
+bool ValueCacheShard::Evict()
+{ // called with lock held for writing
+	int n = entry.GetCount();
+	for(int pass = 0; pass < 2 * n; pass++) {
+		if(hand >= n)
+			hand = 0;
+		int i = hand++;
+		if(key.IsUnlinked(i))
+			continue;
+		ValueCacheEntry& e = entry[i];
+		if(e.referenced.load(std::memory_order_relaxed))
+			e.referenced.store(false, std::memory_order_relaxed);
+		else {
+			Drop(i);
+			evictions++;
+			return true;
+		}
+	}
+	return false;
+}
+
 bool IsValueCacheActive()
 {
 	return !sValueCacheFinished;
@@ -53,9 +157,17 @@ void ShrinkValueCache()
 			lock = false;
 		}
 	}
-	LLOG("MakeValue cache size before shrink: " << TheValueCache().GetSize());
-	TheValueCache().Shrink(ValueCacheMaxSize, ValueCacheMaxCount);
-	LLOG("MakeValue cache size after shrink: " << TheValueCache().GetSize());
+	ValueCacheClass& c = sValueCache();
+	LLOG("MakeValue cache size before shrink: " << c.size);
+	int idle = 0; // evict one value from each shard in turn, stop when a whole round found nothing
+	while((c.size > ValueCacheMaxSize || c.count > ValueCacheMaxCount) && idle < c.SHARDS) {
+		ValueCacheShard& s = c.shard[c.shrink_hand++ % c.SHARDS];
+		s.lock.EnterWrite();
+		bool evicted = s.Evict();
+		s.lock.LeaveWrite();
+		idle = evicted ? 0 : idle + 1;
+	}
+	LLOG("MakeValue cache size after shrink: " << c.size);
 }
 
 void SetupValueCache(int maxsize, int maxcount)
@@ -73,13 +185,89 @@ void SetupValueCache(int maxsize, int maxcount)
 	}
 }
 
-
 Value MakeValueSz(ValueMaker& m, int& sz)
 {
-	Mutex::Lock __(ValueCacheMutex);
-	LLOG("MakeValue cache size before make: " << TheValueCache().GetSize());
-	Value v = TheValueCache().Get(m, [] { ValueCacheMutex.Leave(); }, [] { ValueCacheMutex.Enter(); }, sz);
-	LLOG("MakeValue cache size after make: " << TheValueCache().GetSize());
+	ValueCacheClass& c = sValueCache();
+	ValueCacheKey k;
+	k.key = m.Key();
+	k.type = typeid(m).name();
+	ValueCacheShard& s = c.For(k);
+	Value v;
+
+	for(;;) {
+		s.lock.EnterRead();
+		bool found = s.Get(k, v, sz);
+		s.lock.LeaveRead();
+		if(found)
+			return v;
+
+		s.lock.EnterWrite();
+		if(s.Get(k, v, sz)) {
+			s.lock.LeaveWrite();
+			return v;
+		}
+		int q = s.pending.Find(k);
+		if(q < 0)
+			break;
+		ValueCachePending& p = *s.pending[q]; // another thread is making this value
+		p.mutex.Enter();
+		p.waiters++;
+		p.mutex.Leave();
+		s.waits++;
+		s.lock.LeaveWrite();
+
+		Mutex::Lock __(p.mutex);
+		while(!p.done)
+			p.cv.Wait(p.mutex);
+		bool failed = p.failed;
+		if(!failed) {
+			v = p.value;
+			sz = p.size;
+		}
+		if(--p.waiters == 0)
+			p.cv.Broadcast();
+		if(!failed)
+			return v;
+	}
+
+	ValueCachePending p;
+	s.pending.Add(k, &p);
+	s.misses++;
+	s.lock.LeaveWrite();
+
+	auto Finish = [&] { // pending is on the stack, wait for all waiters to pick the result
+		s.lock.EnterWrite();
+		s.pending.RemoveKey(k);
+		if(!p.failed) {
+			int q = s.key.Put(k);
+			ValueCacheEntry& e = s.entry.At(q);
+			e.value = v;
+			e.size = sz;
+			e.referenced = true;
+			c.size += sz;
+			c.count++;
+		}
+		s.lock.LeaveWrite();
+		Mutex::Lock __(p.mutex);
+		p.value = v;
+		p.size = sz;
+		p.done = true;
+		p.cv.Broadcast();
+		while(p.waiters)
+			p.cv.Wait(p.mutex);
+	};
+
+	try {
+		sz = m.Make(v) + ValueCacheInternalSize;
+	}
+	catch(...) {
+		p.failed = true;
+		Finish();
+		throw;
+	}
+	Finish();
+
+	LLOG("MakeValue cache size after make: " << c.size);
 	ShrinkValueCache();
 	LLOG("-------------");
 	return v;
@@ -91,4 +279,70 @@ Value MakeValue(ValueMaker& m)
 	return MakeValueSz(m, sz);
 }
 
+int ValueCacheRemove_(Function<bool (const Value&)> what, bool one)
+{
+	ValueCacheClass& c = sValueCache();
+	int n = 0;
+	for(ValueCacheShard& s : c.shard) {
+		RWMutex::WriteLock __(s.lock);
+		for(int i = 0; i < s.entry.GetCount(); i++)
+			if(!s.key.IsUnlinked(i) && what(s.entry[i].value)) {
+				s.Drop(i);
+				n++;
+				if(one)
+					return n;
+			}
+	}
+	return n;
+}
+
+void ValueCacheAdjustSize_(Function<int (const Value&)> getsize)
+{
+	ValueCacheClass& c = sValueCache();
+	for(ValueCacheShard& s : c.shard) {
+		RWMutex::WriteLock __(s.lock);
+		for(int i = 0; i < s.entry.GetCount(); i++)
+			if(!s.key.IsUnlinked(i)) {
+				ValueCacheEntry& e = s.entry[i];
+				int sz = getsize(e.value);
+				if(sz >= 0) {
+					c.size += sz + ValueCacheInternalSize - e.size;
+					e.size = sz + ValueCacheInternalSize;
+				}
+			}
+	}
+}
+
+ValueCacheStats GetValueCacheStats()
+{
+	ValueCacheClass& c = sValueCache();
+	ValueCacheStats st;
+	st.hits = st.misses = st.waits = st.evictions = 0;
+	for(ValueCacheShard& s : c.shard) {
+		st.hits += s.hits;
+		st.misses += s.misses;
+		st.waits += s.waits;
+		st.evictions += s.evictions;
+	}
+	st.size = c.size;
+	st.count = c.count;
+	return st;
+}
+
+void ClearValueCacheStats()
+{
+	for(ValueCacheShard& s : sValueCache().shard)
+		s.hits = s.misses = s.waits = s.evictions = 0;
+}
+
+int64 GetValueCacheSize()
+{
+	return sValueCache().size;
+}
+
+int GetValueCacheCount()
+{
+	return sValueCache().count;
+}
+
 };
\ No newline at end of file
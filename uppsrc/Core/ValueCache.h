@@ -1,7 +1,5 @@
 extern StaticMutex ValueCacheMutex;
 
-LRUCache<Value>& TheValueCache();
-
 typedef LRUCache<Value>::Maker ValueMaker;
 
 Value MakeValueSz(ValueMaker& m, int& sz);
@@ -14,25 +12,39 @@ void ShrinkValueCache();
 
 void SetupValueCache(int maxsize, int maxcount);
 
+struct ValueCacheStats {
+	int64 hits;      // values found in the cache
+	int64 misses;    // values created by ValueMaker::Make
+	int64 waits;     // requests that waited for another thread to make the same value
+	int64 evictions; // values dropped to maintain the limits
+	int64 size;      // total size of cached values, including internal overhead
+	int   count;     // number of cached values
+};
+
+ValueCacheStats GetValueCacheStats();
+void            ClearValueCacheStats();
+int64           GetValueCacheSize();
+int             GetValueCacheCount();
+
+int  ValueCacheRemove_(Function<bool (const Value&)> what, bool one);
+void ValueCacheAdjustSize_(Function<int (const Value&)> getsize);
+
 template <class P>
 int ValueCacheRemove(P what)
 {
-	Mutex::Lock __(ValueCacheMutex);
-	return TheValueCache().Remove(what);
+	return ValueCacheRemove_(what, false);
 }
 
 template <class P>
 int ValueCacheRemoveOne(P what)
 {
-	Mutex::Lock __(ValueCacheMutex);
-	return TheValueCache().Remove(what);
+	return ValueCacheRemove_(what, true);
 }
 
 template <class P>
 void ValueCacheAdjustSize(P getsize)
 {
-	Mutex::Lock __(ValueCacheMutex);
-	TheValueCache().AdjustSize(getsize);
+	ValueCacheAdjustSize_(getsize);
 }
 
 template <class M>
@@ -285,25 +285,46 @@ String AsString(const ValueArray& v) {
 	return sAsString(v.Get());
 }
 
+ValueMap::Shape *ValueMap::Data::EmptyShape()
+{ // shared by all maps without keys, never deleted so that global maps destroyed at exit can use it
+	static Shape *empty = [] { MemoryIgnoreLeaksBlock __; return new Shape; }();
+	return empty;
+}
+
+ValueMap::Data::Data()
+{
+	shape = EmptyShape();
+	shape->Retain();
+}
+
+void ValueMap::Data::UnShareShape()
+{
+	Shape *s = new Shape;
+	s->key = clone(shape->key);
+	shape->Release();
+	shape = s;
+}
+
 bool ValueMap::Data::IsNull() const {
 	return this == &Single<ValueMap::NullData>();
 }
 
 void ValueMap::Data::Serialize(Stream& s) {
-	s % key % value;
-	if(key.GetCount() != value.GetCount())
+	s % (s.IsLoading() ? KeyW() : shape->key) % value;
+	if(Key().GetCount() != value.GetCount())
 		s.LoadError();
 }
 
 void ValueMap::Data::Xmlize(XmlIO& xio)
 {
-	Upp::Xmlize(xio, key);
+	Upp::Xmlize(xio, xio.IsLoading() ? KeyW() : shape->key);
 	Upp::Xmlize(xio, value);
 }
 
 void ValueMap::Data::Jsonize(JsonIO& jio)
 {
 	if(jio.IsStoring()) {
+		const Index<Value>& key = Key();
 		ValueArray va;
 		int n = min(value.GetCount(), key.GetCount());
 		for(int i = 0; i < n; i++) {
@@ -316,6 +337,7 @@ void ValueMap::Data::Jsonize(JsonIO& jio)
 	}
 	else {
 		Value va = jio.Get();
+		Index<Value>& key = KeyW();
 		key.Clear();
 		value.Clear();
 		for(int i = 0; i < va.GetCount(); i++) {
@@ -329,6 +351,7 @@ void ValueMap::Data::Jsonize(JsonIO& jio)
 }
 
 hash_t ValueMap::Data::GetHashValue() const {
+	const Index<Value>& key = Key();
 	CombineHash w(key.GetCount());
 	for(int i = 0; i < key.GetCount(); i++)
 		w.Put(key[i].GetHashValue());
@@ -347,27 +370,29 @@ static bool sIsEqual(const Index<Value>& a, const Index<Value>& b)
 
 bool ValueMap::Data::IsEqual(const Value::Void *p)
 {
-	return sIsEqual(((Data *)p)->key, key) && ((Data *)p)->value == value;
+	return sIsEqual(((Data *)p)->Key(), Key()) && ((Data *)p)->value == value;
 }
 
 bool ValueMap::operator==(const ValueMap& v) const
 {
-	return sIsEqual(data->key, v.data->key) && data->value == v.data->value;
+	return sIsEqual(data->Key(), v.data->Key()) && data->value == v.data->value;
 }
 
 int  ValueMap::Data::Compare(const Value::Void *p)
 {
 	Data *b = (Data *)p;
-	int n = min(key.GetCount(), b->key.GetCount());
+	const Index<Value>& key = Key();
+	const Index<Value>& bkey = b->Key();
+	int n = min(key.GetCount(), bkey.GetCount());
 	for(int i = 0; i < n; i++) {
-		int q = SgnCompare(key[i], b->key[i]);
+		int q = SgnCompare(key[i], bkey[i]);
 		if(q)
 			return q;
 		q = SgnCompare(value[i], b->value[i]);
 		if(q)
 			return q;
 	}
-	return SgnCompare(key.GetCount(), b->key.GetCount());
+	return SgnCompare(key.GetCount(), bkey.GetCount());
 }
 
 int ValueMap::Compare(const ValueMap& b) const
@@ -389,6 +414,7 @@ bool ValueMap::IsSame(const ValueMap& b) const
 
 String ValueMap::Data::AsString() const
 {
+	const Index<Value>& key = Key();
 	String s;
 	s << "{ ";
 	for(int i = 0; i < key.GetCount(); i++) {
@@ -408,7 +434,7 @@ ValueMap::Data& ValueMap::Create()
 void ValueMap::Clone(Data *&ptr)
 {
 	Data *d = new Data;
-	d->key = clone(ptr->key);
+	d->SetShape(ptr->shape);
 	d->value = ptr->value;
 	ptr->Release();
 	ptr = d;
@@ -429,36 +455,44 @@ ValueMap::ValueMap(const ValueMap& v)
 ValueMap::ValueMap(Index<Value>&& k, Vector<Value>&& v)
 {
 	Data& d = Create();
-	d.key = pick(k);
+	d.KeyW() = pick(k);
 	d.value = ValueArray(pick(v));
 }
 
 ValueMap::ValueMap(VectorMap<Value, Value>&& m)
 {
 	Data& d = Create();
-	d.key = m.PickKeys();
+	d.KeyW() = m.PickKeys();
 	d.value = ValueArray(m.PickValues());
 }
 
 ValueMap::ValueMap(const Index<Value>& k, const Vector<Value>& v, int deep)
 {
 	Data& d = Create();
-	d.key = clone(k);
+	d.KeyW() = clone(k);
 	d.value = ValueArray(v, 0);
 }
 
 ValueMap::ValueMap(const VectorMap<Value, Value>& m, int deep)
 {
 	Data& d = Create();
-	d.key = clone(m.GetKeys());
+	d.KeyW() = clone(m.GetKeys());
 	d.value = ValueArray(m.GetValues(), 0);
 }
 
+ValueMap::ValueMap(const ValueMap& shape, Vector<Value>&& v)
+{
+	ASSERT(shape.GetCount() == v.GetCount());
+	Data& d = Create();
+	d.SetShape(shape.data->shape);
+	d.value = ValueArray(pick(v));
+}
+
 VectorMap<Value, Value> ValueMap::Pick()
 {
 	Data& d = UnShare();
-	VectorMap<Value, Value> m(d.key.PickKeys(), d.value.Pick());
-	d.key.Clear();
+	VectorMap<Value, Value> m(d.KeyW().PickKeys(), d.value.Pick());
+	d.KeyW().Clear();
 	return m;
 }
 
@@ -540,11 +574,11 @@ void ValueMap::Clear() {
 void ValueMap::Set(const Value& key, const Value& value)
 {
 	Data& d = UnShare();
-	int i = d.key.Find(key);
+	int i = d.Key().Find(key);
 	if(i >= 0)
 		d.value.Set(i, value);
 	else {
-		d.key.Add(key);
+		d.KeyW().Add(key);
 		d.value.Add(value);
 	}
 }
@@ -554,21 +588,21 @@ void ValueMap::SetAt(int i, const Value& v) {
 }
 
 void ValueMap::SetKey(int i, const Value& k) {
-	UnShare().key.Set(i, k);
+	UnShare().KeyW().Set(i, k);
 }
 
 int ValueMap::RemoveKey(const Value& key)
 {
 	Data& d = UnShare();
 	Vector<int> rk;
-	int q = d.key.Find(key);
+	int q = d.Key().Find(key);
 	while(q >= 0) {
 		rk.Add(q);
-		q = d.key.FindNext(q);
+		q = d.Key().FindNext(q);
 	}
 	if(rk.GetCount()) {
 		Sort(rk);
-		d.key.Remove(rk);
+		d.KeyW().Remove(rk);
 		d.value.Remove(rk);
 	}
 	return rk.GetCount();
@@ -577,14 +611,14 @@ int ValueMap::RemoveKey(const Value& key)
 void ValueMap::Remove(int i)
 {
 	Data& d = UnShare();
-	d.key.Remove(i);
+	d.KeyW().Remove(i);
 	d.value.Remove(i);
 }
 
 Value ValueMap::GetAndClear(const Value& key)
 {
 	Data& d = UnShare();
-	int q = d.key.Find(key);
+	int q = d.Key().Find(key);
 	return q < 0 ? ErrorValue() : d.value.GetAndClear(q);
 }
 
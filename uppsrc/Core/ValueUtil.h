@@ -307,6 +307,16 @@ template<>
 String AsString(const ValueArray& v);
 
 class ValueMap : public ValueType<ValueMap, VALUEMAP_V, Moveable<ValueMap> >{
+	struct Shape { // keys, shared by maps with the same keys until one of them changes them
+		Atomic       refcount;
+		Index<Value> key;
+
+		void Retain()                              { AtomicInc(refcount); }
+		void Release()                             { if(AtomicDec(refcount) == 0) delete this; }
+
+		Shape()                                    { refcount = 1; }
+	};
+
 	struct Data : Value::Void {
 		virtual bool       IsNull() const;
 		virtual void       Serialize(Stream& s);
@@ -318,14 +328,14 @@ class ValueMap : public ValueType<ValueMap, VALUEMAP_V, Moveable<ValueMap> >{
 		virtual int        Compare(const Value::Void *p);
 
 		const Value& Get(const Value& k) const {
-			int q = key.Find(k);
+			int q = shape->key.Find(k);
 			return q >= 0 ? value[q] : ErrorValue();
 		}
 		Value& GetAdd(const Value& k) {
-			int i = key.Find(k);
+			int i = shape->key.Find(k);
 			if(i < 0) {
 				i = value.GetCount();
-				key.Add(k);
+				KeyW().Add(k);
 			}
 			return value.At(i);
 		}
@@ -334,8 +344,17 @@ class ValueMap : public ValueType<ValueMap, VALUEMAP_V, Moveable<ValueMap> >{
 			return value.At(i);
 		}
 
-		Index<Value> key;
+		const Index<Value>& Key() const            { return shape->key; }
+		Index<Value>&       KeyW()                 { if(shape->refcount != 1) UnShareShape(); return shape->key; }
+		void                SetShape(Shape *s)     { s->Retain(); shape->Release(); shape = s; }
+		void                UnShareShape();
+		static Shape       *EmptyShape();
+
+		Shape       *shape;
 		ValueArray   value;
+
+		Data();
+		~Data()                                    { shape->Release(); }
 	};
 
 	struct NullData : Data {};
@@ -360,6 +379,7 @@ public:
 	ValueMap(VectorMap<Value, Value>&& m);
 	ValueMap(const Index<Value>& k, const Vector<Value>& v, int deep);
 	ValueMap(const VectorMap<Value, Value>& m, int deep);
+	ValueMap(const ValueMap& shape, Vector<Value>&& v);
 	ValueMap(std::initializer_list<std::pair<Value, Value>> init) { Init0(); for(const auto& i : init) { Add(i.first, i.second); }}
 	~ValueMap();
 
@@ -375,10 +395,10 @@ public:
 	void Clear();
 	int  GetCount() const                           { return data->value.GetCount(); }
 	bool IsEmpty() const                            { return data->value.IsEmpty(); }
-	const Value& GetKey(int i) const                { return data->key[i]; }
+	const Value& GetKey(int i) const                { return data->Key()[i]; }
 	const Value& GetValue(int i) const              { return data->value[i]; }
-	int  Find(const Value& key) const               { return data ? data->key.Find(key) : -1; }
-	int  FindNext(int ii) const                     { return data ? data->key.FindNext(ii) : -1; }
+	int  Find(const Value& key) const               { return data ? data->Key().Find(key) : -1; }
+	int  FindNext(int ii) const                     { return data ? data->Key().FindNext(ii) : -1; }
 
 	void Add(const Value& key, const Value& value);
 	void Add(const String& key, const Value& value) { Add(Value(key), value); }
@@ -412,7 +432,7 @@ public:
 	int  RemoveKey(Id key)                          { return RemoveKey(Value(key.ToString())); }
 	void Remove(int i);
 
-	const Index<Value>& GetKeys() const             { return data->key; }
+	const Index<Value>& GetKeys() const             { return data->Key(); }
 	ValueArray GetValues() const                    { return data->value; }
 
 	operator ValueArray() const                     { return GetValues(); }
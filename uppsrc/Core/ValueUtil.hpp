@@ -1,7 +1,7 @@
 inline
 void ValueMap::Add(const Value& key, const Value& value) {
 	Data& d = UnShare();
-	d.key.Add(key);
+	d.KeyW().Add(key);
 	d.value.Add(value);
 }
 
@@ -19,12 +19,13 @@ String WebSocket::FormatBlock(const String& s)
 WebSocket::WebSocket()
 {
 	Clear();
+	deflate_enabled = true;
+	max_message_size = 64 * 1024 * 1024;
 
 	static String request_headers_const =
 	    "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n"
 		"Accept-Language: cs,en-US;q=0.7,en;q=0.3\r\n"
 		"Sec-WebSocket-Version: 13\r\n"
-		"Sec-WebSocket-Extensions: permessage-deflate\r\n"
 		"Connection: keep-alive, Upgrade\r\n"
 		"Pragma: no-cache\r\n"
 		"Cache-Control: no-cache\r\n"
@@ -46,6 +47,10 @@ void WebSocket::Clear()
 	socket->Clear();
 	close_sent = close_received = false;
 	client = false;
+	deflate = inflate_reset = false;
+	inflater.Clear();
+	deflated.Clear();
+	deflated_opcode = 0;
 }
 
 void WebSocket::Error(const String& err)
@@ -136,6 +141,7 @@ void WebSocket::SendRequest()
 	    "Host: " + host + "\r\n" +
 		"Sec-WebSocket-Key: " + Base64Encode(h) + "\r\n" +
 	    request_headers +
+	    (deflate_enabled ? "Sec-WebSocket-Extensions: permessage-deflate; client_no_context_takeover\r\n" : "") +
 	    "\r\n"
 	);
 	opcode = HTTP_RESPONSE_HEADER;
@@ -218,6 +224,109 @@ bool WebSocket::ReadHttpHeader()
 	}
 }
 
+struct sDeflateParams { // permessage-deflate extension parameters, RFC 7692
+	bool server_no_context_takeover = false;
+	bool client_no_context_takeover = false;
+	int  server_max_window_bits = 15;
+	int  client_max_window_bits = 15;
+	bool client_max_window_bits_present = false;
+};
+
+static String sExtensions(const HttpHeader& hdr)
+{ // Sec-WebSocket-Extensions can be split to more header fields
+	String r;
+	for(int i = hdr.fields.Find("sec-websocket-extensions"); i >= 0; i = hdr.fields.FindNext(i))
+		MergeWith(r, ",", hdr.fields[i]);
+	return r;
+}
+
+static bool sParseDeflate(const String& ext, sDeflateParams& p)
+{ // false if ext is not a valid permessage-deflate offer / response
+	Vector<String> param = Split(ext, ';', false);
+	if(param.GetCount() == 0 || ToLower(TrimBoth(param[0])) != "permessage-deflate")
+		return false;
+	Index<String> found;
+	for(int i = 1; i < param.GetCount(); i++) {
+		String name = ToLower(TrimBoth(param[i]));
+		String value;
+		int q = name.Find('=');
+		if(q >= 0) {
+			value = TrimBoth(name.Mid(q + 1));
+			name = TrimBoth(name.Mid(0, q));
+			if(value.GetCount() >= 2 && *value == '"' && *value.Last() == '"')
+				value = value.Mid(1, value.GetCount() - 2);
+		}
+		if(found.Find(name) >= 0) // parameters must not repeat
+			return false;
+		found.Add(name);
+		auto Bits = [&](int& bits) { // 8..15 without leading zeroes
+			if(value.GetCount() < 1 || value.GetCount() > 2 || *value == '0' ||
+			   !IsDigit(*value) || !IsDigit(*value.Last()))
+				return false;
+			bits = atoi(value);
+			return bits >= 8 && bits <= 15;
+		};
+		if(name == "server_no_context_takeover" && q < 0)
+			p.server_no_context_takeover = true;
+		else
+		if(name == "client_no_context_takeover" && q < 0)
+			p.client_no_context_takeover = true;
+		else
+		if(name == "server_max_window_bits") {
+			if(!Bits(p.server_max_window_bits))
+				return false;
+		}
+		else
+		if(name == "client_max_window_bits") { // value is optional in the offer
+			p.client_max_window_bits_present = true;
+			if(q >= 0 && !Bits(p.client_max_window_bits))
+				return false;
+		}
+		else
+			return false;
+	}
+	return true;
+}
+
+bool WebSocket::AcceptRequest(const HttpHeader& hdr)
+{
+	String key = hdr["sec-websocket-key"];
+	if(IsNull(key))
+		return false;
+
+	byte sha1[20];
+	SHA1(sha1, key + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11");
+	
+	String r =
+		"HTTP/1.1 101 Switching Protocols\r\n"
+		"Upgrade: websocket\r\n"
+		"Connection: Upgrade\r\n"
+		"Sec-WebSocket-Accept: " + Base64Encode((char *)sha1, 20) + "\r\n";
+	
+	deflate = false;
+	if(deflate_enabled)
+		for(const String& offer : Split(sExtensions(hdr), ',')) {
+			sDeflateParams p;
+			if(sParseDeflate(offer, p) && p.server_max_window_bits == 15) { // we always compress with full window
+				deflate = true;
+				break;
+			}
+			LLOG("Extension offer declined: " << offer);
+		}
+	if(deflate) { // without context takeover, compressed message can be shared by many connections
+		r << "Sec-WebSocket-Extensions: permessage-deflate; server_no_context_takeover; client_no_context_takeover\r\n";
+		inflate_reset = true;
+		LLOG("permessage-deflate accepted");
+	}
+	
+	Out(r + "\r\n");
+
+	LLOG("HTTP request header received, sending response");
+	data.Clear();
+	opcode = READING_FRAME_HEADER;
+	return true;
+}
+
 void WebSocket::RequestHeader()
 {
 	if(ReadHttpHeader()) {
@@ -228,25 +337,8 @@ void WebSocket::RequestHeader()
 		}
 		String dummy;
 		hdr.Request(dummy, uri, dummy);
-		String key = hdr["sec-websocket-key"];
-		if(IsNull(key)) {
+		if(!AcceptRequest(hdr))
 			Error("Invalid HTTP header: missing sec-websocket-key");
-			return;
-		}
-	
-		byte sha1[20];
-		SHA1(sha1, key + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11");
-		
-		Out(
-			"HTTP/1.1 101 Switching Protocols\r\n"
-			"Upgrade: websocket\r\n"
-			"Connection: Upgrade\r\n"
-			"Sec-WebSocket-Accept: " + Base64Encode((char *)sha1, 20) + "\r\n\r\n"
-		);
-		
-		LLOG("HTTP request header received, sending response");
-		data.Clear();
-		opcode = READING_FRAME_HEADER;
 	}
 }
 
@@ -268,6 +360,17 @@ void WebSocket::ResponseHeader()
 			Error("Invalid server response HTTP header");
 			return;
 		}
+		String ext = sExtensions(h);
+		deflate = false;
+		if(ext.GetCount()) { // only permessage-deflate without client_max_window_bits was offered
+			sDeflateParams p;
+			if(!deflate_enabled || !sParseDeflate(ext, p) || p.client_max_window_bits_present) {
+				Error("Unsupported Sec-WebSocket-Extensions in server response");
+				return;
+			}
+			deflate = true;
+			inflate_reset = p.server_no_context_takeover;
+		}
 		LLOG("HTTP response header received");
 		opcode = READING_FRAME_HEADER;
 		data.Clear();
@@ -315,6 +418,10 @@ void WebSocket::FrameHeader()
 
 		if(ok) {
 			LLOG("Frame header received, len: " << length << ", code " << new_opcode);
+			if(length > max_message_size - deflated.GetCount()) { // fragments of compressed message are accumulated
+				MessageTooBig();
+				return;
+			}
 			opcode = new_opcode;
 			data.Clear();
 			data_pos = 0;
@@ -340,9 +447,17 @@ void WebSocket::FrameData()
 		int n = socket->Get(~buffer, (int)min(length - data_pos, (int64)32768));
 		if(n == 0)
 			return;
-		if(mask)
-			for(int i = 0; i < n; i++) // TODO: Optimize
-				buffer[i] ^= key[(i + data_pos) & 3];
+		if(mask) {
+			byte k[4];
+			for(int i = 0; i < 4; i++)
+				k[i] = (byte)key[(i + data_pos) & 3];
+			int i = 0;
+			dword k32 = Peek32(k);
+			for(; i + 4 <= n; i += 4)
+				Poke32(~buffer + i, Peek32(~buffer + i) ^ k32);
+			for(; i < n; i++)
+				buffer[i] ^= k[i & 3];
+		}
 		data.Cat(~buffer, n); // TODO: Split long data
 		data_pos += n;
 		LLOG("Frame data chunk received, chunk len: " << n);
@@ -362,17 +477,98 @@ void WebSocket::FrameData()
 		socket->Close();
 		break;
 	default:
-		Input& m = in_queue.AddTail();
-		m.opcode = opcode;
-		m.data = data;
-		LLOG((m.opcode & TEXT ? "TEXT: " : "BINARY: ") << FormatBlock(data));
-		LLOG("Input queue count is now " << in_queue.GetCount());
+		if(deflate && ((opcode & RSV1) || deflated_opcode)) { // compressed message, possibly fragmented
+			if(!deflated_opcode)
+				deflated_opcode = opcode & ~RSV1;
+			deflated.Cat(data);
+			if(opcode & FIN) {
+				String s = Inflate(deflated);
+				if(IsError())
+					return;
+				Message(deflated_opcode | FIN, s);
+				deflated.Clear();
+				deflated_opcode = 0;
+			}
+		}
+		else
+			Message(opcode, data);
 		break;
 	}
 	data.Clear();
 	opcode = READING_FRAME_HEADER;
 }
 
+void WebSocket::Message(dword opcode, const String& data)
+{
+	Input& m = in_queue.AddTail();
+	m.opcode = opcode;
+	m.data = data;
+	LLOG((m.opcode & TEXT ? "TEXT: " : "BINARY: ") << FormatBlock(data));
+	LLOG("Input queue count is now " << in_queue.GetCount());
+}
+
+String WebSocket::Inflate(const String& data)
+{
+	if(!inflater) {
+		inflater.Create();
+		inflater->NoHeader().Decompress();
+	}
+	else
+	if(inflate_reset)
+		inflater->Decompress();
+	String out;
+	bool toobig = false;
+	inflater->WhenOut = [&](const void *ptr, int size) { // check the size while inflating
+		if(size > max_message_size - out.GetCount())
+			toobig = true;
+		else
+			out.Cat((const char *)ptr, size);
+	};
+	for(int pos = 0; pos < data.GetCount() && !toobig; pos += 65536)
+		inflater->Put(~data + pos, min(data.GetCount() - pos, 65536));
+	if(!toobig)
+		inflater->Put("\0\0\xff\xff", 4);
+	inflater->WhenOut.Clear();
+	if(toobig) {
+		MessageTooBig();
+		return Null;
+	}
+	if(inflater->IsError()) {
+		Error("Invalid permessage-deflate data");
+		return Null;
+	}
+	LLOG("Inflated " << data.GetCount() << " -> " << out.GetCount());
+	return out;
+}
+
+void WebSocket::MessageTooBig()
+{
+	LLOG("Message exceeds " << max_message_size << " bytes");
+	if(!close_sent) {
+		String msg;
+		msg.Cat(1009 >> 8); // status code 1009: message too big
+		msg.Cat(1009 & 255);
+		msg.Cat("Message too big");
+		SendRaw(CLOSE|FIN, msg, MASK);
+		close_sent = true;
+		Output();
+	}
+	Error("Message too big");
+}
+
+String WebSocket::DeflateMessage(const String& data)
+{ // no context takeover, every message is compressed separately
+	Zlib z;
+	z.NoHeader().Compress();
+	z.Put(data);
+	z.Flush();
+	String r = z.Get();
+	if(r.EndsWith(String("\0\0\xff\xff", 4)))
+		r.Trim(r.GetCount() - 4);
+	z.Clear();
+	return r;
+}
+
 void WebSocket::Do0()
 {
 	int prev_opcode;
@@ -442,6 +638,22 @@ void WebSocket::Output()
 {
 	if(socket->IsOpen()) {
 		while(out_queue.GetCount()) {
+			if(out_at == 0 && out_queue.GetCount() > 1) { // send whole blocks with single syscall
+				String h[16];
+				int count = min(out_queue.GetCount(), 16);
+				for(int i = 0; i < count; i++)
+					h[i] = out_queue[i];
+				int n = socket->Put(h, count);
+				if(n == 0)
+					break;
+				LLOG("Sent " << n << " bytes in " << count << " blocks");
+				while(out_queue.GetCount() && n >= out_queue.Head().GetCount()) {
+					n -= out_queue.Head().GetCount();
+					out_queue.DropHead();
+				}
+				out_at = n;
+				continue;
+			}
 			const String& s = out_queue.Head();
 			int n = socket->Put(~s + out_at, s.GetCount() - out_at);
 			if(n == 0)
@@ -457,17 +669,10 @@ void WebSocket::Output()
 	}
 }
 
-void WebSocket::SendRaw(int hdr, const String& data, dword mask)
+String WebSocket::MakeFrameHeader(int hdr, int len, dword mask)
 {
-	if(IsError())
-		return;
-	
-	ASSERT(!close_sent);
-	LLOG("Send " << data.GetCount() << " bytes, hdr: " << hdr);
-	
 	String header;
 	header.Cat(hdr);
-	int len = data.GetCount();
 	if(len > 65535) {
 		header.Cat(127 | mask);
 		header.Cat(0);
@@ -487,6 +692,25 @@ void WebSocket::SendRaw(int hdr, const String& data, dword mask)
 	}
 	else
 		header.Cat((int)len | mask);
+	return header;
+}
+
+void WebSocket::SendRaw(int hdr, const String& data_, dword mask)
+{
+	if(IsError())
+		return;
+	
+	ASSERT(!close_sent);
+	LLOG("Send " << data_.GetCount() << " bytes, hdr: " << hdr);
+	
+	String data = data_;
+	if(deflate && (hdr & FIN) && findarg(hdr & 15, TEXT, BINARY) >= 0 && data.GetCount() >= DEFLATE_MIN) {
+		data = DeflateMessage(data);
+		hdr |= RSV1;
+		LLOG("Deflated to " << data.GetCount() << " bytes");
+	}
+	
+	String header = MakeFrameHeader(hdr, data.GetCount(), mask);
 
 	if(mask) {
 		byte Cle[4];
@@ -512,27 +736,18 @@ void WebSocket::SendRaw(int hdr, const String& data, dword mask)
 	}
 }
 
+void WebSocket::Send(WebSocketFrame& frame)
+{
+	if(IsError())
+		return;
+	ASSERT(!close_sent);
+	Out(frame.Get(deflate));
+}
+
 bool WebSocket::WebAccept(TcpSocket& socket_, HttpHeader& hdr)
 {
 	socket = &socket_;
-	String key = hdr["sec-websocket-key"];
-	if(IsNull(key))
-		return false;
-	
-	byte sha1[20];
-	SHA1(sha1, key + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11");
-	
-	Out(
-		"HTTP/1.1 101 Switching Protocols\r\n"
-		"Upgrade: websocket\r\n"
-		"Connection: Upgrade\r\n"
-		"Sec-WebSocket-Accept: " + Base64Encode((char *)sha1, 20) + "\r\n\r\n"
-	);
-
-	LLOG("HTTP request header received, sending response");
-	data.Clear();
-	opcode = READING_FRAME_HEADER;
-	return true;
+	return AcceptRequest(hdr);
 }
 
 bool WebSocket::WebAccept(TcpSocket& socket)
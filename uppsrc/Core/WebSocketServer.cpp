@@ -0,0 +1,121 @@
+#include "Core.h"
+
+namespace Upp {
+
+#define LLOG(x)  // DLOG("WS SERVER " << x)
+
+WebSocketFrame::WebSocketFrame(const String& data, bool text)
+:	data(data)
+{
+	hdr = WebSocket::FIN | (text ? WebSocket::TEXT : WebSocket::BINARY);
+}
+
+const String& WebSocketFrame::Get(bool deflate)
+{
+	deflate = deflate && data.GetCount() >= WebSocket::DEFLATE_MIN;
+	String& f = frame[deflate];
+	if(f.IsEmpty()) { // frame is created on the first use, then shared by all WebSockets
+		String payload = deflate ? WebSocket::DeflateMessage(data) : data;
+		f = WebSocket::MakeFrameHeader(hdr | (deflate ? WebSocket::RSV1 : 0), payload.GetCount());
+		f.Cat(payload);
+	}
+	return f;
+}
+
+bool WebSocketServer::Listen(int port, int listen_count, bool ipv6)
+{
+	quit = false;
+	if(!listener.Listen(port, listen_count, ipv6))
+		return false;
+	listener.Timeout(0);
+	return true;
+}
+
+void WebSocketServer::Accept()
+{
+	while(ws.GetCount() < max_connections) {
+		WebSocket& w = ws.Add();
+		w.NonBlocking().Deflate(deflate).MaxMessageSize(max_message_size);
+		w.socket->ReadBufferSize(read_buffer_size);
+		if(!w.Accept(listener)) {
+			ws.Drop();
+			break;
+		}
+		LLOG("Accepted " << w.GetPeerAddr() << ", connections: " << ws.GetCount());
+	}
+}
+
+void WebSocketServer::Do(int timeout)
+{
+	we.Clear();
+	we.Add(listener, WAIT_READ);
+	for(WebSocket& w : ws)
+		w.AddTo(we);
+	if(we.Wait(timeout) <= 0)
+		return;
+	int n = ws.GetCount(); // connections accepted now are processed in the next step
+	if(we[0] & WAIT_READ)
+		Accept();
+	Vector<int> closed;
+	for(int i = 0; i < n; i++) {
+		if(!we[i + 1])
+			continue;
+		WebSocket& w = ws[i];
+		bool connected = w.IsConnected();
+		w.Do();
+		if(!connected && w.IsConnected())
+			WhenAccept(w);
+		for(;;) {
+			String s = w.Receive();
+			if(s.IsVoid())
+				break;
+			WhenMessage(w, s);
+		}
+		if(w.IsError() || w.IsClosed())
+			closed.Add(i);
+	}
+	for(int i : closed) {
+		LLOG("Closed " << ws[i].GetPeerAddr() << ": " << ws[i].GetError());
+		WhenClose(ws[i]);
+	}
+	ws.Remove(closed);
+}
+
+void WebSocketServer::Run()
+{
+	while(!quit && listener.IsOpen())
+		Do();
+}
+
+int WebSocketServer::Broadcast(WebSocketFrame& frame)
+{
+	int count = 0;
+	for(WebSocket& w : ws)
+		if(w.IsConnected() && !w.close_sent && !w.IsError()) {
+			w.Send(frame);
+			w.Output();
+			count++;
+		}
+	return count;
+}
+
+int WebSocketServer::Broadcast(const String& data, Gate<WebSocket&> filter, bool text)
+{
+	WebSocketFrame frame(data, text);
+	int count = 0;
+	for(WebSocket& w : ws)
+		if(w.IsConnected() && !w.close_sent && !w.IsError() && filter(w)) {
+			w.Send(frame);
+			w.Output();
+			count++;
+		}
+	return count;
+}
+
+int WebSocketServer::Broadcast(const String& data, bool text)
+{
+	WebSocketFrame frame(data, text);
+	return Broadcast(frame);
+}
+
+}
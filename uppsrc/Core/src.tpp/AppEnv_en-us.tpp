@@ -269,6 +269,24 @@ URL that will be opened in the browser&]
 [s2;%% Returns true if CPU has SSE3 support.&]
 [s3; &]
 [s4; &]
+[s5;:Upp`:`:CpuSSE42`(`): [@(0.0.255) bool]_[* CpuSSE42]()&]
+[s2;%% Returns true if CPU has SSE4.2 support (includes CRC32C instruction).&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CpuPCLMUL`(`): [@(0.0.255) bool]_[* CpuPCLMUL]()&]
+[s2;%% Returns true if CPU has carry`-less multiplication (PCLMULQDQ) 
+instruction.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CpuAVX2`(`): [@(0.0.255) bool]_[* CpuAVX2]()&]
+[s2;%% Returns true if CPU has AVX2 support and operating system 
+preserves AVX registers.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CpuSHA`(`): [@(0.0.255) bool]_[* CpuSHA]()&]
+[s2;%% Returns true if CPU has SHA extensions.&]
+[s3; &]
+[s4; &]
 [s5;:Upp`:`:CpuHypervisor`(`): [@(0.0.255) bool]_[* CpuHypervisor]()&]
 [s2;%% Checks whether CPU has hypervisor flag set. If it has, the 
 program is running in virtual machine. Unfortunately, opposite 
@@ -0,0 +1,181 @@
+topic "Compression codec registry";
+[2 $$0,0#00000000000000000000000000000000:Default]
+[i448;a25;kKO9;2 $$1,0#37138531426314131252341829483380:class]
+[l288;2 $$2,2#27521748481378242620020725143825:desc]
+[0 $$3,0#96390100711032703541132217272105:end]
+[H6;0 $$4,0#05600065144404261032431302351956:begin]
+[i448;a25;kKO9;2 $$5,0#37138531426314131252341829483370:item]
+[l288;a4;*@5;1 $$6,6#70004532496200323422659154056402:requirement]
+[l288;i1121;b17;O9;~~~.1408;2 $$7,0#10431211400427159095818037425705:param]
+[i448;b42;O9;2 $$8,8#61672508125594000341940100500538:tparam]
+[b42;2 $$9,9#13035079074754324216151401829390:normal]
+[{_} 
+[ {{10000@(113.42.0) [s0;%% [*@7;4 Compression codec registry]]}}&]
+[s3; &]
+[s0;%% Core provides single interface to all compression formats. 
+`"gz`" is always available, compression plugins register themselves 
+when linked (plugin/zstd as `"zstd`", plugin/lz4 as `"lz4`", plugin/bz2 
+as `"bz2`", plugin/lzma as `"lzma`"). All codecs use the same 
+pipeline: input is split to blocks that are compressed in parallel 
+as complete independent streams (gzip members, zstd or lz4 frames...) 
+and written in order, with at most 2 `* threads blocks in memory. 
+The output is concatenation of valid streams, readable by standard 
+tools.&]
+[s3; &]
+[ {{10000@(113.42.0) [s0;%% [*@7;4 StreamCodec]]}}&]
+[s3; &]
+[s1;:StreamCodec`:`:struct: [@(0.0.255)3 struct][3 _][*3 StreamCodec]&]
+[s2;%% Describes the compression format.&]
+[s3; &]
+[s5;:StreamCodec`:`:name: [_^String^ String]_[* name]&]
+[s2;%% Name of codec, like `"zstd`".&]
+[s3; &]
+[s4; &]
+[s5;:StreamCodec`:`:extension: [_^String^ String]_[* extension]&]
+[s2;%% File extension including the dot, like `".zst`".&]
+[s3; &]
+[s4; &]
+[s5;:StreamCodec`:`:default`_level: [@(0.0.255) int]_[* default`_level]&]
+[s2;%% Compression level used when level is Null.&]
+[s3; &]
+[s4; &]
+[s5;:StreamCodec`:`:block`_size: [@(0.0.255) int]_[* block`_size]&]
+[s2;%% Uncompressed size of pipeline blocks.&]
+[s3; &]
+[s4; &]
+[s5;:StreamCodec`:`:Detect: [_^Function^ Function]<[@(0.0.255) bool]_([@(0.0.255) const]_[_^byte^ b
+yte]_`*[*@3 header], [@(0.0.255) int]_[*@3 len])>_[* Detect]&]
+[s2;%% Returns true if the data starting with [%-*@3 header] are in 
+this format. At most CodecRegistry`::HEADER`_SIZE bytes are passed.&]
+[s3; &]
+[s4; &]
+[s5;:StreamCodec`:`:CompressBlock: [_^Function^ Function]<[_^String^ String]_([@(0.0.255) c
+onst]_[@(0.0.255) void]_`*[*@3 data], [@(0.0.255) int]_[*@3 len], [@(0.0.255) int]_[*@3 level])>
+_[* CompressBlock]&]
+[s2;%% Compresses the block as complete stream. Returns void String 
+on error. Has to be thread`-safe.&]
+[s3; &]
+[s4; &]
+[s5;:StreamCodec`:`:CreateDecompressStream: [_^Function^ Function]<[_^Stream^ Stream]_`*([_^Stream^ S
+tream][@(0.0.255) `&]_[*@3 in], [@(0.0.255) bool]_[*@3 co])>_[* CreateDecompressStream]&]
+[s2;%% Creates new decompression stream reading [%-*@3 in]. Decompressor 
+has to accept concatenated streams. If [%-*@3 co] is true, decompressor 
+can use multiple threads.&]
+[s3; &]
+[ {{10000@(113.42.0) [s0;%% [*@7;4 CodecRegistry]]}}&]
+[s3; &]
+[s1;:CodecRegistry`:`:class: [@(0.0.255)3 class][3 _][*3 CodecRegistry]&]
+[s2;%% Global list of codecs. All methods are thread`-safe.&]
+[s3; &]
+[s5;:CodecRegistry`:`:Register`(const StreamCodec`&`): [@(0.0.255) static] 
+[@(0.0.255) void]_[* Register]([@(0.0.255) const]_[_^StreamCodec^ StreamCodec][@(0.0.255) `&
+]_[*@3 codec])&]
+[s2;%% Registers [%-*@3 codec]. Codec with the same name is replaced. 
+Should be called from INITIALIZER. Registered codecs are never changed 
+or destroyed (replaced codec is kept), so pointers and references 
+returned by Get, Find and Detect remain valid even if Register is 
+called later.&]
+[s3;%% &]
+[s4; &]
+[s5;:CodecRegistry`:`:GetCount`(`): [@(0.0.255) static] [@(0.0.255) int]_[* GetCount]()&]
+[s5;:CodecRegistry`:`:Get`(int`): [@(0.0.255) static] [@(0.0.255) const]_[_^StreamCodec^ S
+treamCodec][@(0.0.255) `&]_[* Get]([@(0.0.255) int]_[*@3 i])&]
+[s2;%% Access to registered codecs.&]
+[s3;%% &]
+[s4; &]
+[s5;:CodecRegistry`:`:Find`(const char`*`): [@(0.0.255) static] [@(0.0.255) const]_[_^StreamCodec^ S
+treamCodec]_`*[* Find]([@(0.0.255) const]_[@(0.0.255) char]_`*[*@3 name])&]
+[s2;%% Finds codec by [%-*@3 name] or file extension (with or without 
+the dot). Returns NULL if not found.&]
+[s3;%% &]
+[s4; &]
+[s5;:CodecRegistry`:`:Detect`(const void`*`,int`): [@(0.0.255) static] 
+[@(0.0.255) const]_[_^StreamCodec^ StreamCodec]_`*[* Detect]([@(0.0.255) const]_[@(0.0.255) v
+oid]_`*[*@3 header], [@(0.0.255) int]_[*@3 len])&]
+[s5;:CodecRegistry`:`:Detect`(Stream`&`): [@(0.0.255) static] [@(0.0.255) const]_[_^StreamCodec^ S
+treamCodec]_`*[* Detect]([_^Stream^ Stream][@(0.0.255) `&]_[*@3 in])&]
+[s2;%% Detects the format by magic number. Stream variant peeks the 
+header in the stream buffer, if the buffer does not contain the 
+whole header, it reads the header and seeks back. Streams that are 
+not seekable (without STRM`_SEEK style) are detected using just the 
+buffered data. Stream position is not changed. Returns NULL if format 
+is not known. Note that .lzma format has no magic number and is 
+detected heuristically.&]
+[s3;%% &]
+[ {{10000@(113.42.0) [s0;%% [*@7;4 CodecCompressStream]]}}&]
+[s3; &]
+[s1;:CodecCompressStream`:`:class: [@(0.0.255)3 class][3 _][*3 CodecCompressStream][3 _:_][@(0.0.255)3 p
+ublic][3 _][*@3;3 Stream]&]
+[s2;%% Output stream compressing data with the block pipeline.&]
+[s3; &]
+[s5;:CodecCompressStream`:`:Open`(Stream`&`,const StreamCodec`&`,int`,int`): [@(0.0.255) b
+ool]_[* Open]([_^Stream^ Stream][@(0.0.255) `&]_[*@3 out], [@(0.0.255) const]_[_^StreamCodec^ S
+treamCodec][@(0.0.255) `&]_[*@3 codec], [@(0.0.255) int]_[*@3 level]_`=_Null, 
+[@(0.0.255) int]_[*@3 threads]_`=_[@3 0])&]
+[s5;:CodecCompressStream`:`:Open`(Stream`&`,const char`*`,int`,int`): [@(0.0.255) bool]_
+[* Open]([_^Stream^ Stream][@(0.0.255) `&]_[*@3 out], [@(0.0.255) const]_[@(0.0.255) char]_`*
+[*@3 codec], [@(0.0.255) int]_[*@3 level]_`=_Null, [@(0.0.255) int]_[*@3 threads]_`=_[@3 0])&]
+[s2;%% Starts compression to [%-*@3 out]. Null [%-*@3 level] means default 
+level of codec, [%-*@3 threads] 0 means CPU`_Cores(). Single thread 
+compresses in the calling thread. Output does not depend on the 
+number of threads. Returns false if codec is not known. Close 
+has to be called to finish the output.&]
+[s3;%% &]
+[ {{10000@(113.42.0) [s0;%% [*@7;4 CodecDecompressStream]]}}&]
+[s3; &]
+[s1;:CodecDecompressStream`:`:class: [@(0.0.255)3 class][3 _][*3 CodecDecompressStream][3 _:_
+][@(0.0.255)3 public][3 _][*@3;3 Stream]&]
+[s2;%% Input stream decompressing data in any registered format.&]
+[s3; &]
+[s5;:CodecDecompressStream`:`:Open`(Stream`&`,int`): [@(0.0.255) bool]_[* Open]([_^Stream^ S
+tream][@(0.0.255) `&]_[*@3 in], [@(0.0.255) int]_[*@3 threads]_`=_[@3 1])&]
+[s2;%% Detects the format of [%-*@3 in] and starts decompression. With 
+more than one thread, decompression runs ahead in worker thread 
+up to [%-*@3 threads] blocks and codecs that support it (zstd, lz4) 
+decompress blocks in parallel. Returns false if format is not 
+known.&]
+[s3;%% &]
+[s4; &]
+[s5;:CodecDecompressStream`:`:GetCodec`(`)const: [@(0.0.255) const]_[_^StreamCodec^ Stre
+amCodec]_`*[* GetCodec]()_[@(0.0.255) const]&]
+[s2;%% Returns detected codec.&]
+[s3; &]
+[ {{10000@(113.42.0) [s0;%% [*@7;4 Functions]]}}&]
+[s3; &]
+[s5;:OpenCompressStream`(Stream`&`,const char`*`,int`,int`): [_^One^ One]<[_^Stream^ Str
+eam]>_[* OpenCompressStream]([_^Stream^ Stream][@(0.0.255) `&]_[*@3 out], 
+[@(0.0.255) const]_[@(0.0.255) char]_`*[*@3 codec], [@(0.0.255) int]_[*@3 level]_`=_Null, 
+[@(0.0.255) int]_[*@3 threads]_`=_[@3 0])&]
+[s2;%% Returns compression stream or empty One if [%-*@3 codec] is 
+not known.&]
+[s3;%% &]
+[s4; &]
+[s5;:OpenDecompressStream`(Stream`&`,int`): [_^One^ One]<[_^Stream^ Stream]>_[* OpenDecomp
+ressStream]([_^Stream^ Stream][@(0.0.255) `&]_[*@3 in], [@(0.0.255) int]_[*@3 threads]_`=_[@3 1
+])&]
+[s2;%% Returns decompression stream or empty One if the format is 
+not recognized.&]
+[s3;%% &]
+[s4; &]
+[s5;:CodecCompress`(Stream`&`,Stream`&`,const char`*`,int`,int`): [_^int64^ int64]_[* Cod
+ecCompress]([_^Stream^ Stream][@(0.0.255) `&]_[*@3 out], [_^Stream^ Stream][@(0.0.255) `&]_
+[*@3 in], [@(0.0.255) const]_[@(0.0.255) char]_`*[*@3 codec], [@(0.0.255) int]_[*@3 level]_`=
+_Null, [@(0.0.255) int]_[*@3 threads]_`=_[@3 0])&]
+[s5;:CodecCompress`(const String`&`,const char`*`,int`,int`): [_^String^ String]_[* Codec
+Compress]([@(0.0.255) const]_[_^String^ String][@(0.0.255) `&]_[*@3 data], 
+[@(0.0.255) const]_[@(0.0.255) char]_`*[*@3 codec], [@(0.0.255) int]_[*@3 level]_`=_Null, 
+[@(0.0.255) int]_[*@3 threads]_`=_[@3 0])&]
+[s2;%% Compresses data. Returns the size of output or void String 
+/ negative value on error.&]
+[s3;%% &]
+[s4; &]
+[s5;:CodecDecompress`(Stream`&`,Stream`&`,int`): [_^int64^ int64]_[* CodecDecompress]([_^Stream^ S
+tream][@(0.0.255) `&]_[*@3 out], [_^Stream^ Stream][@(0.0.255) `&]_[*@3 in], 
+[@(0.0.255) int]_[*@3 threads]_`=_[@3 1])&]
+[s5;:CodecDecompress`(const String`&`,int`): [_^String^ String]_[* CodecDecompress]([@(0.0.255) c
+onst]_[_^String^ String][@(0.0.255) `&]_[*@3 data], [@(0.0.255) int]_[*@3 threads]_`=_[@3 1])&]
+[s2;%% Decompresses data in any registered format. Returns the size 
+of output or void String / negative value on error (including 
+unknown format and truncated input).&]
+[s3;%% &]
+[s0;%% ]]
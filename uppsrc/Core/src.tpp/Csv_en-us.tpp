@@ -0,0 +1,217 @@
+topic "CSV reader and writer";
+[2 $$0,0#00000000000000000000000000000000:Default]
+[i448;a25;kKO9;2 $$1,0#37138531426314131252341829483380:class]
+[l288;2 $$2,0#27521748481378242620020725143825:desc]
+[0 $$3,0#96390100711032703541132217272105:end]
+[H6;0 $$4,0#05600065144404261032431302351956:begin]
+[i448;a25;kKO9;2 $$5,0#37138531426314131252341829483370:item]
+[l288;a4;*@5;1 $$6,6#70004532496200323422659154056402:requirement]
+[l288;i1121;b17;O9;~~~.1408;2 $$7,0#10431211400427159095818037425705:param]
+[i448;b42;O9;2 $$8,8#61672508125594000341940100500538:tparam]
+[b42;2 $$9,9#13035079074754324216151401829390:normal]
+[{_} 
+[ {{10000@(113.42.0) [s0;%% [*@7;4 CsvReader]]}}&]
+[s3; &]
+[s1;:Upp`:`:CsvReader`:`:class: [@(0.0.255)3 class][3 _][*3 CsvReader][3 _:_][@(0.0.255)3 private][3 _][*@3;3 NoCopy]&]
+[s9;%% Reads CSV (comma separated values) data from String, file or Stream. Fields can be quoted, quoted fields can contain separators, line ends and doubled quotes; empty lines are skipped. Records are either fetched one by one or a single column (or the whole content) is read in bulk, in parallel for larger inputs.&]
+[s9;%% Scanning for separators, quotes and line ends uses SIMD. For parallel reading, the input is split into chunks which are parsed by CoWork threads; the quote state at the start of each chunk is established by counting quotes in preceding chunks, so chunk boundaries are always moved to the nearest record start even if quoted fields span lines.&]
+[s3; &]
+[s0; &]
+[ {{10000F(128)G(128)@1 [s0;%% [* Public Method List]]}}&]
+[s3; &]
+[s5;:Upp`:`:CsvReader`:`:Separator`(int`): CsvReader[@(0.0.255) `&] [* Separator]([@(0.0.255) int] [*@3 c])&]
+[s2;%% Sets the field separator. Default is ','.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvReader`:`:Quote`(int`): CsvReader[@(0.0.255) `&] [* Quote]([@(0.0.255) int] [*@3 c])&]
+[s2;%% Sets the quote character. Default is '`"'.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvReader`:`:Charset`(Upp`:`:byte`): CsvReader[@(0.0.255) `&] [* Charset](byte [*@3 cs])&]
+[s2;%% Sets the encoding of input; texts are converted to the default charset. Default is CHARSET`_DEFAULT (no conversion).&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvReader`:`:Header`(bool`): CsvReader[@(0.0.255) `&] [* Header]([@(0.0.255) bool] [*@3 b] [@(0.0.255) `=] [@3 true])&]
+[s2;%% The first record is the header with column names. It is not returned by Fetch or bulk reads and is available through GetHeader and FindColumn.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvReader`:`:Parallel`(bool`): CsvReader[@(0.0.255) `&] [* Parallel]([@(0.0.255) bool] [*@3 b] [@(0.0.255) `=] [@3 true])&]
+[s2;%% Bulk reads are performed in parallel. Default is true.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvReader`:`:NoParallel`(`): CsvReader[@(0.0.255) `&] [* NoParallel]()&]
+[s2;%% Same as Parallel(false).&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvReader`:`:ChunkSize`(int`): CsvReader[@(0.0.255) `&] [* ChunkSize]([@(0.0.255) int] [*@3 bytes])&]
+[s2;%% Sets the size of input chunk for parallel processing and the size of block read from Stream. Default is 1MB.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvReader`:`:OpenFile`(const` char`*`): [@(0.0.255) bool] [* OpenFile]([@(0.0.255) const] [@(0.0.255) char] [@(0.0.255) *] [*@3 path])&]
+[s2;%% Opens the file [%-*@3 path], which is then accessed through FileMapping. Returns false if the file cannot be opened.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvReader`:`:Open`(const` Upp`:`:String`&`): [@(0.0.255) void] [* Open]([@(0.0.255) const] String[@(0.0.255) `&] [*@3 text])&]
+[s2;%% Reads CSV from [%-*@3 text].&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvReader`:`:Open`(Upp`:`:Stream`&`): [@(0.0.255) void] [* Open](Stream[@(0.0.255) `&] [*@3 s])&]
+[s2;%% Reads CSV from Stream [%-*@3 s], data are read in blocks of ChunkSize. The stream must exist until the reading is finished.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvReader`:`:Close`(`): [@(0.0.255) void] [* Close]()&]
+[s2;%% Closes the input.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvReader`:`:Fetch`(`): [@(0.0.255) bool] [* Fetch]()&]
+[s2;%% Reads the next record. Returns false if there are no more records.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvReader`:`:GetIndex`(`)const: int64 [* GetIndex]() [@(0.0.255) const]&]
+[s2;%% Returns the index of the last record read (by Fetch or bulk read), starting with 0, not counting the header. Returns `-1 if nothing was read yet.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvReader`:`:GetCount`(`)const: [@(0.0.255) int] [* GetCount]() [@(0.0.255) const]&]
+[s2;%% Returns the number of fields of the current record.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvReader`:`:Get`(int`)const: String [* Get]([@(0.0.255) int] [*@3 i]) [@(0.0.255) const]&]
+[s2;%% Returns the field [%-*@3 i] of current record or empty String if there is no such field.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvReader`:`:operator`[`]`(int`)const: String [* operator`[`]]([@(0.0.255) int] [*@3 i]) [@(0.0.255) const]&]
+[s2;%% Same as Get([%-*@3 i]).&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvReader`:`:Get`(const` char`*`): String [* Get]([@(0.0.255) const] [@(0.0.255) char] [@(0.0.255) *] [*@3 column])&]
+[s2;%% Returns the field of the [%-*@3 column] named in the header.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvReader`:`:operator`[`]`(const` char`*`): String [* operator`[`]]([@(0.0.255) const] [@(0.0.255) char] [@(0.0.255) *] [*@3 column])&]
+[s2;%% Same as Get([%-*@3 column]).&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvReader`:`:GetInt64`(int`)const: int64 [* GetInt64]([@(0.0.255) int] [*@3 i]) [@(0.0.255) const]&]
+[s2;%% Returns the field [%-*@3 i] of current record converted to int64 without creating String, Null if it is not a number.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvReader`:`:GetDouble`(int`)const: [@(0.0.255) double] [* GetDouble]([@(0.0.255) int] [*@3 i]) [@(0.0.255) const]&]
+[s2;%% Returns the field [%-*@3 i] of current record converted to double without creating String, Null if it is not a number.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvReader`:`:GetRecord`(`)const: Vector<String> [* GetRecord]() [@(0.0.255) const]&]
+[s2;%% Returns all fields of current record.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvReader`:`:GetHeader`(`): [@(0.0.255) const] Vector<String>[@(0.0.255) `&] [* GetHeader]()&]
+[s2;%% Returns the column names if Header is active.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvReader`:`:FindColumn`(const` char`*`): [@(0.0.255) int] [* FindColumn]([@(0.0.255) const] [@(0.0.255) char] [@(0.0.255) *] [*@3 name])&]
+[s2;%% Returns the index of column [%-*@3 name] or `-1 if not found.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvReader`:`:CountRecords`(`): int64 [* CountRecords]()&]
+[s2;%% Reads all remaining records and returns their number.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvReader`:`:ReadInt64`(int`): Vector<int64> [* ReadInt64]([@(0.0.255) int] [*@3 column])&]
+[s2;%% Reads [%-*@3 column] of all remaining records as int64 values. Fields that are not numbers are Null.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvReader`:`:ReadDouble`(int`): Vector<[@(0.0.255) double]> [* ReadDouble]([@(0.0.255) int] [*@3 column])&]
+[s2;%% Reads [%-*@3 column] of all remaining records as double values. Fields that are not numbers are Null.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvReader`:`:ReadString`(int`): Vector<String> [* ReadString]([@(0.0.255) int] [*@3 column])&]
+[s2;%% Reads [%-*@3 column] of all remaining records.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvReader`:`:ReadAll`(`): Vector<Vector<String>> [* ReadAll]()&]
+[s2;%% Reads all remaining records.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvReader`:`:CsvReader`(Upp`:`:Stream`&`): [* CsvReader](Stream[@(0.0.255) `&] [*@3 s])&]
+[s2;%% Same as Open([%-*@3 s]).&]
+[s3; &]
+[s4; &]
+[s0; &]
+[s0; &]
+[s0; &]
+[ {{10000@(113.42.0) [s0;%% [*@7;4 CsvWriter]]}}&]
+[s3; &]
+[s1;:Upp`:`:CsvWriter`:`:class: [@(0.0.255)3 class][3 _][*3 CsvWriter][3 _:_][@(0.0.255)3 private][3 _][*@3;3 NoCopy]&]
+[s9;%% Writes CSV data to the Stream. Fields are quoted only when needed (they contain separator, quote or line end). Output can be read back by CsvReader and GetCsvLine.&]
+[s3; &]
+[s0; &]
+[ {{10000F(128)G(128)@1 [s0;%% [* Public Method List]]}}&]
+[s3; &]
+[s5;:Upp`:`:CsvWriter`:`:Separator`(int`): CsvWriter[@(0.0.255) `&] [* Separator]([@(0.0.255) int] [*@3 c])&]
+[s2;%% Sets the field separator. Default is ','.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvWriter`:`:Quote`(int`): CsvWriter[@(0.0.255) `&] [* Quote]([@(0.0.255) int] [*@3 c])&]
+[s2;%% Sets the quote character. Default is '`"'.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvWriter`:`:Charset`(Upp`:`:byte`): CsvWriter[@(0.0.255) `&] [* Charset](byte [*@3 cs])&]
+[s2;%% Texts are converted from the default charset to [%-*@3 cs].&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvWriter`:`:QuoteAll`(bool`): CsvWriter[@(0.0.255) `&] [* QuoteAll]([@(0.0.255) bool] [*@3 b] [@(0.0.255) `=] [@3 true])&]
+[s2;%% All fields are quoted.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvWriter`:`:LineEnd`(const` char`*`): CsvWriter[@(0.0.255) `&] [* LineEnd]([@(0.0.255) const] [@(0.0.255) char] [@(0.0.255) *] [*@3 s])&]
+[s2;%% Sets the record separator. Default is `"`\r`\n`".&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvWriter`:`:Put`(const` char`*`,int`): CsvWriter[@(0.0.255) `&] [* Put]([@(0.0.255) const] [@(0.0.255) char] [@(0.0.255) *] [*@3 s], [@(0.0.255) int] [*@3 len])&]
+[s2;%% Writes a text field.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvWriter`:`:Put`(const` Upp`:`:String`&`): CsvWriter[@(0.0.255) `&] [* Put]([@(0.0.255) const] String[@(0.0.255) `&] [*@3 s])&]
+[s2;%% Writes a text field.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvWriter`:`:Put`(const` char`*`): CsvWriter[@(0.0.255) `&] [* Put]([@(0.0.255) const] [@(0.0.255) char] [@(0.0.255) *] [*@3 s])&]
+[s2;%% Writes a text field.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvWriter`:`:Put`(Upp`:`:int64`): CsvWriter[@(0.0.255) `&] [* Put](int64 [*@3 n])&]
+[s2;%% Writes a number, Null is written as empty field.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvWriter`:`:Put`(int`): CsvWriter[@(0.0.255) `&] [* Put]([@(0.0.255) int] [*@3 n])&]
+[s2;%% Writes a number, Null is written as empty field.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvWriter`:`:Put`(double`): CsvWriter[@(0.0.255) `&] [* Put]([@(0.0.255) double] [*@3 x])&]
+[s2;%% Writes a number, Null is written as empty field.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvWriter`:`:Put`(const` Upp`:`:Value`&`): CsvWriter[@(0.0.255) `&] [* Put]([@(0.0.255) const] Value[@(0.0.255) `&] [*@3 v])&]
+[s2;%% Writes a Value, numbers are formatted as numbers, other types are converted using AsString. Null is written as empty field.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvWriter`:`:PutNull`(`): CsvWriter[@(0.0.255) `&] [* PutNull]()&]
+[s2;%% Writes an empty field.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvWriter`:`:operator`<`<`(const` Upp`:`:T`&`): CsvWriter[@(0.0.255) `&] [* operator<<]([@(0.0.255) const] T[@(0.0.255) `&] [*@3 x])&]
+[s2;%% Same as Put([%-*@3 x]).&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvWriter`:`:EndRow`(`): CsvWriter[@(0.0.255) `&] [* EndRow]()&]
+[s2;%% Ends the record.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvWriter`:`:PutRow`(const` Upp`:`:Vector`<Upp`:`:String`>`&`): CsvWriter[@(0.0.255) `&] [* PutRow]([@(0.0.255) const] Vector<String>[@(0.0.255) `&] [*@3 row])&]
+[s2;%% Writes all fields of [%-*@3 row] and ends the record.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:CsvWriter`:`:CsvWriter`(Upp`:`:Stream`&`): [* CsvWriter](Stream[@(0.0.255) `&] [*@3 out])&]
+[s2;%% Constructs the writer for [%-*@3 out].&]
+[s3; &]
+[s4; &]
+[s0; ]]
\ No newline at end of file
@@ -0,0 +1,146 @@
+topic "DnsResolver";
+[2 $$0,0#00000000000000000000000000000000:Default]
+[i448;a25;kKO9;2 $$1,0#37138531426314131252341829483380:class]
+[l288;2 $$2,2#27521748481378242620020725143825:desc]
+[0 $$3,0#96390100711032703541132217272105:end]
+[H6;0 $$4,0#05600065144404261032431302351956:begin]
+[i448;a25;kKO9;2 $$5,0#37138531426314131252341829483370:item]
+[l288;a4;*@5;1 $$6,6#70004532496200323422659154056402:requirement]
+[l288;i1121;b17;O9;~~~.1408;2 $$7,0#10431211400427159095818037425705:param]
+[i448;b42;O9;2 $$8,8#61672508125594000341940100500538:tparam]
+[b42;2 $$9,9#13035079074754324216151401829390:normal]
+[{_} 
+[ {{10000@(113.42.0) [s0;%% [*@7;4 DnsResolver]]}}&]
+[s3; &]
+[s1;:DnsResolver`:`:class: [@(0.0.255)3 class][3 _][*3 DnsResolver]&]
+[s2;%% Non`-blocking stub resolver that queries DNS servers directly 
+via UDP, without auxiliary threads. Multiple lookups can be in 
+progress at the same time and resolver can be added to SocketWaitEvent 
+to be processed together with other sockets. Nameservers, search 
+list and options are loaded from /etc/resolv.conf, /etc/hosts 
+is consulted before querying servers. Results are by default 
+stored in IpAddrInfo cache, so that subsequent TcpSocket`::Connect 
+does not need to resolve the host again. Each lookup uses its own 
+socket bound to random source port and answers are only accepted 
+from the queried server when they match the question sent.&]
+[s3; &]
+[ {{10000F(128)G(128)@1 [s0;%% [* Public Member List]]}}&]
+[s3; &]
+[s5;:DnsResolver`:`:WhenDone: [_^Event^ Event]<[@(0.0.255) int]>_[* WhenDone]&]
+[s2;%% Invoked from Do with the handle of finished lookup.&]
+[s3; &]
+[s4; &]
+[s5;:DnsResolver`:`:NameServer`(const String`&`,int`): [_^DnsResolver^ DnsResolver][@(0.0.255) `&
+]_[* NameServer]([@(0.0.255) const]_[_^String^ String][@(0.0.255) `&]_[*@3 ip], 
+[@(0.0.255) int]_[*@3 port]_`=_[@3 53])&]
+[s2;%% Adds nameserver.&]
+[s3;%% &]
+[s4; &]
+[s5;:DnsResolver`:`:ClearNameServers`(`): [_^DnsResolver^ DnsResolver][@(0.0.255) `&]_[* C
+learNameServers]()&]
+[s2;%% Removes all nameservers.&]
+[s3; &]
+[s4; &]
+[s5;:DnsResolver`:`:Search`(const String`&`): [_^DnsResolver^ DnsResolver][@(0.0.255) `&
+]_[* Search]([@(0.0.255) const]_[_^String^ String][@(0.0.255) `&]_[*@3 domain])&]
+[s2;%% Adds [%-*@3 domain] to the search list. Names with less than 
+`"ndots`" dots are tried with search domains first.&]
+[s3;%% &]
+[s4; &]
+[s5;:DnsResolver`:`:ClearSearch`(`): [_^DnsResolver^ DnsResolver][@(0.0.255) `&]_[* Clear
+Search]()&]
+[s2;%% Clears the search list.&]
+[s3; &]
+[s4; &]
+[s5;:DnsResolver`:`:Timeout`(int`): [_^DnsResolver^ DnsResolver][@(0.0.255) `&]_[* Timeou
+t]([@(0.0.255) int]_[*@3 ms])&]
+[s2;%% Sets the timeout of single query. Default is 5000.&]
+[s3;%% &]
+[s4; &]
+[s5;:DnsResolver`:`:Attempts`(int`): [_^DnsResolver^ DnsResolver][@(0.0.255) `&]_[* Attem
+pts]([@(0.0.255) int]_[*@3 n])&]
+[s2;%% Sets the number of attempts per nameserver. Default is 2.&]
+[s3;%% &]
+[s4; &]
+[s5;:DnsResolver`:`:Cache`(bool`): [_^DnsResolver^ DnsResolver][@(0.0.255) `&]_[* Cache]([@(0.0.255) b
+ool]_[*@3 b]_`=_[@(0.0.255) true])&]
+[s5;:DnsResolver`:`:NoCache`(`): [_^DnsResolver^ DnsResolver][@(0.0.255) `&]_[* NoCache]()
+&]
+[s2;%% Sets whether results are stored to IpAddrInfo cache (with 
+TTL received from the server). Default is true.&]
+[s3;%% &]
+[s4; &]
+[s5;:DnsResolver`:`:NegativeTTL`(int`): [_^DnsResolver^ DnsResolver][@(0.0.255) `&]_[* Ne
+gativeTTL]([@(0.0.255) int]_[*@3 ms])&]
+[s2;%% Sets the time failed lookups are cached.&]
+[s3;%% &]
+[s4; &]
+[s5;:DnsResolver`:`:Host`(const String`&`,const String`&`): [_^DnsResolver^ DnsResolver
+][@(0.0.255) `&]_[* Host]([@(0.0.255) const]_[_^String^ String][@(0.0.255) `&]_[*@3 name], 
+[@(0.0.255) const]_[_^String^ String][@(0.0.255) `&]_[*@3 ip])&]
+[s5;:DnsResolver`:`:ClearHosts`(`): [_^DnsResolver^ DnsResolver][@(0.0.255) `&]_[* ClearH
+osts]()&]
+[s2;%% Adds static host entry, resp. clears all static entries.&]
+[s3;%% &]
+[s4; &]
+[s5;:DnsResolver`:`:LoadResolvConf`(const char`*`): [@(0.0.255) bool]_[* LoadResolvConf](
+[@(0.0.255) const]_[@(0.0.255) char]_`*[*@3 path]_`=_`"`/etc`/resolv`.conf`")&]
+[s5;:DnsResolver`:`:LoadHosts`(const char`*`): [@(0.0.255) bool]_[* LoadHosts]([@(0.0.255) c
+onst]_[@(0.0.255) char]_`*[*@3 path]_`=_`"`/etc`/hosts`")&]
+[s2;%% Loads configuration. Both are called by the constructor.&]
+[s3;%% &]
+[s4; &]
+[s5;:DnsResolver`:`:Start`(const String`&`,int`): [@(0.0.255) int]_[* Start]([@(0.0.255) c
+onst]_[_^String^ String][@(0.0.255) `&]_[*@3 host], [@(0.0.255) int]_[*@3 family]_`=_IpAddr
+Info`::FAMILY`_ANY)&]
+[s2;%% Starts resolving [%-*@3 host], returns the handle of lookup.&]
+[s3;%% &]
+[s4; &]
+[s5;:DnsResolver`:`:InProgress`(int`)const: [@(0.0.255) bool]_[* InProgress]([@(0.0.255) i
+nt]_[*@3 handle])_[@(0.0.255) const]&]
+[s5;:DnsResolver`:`:InProgress`(`)const: [@(0.0.255) bool]_[* InProgress]()_[@(0.0.255) co
+nst]&]
+[s2;%% Returns true if lookup [%-*@3 handle], resp. any lookup, is 
+still in progress.&]
+[s3;%% &]
+[s4; &]
+[s5;:DnsResolver`:`:IsResolved`(int`)const: [@(0.0.255) bool]_[* IsResolved]([@(0.0.255) i
+nt]_[*@3 handle])_[@(0.0.255) const]&]
+[s2;%% Returns true if lookup was successful.&]
+[s3;%% &]
+[s4; &]
+[s5;:DnsResolver`:`:GetResult`(int`)const: [_^Vector^ Vector]<[_^String^ String]>_[* GetRe
+sult]([@(0.0.255) int]_[*@3 handle])_[@(0.0.255) const]&]
+[s2;%% Returns textual IPv4/IPv6 addresses found.&]
+[s3;%% &]
+[s4; &]
+[s5;:DnsResolver`:`:GetTTL`(int`)const: [@(0.0.255) int]_[* GetTTL]([@(0.0.255) int]_[*@3 h
+andle])_[@(0.0.255) const]&]
+[s2;%% Returns the minimal TTL of answer records in seconds, 
+limited to one day.&]
+[s3;%% &]
+[s4; &]
+[s5;:DnsResolver`:`:Remove`(int`): [@(0.0.255) void]_[* Remove]([@(0.0.255) int]_[*@3 handle
+])&]
+[s2;%% Releases the lookup.&]
+[s3;%% &]
+[s4; &]
+[s5;:DnsResolver`:`:Do`(`): [@(0.0.255) void]_[* Do]()&]
+[s2;%% Processes incoming answers and timeouts.&]
+[s3; &]
+[s4; &]
+[s5;:DnsResolver`:`:GetWaitEvents`(`)const: [_^dword^ dword]_[* GetWaitEvents]()_[@(0.0.255) c
+onst]&]
+[s5;:DnsResolver`:`:GetWaitTimeout`(`)const: [@(0.0.255) int]_[* GetWaitTimeout]()_[@(0.0.255) c
+onst]&]
+[s5;:DnsResolver`:`:AddTo`(SocketWaitEvent`&`): [@(0.0.255) void]_[* AddTo]([_^SocketWaitEvent^ S
+ocketWaitEvent][@(0.0.255) `&]_[*@3 e])&]
+[s2;%% Support for waiting: adds resolver sockets to [%-*@3 e]; GetWaitTimeout 
+returns the time to the nearest timeout.&]
+[s3;%% &]
+[s4; &]
+[s5;:DnsResolver`:`:Resolve`(const String`&`,int`): [_^Vector^ Vector]<[_^String^ String]>
+_[* Resolve]([@(0.0.255) const]_[_^String^ String][@(0.0.255) `&]_[*@3 host], 
+[@(0.0.255) int]_[*@3 family]_`=_IpAddrInfo`::FAMILY`_ANY)&]
+[s2;%% Blocking lookup. Returns empty Vector on failure.&]
+[s3;%% ]]
\ No newline at end of file
@@ -62,4 +62,49 @@ the slot used for resolving the request.&]
 [s5;:IpAddrInfo`:`:IpAddrInfo`(`): [* IpAddrInfo]()&]
 [s5;:IpAddrInfo`:`:`~IpAddrInfo`(`): [@(0.0.255) `~][* IpAddrInfo]()&]
 [s2;%% Constructor, destructor.&]
+[s3; &]
+[s4; &]
+[s5;:IpAddrInfo`:`:CacheTTL`(int`): [@(0.0.255) static] [@(0.0.255) void]_[* CacheTTL]([@(0.0.255) i
+nt]_[*@3 ms])&]
+[s2;%% Sets the time successfully resolved addresses are kept in 
+the process`-wide resolver cache. Zero disables caching of positive 
+results. Default is 30000.&]
+[s3;%% &]
+[s4; &]
+[s5;:IpAddrInfo`:`:CacheNegativeTTL`(int`): [@(0.0.255) static] [@(0.0.255) void]_[* Cach
+eNegativeTTL]([@(0.0.255) int]_[*@3 ms])&]
+[s2;%% Sets the time failed lookups are kept in the cache. Zero disables 
+negative caching. Default is 5000.&]
+[s3;%% &]
+[s4; &]
+[s5;:IpAddrInfo`:`:CacheMaxCount`(int`): [@(0.0.255) static] [@(0.0.255) void]_[* CacheM
+axCount]([@(0.0.255) int]_[*@3 n])&]
+[s2;%% Sets the maximum number of cached hosts. Default is 4096.&]
+[s3;%% &]
+[s4; &]
+[s5;:IpAddrInfo`:`:NoCache`(`): [@(0.0.255) static] [@(0.0.255) void]_[* NoCache]()&]
+[s2;%% Disables the cache.&]
+[s3; &]
+[s4; &]
+[s5;:IpAddrInfo`:`:ClearCache`(`): [@(0.0.255) static] [@(0.0.255) void]_[* ClearCache]()
+&]
+[s2;%% Removes all entries from the cache and resets hit/miss counters.&]
+[s3; &]
+[s4; &]
+[s5;:IpAddrInfo`:`:AddToCache`(const String`&`,int`,const Vector`<String`>`&`,int`): [@(0.0.255) s
+tatic] [@(0.0.255) void]_[* AddToCache]([@(0.0.255) const]_[_^String^ String][@(0.0.255) `&
+]_[*@3 host], [@(0.0.255) int]_[*@3 family], [@(0.0.255) const]_[_^Vector^ Vector]<[_^String^ S
+tring]>`&_[*@3 ip], [@(0.0.255) int]_[*@3 ttl`_ms])&]
+[s2;%% Stores textual addresses [%-*@3 ip] of [%-*@3 host] in the cache 
+for [%-*@3 ttl`_ms] milliseconds. Empty [%-*@3 ip] stores negative 
+result. Used by DnsResolver to share its results with IpAddrInfo.&]
+[s3;%% &]
+[s4; &]
+[s5;:IpAddrInfo`:`:GetCacheHits`(`): [@(0.0.255) static] [@(0.0.255) int]_[* GetCacheHits](
+)&]
+[s5;:IpAddrInfo`:`:GetCacheMisses`(`): [@(0.0.255) static] [@(0.0.255) int]_[* GetCacheMi
+sses]()&]
+[s2;%% Returns the number of lookups served from the cache, resp. 
+resolved by getaddrinfo. Concurrent lookups of the same host 
+are coalesced into single getaddrinfo call.&]
 [s3; ]]
\ No newline at end of file
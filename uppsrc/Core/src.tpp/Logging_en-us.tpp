@@ -31,14 +31,19 @@ in all threads.&]
 [s0; &]
 [ {{10000F(128)G(128)@1 [s0; [* Entity List]]}}&]
 [s0;%- &]
-[s5;:StdLogSetup`(dword`,const char`*`,int`):%- [@(0.0.255) void]_[* StdLogSetup]([_^dword^ d
+[s5;:StdLogSetup`(dword`,const char`*`,int`,int`):%- [@(0.0.255) void]_[* StdLogSetup]([_^dword^ d
 word]_[*@3 options], [@(0.0.255) const]_[@(0.0.255) char]_`*[*@3 filepath]_`=_NULL, 
-[@(0.0.255) int]_[*@3 filesize`_limit]_`=_[@3 10]_`*_[@3 1024]_`*_[@3 1024])&]
+[@(0.0.255) int]_[*@3 filesize`_limit]_`=_[@3 10]_`*_[@3 1024]_`*_[@3 1024], 
+[@(0.0.255) int]_[*@3 rotate`_interval]_`=_[@3 0])&]
 [s2; This function setups standard U`+`+ logging. [%-*@3 filepath] 
 is the path of .log file (if logging to file is active), [%-*@3 filesize`_limit] 
 is maximum size of log (if LOG`_FILE options is active), if achieved, 
-a new log file is created. [%-*@3 options] is a combination of 
-bit flags:&]
+the log is rotated and a new log file is created. If [%-*@3 rotate`_interval] 
+is positive, the log is also rotated each [%-*@3 rotate`_interval] 
+seconds (aligned to multiples of interval, e.g. 3600 rotates at 
+each full hour). Without LOG`_ROTATE, one previous part `'.1`' 
+is preserved by these rotations. [%-*@3 options] is a combination 
+of bit flags:&]
 [s2; &]
 [ {{2939:7061<288;^ [s0; LOG`_FILE ]
 :: [s0; Output log to file (this is default). The default path of file 
@@ -69,6 +74,21 @@ of replacing it.]
 :: [s0; LOG`_ROTATE`_GZIP]
 :: [s0; Older preserved log files are compressed using gzip (except 
 the most recent log `'.1`'.]
+:: [s0; LOG`_ROTATE`_ZSTD]
+:: [s0; Older preserved log files are compressed using zstd (`'.zst`'), 
+requires plugin/zstd to be linked, otherwise gzip is used.]
+:: [s0; LOG`_ASYNC]
+:: [s0; Lines are formatted by the logging thread into its own lock`-free 
+ring buffer (64KB) and written to outputs by background writer 
+thread in large blocks. Lines of single thread keep their order. 
+When the buffer is full, logging thread waits for the writer. 
+Lines are written when the buffer is half full, every 50ms, by 
+StdLogFlush, on program exit and before any line is logged in 
+panic mode (e.g. failed ASSERT).]
+:: [s0; LOG`_ASYNC`_DROP]
+:: [s0; With LOG`_ASYNC, lines that do not fit into full buffer are 
+dropped instead of waiting. The number of dropped lines is written 
+to the log and is available through GetStdLogDropped.]
 :: [s0; LOG`_COUTW]
 :: [s0; Output log to standard output, using Cout. This provides eventual 
 conversion of UTF8 characters, at the price of using heap (so 
@@ -87,6 +107,14 @@ cannot be used to e.g. LOG inside heap routines).]}}&]
 [s2; Returns the path of current log, if any.&]
 [s3;%- &]
 [s4;%- &]
+[s5;:Upp`:`:StdLogFlush`(`):%- [@(0.0.255) void]_[* StdLogFlush]()&]
+[s2; Writes all lines buffered with LOG`_ASYNC.&]
+[s3;%- &]
+[s4;%- &]
+[s5;:Upp`:`:GetStdLogDropped`(`):%- [_^int64^ int64]_[* GetStdLogDropped]()&]
+[s2; Returns the total number of lines dropped with LOG`_ASYNC`_DROP.&]
+[s3;%- &]
+[s4;%- &]
 [s5;:LOG`_BEGIN:%- [@(0.0.255) const]_[@(0.0.255) char]_[* LOG`_BEGIN `= 
 `'`\x1e`';]&]
 [s2; Putting this character into standard log stream adds one tabulator 
@@ -147,7 +175,18 @@ defined as LOG(#x << `"`=`" << x)]
 :: [s0; TIMING(x), DTIMING(x), RTIMING(x)]
 :: [s0; Establishes profiling timing inspector which profiles since 
 definition till the end of block, profiling values are printed 
-to log at the program exit.]
+to log at the program exit. Times are measured with nanosecond 
+resolution (tmGetTimeNs) and accumulated per thread without locking; 
+the log contains total and average time, min, max, p50 and p99 
+(from log`-linear histogram with 8 buckets per power of two) and, 
+if used by more threads, the same values for each thread. When 
+trace is active, each pass is also recorded as trace zone.]
+:: [s0; RZONE(x)]
+:: [s0; Records trace zone from definition till the end of block if 
+trace is active (StartTrace), otherwise costs just one flag test. 
+Trace can be exported by GetTraceJson or SaveTrace to Chrome Trace 
+Event format (chrome://tracing, ui.perfetto.dev); it also contains 
+CoWork jobs of each worker thread.]
 :: [s0; LOGHEX(x), DLOGHEX(x), RLOGHEX(x)]
 :: [s0; Outputs value as hexadecimal dump, currently works with String.]
 :: [s0; DUMPHEX(x), DDUMPHEX(x), RDUMPHEX(x)]
@@ -26,4 +26,43 @@ hash of [%-*@3 size] bytes of [%-*@3 data].&]
 onst]_[_^String^ String][@(0.0.255) `&]_[*@3 data])&]
 [s3; [%% Returns a String representing the 32 bytes (256 bits) SHA`-2 
 hash of ][*@3 data.]&]
+[s4;%% &]
+[s4;%% &]
+[s1;%% &]
+[s2;:Upp`:`:SHA256Multi`(Upp`:`:byte`*const`*`,const void`*const`*`,const size`_t`*`,int`): [@(0.0.255) v
+oid]_[* SHA256Multi]([_^Upp`:`:byte^ byte]_`*[@(0.0.255) const]_`*[*@3 hash32], 
+[@(0.0.255) const]_[@(0.0.255) void]_`*[@(0.0.255) const]_`*[*@3 data], 
+[@(0.0.255) const]_size`_t_`*[*@3 size], [@(0.0.255) int]_[*@3 count])&]
+[s3;%% Computes SHA`-256 hashes of [%-*@3 count] independent buffers. 
+If the CPU has AVX2 but not SHA extensions, 8 buffers are hashed 
+at once in AVX2 lanes, which is substantially faster for many 
+small buffers.&]
+[s4;%% &]
+[s1;%% &]
+[s2;:Upp`:`:SHA256Multi`(const Upp`:`:Vector`<Upp`:`:String`>`&`): [_^Upp`:`:Vector^ V
+ector]<[_^Upp`:`:String^ String]>_[* SHA256Multi]([@(0.0.255) const]_[_^Upp`:`:Vector^ Vect
+or]<[_^Upp`:`:String^ String]>`&_[*@3 data])&]
+[s3;%% Returns hexadecimal SHA`-256 hashes of all [%-*@3 data], using 
+SHA256Multi.&]
+[s4;%% &]
+[s1;%% &]
+[s2;:Upp`:`:CoSHA256Files`(const Upp`:`:Vector`<Upp`:`:String`>`&`): [_^Upp`:`:Vector^ V
+ector]<[_^Upp`:`:String^ String]>_[* CoSHA256Files]([@(0.0.255) const]_[_^Upp`:`:Vector^ V
+ector]<[_^Upp`:`:String^ String]>`&_[*@3 path])&]
+[s3;%% Computes hexadecimal SHA`-256 hashes of files in parallel. 
+Files that cannot be read have void String as result.&]
+[s4;%% &]
+[s1;%% &]
+[s2;:Upp`:`:GetHashAcceleration`(`): [_^Upp`:`:dword^ dword]_[* GetHashAcceleration]()&]
+[s3;%% Returns the set of hardware accelerated paths used by hashing 
+functions, combination of HASH`_CLMUL (CRC32 by carry`-less multiplication), 
+HASH`_CRC32C (SSE4.2 CRC32C instruction), HASH`_SHANI (SHA extensions) 
+and HASH`_AVX2 (multi`-buffer SHA`-256). Paths are chosen at runtime 
+based on CPU capabilities.&]
+[s4;%% &]
+[s1;%% &]
+[s2;:Upp`:`:SetHashAcceleration`(Upp`:`:dword`): [@(0.0.255) void]_[* SetHashAcceleratio
+n]([_^Upp`:`:dword^ dword]_[*@3 mask]_`=_[@3 0xffffffff])&]
+[s3;%% Restricts hardware paths to [%-*@3 mask]. Intended for testing 
+and benchmarking against portable code.&]
 [s4;%% ]]
\ No newline at end of file
@@ -228,6 +228,43 @@ switches SO`_LINGER off.&]
 [s2;%% Same as Linger(Null).&]
 [s3;%% &]
 [s4;%% &]
+[s5;:Socket`:`:ReadBufferSize`(int`): [_^Socket^ Socket][@(0.0.255) `&]_[* ReadBufferSize]([@(0.0.255) i
+nt]_[*@3 bytes])&]
+[s2;%% Sets the size of internal buffer used by Get, Peek and GetLine 
+methods. Buffer is allocated on the first read. Default is 64KB.&]
+[s3;%% &]
+[s4;%% &]
+[s5;:Socket`:`:GetReadBufferSize`(`)const: [@(0.0.255) int]_[* GetReadBufferSize]()_[@(0.0.255) c
+onst]&]
+[s2;%% Returns the size of internal read buffer.&]
+[s3;%% &]
+[s4;%% &]
+[s5;:Socket`:`:RecvBufferSize`(int`): [_^Socket^ Socket][@(0.0.255) `&]_[* RecvBufferSize]([@(0.0.255) i
+nt]_[*@3 bytes])&]
+[s2;%% Sets SO`_RCVBUF option. If socket is not open yet, option is 
+applied when it is opened (which is required to affect TCP window 
+scaling).&]
+[s3;%% &]
+[s4;%% &]
+[s5;:Socket`:`:SendBufferSize`(int`): [_^Socket^ Socket][@(0.0.255) `&]_[* SendBufferSize]([@(0.0.255) i
+nt]_[*@3 bytes])&]
+[s2;%% Sets SO`_SNDBUF option. If socket is not open yet, option is 
+applied when it is opened.&]
+[s3;%% &]
+[s4;%% &]
+[s5;:Socket`:`:QuickAck`(bool`): [_^Socket^ Socket][@(0.0.255) `&]_[* QuickAck]([@(0.0.255) b
+ool]_[*@3 b]_`=_[@(0.0.255) true])&]
+[s2;%% Renews TCP`_QUICKACK after each receive, which disables delayed 
+ACKs. Linux only, ignored on other platforms.&]
+[s3;%% &]
+[s4;%% &]
+[s5;:Socket`:`:FastOpen`(int`): [_^Socket^ Socket][@(0.0.255) `&]_[* FastOpen]([@(0.0.255) i
+nt]_[*@3 queue`_length]_`=_[@(0.0.255) 256])&]
+[s2;%% Activates TCP Fast Open for Listen (with [%-*@3 queue`_length]) 
+or Connect. Must be called before Listen or Connect. This is just 
+a hint, Linux only, ignored when kernel does not support it.&]
+[s3;%% &]
+[s4;%% &]
 [s5;:Socket`:`:Wait`(dword`): [@(0.0.255) bool]_[* Wait]([_^topic`:`/`/Core`/src`/PrimitiveDataTypes`$en`-us`#Upp`:`:dword`:`:typedef^ d
 word]_[*@3 events])&]
 [s2;%% Waits for at most timeout for [%-*@3 events], which can be a 
@@ -319,6 +356,26 @@ written in time specified by timeout, sets error and returns
 false.&]
 [s3;%% &]
 [s4;%% &]
+[s5;:Socket`:`:Put`(const String`*`,int`): [@(0.0.255) int]_[* Put]([@(0.0.255) const]_
+[_^String^ String]_`*[*@3 s], [@(0.0.255) int]_[*@3 count])&]
+[s2;%% Outputs [%-*@3 count] Strings using scatter/gather output (writev), 
+which means that e.g. HTTP header and body do not need to be concatenated 
+and are sent with single system call. Returns the number of bytes 
+written. In SSL mode, Strings are simply written one after another.&]
+[s3;%% &]
+[s4;%% &]
+[s5;:Socket`:`:PutAll`(const String`*`,int`): [@(0.0.255) bool]_[* PutAll]([@(0.0.255) const]_
+[_^String^ String]_`*[*@3 s], [@(0.0.255) int]_[*@3 count])&]
+[s5;:Socket`:`:PutAll`(const Vector`<String`>`&`): [@(0.0.255) bool]_[* PutAll]([@(0.0.255) c
+onst]_[_^Vector^ Vector]<[_^String^ String]>`&_[*@3 s])&]
+[s5;:Socket`:`:PutAll`(const String`&`,const String`&`): [@(0.0.255) bool]_[* PutAll]([@(0.0.255) c
+onst]_[_^String^ String][@(0.0.255) `&]_[*@3 s1], [@(0.0.255) const]_[_^String^ String][@(0.0.255) `&
+]_[*@3 s2])&]
+[s2;%% Outputs all Strings using scatter/gather output. If all data 
+cannot be written in time specified by timeout, sets error and 
+returns false.&]
+[s3;%% &]
+[s4;%% &]
 [s5;:Socket`:`:StartSSL`(`): [@(0.0.255) bool]_[* StartSSL]()&]
 [s2;%% Sets Socket to SSL mode and starts SSL handshake. Core/SSL 
 must be present in project. Returns true if SSL could have been 
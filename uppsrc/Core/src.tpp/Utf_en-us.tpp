@@ -12,6 +12,11 @@ topic "Unicode UTF[8,16,32] support";
 [{_} 
 [ {{10000@(113.42.0) [s0;%% [*@7;4 Unicode UTF`[8,16,32`] support]]}}&]
 [s0;%% &]
+[s0;%% Conversion, length and validation functions process runs 
+of ASCII characters in blocks of 16 or 32 code units using SIMD 
+instructions (SSE2 or NEON) if available, the rest of text is 
+processed one codepoint at a time.&]
+[s0;%% &]
 [s5;:IsUtf8Lead`(int`): [@(0.0.255) bool]_[* IsUtf8Lead]([@(0.0.255) int]_[*@3 c])&]
 [s2;%% Tests whether [%-*@3 c ]is lead UTF`-8 byte.&]
 [s3;%% &]
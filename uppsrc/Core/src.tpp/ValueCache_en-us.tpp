@@ -15,6 +15,13 @@ topic "Global Value Cache";
 [s0; Global Value Cache is a centralized mechanism to cache data. 
 Items in the cache are of Value type. Global Value Cache adjusts 
 its size based on current system memory consumption.&]
+[s0; &]
+[s0; The cache is divided into shards selected by the hash of the 
+key, each with its own reader/writer lock, so that threads retrieving 
+cached Values do not block each other. When the cache exceeds 
+its limits, Values are evicted using the CLOCK (second chance) 
+algorithm, which approximates LRU order. The total size and count 
+of cached Values are maintained globally.&]
 [s0;* &]
 [ {{10000F(128)G(128)@1 [s0; [* Function List]]}}&]
 [s3; &]
@@ -37,7 +44,11 @@ if yes then it returns Value from the cache, otherwise calls
 ValueMaker`::Make to obtain the Value and stores it to the cache. 
 Note that this function allows full reentrancy (from various 
 threads as well as recursive calls (through Make method) in single 
-thread&]
+thread). Make is called without holding any lock. If another thread 
+is already making the Value for the same key, the function waits 
+for it and returns its result instead of calling Make again. If 
+Make throws an exception, nothing is stored and the exception 
+is propagated.&]
 [s2; &]
 [s4;%- &]
 [s5;:Upp`:`:MakeValue`(const K`&`,const M`&`):%- [@(0.0.255) template] 
@@ -103,4 +114,29 @@ size needed to store Value passed as parameter or it can return
 negative number to signal that the size has not changed. This 
 is very specific function basically only needed to support PaintOnly 
 Images.&]
+[s3; &]
+[s4;%- &]
+[s5;:Upp`:`:GetValueCacheSize`(`):%- [_^Upp`:`:int64^ int64]_[* GetValueCacheSize]()&]
+[s2; Returns the total size of cached Values, including internal 
+overhead.&]
+[s3;%- &]
+[s4;%- &]
+[s5;:Upp`:`:GetValueCacheCount`(`):%- [@(0.0.255) int]_[* GetValueCacheCount]()&]
+[s2; Returns the number of cached Values.&]
+[s3;%- &]
+[s4;%- &]
+[s5;:Upp`:`:GetValueCacheStats`(`):%- [_^Upp`:`:ValueCacheStats^ ValueCacheStats]_[* Get
+ValueCacheStats]()&]
+[s2; Returns cache statistics:&]
+[s2; &]
+[s2; [* hits] `- number of requests satisfied from the cache,&]
+[s2; [* misses] `- number of Values created by ValueMaker`::Make,&]
+[s2; [* waits] `- number of requests that waited for another thread 
+making the same Value,&]
+[s2; [* evictions] `- number of Values dropped to maintain the limits,&]
+[s2; [* size], [* count] `- current size and count of the cache.&]
+[s3;%- &]
+[s4;%- &]
+[s5;:Upp`:`:ClearValueCacheStats`(`):%- [@(0.0.255) void]_[* ClearValueCacheStats]()&]
+[s2; Resets hits, misses, waits and evictions counters to zero.&]
 [s0; ]]
\ No newline at end of file
@@ -34,6 +34,12 @@ elements with corresponding indices.&]
 ValueArray elements contained in Value with text keys (if Value 
 does not contain ValueMap or requested key, Void Value is returned).&]
 [s2; &]
+[s2; ValueMaps with the same keys can share them: copies of ValueMap 
+share keys even after values are changed, ParseJSON makes all 
+objects with the same keys (typically records in JSON array) 
+share them. Keys are copied when they are changed (Add of new 
+key, SetKey, Remove...).&]
+[s2; &]
 [ {{10000F(128)G(128)@1 [s0; [* Public Method List]]}}&]
 [s3;%- &]
 [s5;:ValueMap`:`:ValueMap`(`):%- [* ValueMap]()&]
@@ -78,6 +84,14 @@ onst]_[_^VectorMap^ VectorMap]<[_^Value^ Value], [_^Value^ Value]>`&_[*@3 m],
 [s2; Creates ValueMap by deep copying VectorMap.&]
 [s3; &]
 [s4;%- &]
+[s5;:Upp`:`:ValueMap`:`:ValueMap`(const Upp`:`:ValueMap`&`,Upp`:`:Vector`<Upp`:`:Value`>`&`&`):%- [* V
+alueMap]([@(0.0.255) const]_[* ValueMap][@(0.0.255) `&]_[*@3 shape], 
+[_^Upp`:`:Vector^ Vector]<[_^Upp`:`:Value^ Value]>`&`&_[*@3 v])&]
+[s2; Creates ValueMap with the same keys as [%-*@3 shape] (keys are 
+shared, not copied) and values picked from [%-*@3 v]. [%-*@3 v] 
+must have the same number of elements as [%-*@3 shape].&]
+[s3; &]
+[s4;%- &]
 [s5;:ValueMap`:`:`~ValueMap`(`):%- [@(0.0.255) `~][* ValueMap]()&]
 [s2; Destructor.&]
 [s3;%- &]
@@ -56,6 +56,46 @@ request headers for Connect.&]
 [s2;%% Returns current HTTP request headers for Connect.&]
 [s3; &]
 [s4; &]
+[s5;:Upp`:`:WebSocket`:`:Deflate`(bool`): [_^Upp`:`:WebSocket^ WebSocket][@(0.0.255) `&
+]_[* Deflate]([@(0.0.255) bool]_[*@3 b]_`=_[@(0.0.255) true])&]
+[s2;%% Enables permessage`-deflate extension (default is true). 
+Extension is used when both sides agree. Outgoing messages are 
+always compressed without context takeover and full window, so 
+the server declines offers that limit server`_max`_window`_bits, 
+as well as offers with unknown, repeated or invalid parameters.&]
+[s3;%% &]
+[s4; &]
+[s5;:Upp`:`:WebSocket`:`:NoDeflate`(`): [_^Upp`:`:WebSocket^ WebSocket][@(0.0.255) `&]_[* N
+oDeflate]()&]
+[s2;%% Same as Deflate(false).&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:WebSocket`:`:IsDeflate`(`)const: [@(0.0.255) bool]_[* IsDeflate]()_[@(0.0.255) c
+onst]&]
+[s2;%% Returns true if permessage`-deflate was negotiated.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:WebSocket`:`:MaxMessageSize`(int`): [_^Upp`:`:WebSocket^ WebSocket][@(0.0.255) `&
+]_[* MaxMessageSize]([@(0.0.255) int]_[*@3 bytes])&]
+[s2;%% Sets the maximum size of received frame and of decompressed 
+permessage`-deflate message. Compressed message is checked while 
+being inflated. When the limit is exceeded, connection is closed 
+with status code 1009 (message too big) and WebSocket goes to error 
+state. Default is 64MB.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:WebSocket`:`:GetMaxMessageSize`(`)const: [@(0.0.255) int]_[* GetMaxMessageSiz
+e]()_[@(0.0.255) const]&]
+[s2;%% Returns the maximum message size.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:WebSocket`:`:Send`(Upp`:`:WebSocketFrame`&`): [@(0.0.255) void]_[* Send]([_^Upp`:`:WebSocketFrame^ W
+ebSocketFrame][@(0.0.255) `&]_[*@3 frame])&]
+[s2;%% Sends a message prepared as WebSocketFrame. Frame is created 
+(and compressed) only once, then shared by all WebSockets it is 
+sent to.&]
+[s3; &]
+[s4; &]
 [s5;:Upp`:`:WebSocket`:`:IsBlocking`(`)const: [@(0.0.255) bool]_[* IsBlocking]()_[@(0.0.255) c
 onst]&]
 [s2;%% Returns true if WebSocket is in the blocking mode.&]
@@ -42,7 +42,7 @@ static byte sGZip_header[10] = { GZ_MAGIC1, GZ_MAGIC2, Z_DEFLATED, 0, 0, 0, 0, 0
 
 void Crc32Stream::Out(const void *ptr, dword count)
 {
-	crc = crc32(crc, (byte *)ptr, count);
+	crc = UpdateCRC32(crc, ptr, count);
 }
 
 void Crc32Stream::Clear()
@@ -74,6 +74,11 @@ void Zlib::Begin()
 	footer.Clear();
 	gzip_footer = false;
 	gzip_header_done = false;
+	co_in.Clear();
+	co_len = 0;
+	co_dict.Clear();
+	co_hdr = false;
+	adler = adler32(0, NULL, 0);
 }
 
 void Zlib::Compress()
@@ -96,7 +101,7 @@ void Zlib::Decompress()
 	mode = INFLATE;
 }
 
-void Zlib::Pump(bool finish)
+void Zlib::Pump(int flush)
 {
 	if(error)
 		return;
@@ -112,11 +117,11 @@ void Zlib::Pump(bool finish)
 		int code;
 		z.avail_out = chunk;
 		z.next_out = output;
-		code = (mode == DEFLATE ? deflate : inflate)(&z, finish ? Z_FINISH : Z_NO_FLUSH);
+		code = (mode == DEFLATE ? deflate : inflate)(&z, flush);
 		int count = chunk - z.avail_out;
 		if(count) {
 			if((docrc || gzip) && mode == INFLATE)
-				crc = crc32(crc, output, count);
+				crc = UpdateCRC32(crc, output, count);
 			WhenOut((const char *)~output, count);
 			if(mode == INFLATE)
 				total += count;
@@ -174,6 +179,30 @@ int Zlib::GzipHeader(const char *ptr, int size)
 	return pos;
 }
 
+bool Zlib::GzipFooterOk() const
+{
+	return footer.GetCount() >= 8 && Peek32le(~footer) == (int)crc && Peek32le(~footer + 4) == total;
+}
+
+bool Zlib::GzipNextMember()
+{ // gzip file can consist of several members (e.g. produced by parallel compressors)
+	if(!(gzip && mode == INFLATE && gzip_footer && footer.GetCount() > 8) || error)
+		return false;
+	if(!GzipFooterOk()) {
+		LLOG("ZLIB GZIP FOOTER ERROR");
+		error = true;
+		return false;
+	}
+	gzip_hs = footer.Mid(8); // rest goes through header parsing again
+	footer.Clear();
+	crc = crc32(0, NULL, 0);
+	total = 0;
+	gzip_header_done = false;
+	gzip_footer = false;
+	inflateReset(&z);
+	return true;
+}
+
 void Zlib::Put0(const char *ptr, int size)
 {
 	if(error)
@@ -181,36 +210,48 @@ void Zlib::Put0(const char *ptr, int size)
 	ASSERT(mode);
 	if(size <= 0)
 		return;
-	if(gzip && !gzip_header_done && mode == INFLATE) {
-		if(gzip_hs.GetCount()) {
-			gzip_hs.Cat(ptr, size);
-			ptr = ~gzip_hs;
-			size = gzip_hs.GetCount();
-		}
-		int pos = GzipHeader(ptr, size);
-		if(!pos) {
-			if(gzip_hs.GetCount() == 0)
+	do {
+		if(gzip && !gzip_header_done && mode == INFLATE) {
+			if(gzip_hs.GetCount()) {
 				gzip_hs.Cat(ptr, size);
+				ptr = ~gzip_hs;
+				size = gzip_hs.GetCount();
+			}
+			int pos = GzipHeader(ptr, size);
+			if(!pos) {
+				if(gzip_hs.GetCount() == 0)
+					gzip_hs.Cat(ptr, size);
+				return;
+			}
+			
+			gzip_header_done = true;
+			size -= pos;
+			ptr += pos;
+		}
+	
+		if(size <= 0)
+			return;
+	
+		if(mode == DEFLATE && co) {
+			CoPut(ptr, size);
 			return;
 		}
-		
-		gzip_header_done = true;
-		size -= pos;
-		ptr += pos;
-	}
-
-	if(size <= 0)
-		return;
-
-	if(mode == DEFLATE) {
-		total += size;
-		if(docrc || gzip)
-			crc = crc32(crc, (const Bytef *)ptr, size);
+	
+		if(mode == DEFLATE) {
+			total += size;
+			if(docrc || gzip)
+				crc = UpdateCRC32(crc, ptr, size);
+		}
+	
+		z.next_in = (Bytef *)ptr;
+		z.avail_in = size;
+		Pump(Z_NO_FLUSH);
+		ptr = NULL;
+		size = 0;
+		if(gzip_header_done && gzip_hs.GetCount()) // header was assembled in gzip_hs
+			gzip_hs.Clear();
 	}
-
-	z.next_in = (Bytef *)ptr;
-	z.avail_in = size;
-	Pump(false);
+	while(GzipNextMember());
 }
 	
 void Zlib::Put(const void *ptr, int size)
@@ -233,25 +274,143 @@ void Zlib::PutOut(const void *ptr, int size)
 	out.Cat((const char *)ptr, (int)size);
 }
 
+void Zlib::CoPut(const char *ptr, int size)
+{
+	if(!co_in)
+		co_in.Alloc(CO_BLOCK * CO_BLOCKS);
+	total += size;
+	while(size > 0) {
+		int n = min(size, CO_BLOCK * CO_BLOCKS - co_len);
+		memcpy(~co_in + co_len, ptr, n);
+		co_len += n;
+		ptr += n;
+		size -= n;
+		if(co_len == CO_BLOCK * CO_BLOCKS)
+			CoFlush(false);
+	}
+}
+
+void Zlib::CoFlush(bool finish)
+{ // pigz style: blocks are deflated independently, primed with preceding 32KB as dictionary
+	if(error || co_len == 0 && !finish)
+		return;
+	if(hdr && !gzip && !co_hdr) { // zlib header
+		int level = compression_level < 0 ? 6 : compression_level;
+		byte h[2];
+		h[0] = 0x78;
+		h[1] = (level < 2 ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3) << 6;
+		h[1] += 31 - (h[0] * 256 + h[1]) % 31;
+		WhenOut(h, 2);
+	}
+	co_hdr = true;
+
+	struct Block {
+		int    at, len;
+		String out;
+		dword  crc, adler;
+		bool   error;
+	};
+	int n = max((co_len + CO_BLOCK - 1) / CO_BLOCK, 1);
+	Buffer<Block> block(n);
+	CoWork cw;
+	for(int i = 0; i < n; i++) {
+		Block& b = block[i];
+		b.at = i * CO_BLOCK;
+		b.len = min(co_len - b.at, (int)CO_BLOCK);
+		cw & [=, &b] {
+			const byte *s = ~co_in + b.at;
+			b.error = true;
+			b.crc = docrc || gzip ? UpdateCRC32(0, s, b.len) : 0;
+			b.adler = hdr && !gzip ? adler32(adler32(0, NULL, 0), s, b.len) : 0;
+			z_stream z;
+			memset(&z, 0, sizeof(z));
+			z.zalloc = zalloc_new;
+			z.zfree = zfree_new;
+			if(deflateInit2(&z, compression_level, Z_DEFLATED, -MAX_WBITS, DEF_MEM_LEVEL,
+			                Z_DEFAULT_STRATEGY) != Z_OK)
+				return;
+			if(i)
+				deflateSetDictionary(&z, s - CO_DICT, CO_DICT);
+			else
+			if(co_dict.GetCount())
+				deflateSetDictionary(&z, (const Bytef *)~co_dict, co_dict.GetCount());
+			int sz = (int)deflateBound(&z, b.len) + 64; // sync flush marker etc.
+			StringBuffer o(sz);
+			z.next_in = (Bytef *)s;
+			z.avail_in = b.len;
+			z.next_out = (Bytef *)~o;
+			z.avail_out = sz;
+			bool last = finish && i == n - 1;
+			int code = deflate(&z, last ? Z_FINISH : Z_SYNC_FLUSH); // sync flush byte aligns the block
+			if((last ? code == Z_STREAM_END : code == Z_OK) && z.avail_in == 0 && z.avail_out) {
+				o.SetCount(sz - z.avail_out);
+				b.out = o;
+				b.error = false;
+			}
+			deflateEnd(&z);
+		};
+	}
+	cw.Finish();
+
+	for(int i = 0; i < n; i++) {
+		Block& b = block[i];
+		if(b.error) {
+			error = true;
+			return;
+		}
+		if(docrc || gzip)
+			crc = crc32_combine(crc, b.crc, b.len);
+		if(hdr && !gzip)
+			adler = adler32_combine(adler, b.adler, b.len);
+		WhenOut(~b.out, b.out.GetCount());
+	}
+
+	if(co_len >= CO_DICT)
+		co_dict = String(~co_in + co_len - CO_DICT, CO_DICT);
+	else {
+		co_dict.Cat(~co_in, co_len);
+		co_dict = co_dict.Right(CO_DICT);
+	}
+	co_len = 0;
+}
+
 void Zlib::End()
 {
 	LLOG("ZLIB End");
+	if(mode == DEFLATE && co) {
+		CoFlush(true);
+		if(hdr && !gzip) {
+			char h[4];
+			Poke32be(h, adler);
+			WhenOut(h, 4);
+		}
+	}
+	else
 	if(mode != INFLATE || !gzip || gzip_header_done)
-		Pump(true);
+		Pump(Z_FINISH);
 	if(gzip && mode == DEFLATE) {
 		char h[8];
 		Poke32le(h, crc);
 		Poke32le(h + 4, total);
 		WhenOut(h, 8);
 	}
-	if(gzip && mode == INFLATE &&
-	   (footer.GetCount() != 8 || Peek32le(~footer) != (int)crc || Peek32le(~footer + 4) != total)) {
+	if(gzip && mode == INFLATE && (footer.GetCount() != 8 || !GzipFooterOk())) {
 		LLOG("ZLIB GZIP FOOTER ERROR");
 		error = true;
 	}
 	Free();
 }
 
+void Zlib::Flush()
+{
+	LLOG("ZLIB Flush");
+	ASSERT(mode == DEFLATE);
+	if(co)
+		CoFlush(false);
+	else
+		Pump(Z_SYNC_FLUSH);
+}
+
 void Zlib::Free()
 {
 	if(mode == INFLATE)
@@ -297,6 +456,8 @@ Zlib::Zlib()
 	docrc = false;
 	crc = 0;
 	hdr = true;
+	co = false;
+	co_len = 0;
 	chunk = 4096;
 	WhenOut = callback(this, &Zlib::PutOut);
 	compression_level = Z_DEFAULT_COMPRESSION;
@@ -307,11 +468,27 @@ Zlib::~Zlib()
 	Free();
 }
 
-int64 zPress(Stream& out, Stream& in, int64 size, Gate<int64, int64> progress, bool gzip, bool compress,
-             dword *crc = NULL, bool hdr = true)
+void ZDecompressStream::Open(Stream& in)
+{
+	z.Decompress();
+	Set(in, z);
+	FilterEof = [=] {
+		if(z.IsError())
+			SetError();
+		return z.IsError();
+	};
+	End = [=] {
+		z.End();
+		if(z.IsError())
+			SetError();
+	};
+}
+
+static int64 zPress0(Stream& out, Stream& in, int64 size, Gate<int64, int64> progress, bool gzip,
+                     bool compress, dword *crc, bool hdr, bool co)
 {
 	Zlib zlib;
-	zlib.GZip(gzip).CRC(crc).Header(hdr);
+	zlib.GZip(gzip).CRC(crc).Header(hdr).Co(co);
 	
 	int64 r = -1;
 	{
@@ -331,6 +508,12 @@ int64 zPress(Stream& out, Stream& in, int64 size, Gate<int64, int64> progress, b
 	return r;
 }
 
+int64 zPress(Stream& out, Stream& in, int64 size, Gate<int64, int64> progress, bool gzip, bool compress,
+             dword *crc = NULL, bool hdr = true)
+{
+	return zPress0(out, in, size, progress, gzip, compress, crc, hdr, false);
+}
+
 int64 ZCompress(Stream& out, Stream& in, int64 size, Gate<int64, int64>progress, bool hdr)
 {
 	return zPress(out, in, size, progress, false, true, NULL, hdr);
@@ -433,6 +616,54 @@ bool GZCompressFile(const char *dstfile, const char *srcfile, Gate<int64, int64>
 	return !out.IsError();
 }
 
+int64 CoZCompress(Stream& out, Stream& in, Gate<int64, int64>progress)
+{
+	return zPress0(out, in, in.GetLeft(), progress, false, true, NULL, true, true);
+}
+
+String CoZCompress(const void *data, int64 len, Gate<int64, int64>progress)
+{
+	StringStream out;
+	MemReadStream in(data, len);
+	return CoZCompress(out, in, progress) < 0 ? String::GetVoid() : out.GetResult();
+}
+
+String CoZCompress(const String& s, Gate<int64, int64>progress)
+{
+	return CoZCompress(~s, s.GetLength(), progress);
+}
+
+int64 CoGZCompress(Stream& out, Stream& in, Gate<int64, int64>progress)
+{
+	return zPress0(out, in, in.GetLeft(), progress, true, true, NULL, true, true);
+}
+
+String CoGZCompress(const void *data, int64 len, Gate<int64, int64>progress)
+{
+	StringStream out;
+	MemReadStream in(data, len);
+	return CoGZCompress(out, in, progress) < 0 ? String::GetVoid() : out.GetResult();
+}
+
+String CoGZCompress(const String& s, Gate<int64, int64>progress)
+{
+	return CoGZCompress(~s, s.GetLength(), progress);
+}
+
+bool CoGZCompressFile(const char *dstfile, const char *srcfile, Gate<int64, int64>progress)
+{
+	FileIn in(srcfile);
+	if(!in)
+		return false;
+	FileOut out(dstfile);
+	if(!out)
+		return false;
+	if(CoGZCompress(out, in, progress) < 0)
+		return false;
+	out.Close();
+	return !out.IsError();
+}
+
 bool GZCompressFile(const char *srcfile, Gate<int64, int64>progress)
 {
 	return GZCompressFile(~(String(srcfile) + ".gz"), srcfile, progress);
@@ -520,4 +751,69 @@ void sCompressStreamCopy_(Stream& out, Stream& in, Gate<int64, int64> progress,
 	progress(orig_in.GetPos(), insz);
 }
 
+// Seek table trailer compatible with zstd seekable format: skippable frame with
+// (compressed size, decompressed size) pairs, followed by 9 bytes footer.
+// Also used in plugin/lz4, as LZ4 frame decoders skip skippable frames as well.
+
+enum {
+	SEEKTABLE_SKIPPABLE_MAGIC = 0x184D2A5E,
+	SEEKTABLE_MAGIC           = 0x8F92EAB1,
+};
+
+void sWriteSeekTable_(Stream& out, const Vector<Tuple<dword, dword>>& frame)
+{
+	out.Put32le(SEEKTABLE_SKIPPABLE_MAGIC);
+	out.Put32le(8 * frame.GetCount() + 9);
+	for(const auto& f : frame) {
+		out.Put32le(f.a);
+		out.Put32le(f.b);
+	}
+	out.Put32le(frame.GetCount());
+	out.Put(0); // descriptor: no checksums
+	out.Put32le(SEEKTABLE_MAGIC);
+}
+
+bool sReadSeekTable_(Stream& in, int64 base, Vector<int64>& coffset, Vector<int64>& doffset)
+{
+	coffset.Clear();
+	doffset.Clear();
+	if(!(in.GetStyle() & STRM_SEEK))
+		return false;
+	int64 pos = in.GetPos();
+	int64 size = in.GetSize();
+	bool ok = false;
+	if(size - base >= 17) {
+		in.Seek(size - 9);
+		dword n = in.Get32le();
+		int   descriptor = in.Get();
+		int   esz = descriptor & 0x80 ? 12 : 8;
+		int64 tablesz = (int64)n * esz + 9;
+		if((dword)in.Get32le() == SEEKTABLE_MAGIC && (descriptor & 0x7c) == 0 && tablesz + 8 <= size - base) {
+			in.Seek(size - tablesz - 8);
+			if((dword)in.Get32le() == SEEKTABLE_SKIPPABLE_MAGIC && (dword)in.Get32le() == tablesz) {
+				int64 c = base;
+				int64 d = 0;
+				for(dword i = 0; i < n && !in.IsEof(); i++) {
+					coffset.Add(c);
+					doffset.Add(d);
+					c += (dword)in.Get32le();
+					d += (dword)in.Get32le();
+					if(esz == 12)
+						in.Get32le();
+				}
+				coffset.Add(c);
+				doffset.Add(d);
+				ok = !in.IsError() && coffset.GetCount() == (int)n + 1 && c <= size - tablesz - 8;
+			}
+		}
+	}
+	in.ClearError();
+	in.Seek(pos);
+	if(!ok) {
+		coffset.Clear();
+		doffset.Clear();
+	}
+	return ok;
+}
+
 }
@@ -14,6 +14,32 @@ public:
 dword CRC32(const void *ptr, dword count);
 dword CRC32(const String& s);
 
+class Crc32cStream : public OutStream {
+	dword crc;
+
+	virtual  void  Out(const void *data, dword size);
+
+public:
+	dword  Finish()            { Flush(); return crc; }
+	operator dword()           { return Finish(); }
+	void   Clear()             { crc = 0; }
+	
+	Crc32cStream()             { Clear(); }
+};
+
+dword CRC32C(const void *ptr, size_t count);
+dword CRC32C(const String& s);
+
+dword UpdateCRC32(dword crc, const void *ptr, size_t count);
+dword UpdateCRC32C(dword crc, const void *ptr, size_t count);
+dword CombineCRC32(dword crc1, dword crc2, int64 len2);
+dword CombineCRC32C(dword crc1, dword crc2, int64 len2);
+
+dword CoCRC32(const void *ptr, size_t count);
+dword CoCRC32C(const void *ptr, size_t count);
+bool  CoCRC32File(const char *path, dword& crc);
+bool  CoCRC32CFile(const char *path, dword& crc);
+
 class Zlib {
 	enum { NONE, DEFLATE, INFLATE };
 
@@ -35,13 +61,25 @@ class Zlib {
 	String        gzip_name;
 	String        gzip_comment;
 	String        out;
-	
+	bool          co;
+	bool          co_hdr;
+	Buffer<byte>  co_in;
+	int           co_len;
+	String        co_dict;
+	dword         adler;
+
+	enum { CO_BLOCK = 128 * 1024, CO_BLOCKS = 32, CO_DICT = 32 * 1024 };
+
 	void          PutOut(const void *ptr, int size);
-	void          Pump(bool finish);
+	void          Pump(int flush);
+	void          CoPut(const char *ptr, int size);
+	void          CoFlush(bool finish);
 	void          Begin();
 	void          Free();
 	void          Put0(const char *ptr, int size);
 	int           GzipHeader(const char *ptr, int size);
+	bool          GzipFooterOk() const;
+	bool          GzipNextMember();
 	void          Init();
 
 public:
@@ -51,6 +89,7 @@ public:
 	void Decompress();
 	void Put(const void *ptr, int size);
 	void Put(const String& s)              { Put(~s, s.GetCount()); }
+	void Flush();
 	void End();
 	void Clear();
 	
@@ -71,6 +110,7 @@ public:
 	Zlib& NoCRC()                          { return CRC(false); }
 	Zlib& ChunkSize(int n);
 	Zlib& Level(int compression_lvl)       { compression_level = compression_lvl; return *this; }
+	Zlib& Co(bool b = true)                { co = b; return *this; }
 
 	Zlib();
 	~Zlib();
@@ -91,6 +131,7 @@ public:
 	Zlib& NoCRC()                          { return CRC(false); }
 	Zlib& ChunkSize(int n)                 { return z.ChunkSize(n); }
 	Zlib& Level(int compression_lvl)       { return z.Level(compression_lvl); }
+	Zlib& Co(bool b = true)                { return z.Co(b); }
 
 	ZCompressStream()                      {}
 	ZCompressStream(Stream& out)           { Open(out); }
@@ -101,7 +142,7 @@ class ZDecompressStream : public InFilterStream {
 	Zlib         z;
 
 public:
-	void Open(Stream& in)                  { z.Decompress(); Set(in, z); }
+	void Open(Stream& in);
 
 	dword  GetCRC() const                  { return z.GetCRC(); }
 	String GetGZipName() const             { return z.GetGZipName(); }
@@ -137,6 +178,16 @@ int64  GZCompress(Stream& out, Stream& in, Gate<int64, int64> progress = Null);
 String GZCompress(const void *data, int len, Gate<int64, int64> progress = Null);
 String GZCompress(const String& s, Gate<int64, int64> progress = Null);
 
+int64  CoZCompress(Stream& out, Stream& in, Gate<int64, int64> progress = Null);
+String CoZCompress(const void *data, int64 len, Gate<int64, int64> progress = Null);
+String CoZCompress(const String& s, Gate<int64, int64> progress = Null);
+
+int64  CoGZCompress(Stream& out, Stream& in, Gate<int64, int64> progress = Null);
+String CoGZCompress(const void *data, int64 len, Gate<int64, int64> progress = Null);
+String CoGZCompress(const String& s, Gate<int64, int64> progress = Null);
+
+bool   CoGZCompressFile(const char *dstfile, const char *srcfile, Gate<int64, int64> progress = Null);
+
 int64  GZDecompress(Stream& out, Stream& in, int64 size, Gate<int64, int64> progress = Null);
 int64  GZDecompress(Stream& out, Stream& in, Gate<int64, int64> progress = Null);
 String GZDecompress(const void *data, int len, Gate<int64, int64> progress = Null);
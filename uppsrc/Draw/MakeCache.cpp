@@ -41,7 +41,7 @@ void SysImageRealized(const Image& img)
 			}
 			return -1;
 		});
-		LLOG("After drop, cache size: " << TheValueCache().GetSize());
+		LLOG("After drop, cache size: " << GetValueCacheSize());
 	}
 }
 
@@ -13,6 +13,7 @@ protected:
 	virtual int         GetRowsProcessed() const;
 	virtual bool        Fetch();
 	virtual void        GetColumn(int i, Ref f) const;
+	virtual int         FetchBatch(SqlBatch& batch, int n);
 	virtual void        Cancel();
 	virtual Value       GetInsertedId() const;
 	virtual SqlSession& GetSession() const;
@@ -451,6 +452,37 @@ void MySqlConnection::GetColumn(int i, Ref f) const {
 	}
 }
 
+int MySqlConnection::FetchBatch(SqlBatch& batch, int n) {
+	if(lastid)
+		return SqlConnection::FetchBatch(batch, n);
+	int count = 0;
+	while(count < n && Fetch()) { // parses MYSQL_ROW buffers straight to typed columns
+		for(int i = 0; i < info.GetCount(); i++) {
+			SqlBatchColumn& c = batch.Column(i);
+			const char *s = row[i];
+			if(s == NULL)
+				c.AddNull();
+			else
+			if(c.type == INT64_V)
+				c.i64.Add(ScanInt64(s));
+			else
+			if(c.type == DOUBLE_V)
+				c.dbl.Add(ScanDouble(s, NULL, true));
+			else
+			if(c.type == STRING_V)
+				c.str.Add(convert[i] ? ToCharset(CHARSET_DEFAULT, String(s, len[i]), CHARSET_UTF8)
+				                     : String(s, len[i]));
+			else {
+				Value v;
+				GetColumn(i, v);
+				c.AddValue(v);
+			}
+		}
+		count++;
+	}
+	return count;
+}
+
 void MySqlConnection::FreeResult() {
 	lastid = 0;
 	if(result) {
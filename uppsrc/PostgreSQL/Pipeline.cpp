@@ -0,0 +1,323 @@
+#include "PostgreSQL.h"
+
+#ifndef flagNOPOSTGRESQL
+
+namespace Upp {
+
+// Statements are sent with PQsendQueryParams without waiting for the results, so many
+// statements share single network round trip. Server returns results when it reaches
+// sync point (or when asked to flush), in the order the statements were sent. Statements
+// between sync points run in implicit transaction (unless there is explicit one), error
+// rolls it back and the server skips all remaining statements up to the next sync point.
+
+bool PostgreSQLPipeline::Open(PostgreSQLSession& s)
+{
+	Close();
+	if(!s.ConnectionOK())
+		return false;
+	PGconn *conn = s.conn;
+	if(PQpipelineStatus(conn) != PQ_PIPELINE_OFF || PQsetnonblocking(conn, 1)) {
+		s.SetError("Cannot set nonblocking mode", "Pipeline");
+		return false;
+	}
+	if(!PQenterPipelineMode(conn)) {
+		s.SetError(s.ErrorMessage(), "Pipeline");
+		PQsetnonblocking(conn, 0);
+		return false;
+	}
+	session = &s;
+	return true;
+}
+
+void PostgreSQLPipeline::Close()
+{
+	if(!session)
+		return;
+	Finish();
+	if(session->conn) {
+		PQexitPipelineMode(Conn());
+		PQsetnonblocking(Conn(), 0);
+	}
+	session = NULL;
+	pending.Clear();
+	result.Clear();
+	removed = 0;
+	unsynced = 0;
+	flush = false;
+}
+
+PostgreSQLPipeline::Query& PostgreSQLPipeline::Add(Event<const PostgreSQLResult&> done)
+{
+	Query& q = pending.AddTail();
+	q.handle = next_handle++;
+	q.sent = false;
+	q.done = done;
+	return q;
+}
+
+int PostgreSQLPipeline::Send(const String& statement, const Vector<Value>& param,
+                             Event<const PostgreSQLResult&> done)
+{
+	ASSERT(session);
+	Query& q = Add(done);
+
+	String sql;
+	int n = 0;
+	const char *s = statement;
+	while(s < statement.End())
+		if(*s == '\'' || *s == '\"')
+			s = PostgreSQLReadString(s, sql);
+		else {
+			if(*s == '?' && !session->noquestionparams) {
+				if(s[1] == '?') {
+					sql.Cat('?');
+					s++;
+				}
+				else
+					sql << '$' << ++n;
+			}
+			else
+				sql.Cat(*s);
+			s++;
+		}
+
+	if(n != param.GetCount()) { // reported in order with the other results
+		q.result.error = true;
+		q.result.error_message = "Invalid number of parameters";
+		return q.handle;
+	}
+
+	Vector<String> value;
+	Vector<int> format;
+	for(const Value& v : param)
+		value.Add(session->ParamValue(v, format.Add()));
+	Vector<const char *> ptr;
+	Vector<int> len;
+	for(int i = 0; i < n; i++) {
+		ptr.Add(IsNull(param[i]) ? NULL : ~value[i]);
+		len.Add(value[i].GetLength());
+	}
+
+	if(Stream *trace = session->GetTrace())
+		*trace << statement << UPP::EOL;
+
+	if(!PQsendQueryParams(Conn(), sql, n, NULL, ptr.begin(), len.begin(), format.begin(), 0)) {
+		q.result.error = true;
+		q.result.error_message = session->ErrorMessage();
+		return q.handle;
+	}
+	q.sent = true;
+	unsynced++;
+	return q.handle;
+}
+
+int PostgreSQLPipeline::Send(const SqlStatement& s, Event<const PostgreSQLResult&> done)
+{
+	return Send(s.Get(PGSQL), Vector<Value>(), done);
+}
+
+void PostgreSQLPipeline::Sync()
+{
+	if(!session || !unsynced)
+		return;
+	if(!PQpipelineSync(Conn())) {
+		Fail(session->ErrorMessage());
+		return;
+	}
+	Query& q = pending.AddTail();
+	q.handle = -1;
+	q.sent = true;
+	unsynced = 0;
+	flush = PQflush(Conn()) > 0;
+}
+
+void PostgreSQLPipeline::Store(PostgreSQLResult& r, PGresult *result)
+{
+	switch(PQresultStatus(result)) {
+	case PGRES_TUPLES_OK: {
+			Vector<Oid> oid;
+			session->GetColumnInfo(result, r.info, oid);
+			int rows = PQntuples(result);
+			r.row.SetCount(rows);
+			for(int i = 0; i < rows; i++) {
+				Vector<Value>& row = r.row[i];
+				row.SetCount(oid.GetCount());
+				for(int j = 0; j < oid.GetCount(); j++)
+					row[j] = session->GetValue(result, i, j, oid[j]);
+			}
+			r.rows_processed = rows;
+		}
+		break;
+	case PGRES_COMMAND_OK:
+		r.rows_processed = atoi(PQcmdTuples(result));
+		break;
+	case PGRES_PIPELINE_ABORTED:
+		r.error = true;
+		r.error_message = "Not executed because of previous error in pipeline";
+		break;
+	default: {
+			r.error = true;
+			r.error_message = session->FromCharset(PQresultErrorMessage(result));
+			const char *code = PQresultErrorField(result, PG_DIAG_SQLSTATE);
+			r.error_code = code ? code : "";
+		}
+	}
+}
+
+void PostgreSQLPipeline::Finish(Query& q)
+{ // removes q from pending
+	int handle = q.handle;
+	if(q.done) { // result passed to callback is not kept
+		Event<const PostgreSQLResult&> done = pick(q.done);
+		PostgreSQLResult r = pick(q.result);
+		pending.DropHead();
+		done(r);
+	}
+	else {
+		result.Add(handle, pick(q.result));
+		pending.DropHead();
+	}
+	WhenDone(handle);
+}
+
+void PostgreSQLPipeline::Fail(const String& error)
+{
+	unsynced = 0;
+	while(pending.GetCount()) {
+		Query& q = pending.Head();
+		if(q.handle < 0)
+			pending.DropHead();
+		else {
+			if(q.sent) {
+				q.result.error = true;
+				q.result.error_message = error;
+			}
+			Finish(q);
+		}
+	}
+}
+
+void PostgreSQLPipeline::Do()
+{
+	if(!session)
+		return;
+	PGconn *conn = Conn();
+	int f = PQflush(conn);
+	if(f < 0 || !PQconsumeInput(conn)) {
+		Fail(session->ErrorMessage());
+		return;
+	}
+	flush = f > 0;
+	while(pending.GetCount()) {
+		Query& q = pending.Head();
+		if(!q.sent) { // failed before sending
+			Finish(q);
+			continue;
+		}
+		if(PQisBusy(conn))
+			break;
+		PGresult *r = PQgetResult(conn);
+		if(q.handle < 0) {
+			if(!r)
+				break;
+			bool sync = PQresultStatus(r) == PGRES_PIPELINE_SYNC;
+			PQclear(r);
+			if(sync)
+				pending.DropHead();
+		}
+		else
+		if(r) { // NULL follows the results of each statement
+			Store(q.result, r);
+			PQclear(r);
+		}
+		else
+			Finish(q);
+	}
+	if(pending.GetCount() && PQstatus(conn) == CONNECTION_BAD)
+		Fail(session->ErrorMessage());
+}
+
+bool PostgreSQLPipeline::InProgress(int handle) const
+{ // handles are finished in order
+	for(const Query& q : pending)
+		if(q.handle >= 0)
+			return handle >= q.handle && handle < next_handle;
+	return false;
+}
+
+int PostgreSQLPipeline::GetPending() const
+{
+	int n = 0;
+	for(const Query& q : pending)
+		if(q.handle >= 0)
+			n++;
+	return n;
+}
+
+void PostgreSQLPipeline::Remove(int handle)
+{
+	if(result.UnlinkKey(handle) && ++removed > 1000 && removed > result.GetCount() / 2) {
+		result.Sweep();
+		removed = 0;
+	}
+}
+
+dword PostgreSQLPipeline::GetWaitEvents() const
+{
+	return WAIT_READ|(flush * WAIT_WRITE);
+}
+
+SOCKET PostgreSQLPipeline::GetSOCKET() const
+{
+	return session ? (SOCKET)PQsocket(Conn()) : INVALID_SOCKET;
+}
+
+bool PostgreSQLPipeline::Wait(int handle, int timeout)
+{
+	int t0 = msecs();
+	Sync();
+	for(;;) {
+		Do();
+		if(!InProgress(handle))
+			return true;
+		if(!session || !pending.GetCount())
+			return false;
+		int w = IsNull(timeout) ? 1000 : timeout - msecs(t0);
+		if(w <= 0)
+			return false;
+		SocketWaitEvent we;
+		AddTo(we);
+		we.Wait(w);
+	}
+}
+
+const PostgreSQLResult& PostgreSQLPipeline::GetResult(int handle)
+{ // results passed to callback or removed are not available
+	Wait(handle);
+	int q = result.Find(handle);
+	if(q >= 0)
+		return result[q];
+	static PostgreSQLResult unknown;
+	ONCELOCK {
+		unknown.error = true;
+		unknown.error_message = "Result of pipeline statement is not available";
+	}
+	return unknown;
+}
+
+void PostgreSQLPipeline::Finish()
+{
+	Sync();
+	while(session && pending.GetCount()) {
+		Do();
+		if(pending.GetCount()) {
+			SocketWaitEvent we;
+			AddTo(we);
+			we.Wait(1000);
+		}
+	}
+}
+
+}
+
+#endif
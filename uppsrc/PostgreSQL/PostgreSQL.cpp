@@ -35,6 +35,8 @@ enum PGSQL_StandardOid {
 	PGSQL_DATEOID = 1082,
 	PGSQL_TIMEOID = 1083,
 	PGSQL_TIMESTAMPOID = 1114,
+	PGSQL_BPCHAROID = 1042,
+	PGSQL_VARCHAROID = 1043,
 	PGSQL_TIMESTAMPZOID = 1184,
 	PGSQL_NUMERICOID = 1700
 };
@@ -74,6 +76,7 @@ protected:
 	virtual Value       GetInsertedId() const;
 	virtual bool        Fetch();
 	virtual void        GetColumn(int i, Ref f) const;
+	virtual int         FetchBatch(SqlBatch& batch, int n);
 	virtual void        Cancel();
 	virtual SqlSession& GetSession() const;
 	virtual String      GetUser() const;
@@ -83,7 +86,7 @@ private:
 	PostgreSQLSession& session;
 
 	PGconn         *conn;
-	Vector<String>  param;
+	Vector<Value>   param;
 	PGresult       *result;
 	Vector<Oid>     oid;
 	int             rows;
@@ -91,6 +94,7 @@ private:
 	String          last_insert_table;
 
 	void            FreeResult();
+	String          Literal(const Value& r);
 	String          ErrorMessage();
 	String          ErrorCode();
 
@@ -385,6 +389,283 @@ bool PostgreSQLSession::Open(const char *connect)
 	return true;
 }
 
+// Statements are prepared on the server under generated names and executed with
+// PQexecPrepared, so the server parses and plans each one only once per session.
+
+PGresult *PostgreSQLSession::ExecCached(const String& query, int n, const char * const *value,
+                                        const int *length, const int *format)
+{
+	int q = stmt_cache.Find(query);
+	if(q >= 0) {
+		stmt_cache_hits++;
+		stmt_cache[q].lru = ++stmt_lru;
+	}
+	else {
+		stmt_cache_misses++;
+		String name = "upp_stmt_" + AsString(++stmt_serial);
+		PGresult *r = PQprepare(conn, name, query, n, NULL);
+		if(PQresultStatus(r) != PGRES_COMMAND_OK)
+			return r;
+		PQclear(r);
+		while(stmt_cache.GetCount() >= stmt_cache_size) { // evict least recently used
+			int mi = 0;
+			for(int i = 1; i < stmt_cache.GetCount(); i++)
+				if(stmt_cache[i].lru < stmt_cache[mi].lru)
+					mi = i;
+			PQclear(PQexec(conn, "deallocate " + stmt_cache[mi].name));
+			stmt_cache.Remove(mi);
+		}
+		CachedStmt& c = stmt_cache.Add(query);
+		c.name = name;
+		c.lru = ++stmt_lru;
+		q = stmt_cache.GetCount() - 1;
+	}
+	return PQexecPrepared(conn, stmt_cache[q].name, n, value, length, format, 0);
+}
+
+void PostgreSQLSession::ClearStatementCache()
+{
+	if(ConnectionOK())
+		for(const CachedStmt& c : stmt_cache)
+			PQclear(PQexec(conn, "deallocate " + c.name));
+	stmt_cache.Clear();
+}
+
+// Bulk load uses COPY ... FROM STDIN. Binary format is used when all column types and
+// values can be encoded directly, otherwise text format lets the server do the conversions.
+
+static bool sCopyBinary(Oid type, const Value& v)
+{
+	if(IsNull(v))
+		return true;
+	switch(type) {
+	case PGSQL_BOOLOID:
+	case PGSQL_INT8OID:
+	case PGSQL_FLOAT4OID:
+	case PGSQL_FLOAT8OID:
+		return IsNumber(v);
+	case PGSQL_INT2OID:
+		return IsNumber(v) && abs((int64)v) <= 32767;
+	case PGSQL_INT4OID:
+		return IsNumber(v) && abs((int64)v) <= INT_MAX;
+	case PGSQL_TEXTOID:
+	case PGSQL_VARCHAROID:
+	case PGSQL_BPCHAROID:
+		return IsString(v);
+	case PGSQL_BYTEAOID:
+		return IsString(v) || v.GetType() == SQLRAW_V;
+	case PGSQL_DATEOID:
+	case PGSQL_TIMESTAMPOID:
+		return IsDateTime(v);
+	}
+	return false;
+}
+
+static void sCopyInt(StringBuffer& out, int64 x, int len)
+{
+	char h[12];
+	Poke32be(h, len);
+	if(len == 2)
+		Poke16be(h + 4, (word)x);
+	else
+	if(len == 4)
+		Poke32be(h + 4, (dword)x);
+	else
+		Poke64be(h + 4, x);
+	out.Cat(h, 4 + len);
+}
+
+static void sCopyData(StringBuffer& out, const String& data)
+{
+	char h[4];
+	Poke32be(h, data.GetLength());
+	out.Cat(h, 4);
+	out.Cat(data);
+}
+
+static void sCopyBinaryValue(StringBuffer& out, Oid type, const Value& v)
+{
+	if(IsNull(v)) {
+		sCopyInt(out, -1, 0);
+		return;
+	}
+	switch(type) {
+	case PGSQL_BOOLOID:
+		out.Cat("\0\0\0\1", 4);
+		out.Cat((double)v ? 1 : 0);
+		break;
+	case PGSQL_INT2OID:
+		sCopyInt(out, (int64)v, 2);
+		break;
+	case PGSQL_INT4OID:
+		sCopyInt(out, (int64)v, 4);
+		break;
+	case PGSQL_INT8OID:
+		sCopyInt(out, (int64)v, 8);
+		break;
+	case PGSQL_FLOAT4OID: {
+			float f = (float)(double)v;
+			dword x;
+			memcpy(&x, &f, 4);
+			sCopyInt(out, x, 4);
+		}
+		break;
+	case PGSQL_FLOAT8OID: {
+			double d = v;
+			int64 x;
+			memcpy(&x, &d, 8);
+			sCopyInt(out, x, 8);
+		}
+		break;
+	case PGSQL_DATEOID: // days since 2000-01-01
+		sCopyInt(out, Date(v) - Date(2000, 1, 1), 4);
+		break;
+	case PGSQL_TIMESTAMPOID: // microseconds since 2000-01-01
+		sCopyInt(out, (Time(v) - Time(2000, 1, 1)) * 1000000, 8);
+		break;
+	case PGSQL_BYTEAOID:
+		sCopyData(out, SqlRaw(v));
+		break;
+	}
+}
+
+void PostgreSQLSession::CopyText(StringBuffer& out, Oid type, const Value& v) const
+{
+	if(IsNull(v)) {
+		out.Cat("\\N");
+		return;
+	}
+	String text;
+	switch(v.GetType()) {
+	case SQLRAW_V:
+		out.Cat("\\\\x");
+		out.Cat(HexString(SqlRaw(v)));
+		return;
+	case BOOL_V:
+	case INT_V:
+		out.Cat(AsString(int(v)));
+		return;
+	case INT64_V:
+		out.Cat(AsString(int64(v)));
+		return;
+	case DOUBLE_V:
+		out.Cat(FormatDouble(double(v), 20));
+		return;
+	case DATE_V: {
+			Date d = v;
+			out.Cat(Format("%04d-%02d-%02d", d.year, d.month, d.day));
+		}
+		return;
+	case TIME_V: {
+			Time t = v;
+			out.Cat(Format("%04d-%02d-%02d %02d:%02d:%02d",
+			               t.year, t.month, t.day, t.hour, t.minute, t.second));
+		}
+		return;
+	}
+	text = type == PGSQL_BYTEAOID ? "\\x" + HexString(String(v)) : ToCharset(AsString(v));
+	for(const char *s = text; *s; s++)
+		switch(*s) {
+		case '\\': out.Cat("\\\\"); break;
+		case '\t': out.Cat("\\t"); break;
+		case '\n': out.Cat("\\n"); break;
+		case '\r': out.Cat("\\r"); break;
+		default:   out.Cat(*s);
+		}
+}
+
+bool PostgreSQLSession::BulkInsert(const String& table, const Vector<String>& column,
+                                   const Vector< Vector<Value> >& row)
+{
+	if(column.GetCount() == 0 || row.GetCount() == 0)
+		return true;
+	String cols = Join(column, ", ");
+	String q = "select " + cols + " from " + table + " where false";
+	PGresult *r = PQexec(conn, q);
+	if(PQresultStatus(r) != PGRES_TUPLES_OK) {
+		result = r;
+		SetError(ErrorMessage(), q, 0, ErrorCode());
+		PQclear(r);
+		return false;
+	}
+	Vector<Oid> type;
+	for(int i = 0; i < column.GetCount(); i++)
+		type.Add(PQftype(r, i));
+	PQclear(r);
+
+	bool binary = true;
+	for(const Vector<Value>& rw : row)
+		for(int i = 0; i < type.GetCount() && binary; i++)
+			binary = sCopyBinary(type[i], rw.Get(i, Value()));
+
+	String copy = "copy " + table + " (" + cols + ") from stdin";
+	if(binary)
+		copy << " (format binary)";
+	if(trace)
+		*trace << copy << " (" << row.GetCount() << " rows)" << UPP::EOL;
+	r = PQexec(conn, copy);
+	if(PQresultStatus(r) != PGRES_COPY_IN) {
+		result = r;
+		SetError(ErrorMessage(), copy, 0, ErrorCode());
+		PQclear(r);
+		return false;
+	}
+	PQclear(r);
+
+	StringBuffer out;
+	bool ok = true;
+	auto Put = [&] {
+		if(ok && out.GetCount() && PQputCopyData(conn, ~out, out.GetCount()) != 1)
+			ok = false;
+		out.Clear();
+	};
+	if(binary) {
+		out.Cat("PGCOPY\n\377\r\n\0", 11);
+		out.Cat(String('\0', 8)); // flags, header extension length
+	}
+	for(const Vector<Value>& rw : row) {
+		if(binary) {
+			char h[2];
+			Poke16be(h, (word)type.GetCount());
+			out.Cat(h, 2);
+		}
+		for(int i = 0; i < type.GetCount(); i++) {
+			Value v = rw.Get(i, Value()); // Get returns the default by reference
+			if(binary) {
+				if(IsString(v) && type[i] != PGSQL_BYTEAOID)
+					sCopyData(out, ToCharset(String(v)));
+				else
+					sCopyBinaryValue(out, type[i], v);
+			}
+			else {
+				if(i)
+					out.Cat('\t');
+				CopyText(out, type[i], v);
+			}
+		}
+		if(!binary)
+			out.Cat('\n');
+		if(out.GetCount() >= 1024 * 1024)
+			Put();
+	}
+	if(binary)
+		out.Cat("\377\377", 2);
+	Put();
+	if(PQputCopyEnd(conn, ok ? NULL : "transfer failed") != 1)
+		ok = false;
+	while((r = PQgetResult(conn))) {
+		if(PQresultStatus(r) != PGRES_COMMAND_OK && ok) {
+			result = r;
+			SetError(ErrorMessage(), copy, 0, ErrorCode());
+			ok = false;
+		}
+		PQclear(r);
+	}
+	if(!ok && !WasError())
+		SetError(ErrorMessage(), copy);
+	return ok;
+}
+
 bool PostgreSQLSession::ConnectionOK()
 {
 	return conn && PQstatus(conn) == CONNECTION_OK;
@@ -392,6 +673,7 @@ bool PostgreSQLSession::ConnectionOK()
 
 bool PostgreSQLSession::ReOpen()
 {
+	stmt_cache.Clear(); // server side statements are lost with the connection
 	PQreset(conn);
 	if(PQstatus(conn) != CONNECTION_OK)
 	{
@@ -408,6 +690,7 @@ void PostgreSQLSession::Close()
 	if(!conn)
 		return;
 	SessionClose();
+	stmt_cache.Clear();
 	PQfinish(conn);
 	conn = NULL;
 	level = 0;
@@ -437,6 +720,11 @@ int PostgreSQLSession::GetTransactionLevel() const
 }
 
 void PostgreSQLConnection::SetParam(int i, const Value& r)
+{
+	param.At(i) = r;
+}
+
+String PostgreSQLConnection::Literal(const Value& r)
 {
 	String p;
 	if(IsNull(r))
@@ -490,7 +778,75 @@ void PostgreSQLConnection::SetParam(int i, const Value& r)
 		default:
 			NEVER();
 		}
-	param.At(i, p);
+	return p;
+}
+
+static bool sIsCacheable(const char *s)
+{ // only plain DML is worth preparing, utility statements would just fill the cache
+	while(*s && (byte)*s <= ' ')
+		s++;
+	for(const char *k : { "select", "insert", "update", "delete", "with" }) {
+		int l = (int)strlen(k);
+		if(MemICmp(s, k, l) == 0 && !iscid(s[l]))
+			return true;
+	}
+	return false;
+}
+
+void PostgreSQLSession::GetColumnInfo(PGresult *result, Vector<SqlColumnInfo>& info, Vector<Oid>& oid) const
+{
+	int fields = PQnfields(result);
+	info.SetCount(fields);
+	oid.SetCount(fields);
+	for(int i = 0; i < fields; i++)
+	{
+		SqlColumnInfo& f = info[i];
+		f.name = ToUpper(PQfname(result, i));
+		f.width = PQfsize(result, i);
+		int type_mod = PQfmod(result, i) - sizeof(int32);
+		if(f.width < 0)
+			f.width = type_mod;
+		f.precision = (type_mod >> 16) & 0xffff;
+		f.scale = type_mod & 0xffff;
+		f.nullable = true;
+		Oid type_oid = PQftype(result, i);
+		f.type = OidToType(type_oid);
+		oid[i] = type_oid;
+	}
+}
+
+String PostgreSQLSession::ParamValue(const Value& v, int& format) const
+{ // parameters are passed as text, except bytea which is binary
+	format = 0;
+	if(IsNull(v))
+		return Null;
+	switch(v.GetType()) {
+	case SQLRAW_V:
+		format = 1;
+		return SqlRaw(v);
+	case WSTRING_V:
+	case STRING_V:
+		return ToCharset(String(v));
+	case BOOL_V:
+	case INT_V:
+		return AsString(int(v));
+	case INT64_V:
+		return AsString(int64(v));
+	case DOUBLE_V:
+		return FormatDouble(double(v), 20);
+	case DATE_V: {
+			Date d = v;
+			return Format("%04d-%02d-%02d", d.year, d.month, d.day);
+		}
+	case TIME_V: {
+			Time t = v;
+			return Format("%04d-%02d-%02d %02d:%02d:%02d",
+			              t.year, t.month, t.day, t.hour, t.minute, t.second);
+		}
+	default:
+		NEVER();
+	}
+	return Null;
 }
 
 bool PostgreSQLConnection::Execute()
@@ -505,6 +861,8 @@ bool PostgreSQLConnection::Execute()
 	if((p.Id("insert") || p.Id("INSERT")) && (p.Id("into") || p.Id("INTO")) && p.IsId())
 		last_insert_table = p.ReadId();
 
+	bool prepared = session.stmt_cache_size > 0 && !session.noquestionparams && sIsCacheable(statement);
+
 	String query;
 	int pi = 0;
 	const char *s = statement;
@@ -522,13 +880,28 @@ bool PostgreSQLConnection::Execute()
 						session.SetError("Invalid number of parameters", statement);
 						return false;
 					}
-					query.Cat(param[pi++]);
+					if(prepared)
+						query << '$' << ++pi;
+					else
+						query.Cat(Literal(param[pi++]));
 				}
 			}
 			else
 				query.Cat(*s);
 			s++;
 		}
+
+	Vector<String> pvalue;
+	Vector<const char *> pptr;
+	Vector<int> plen, pformat;
+	if(prepared) {
+		for(int i = 0; i < pi; i++)
+			pvalue.Add(session.ParamValue(param[i], pformat.Add()));
+		for(int i = 0; i < pi; i++) { // after pvalue is complete, short strings move with Vector
+			pptr.Add(IsNull(param[i]) ? NULL : ~pvalue[i]);
+			plen.Add(pvalue[i].GetLength());
+		}
+	}
 	param.Clear();
 
 	Stream *trace = session.GetTrace();
@@ -539,7 +912,10 @@ bool PostgreSQLConnection::Execute()
 	int itry = 0;
 	int stat;
 	do {
-		result = PQexecParams(conn, query, 0, NULL, NULL, NULL, NULL, 0);
+		if(prepared)
+			result = session.ExecCached(query, pi, pptr.begin(), plen.begin(), pformat.begin());
+		else
+			result = PQexecParams(conn, query, 0, NULL, NULL, NULL, NULL, 0);
 		stat = PQresultStatus(result);
 	}
 	while(stat != PGRES_TUPLES_OK && stat != PGRES_COMMAND_OK && session.level == 0 &&
@@ -552,24 +928,7 @@ bool PostgreSQLConnection::Execute()
 	if(stat == PGRES_TUPLES_OK) //result set
 	{
 		rows = PQntuples(result);
-		int fields = PQnfields(result);
-		info.SetCount(fields);
-		oid.SetCount(fields);
-		for(int i = 0; i < fields; i++)
-		{
-			SqlColumnInfo& f = info[i];
-			f.name = ToUpper(PQfname(result, i));
-			f.width = PQfsize(result, i);
-			int type_mod = PQfmod(result, i) - sizeof(int32);
-			if(f.width < 0)
-				f.width = type_mod;
-			f.precision = (type_mod >> 16) & 0xffff;
-			f.scale = type_mod & 0xffff;
-			f.nullable = true;
-			Oid type_oid = PQftype(result, i);
-			f.type = OidToType(type_oid);
-			oid[i] = type_oid;
-		}
+		session.GetColumnInfo(result, info, oid);
 		return true;
 	}
 	if(stat == PGRES_COMMAND_OK) //command executed OK
@@ -630,56 +989,84 @@ static Date sDate(const char *s)
 	return Date(atoi(s), atoi(s + 5), atoi(s + 8));
 }
 
-void PostgreSQLConnection::GetColumn(int i, Ref f) const
+Value PostgreSQLSession::GetValue(PGresult *result, int row, int i, Oid oid) const
 {
-	if(PQgetisnull(result, fetched_row, i))
-	{
-		f = Null;
-		return;
-	}
-	char *s = PQgetvalue(result, fetched_row, i);
-	switch(info[i].type)
+	if(PQgetisnull(result, row, i))
+		return Null;
+	char *s = PQgetvalue(result, row, i);
+	switch(OidToType(oid))
 	{
 		case INT64_V:
-			f.SetValue(ScanInt64(s));
-			break;
+			return ScanInt64(s);
 		case INT_V:
-			f.SetValue(ScanInt(s));
-			break;
+			return ScanInt(s);
 		case DOUBLE_V: {
 				double d = ScanDouble(s);
-				f.SetValue(IsNull(d) ? NAN : d);
+				return IsNull(d) ? NAN : d;
 			}
-			break;
 		case BOOL_V:
-			f.SetValue(*s == 't' ? "1" : "0");
-			break;
+			return *s == 't' ? "1" : "0";
 		case DATE_V:
-			f.SetValue(sDate(s));
-			break;
+			return sDate(s);
 		case TIME_V: {
 				Time t = ToTime(sDate(s));
 				t.hour = atoi(s + 11);
 				t.minute = atoi(s + 14);
 				t.second = atoi(s + 17);
-				f.SetValue(t);
+				return t;
 			}
-			break;
-		default: {
-			if(oid[i] == PGSQL_BYTEAOID) {
-				if(session.hex_blobs)
-					f.SetValue(ScanHexString(s, (int)strlen(s)));
-				else {
-					size_t len;
-					unsigned char *q = PQunescapeBytea((const unsigned char *)s, &len);
-					f.SetValue(String(q, (int)len));
-					PQfreemem(q);
-				}
+	}
+	if(oid == PGSQL_BYTEAOID) {
+		if(hex_blobs)
+			return ScanHexString(s, (int)strlen(s));
+		size_t len;
+		unsigned char *q = PQunescapeBytea((const unsigned char *)s, &len);
+		String r(q, (int)len);
+		PQfreemem(q);
+		return r;
+	}
+	return FromCharset(String(s));
+}
+
+void PostgreSQLConnection::GetColumn(int i, Ref f) const
+{
+	f.SetValue(session.GetValue(result, fetched_row, i, oid[i]));
+}
+
+int PostgreSQLConnection::FetchBatch(SqlBatch& batch, int n)
+{ // parses numbers and text straight from PGresult, Value only for dates and bytea
+	int count = 0;
+	while(count < n && Fetch()) {
+		for(int i = 0; i < info.GetCount(); i++) {
+			SqlBatchColumn& c = batch.Column(i);
+			if(PQgetisnull(result, fetched_row, i)) {
+				c.AddNull();
+				continue;
+			}
+			const char *s = PQgetvalue(result, fetched_row, i);
+			if(c.type == INT64_V) {
+				if(info[i].type == BOOL_V)
+					c.i64.Add(*s == 't');
+				else
+					c.i64.Add(ScanInt64(s));
 			}
 			else
-				f.SetValue(FromCharset(String(s)));
+			if(c.type == DOUBLE_V) {
+				double d = ScanDouble(s);
+				c.dbl.Add(IsNull(d) ? NAN : d);
+			}
+			else
+			if(c.type == STRING_V && oid[i] != PGSQL_BYTEAOID)
+				c.str.Add(FromCharset(String(s, PQgetlength(result, fetched_row, i))));
+			else {
+				Value v;
+				GetColumn(i, v);
+				c.AddValue(v);
+			}
 		}
+		count++;
 	}
+	return count;
 }
 
 void PostgreSQLConnection::Cancel()
@@ -59,6 +59,14 @@ private:
 	
 	VectorMap<String, String> pkache;
 
+	struct CachedStmt : Moveable<CachedStmt> {
+		String name;
+		int64  lru;
+	};
+	VectorMap<String, CachedStmt> stmt_cache; // server side prepared statements by query text
+	int64                         stmt_lru = 0;
+	int                           stmt_serial = 0;
+
 	void                  ExecTrans(const char * statement);
 	Vector<String>        EnumData(char type, const char *schema = NULL);
 	String                ErrorMessage();
@@ -70,8 +78,15 @@ private:
 	String                ToCharset(const String& s) const;
 	
 	void                  DoKeepAlive();
+	PGresult             *ExecCached(const String& query, int n, const char * const *value,
+	                                  const int *length, const int *format);
+	void                  CopyText(StringBuffer& out, Oid type, const Value& v) const;
+	String                ParamValue(const Value& v, int& format) const;
+	Value                 GetValue(PGresult *result, int row, int i, Oid oid) const;
+	void                  GetColumnInfo(PGresult *result, Vector<SqlColumnInfo>& info, Vector<Oid>& oid) const;
 
 	friend class PostgreSQLConnection;
+	friend class PostgreSQLPipeline;
 
 public:
 	Gate1<int>            WhenReconnect;
@@ -92,12 +107,85 @@ public:
 	virtual void          Commit();
 	virtual void          Rollback();
 	virtual int           GetTransactionLevel() const;
+	virtual void          ClearStatementCache();
+	virtual bool          HasBulkInsert() const            { return true; }
+	virtual bool          BulkInsert(const String& table, const Vector<String>& column,
+	                                 const Vector< Vector<Value> >& row);
 
 	PostgreSQLSession()                                   { conn = NULL; Dialect(PGSQL); level = 0; keepalive = hex_blobs = false; }
 	~PostgreSQLSession()                                  { Close(); }
 	PGconn * GetPGConn()                                  { return conn; }
 };
 
+struct PostgreSQLResult {
+	Vector<SqlColumnInfo>   info;
+	Vector< Vector<Value> > row;
+	int                     rows_processed = 0;
+	bool                    error = false;
+	String                  error_message;
+	String                  error_code;
+
+	bool                    IsError() const                    { return error; }
+	int                     GetCount() const                   { return row.GetCount(); }
+	int                     GetColumns() const                 { return info.GetCount(); }
+	const Vector<Value>&    operator[](int i) const            { return row[i]; }
+	Value                   Get(int i, int j) const            { return row[i][j]; }
+};
+
+class PostgreSQLPipeline { // asynchronous execution using libpq pipeline mode
+	struct Query {
+		int                            handle;      // -1 is sync point
+		bool                           sent;        // false: failed before sending, result is ready
+		Event<const PostgreSQLResult&> done;
+		PostgreSQLResult               result;
+	};
+
+	PostgreSQLSession               *session = NULL;
+	BiArray<Query>                   pending;     // in the order sent, results arrive in the same order
+	ArrayMap<int, PostgreSQLResult>  result;      // finished queries without callback
+	int                              removed = 0; // unlinked in result
+	int                              next_handle = 0;
+	int                              unsynced = 0;    // queries sent after the last sync point
+	bool                             flush = false;   // output not completely written to the socket
+
+	PGconn *Conn() const                                       { return session->conn; }
+	Query&  Add(Event<const PostgreSQLResult&> done);
+	void    Store(PostgreSQLResult& r, PGresult *result);
+	void    Finish(Query& q);
+	void    Fail(const String& error);
+
+	PostgreSQLPipeline(const PostgreSQLPipeline&);
+
+public:
+	Event<int>     WhenDone;
+
+	bool           Open(PostgreSQLSession& session);
+	void           Close();
+	bool           IsOpen() const                              { return session; }
+
+	int            Send(const String& statement, const Vector<Value>& param = Vector<Value>(),
+	                    Event<const PostgreSQLResult&> done = Null);
+	int            Send(const SqlStatement& s, Event<const PostgreSQLResult&> done = Null);
+	void           Sync();
+
+	bool           InProgress(int handle) const;
+	bool           InProgress() const                          { return pending.GetCount(); }
+	int            GetPending() const;
+	bool           Wait(int handle, int timeout = Null);
+	const PostgreSQLResult& GetResult(int handle);
+	void           Remove(int handle);
+	void           Finish();
+
+	void           Do();
+	dword          GetWaitEvents() const;
+	SOCKET         GetSOCKET() const;
+	void           AddTo(SocketWaitEvent& e)                   { e.Add(GetSOCKET(), GetWaitEvents()); }
+
+	PostgreSQLPipeline()                                       {}
+	PostgreSQLPipeline(PostgreSQLSession& session)             { Open(session); }
+	~PostgreSQLPipeline()                                      { Close(); }
+};
+
 class PgSequence : public ValueGen {
 	SqlId       ssq;
 	SqlId&      seq;
@@ -2,6 +2,48 @@
 
 namespace Upp {
 
+bool SqlSession::HasBulkInsert() const
+{
+	return findarg(dialect, SQLITE3, PGSQL, MY_SQL) >= 0;
+}
+
+bool SqlSession::BulkInsert(const String& table, const Vector<String>& column,
+                            const Vector< Vector<Value> >& row)
+{ // multirow insert with parameters, all full chunks have the same statement text,
+  // so with statement cache it is prepared just once
+	int ncol = column.GetCount();
+	if(ncol == 0)
+		return true;
+	int chunk = clamp((dialect == SQLITE3 ? 999 : 32767) / ncol, 1, 500);
+	Sql sql(*this);
+	String stmt;
+	int stmt_rows = 0;
+	for(int i = 0; i < row.GetCount(); i += chunk) {
+		int n = min(chunk, row.GetCount() - i);
+		if(n != stmt_rows) {
+			stmt.Clear();
+			stmt << "insert into " << table << '(' << Join(column, ", ") << ") values ";
+			for(int j = 0; j < n; j++) {
+				if(j)
+					stmt << ", ";
+				stmt << '(';
+				for(int k = 0; k < ncol; k++)
+					stmt << (k ? ", ?" : "?");
+				stmt << ')';
+			}
+			stmt_rows = n;
+		}
+		sql.SetStatement(stmt);
+		int pi = 0;
+		for(int j = i; j < i + n; j++)
+			for(int k = 0; k < ncol; k++)
+				sql.SetParam(pi++, row[j].Get(k, Value()));
+		if(!sql.Execute())
+			return false;
+	}
+	return true;
+}
+
 SqlMassInsert::~SqlMassInsert()
 {
 	Flush();
@@ -10,7 +52,7 @@ SqlMassInsert::~SqlMassInsert()
 SqlMassInsert& SqlMassInsert::operator()(SqlId col, const Value& val)
 {
 	if(pos == 0) {
-		cache.Add().nulls = 0;
+		cache.Add();
 		cache.Top();
 	}
 	if(cache.GetCount() == 1)
@@ -19,10 +61,7 @@ SqlMassInsert& SqlMassInsert::operator()(SqlId col, const Value& val)
 		ASSERT(column[pos] == col.Quoted() || column[pos] == ~col);
 	Row& r = cache.Top();
 	r.value.Add(val);
-	if(IsNull(val))
-		r.nulls |= ((uint64)1 << pos);
 	pos++;
-	ASSERT(pos < 62);
 	return *this;
 }
 
@@ -38,33 +77,21 @@ SqlMassInsert& SqlMassInsert::EndRow(SqlBool remove)
 	cache.Top().remove = remove;
 	if(pos == 0)
 		return *this;
-	if(cache.GetCount() && cache[0].value.GetCount() * cache.GetCount() > 5000 || cache.GetCount() > 990) // MSSQL maximum is 1000
+	if((bulk && sql.GetSession().HasBulkInsert())
+	   ? cache.GetCount() * column.GetCount() > 200000 // bulk load
+	   : ((cache.GetCount() && cache[0].value.GetCount() * cache.GetCount() > 5000)
+	      || cache.GetCount() > 990 // MSSQL maximum is 1000
+	      || (cache.GetCount() >= 500 && sql.GetDialect() == SQLITE3))) // SQLite compound select limit
 		Flush();
 	ASSERT(column.GetCount() == pos);
 	pos = 0;
 	return *this;
 }
 
-void SqlMassInsert::Flush()
-{
-	const uint64 DONE = (uint64)-1;
-	if(cache.GetCount() == 0)
-		return;
-	if(use_transaction)
-		sql.GetSession().Begin();
-	SqlBool remove;
-	bool doremove = false;
-	for(int ii = 0; ii < cache.GetCount(); ii++) {
-		SqlBool rm = cache[ii].remove;
-		if(!rm.IsEmpty()) {
-			doremove = true;
-			remove = remove || rm;
-		}
-	}
-	if(doremove)
-		sql * Delete(table).Where(remove);
+Vector<String> SqlMassInsert::InsertStatements(int dialect)
+{ // values as literals, statement text is different for each flush
+	Vector<String> r;
 	String insert;
-	int dialect = sql.GetDialect();
 	if(findarg(dialect, MY_SQL, PGSQL, MSSQL) >= 0) {
 		insert << "insert into " + ~table + '(';
 		for(int i = 0; i < column.GetCount(); i++) {
@@ -87,15 +114,22 @@ void SqlMassInsert::Flush()
 				insert << ")";
 			}
 		}
+		r.Add(insert);
+		return r;
+	}
+	Vector<String> nulls; // rows with the same null columns are inserted by single statement
+	for(const Row& r : cache) {
+		String& n = nulls.Add();
+		for(const Value& v : r.value)
+			n.Cat(IsNull(v) ? '1' : '0');
 	}
-	else
 	for(int ii = 0; ii < cache.GetCount(); ii++) {
-		uint64 nulls = cache[ii].nulls;
-		if(nulls != DONE) {
-			insert << "insert into " + ~table + '(';
+		String pattern = nulls[ii];
+		if(pattern.GetCount()) {
+			insert = "insert into " + ~table + '(';
 			bool nextcol = false;
 			for(int i = 0; i < column.GetCount(); i++) {
-				if(!(nulls & ((uint64)1 << i))) {
+				if(pattern[i] == '0') {
 					if(nextcol)
 						insert << ", ";
 					nextcol = true;
@@ -106,15 +140,15 @@ void SqlMassInsert::Flush()
 			bool nextsel = false;
 			for(int i = ii; i < cache.GetCount(); i++) {
 				Row& r = cache[i];
-				if(r.nulls == nulls && r.value.GetCount()) {
-					r.nulls = DONE;
+				if(nulls[i] == pattern) {
+					nulls[i].Clear();
 					if(nextsel)
 						insert << " union all";
 					nextsel = true;
 					insert << " select ";
 					bool nextval = false;
 					for(int i = 0; i < r.value.GetCount(); i++)
-						if(!(nulls & ((uint64)1 << i))) {
+						if(pattern[i] == '0') {
 							if(nextval)
 								insert << ", ";
 							nextval = true;
@@ -124,21 +158,56 @@ void SqlMassInsert::Flush()
 						insert << " from dual";
 				}
 			}
+			r.Add(insert);
+		}
+	}
+	return r;
+}
+
+void SqlMassInsert::Flush()
+{
+	if(cache.GetCount() == 0)
+		return;
+	SqlSession& session = sql.GetSession();
+	if(use_transaction)
+		session.Begin();
+	SqlBool remove;
+	bool doremove = false;
+	for(int ii = 0; ii < cache.GetCount(); ii++) {
+		SqlBool rm = cache[ii].remove;
+		if(!rm.IsEmpty()) {
+			doremove = true;
+			remove = remove || rm;
 		}
 	}
-	sql.Execute(insert);
-	if(sql.WasError()) {
+	bool ok = !doremove || sql.Execute(Delete(table).Where(remove));
+	if(ok) {
+		if(bulk && session.HasBulkInsert()) {
+			Vector< Vector<Value> > row;
+			for(Row& r : cache)
+				if(r.value.GetCount())
+					row.Add(pick(r.value));
+			ok = session.BulkInsert(~table, column, row);
+		}
+		else
+			for(const String& s : InsertStatements(sql.GetDialect()))
+				if(!sql.Execute(s)) {
+					ok = false;
+					break;
+				}
+	}
+	if(!ok) {
 		error = true;
 		if(use_transaction)
-			sql.GetSession().Rollback();
+			session.Rollback();
 	}
 	else
 		if(use_transaction)
-			sql.GetSession().Commit();
+			session.Commit();
+	session.InvalidateResultCache(~table);
 	cache.Clear();
 	column.Clear();
 	pos = 0;
 }
 
 }
-
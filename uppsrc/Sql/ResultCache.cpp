@@ -0,0 +1,205 @@
+#include "Sql.h"
+
+namespace Upp {
+
+#define LLOG(x) // DLOG(x)
+
+// Results of statements marked Cached are stored in SqlSession, keyed by compiled statement
+// text and parameters. Entries remember identifiers referenced by the statement (collected
+// from SqlExp text); SqlInsert, SqlUpdate and SqlDelete executed through the session drop all
+// entries referencing the modified table. Text of any other statement executed is checked too:
+// the target of insert, update or delete is found by simple parsing, statements that are not
+// queries and not recognized drop the whole cache.
+
+SqlSession& SqlSession::ResultCache(int maxsize, int maxrows)
+{
+	result_cache_limit = max(maxsize, 0);
+	result_cache_maxrows = max(maxrows, 0);
+	ShrinkResultCache(result_cache_limit);
+	return *this;
+}
+
+void SqlSession::ShrinkResultCache(int maxsize)
+{
+	while(result_cache_size > maxsize && result_cache.GetCount()) {
+		int mi = 0; // evict least recently used
+		for(int i = 1; i < result_cache.GetCount(); i++)
+			if(result_cache[i].lru < result_cache[mi].lru)
+				mi = i;
+		result_cache_size -= result_cache[mi].size;
+		result_cache.Remove(mi);
+	}
+}
+
+void SqlSession::AddCachedResult(const Value& key, const Value& result, Index<String>&& ids, int size)
+{
+	if(size > result_cache_limit)
+		return;
+	ShrinkResultCache(result_cache_limit - size);
+	ResultCacheEntry& e = result_cache.GetAdd(key);
+	result_cache_size += size - e.size;
+	e.result = result;
+	e.ids = pick(ids);
+	e.size = size;
+	e.lru = ++result_cache_lru;
+}
+
+void SqlSession::InvalidateResultCache(const String& table)
+{
+	if(result_cache.IsEmpty())
+		return;
+	String t = ToUpper(table);
+	Vector<int> remove;
+	for(int i = 0; i < result_cache.GetCount(); i++)
+		if(result_cache[i].ids.Find(t) >= 0) {
+			result_cache_size -= result_cache[i].size;
+			remove.Add(i);
+		}
+	LLOG("InvalidateResultCache " << table << ", " << remove.GetCount() << " entries");
+	result_cache_invalidations += remove.GetCount();
+	result_cache.Remove(remove);
+}
+
+static String sSqlName(const char *&s)
+{ // keyword or (possibly quoted and qualified) identifier, last part upper-cased
+	String r;
+	for(;;) {
+		while(*s && (byte)*s <= ' ')
+			s++;
+		if(*s == '"' || *s == '`' || *s == '[') {
+			char e = *s == '[' ? ']' : *s;
+			const char *b = ++s;
+			while(*s && *s != e)
+				s++;
+			r = String(b, s);
+			if(*s)
+				s++;
+		}
+		else {
+			const char *b = s;
+			while(IsAlNum(*s) || *s == '_' || *s == '$' || *s == '#' || (byte)*s >= 128)
+				s++;
+			r = String(b, s);
+		}
+		if(*s != '.')
+			return ToUpper(r);
+		s++;
+	}
+}
+
+void SqlSession::InvalidateResultCacheFor(const String& statement)
+{
+	const char *s = statement;
+	String w = sSqlName(s);
+	if(findarg(w, "SELECT", "VALUES", "EXPLAIN", "SHOW", "DESCRIBE", "PRAGMA", "SET") >= 0 ||
+	   findarg(w, "BEGIN", "START", "COMMIT", "END", "ROLLBACK", "SAVEPOINT", "RELEASE") >= 0)
+		return; // does not modify data, or data modified in transaction were already invalidated
+	String table;
+	if(findarg(w, "INSERT", "REPLACE", "MERGE", "DELETE") >= 0) {
+		for(int i = 0; i < 4 && IsNull(table); i++) // skip OR REPLACE, IGNORE, LOW_PRIORITY etc.
+			if(findarg(sSqlName(s), "INTO", "FROM") >= 0)
+				table = sSqlName(s);
+	}
+	else
+	if(w == "UPDATE") {
+		table = sSqlName(s);
+		if(table == "OR") { // UPDATE OR REPLACE
+			sSqlName(s);
+			table = sSqlName(s);
+		}
+		while(findarg(table, "ONLY", "LOW_PRIORITY", "IGNORE") >= 0)
+			table = sSqlName(s);
+	}
+	if(table.GetCount())
+		InvalidateResultCache(table);
+	else {
+		LLOG("InvalidateResultCacheFor " << statement << ", clearing");
+		result_cache_invalidations += result_cache.GetCount();
+		ClearResultCache();
+	}
+}
+
+void SqlSession::ClearResultCache()
+{
+	result_cache.Clear();
+	result_cache_size = 0;
+}
+
+bool Sql::ExecuteCached(const SqlStatement& st)
+{
+	SqlSession& session = GetSession();
+	String s = Compile(st);
+	Value key = s;
+	if(param.GetCount()) {
+		ValueArray va;
+		va.Add(s);
+		for(const Value& v : param)
+			va.Add(v);
+		key = va;
+	}
+	int q = session.result_cache.Find(key);
+	if(q >= 0) {
+		SqlSession::ResultCacheEntry& e = session.result_cache[q];
+		e.lru = ++session.result_cache_lru;
+		session.result_cache_hits++;
+		SetStatement(s);
+		cn->info <<= e.result.To<CachedResult>().info;
+		if(Stream *t = session.GetTrace())
+			*t << "(cached) " << (session.IsTraceCompression() ? CompressLog(s) : s) << '\n';
+		cached = e.result;
+		cached_row = -1;
+		return true;
+	}
+	session.result_cache_misses++;
+	if(!Execute(s))
+		return false;
+	if(session.IsTransactionOpen()) // transaction could be rolled back, do not store
+		return true;
+	CachedResult r;
+	r.info <<= cn->info;
+	int ncol = r.info.GetCount();
+	int size = sizeof(CachedResult);
+	for(const SqlColumnInfo& c : r.info)
+		size += sizeof(SqlColumnInfo) + c.name.GetLength();
+	while(Fetch()) {
+		if(r.rows >= session.result_cache_maxrows || size > session.result_cache_limit) {
+			r.more = true; // not stored, rows buffered so far are followed by the rest of cursor
+			break;
+		}
+		r.rows++;
+		for(int i = 0; i < ncol; i++) {
+			Value& v = r.data.Add();
+			cn->GetColumn(i, v);
+			size += sizeof(Value);
+			if(v.Is<String>())
+				size += v.To<String>().GetLength();
+		}
+	}
+	bool store = !r.more;
+	cached = RawPickToValue(pick(r));
+	cached_row = -1;
+	if(store)
+		session.AddCachedResult(key, cached, st.GetIds(), size);
+	return true;
+}
+
+bool Sql::Execute(const SqlStatement& s)
+{
+	SqlSession& session = GetSession();
+	if(s.IsCached() && session.result_cache_limit)
+		return ExecuteCached(s);
+	bool b = Execute(Compile(s));
+	String table = s.GetTable();
+	if(table.GetCount() && session.result_cache.GetCount())
+		for(const String& id : SqlGetIds(table))
+			session.InvalidateResultCache(id);
+	return b;
+}
+
+void Sql::ExecuteX(const SqlStatement& s)
+{
+	if(!Execute(s))
+		throw SqlExc(GetSession());
+}
+
+}
@@ -32,12 +32,14 @@ String         SqlSession::Savepoint()                                   { NEVER
 void           SqlSession::RollbackTo(const String&)                     { NEVER(); }
 bool           SqlSession::IsOpen() const                                { return false; }
 int            SqlSession::GetTransactionLevel() const                   { return 0; }
+bool           SqlSession::IsTransactionOpen() const                     { return GetTransactionLevel() > 0; }
 RunScript      SqlSession::GetRunScript() const                          { return NULL; }
 SqlConnection *SqlSession::CreateConnection()                            { return NULL; }
 Vector<String> SqlSession::EnumUsers()                                   { return Vector<String>(); }
 Vector<String> SqlSession::EnumDatabases()                               { return Vector<String>(); }
 Vector<String> SqlSession::EnumTables(String database)                   { return Vector<String>(); }
 Vector<String> SqlSession::EnumViews(String database)                    { return Vector<String>(); }
+void           SqlSession::ClearStatementCache()                         {}
 Vector<String> SqlSession::EnumSequences(String database)                { return Vector<String>(); }
 Vector<String> SqlSession::EnumPrimaryKey(String database, String table) { return Vector<String>(); }
 Vector<String> SqlSession::EnumReservedWords()                           { return Vector<String>(); }
@@ -124,6 +126,7 @@ void SqlSession::SessionClose()
 		sqlr->Cancel();
 		sqlr.Clear();
 	}
+	ClearResultCache();
 }
 
 Sql& SqlSession::GetSessionSql()
@@ -81,6 +81,134 @@ Value SqlConnection::GetInsertedId() const
 	return Null;
 }
 
+int SqlBatchColumn::GetCount() const
+{
+	switch(type) {
+	case INT64_V:  return i64.GetCount();
+	case DOUBLE_V: return dbl.GetCount();
+	case STRING_V: return str.GetCount();
+	}
+	return val.GetCount();
+}
+
+Value SqlBatchColumn::Get(int i) const
+{
+	if(null[i]) {
+		int q = error.Find(i);
+		return q >= 0 ? ErrorValue(error[q]) : Value();
+	}
+	switch(type) {
+	case INT64_V:  return i64[i];
+	case DOUBLE_V: return dbl[i];
+	case STRING_V: return str[i];
+	}
+	return val[i];
+}
+
+void SqlBatchColumn::AddNull()
+{
+	null.Set(GetCount(), true);
+	switch(type) {
+	case INT64_V:  i64.Add(0); break;
+	case DOUBLE_V: dbl.Add(0); break;
+	case STRING_V: str.Add(); break;
+	default:       val.Add(); break;
+	}
+}
+
+void SqlBatchColumn::AddValue(const Value& v)
+{
+	if(UPP::IsNull(v)) {
+		AddNull();
+		return;
+	}
+	auto Invalid = [&] {
+		error.Add(GetCount(), "Invalid numeric value '" + AsString(v) + "'");
+		AddNull();
+	};
+	switch(type) { // value can differ from column type (e.g. SQLite dynamic typing)
+	case INT64_V: {
+		int64 x = IsNumber(v) ? (int64)v : ScanInt64(AsString(v));
+		if(UPP::IsNull(x))
+			Invalid();
+		else
+			i64.Add(x);
+		break;
+	}
+	case DOUBLE_V: {
+		double x = IsNumber(v) ? (double)v : ScanDouble(AsString(v));
+		if(UPP::IsNull(x))
+			Invalid();
+		else
+			dbl.Add(x);
+		break;
+	}
+	case STRING_V: str.Add(IsString(v) ? String(v) : AsString(v)); break;
+	default:       val.Add(v); break;
+	}
+}
+
+void SqlBatchColumn::Clear()
+{
+	i64.Clear();
+	dbl.Clear();
+	str.Clear();
+	val.Clear();
+	null.Clear();
+	error.Clear();
+}
+
+void SqlBatch::Init(const Vector<SqlColumnInfo>& info)
+{
+	rows = 0;
+	if(column.GetCount() != info.GetCount())
+		column.SetCount(info.GetCount());
+	for(int i = 0; i < info.GetCount(); i++) {
+		SqlBatchColumn& c = column[i];
+		c.Clear();
+		c.name = info[i].name;
+		switch(info[i].type) {
+		case BOOL_V:
+		case INT_V:
+		case INT64_V:  c.type = INT64_V; break;
+		case DOUBLE_V: c.type = DOUBLE_V; break;
+		case STRING_V:
+		case WSTRING_V: c.type = STRING_V; break;
+		default:       c.type = VOID_V; break;
+		}
+	}
+}
+
+int SqlBatch::FindColumn(const String& name) const
+{
+	for(int i = 0; i < column.GetCount(); i++)
+		if(column[i].name == name)
+			return i;
+	return -1;
+}
+
+Vector<Value> SqlBatch::GetRow(int row) const
+{
+	Vector<Value> r;
+	for(const SqlBatchColumn& c : column)
+		r.Add(c.Get(row));
+	return r;
+}
+
+int SqlConnection::FetchBatch(SqlBatch& batch, int n)
+{ // generic implementation, drivers override to avoid Value per cell
+	int count = 0;
+	while(count < n && Fetch()) {
+		for(int i = 0; i < info.GetCount(); i++) {
+			Value v;
+			GetColumn(i, v);
+			batch.Column(i).AddValue(v);
+		}
+		count++;
+	}
+	return count;
+}
+
 String Sql::Compile(const SqlStatement& s)
 {
 	byte dialect = GetDialect();
@@ -89,6 +217,7 @@ String Sql::Compile(const SqlStatement& s)
 }
 
 void Sql::Clear() {
+	cached = Value();
 	if(cn) {
 		cn->Cancel();
 		cn->parse = true;
@@ -97,7 +226,8 @@ void Sql::Clear() {
 
 void Sql::SetParam(int i, const Value& val) {
 	cn->SetParam(i, val);
-	if(GetSession().GetTrace())
+	SqlSession& session = GetSession();
+	if(session.GetTrace() || session.result_cache_limit) // result cache is keyed by parameters too
 		param.Set(i, val);
 }
 
@@ -109,6 +239,8 @@ void Sql::SetStatement(const String& s) {
 bool Sql::Execute() {
 	SqlSession &session = GetSession();
 
+	cached = Value();
+
 	session.SetStatement(cn->statement);
 	session.SetStatus(SqlSession::BEFORE_EXECUTING);
 	cn->starttime = msecs();
@@ -145,6 +277,8 @@ bool Sql::Execute() {
 	session.SetStatus(SqlSession::START_EXECUTING);
 	bool b = cn->Execute();
 	session.SetTime(msecs() - cn->starttime);
+	if(session.result_cache.GetCount())
+		session.InvalidateResultCacheFor(cn->statement);
 	session.SetStatus(SqlSession::END_EXECUTING);
 	if(!b)
 		session.SetStatus(SqlSession::EXECUTING_ERROR);
@@ -210,6 +344,16 @@ __Expand(E__ExecuteFX)
 //$+
 
 bool Sql::Fetch() {
+	if(!cached.IsVoid()) {
+		const CachedResult& r = cached.To<CachedResult>();
+		if(++cached_row < r.rows)
+			return true;
+		if(!r.more)
+			return false;
+		cached = Value(); // cursor is at the row that follows the stored rows
+		return true;
+	}
+
 	SqlSession& session = GetSession();
 	session.SetStatus(SqlSession::START_FETCHING);
 
@@ -238,7 +382,7 @@ bool Sql::Fetch() {
 }
 
 //$-
-#define E__GetColumn(I) cn->GetColumn(I - 1, p##I)
+#define E__GetColumn(I) GetColumn(I - 1, p##I)
 
 #define E__FetchF(I) \
 bool Sql::Fetch(__List##I(E__Ref)) { \
@@ -258,6 +402,61 @@ Vector<Value> Sql::GetRow() const {
 	return row;
 }
 
+int Sql::FetchBatch(SqlBatch& batch, int n) {
+	batch.Init(cn->info);
+	int count = 0;
+	if(!cached.IsVoid()) {
+		const CachedResult& r = cached.To<CachedResult>();
+		while(count < n && ++cached_row < r.rows) {
+			const Value *v = r.data.begin() + cached_row * r.info.GetCount();
+			for(int i = 0; i < r.info.GetCount(); i++)
+				batch.Column(i).AddValue(v[i]);
+			count++;
+		}
+		if(count == n || !r.more) {
+			batch.rows = count;
+			return count;
+		}
+		for(int i = 0; i < r.info.GetCount(); i++) { // row the cursor is at
+			Value v;
+			cn->GetColumn(i, v);
+			batch.Column(i).AddValue(v);
+		}
+		cached = Value();
+		if(++count == n) {
+			batch.rows = count;
+			return count;
+		}
+	}
+
+	SqlSession& session = GetSession();
+	session.SetStatus(SqlSession::START_FETCHING);
+
+	dword t0 = msecs();
+	count += cn->FetchBatch(batch, n - count);
+	dword t = msecs();
+
+	dword total = cn->starttime == INT_MAX ? 0 : t - cn->starttime;
+	dword fetch = t - t0;
+
+	batch.rows = count;
+	session.SetStatus(SqlSession::END_FETCHING);
+	if(count < n) {
+		session.SetTime(total);
+		session.SetStatus(SqlSession::END_FETCHING_MANY);
+	}
+	Stream *s = session.GetTrace();
+	if(s) {
+		if((int)total > session.traceslow)
+			*s << "SLOW SQL: " << total << " ms: " << cn->statement << UPP::EOL;
+		else
+		if((int)fetch > session.traceslow)
+			*s << "SLOW SQL: " << fetch << " ms further fetch: " << cn->statement << UPP::EOL;
+	}
+	cn->starttime = INT_MAX;
+	return count;
+}
+
 bool Sql::Fetch(Vector<Value>& row) {
 	if(!Fetch()) return false;
 	row = GetRow();
@@ -333,7 +532,13 @@ int  Sql::GetColumns() const {
 }
 
 void Sql::GetColumn(int i, Ref r) const {
-	cn->GetColumn(i, r);
+	if(cached.IsVoid())
+		cn->GetColumn(i, r);
+	else {
+		const CachedResult& c = cached.To<CachedResult>();
+		ASSERT(cached_row >= 0 && cached_row < c.rows);
+		r.SetValue(c.data[cached_row * c.info.GetCount() + i]);
+	}
 }
 
 void Sql::GetColumn(SqlId colid, Ref r) const
@@ -353,7 +558,7 @@ void Sql::GetColumn(SqlId colid, Ref r) const
 
 Value Sql::operator[](int i) const {
 	Value v;
-	cn->GetColumn(i, v);
+	GetColumn(i, v);
 	return v;
 }
 
@@ -377,7 +582,7 @@ Value Sql::Select0(const String& s) {
 	if(!Fetch())
 		return Null;
 	Value v;
-	cn->GetColumn(0, v);
+	GetColumn(0, v);
 	return v;
 }
 
@@ -689,6 +894,7 @@ void Sql::Detach()
 	if(cn) delete cn;
 	cn = NULL;
 	param.Clear();
+	cached = Value();
 }
 
 void Sql::Attach(SqlConnection *connection)
@@ -723,6 +929,13 @@ void operator*=(ValueMap& map, SqlSelect select)
 	while(sql.Fetch())
 		map.Add(sql[0], sql[1]);
 }
+
+void operator*=(SqlBatch& batch, SqlSelect select)
+{
+	Sql sql;
+	sql * select;
+	sql.FetchBatch(batch, INT_MAX);
+}
 #endif
 
 }
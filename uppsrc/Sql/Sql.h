@@ -16,6 +16,7 @@ namespace Upp {
 
 #include "Sqlexp.h"
 #include "Sqls.h"
+#include "SqlPool.h"
 #include "SqlSchema.h"
 
 }
@@ -53,7 +53,7 @@ String SqlId::Quoted() const
 	return id.ToString();
 }
 
-void SqlCompile(const char *&s, StringBuffer *r, byte dialect, Vector<SqlVal> *split)
+void SqlCompile(const char *&s, StringBuffer *r, byte dialect, Vector<SqlVal> *split, Index<String> *ids)
 {
 	char quote = dialect == MY_SQL ? '`' : '\"';
 	const char *b = s;
@@ -84,6 +84,8 @@ void SqlCompile(const char *&s, StringBuffer *r, byte dialect, Vector<SqlVal> *s
 					while((byte)*s >= 32)
 						s++;
 					int c = *s;
+					if(ids && *b != '*' && s > b)
+						ids->FindAdd(ToUpper(String(b, s)));
 					if(r) {
 						if(do_quote)
 							*r << quote;
@@ -123,16 +125,16 @@ void SqlCompile(const char *&s, StringBuffer *r, byte dialect, Vector<SqlVal> *s
 			for(;;) {
 				c = *s++;
 				if(c & dialect) {
-					SqlCompile(s, er, dialect, NULL);
+					SqlCompile(s, er, dialect, NULL, ids);
 					er = NULL;
 				}
 				else
-					SqlCompile(s, NULL, dialect, NULL);
+					SqlCompile(s, NULL, dialect, NULL, ids);
 				if(*s == '\0')
 					return;
 				c = *s++;
 				if(c == SQLC_ELSE) {
-					SqlCompile(s, er, dialect, NULL);
+					SqlCompile(s, er, dialect, NULL, ids);
 					ASSERT(*s == SQLC_ENDIF);
 					s++;
 					break;
@@ -326,7 +328,7 @@ String SqlCompile(byte dialect, const String& s)
 	StringBuffer b;
 	b.Reserve(s.GetLength() + 100);
 	const char *q = s;
-	SqlCompile(q, &b, dialect, NULL);
+	SqlCompile(q, &b, dialect, NULL, NULL);
 	return String(b);
 }
 
@@ -342,10 +344,18 @@ Vector<SqlVal> SplitSqlSet(const SqlSet& set)
 	String h = ~set;
 	const char *q = h;
 	Vector<SqlVal> r;
-	SqlCompile(q, NULL, ORACLE, &r);
+	SqlCompile(q, NULL, ORACLE, &r, NULL);
 	return r;
 }
 
+Index<String> SqlGetIds(const String& s)
+{
+	const char *q = s;
+	Index<String> ids;
+	SqlCompile(q, NULL, ORACLE, NULL, &ids);
+	return ids;
+}
+
 String SqlFormat(int x)
 {
 	if(IsNull(x)) return "NULL";
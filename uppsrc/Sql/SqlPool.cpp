@@ -0,0 +1,227 @@
+#include "Sql.h"
+
+namespace Upp {
+
+#define LLOG(x) // LOG(x)
+
+SqlSession *SqlSessionPool::Create()
+{ // called with lock released
+	SqlSession *s = factory ? factory() : NULL;
+	if(s && !s->IsOpen()) {
+		delete s;
+		s = NULL;
+	}
+	return s;
+}
+
+bool SqlSessionPool::IsHealthy(SqlSession& s)
+{
+	if(!s.IsOpen())
+		return false;
+	if(WhenCheck)
+		return WhenCheck(s);
+	if(check_statement.IsEmpty())
+		return true;
+	Sql sql(s);
+	bool ok = sql.Execute(check_statement);
+	s.ClearError();
+	return ok;
+}
+
+bool SqlSessionPool::Open()
+{
+	Mutex::Lock __(lock);
+	closed = false;
+	while(count < min_size) {
+		count++;
+		lock.Leave();
+		SqlSession *s = Create();
+		lock.Enter();
+		if(!s) {
+			count--;
+			return false;
+		}
+		stats.created++;
+		Idle& m = idle.Add();
+		m.session = s;
+		m.time = msecs();
+		cv.Signal();
+	}
+	return true;
+}
+
+void SqlSessionPool::Close()
+{ // sessions in use are closed when released
+	Vector<Idle> h;
+	{
+		Mutex::Lock __(lock);
+		closed = true;
+		h = pick(idle);
+		count -= h.GetCount();
+		cv.Broadcast();
+	}
+	for(Idle& m : h)
+		delete m.session;
+}
+
+SqlSession *SqlSessionPool::Acquire(int timeout_)
+{
+	int tm = IsNull(timeout_) ? timeout : timeout_;
+	int64 start = 0;
+	auto Waited = [&] {
+		if(start) {
+			int64 t = usecs(start);
+			stats.wait_time += t;
+			stats.max_wait = max(stats.max_wait, t);
+		}
+	};
+	Mutex::Lock __(lock);
+	for(;;) {
+		if(closed)
+			return NULL;
+		while(idle.GetCount()) { // most recently used first, it is least likely to be stale
+			Idle m = idle.Pop();
+			if(msecs(m.time) > check_idle) {
+				lock.Leave();
+				bool ok = IsHealthy(*m.session);
+				if(!ok)
+					delete m.session;
+				lock.Enter();
+				if(!ok) {
+					LLOG("SqlSessionPool: discarding stale session");
+					count--;
+					stats.discarded++;
+					continue;
+				}
+			}
+			stats.acquired++;
+			Waited();
+			return m.session;
+		}
+		if(count < max_size) {
+			count++;
+			lock.Leave();
+			SqlSession *s = Create();
+			lock.Enter();
+			if(!s) {
+				count--;
+				cv.Signal(); // somebody else might get the released session
+				Waited();
+				return NULL;
+			}
+			stats.created++;
+			stats.acquired++;
+			Waited();
+			return s;
+		}
+		int wait = -1;
+		if(start == 0) {
+			start = usecs();
+			stats.waited++;
+		}
+		if(tm >= 0) {
+			wait = tm - int(usecs(start) / 1000);
+			if(wait <= 0) {
+				stats.timeouts++;
+				Waited();
+				return NULL;
+			}
+		}
+		stats.waiting++;
+		cv.Wait(lock, wait);
+		stats.waiting--;
+	}
+}
+
+void SqlSessionPool::Release(SqlSession *s, bool discard)
+{
+	if(!s)
+		return;
+	int rollback = 0;
+	if(!discard) {
+		for(int level = s->GetTransactionLevel(); level > 0; level--) { // do not leak unfinished transaction
+			s->Rollback();                                                // to the next user
+			rollback = 1;
+			if(s->GetTransactionLevel() >= level)
+				break;
+		}
+		if(!s->IsOpen() || s->GetErrorClass() == Sql::CONNECTION_BROKEN)
+			discard = true;
+		s->ClearError();
+	}
+	Mutex::Lock __(lock);
+	stats.rollbacks += rollback;
+	if(discard || closed) {
+		if(!closed)
+			stats.discarded++;
+		count--;
+		lock.Leave();
+		delete s;
+		lock.Enter();
+	}
+	else {
+		Idle& m = idle.Add();
+		m.session = s;
+		m.time = msecs();
+	}
+	cv.Signal();
+}
+
+SqlSessionPool::Stats SqlSessionPool::GetStats() const
+{
+	Mutex::Lock __(lock);
+	Stats s = stats;
+	s.size = count;
+	s.idle = idle.GetCount();
+	return s;
+}
+
+void SqlSessionPool::ResetStats()
+{
+	Mutex::Lock __(lock);
+	int waiting = stats.waiting;
+	stats = Stats();
+	stats.waiting = waiting;
+}
+
+SqlSessionPool::~SqlSessionPool()
+{
+	Close();
+	ASSERT(count == 0); // all sessions have to be released before the pool is destroyed
+}
+
+static thread_local SqlPooledSession *sPooled; // innermost checkout of this thread
+
+SqlPooledSession::SqlPooledSession(SqlSessionPool& pool, int timeout)
+:	pool(pool)
+{
+	session = NULL;
+	owner = false;
+	discard = false;
+	for(SqlPooledSession *q = sPooled; q; q = q->prev)
+		if(&q->pool == &pool && q->session) { // nested checkout shares the session of the thread
+			session = q->session;
+			break;
+		}
+	if(!session) {
+		session = pool.Acquire(timeout);
+		owner = true;
+	}
+	prev = sPooled;
+	sPooled = this;
+}
+
+void SqlPooledSession::Release()
+{
+	for(SqlPooledSession **q = &sPooled; *q; q = &(*q)->prev)
+		if(*q == this) {
+			*q = prev;
+			break;
+		}
+	if(owner && session)
+		pool.Release(session, discard);
+	session = NULL;
+	owner = false;
+}
+
+}
@@ -0,0 +1,82 @@
+class SqlSessionPool : NoCopy {
+public:
+	struct Stats {
+		int   size = 0;       // sessions owned by the pool, idle or in use
+		int   idle = 0;
+		int   waiting = 0;    // threads waiting for session now
+		int64 acquired = 0;
+		int64 waited = 0;     // acquisitions that had to wait
+		int64 timeouts = 0;
+		int64 created = 0;
+		int64 discarded = 0;  // sessions closed because of failed check or connection error
+		int64 rollbacks = 0;  // sessions returned with transaction still open
+		int64 wait_time = 0;  // total wait time in microseconds
+		int64 max_wait = 0;   // the longest wait in microseconds
+	};
+
+private:
+	struct Idle : Moveable<Idle> {
+		SqlSession *session;
+		int         time;
+	};
+
+	Function<SqlSession *()> factory;
+	int                      min_size = 1;
+	int                      max_size = 8;
+	int                      timeout = 30000;
+	int                      check_idle = 10000;
+	String                   check_statement = "select 1";
+
+	mutable Mutex            lock;
+	ConditionVariable        cv;
+	Vector<Idle>             idle;
+	int                      count = 0; // sessions in existence, including ones being created
+	bool                     closed = false;
+	Stats                    stats;
+
+	bool        IsHealthy(SqlSession& s);
+	SqlSession *Create();
+
+public:
+	Gate<SqlSession&> WhenCheck;
+
+	SqlSessionPool& Factory(Function<SqlSession *()> f)  { factory = pick(f); return *this; }
+	SqlSessionPool& MinSize(int n)                       { min_size = max(n, 0); return *this; }
+	SqlSessionPool& MaxSize(int n)                       { max_size = max(n, 1); return *this; }
+	SqlSessionPool& Timeout(int ms)                      { timeout = ms; return *this; }
+	SqlSessionPool& CheckIdle(int ms)                    { check_idle = ms; return *this; }
+	SqlSessionPool& CheckStatement(const char *s)        { check_statement = s; return *this; }
+
+	bool        Open();
+	void        Close();
+
+	SqlSession *Acquire(int timeout = Null);
+	void        Release(SqlSession *session, bool discard = false);
+
+	Stats       GetStats() const;
+	void        ResetStats();
+
+	~SqlSessionPool();
+};
+
+class SqlPooledSession : NoCopy {
+	SqlSessionPool&   pool;
+	SqlSession       *session;
+	bool              owner;
+	bool              discard;
+	SqlPooledSession *prev;
+
+public:
+	bool        IsOk() const                                 { return session; }
+	operator    bool() const                                 { return session; }
+
+	SqlSession& Get() const                                  { ASSERT(session); return *session; }
+	operator    SqlSession&() const                          { return Get(); }
+	SqlSession *operator->() const                           { return &Get(); }
+
+	void        Discard()                                    { discard = true; }
+	void        Release();
+
+	SqlPooledSession(SqlSessionPool& pool, int timeout = Null);
+	~SqlPooledSession()                                      { Release(); }
+};
@@ -379,6 +379,7 @@ SqlStatement SqlCreateTable::As(const SqlSelect& select)
 
 SqlDelete::SqlDelete(SqlVal table) {
 	text = "delete from " + ~table;
+	this->table = ~table;
 }
 
 SqlDelete& SqlDelete::Where(const SqlBool& b) {
@@ -414,7 +415,7 @@ SqlInsert::operator SqlStatement() const {
 	}
 	if(!ret.IsEmpty())
 		s << " returning " << ~ret;
-	return SqlStatement(s);
+	return SqlStatement(s, table.Quoted());
 }
 
 struct InsertFieldOperator : public FieldOperator {
@@ -495,7 +496,7 @@ SqlInsert::operator SqlStatement() const {
 			s << ' ' + SqlStatement(sel).GetText();
 		}
 	}
-	return SqlStatement(s);
+	return SqlStatement(s, table.Quoted());
 }
 
 SqlInsert& SqlInsert::From(const SqlId& from) {
@@ -606,7 +607,7 @@ SqlUpdate::operator SqlStatement() const {
 		stmt << " where " << ~where;
 	if(!ret.IsEmpty())
 		stmt << " returning " << ~ret;
-	return SqlStatement(stmt);
+	return SqlStatement(stmt, table.Quoted());
 }
 
 void SqlUpdate::Column(const SqlId& column, SqlVal val) {
@@ -653,7 +654,7 @@ SqlUpdate::operator SqlStatement() const {
 	stmt << "update " << table.Quoted() << " set " << ~set;
 	if(!where.IsEmpty())
 		stmt << " where " << ~where;
-	return SqlStatement(stmt);
+	return SqlStatement(stmt, table.Quoted());
 }
 
 void SqlUpdate::Column(const SqlId& column, SqlVal val) {
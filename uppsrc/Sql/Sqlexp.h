@@ -94,6 +94,7 @@ String SqlCompile(byte dialect, const String& s);
 String SqlCompile(const String& s);
 
 Vector<SqlVal> SplitSqlSet(const SqlSet& set);
+Index<String>  SqlGetIds(const String& s); // upper-cased identifiers (tables, columns) in SqlExp text
 
 String SqlFormat(int x);
 String SqlFormat(double x);
@@ -540,10 +541,12 @@ public:
 
 class SqlStatement {
 	String text;
+	String table;  // SqlExp text of table modified by SqlInsert, SqlUpdate or SqlDelete
+	bool   cached = false;
 
 public:
 	SqlStatement() {}
-	explicit SqlStatement(const String& s) : text(s) {}
+	explicit SqlStatement(const String& s, const String& table = Null) : text(s), table(table) {}
 
 	String Get(int dialect) const;
 #ifndef flagNOAPPSQL
@@ -553,6 +556,11 @@ public:
 	bool   IsEmpty() const                           { return text.IsEmpty(); }
 	operator bool() const                            { return !IsEmpty(); }
 
+	SqlStatement& Cached(bool b = true)              { cached = b; return *this; }
+	bool   IsCached() const                          { return cached; }
+	String GetTable() const                          { return table; }
+	Index<String> GetIds() const                     { return SqlGetIds(text); }
+
 //Deprecated!!!
 	bool  Execute(Sql& cursor) const;
 	void  Force(Sql& cursor) const;
@@ -566,6 +574,7 @@ class SqlSelect {
 	String  text;
 	String  tables;
 	bool    on, valid;
+	bool    cached = false;
 
 	SqlSelect& InnerJoin0(const String& table);
 	SqlSelect& LeftJoin0(const String& table);
@@ -622,9 +631,10 @@ public:
 	SqlSelect& Limit(int limit);
 	SqlSelect& Limit(int64 offset, int limit);
 	SqlSelect& Offset(int64 offset);
+	SqlSelect& Cached(bool b = true)                  { cached = b; return *this; }
 
 	operator  SqlSet() const                           { return SqlSet(text, SqlSet::SETOP); }
-	operator  SqlStatement() const                     { return SqlStatement(text); }
+	operator  SqlStatement() const                     { return SqlStatement(text).Cached(cached); }
 	SqlVal    AsValue() const;
 	SqlSet    AsTable(const SqlId& tab) const;
 	
@@ -673,6 +683,7 @@ __Expand(E__QSelect);
 
 class SqlDelete {
 	String text;
+	String table;
 	SqlSet ret;
 
 public:
@@ -682,7 +693,7 @@ public:
 	SqlDelete& Returning(SqlVal a, SqlVal b)          { return Returning(SqlSet(a, b)); }
 	SqlDelete& Returning(SqlVal a, SqlVal b, SqlVal c){ return Returning(SqlSet(a, b, c)); }
 
-	operator SqlStatement() const                     { return SqlStatement(text); }
+	operator SqlStatement() const                     { return SqlStatement(text, table); }
 
 	SqlDelete(SqlVal table);
 
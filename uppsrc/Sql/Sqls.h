@@ -40,6 +40,48 @@ struct SqlColumnInfo : Moveable<SqlColumnInfo> {
 	bool        binary;    //column holds binary data
 };
 
+struct SqlBatchColumn {
+	String         name;
+	int            type;  // INT64_V, DOUBLE_V, STRING_V or VOID_V (other types stored as Value)
+	Vector<int64>  i64;
+	Vector<double> dbl;
+	Vector<String> str;
+	Vector<Value>  val;
+	Bits           null;  // null cells have default value in typed vector
+	VectorMap<int, String> error; // cells not convertible to column type, stored as null
+
+	int            GetCount() const;
+	bool           IsNull(int i) const                 { return null[i]; }
+	bool           IsError(int i) const                { return null[i] && error.Find(i) >= 0; }
+	Value          Get(int i) const;
+
+	void           AddNull();
+	void           AddValue(const Value& v);
+	void           Clear();
+};
+
+class SqlBatch {
+	Array<SqlBatchColumn> column;
+	int                   rows = 0;
+
+	friend class Sql;
+
+public:
+	void                  Init(const Vector<SqlColumnInfo>& info);
+
+	int                   GetCount() const             { return rows; }
+	int                   GetColumns() const           { return column.GetCount(); }
+	int                   FindColumn(const String& name) const;
+
+	const SqlBatchColumn& operator[](int i) const      { return column[i]; }
+	SqlBatchColumn&       Column(int i)                { return column[i]; }
+
+	Value                 Get(int row, int col) const  { return column[col].Get(row); }
+	Vector<Value>         GetRow(int row) const;
+
+	void                  Clear()                      { column.Clear(); rows = 0; }
+};
+
 class SqlConnection {
 protected:
 	friend class Sql;
@@ -51,6 +93,7 @@ protected:
 	virtual Value       GetInsertedId() const;
 	virtual bool        Fetch() = 0;
 	virtual void        GetColumn(int i, Ref r) const = 0;
+	virtual int         FetchBatch(SqlBatch& batch, int n);
 	virtual void        Cancel() = 0;
 	virtual SqlSession& GetSession() const = 0;
 	virtual String      GetUser() const;
@@ -87,6 +130,15 @@ private:
 class Sql {
 	SqlConnection  *cn;
 	Vector<Value>   param;
+	Value           cached; // CachedResult served from SqlSession result cache
+	int             cached_row = -1;
+
+	struct CachedResult {
+		Vector<SqlColumnInfo> info;
+		Vector<Value>         data; // row-major, info.GetCount() values per row
+		int                   rows = 0;
+		bool                  more = false; // too big to store, next rows are fetched from the cursor
+	};
 
 	friend class SqlSession;
 	friend class SqlConnection;
@@ -99,6 +151,8 @@ class Sql {
 	void   Attach(SqlConnection *connection);
 	void   Detach();
 
+	bool   ExecuteCached(const SqlStatement& s);
+
 protected:
 	Sql(SqlConnection *connection);
 
@@ -119,8 +173,8 @@ public:
 	bool   Execute(const String& s);
 	void   ExecuteX(const String& s); // Deprecated
 
-	bool   Execute(const SqlStatement& s)              { return Execute(Compile(s)); }
-	void   ExecuteX(const SqlStatement& s)             { ExecuteX(Compile(s)); }  // Deprecated
+	bool   Execute(const SqlStatement& s);
+	void   ExecuteX(const SqlStatement& s);  // Deprecated
 
 
 //$-
@@ -154,6 +208,7 @@ public:
 	bool   Fetch(Vector<Value>& row);
 	bool   Fetch(ValueMap& row);
 	bool   Fetch(Fields fields);
+	int    FetchBatch(SqlBatch& batch, int n = 4096);
 
 	int    GetRowsProcessed() const                    { return cn->GetRowsProcessed(); }
 
@@ -174,7 +229,7 @@ public:
 	void        SetFetchRows(int nrows)                { cn->fetchrows = nrows; } // deprecated
 	void        SetLongSize(int lsz)                   { cn->longsize = lsz; } // deprecated
 
-	void        Cancel()                               { if(cn) cn->Cancel(); }
+	void        Cancel()                               { cached = Value(); if(cn) cn->Cancel(); }
 
 	Value       Select(const String& what); // Deprecated
 
@@ -336,6 +391,29 @@ protected:
 	
 	bool                          use_realcase = false;
 	
+	int                           stmt_cache_size = 0;
+	int64                         stmt_cache_hits = 0;
+	int64                         stmt_cache_misses = 0;
+	
+	struct ResultCacheEntry {
+		Value                     result;
+		Index<String>             ids; // tables (and columns) the statement references
+		int                       size = 0;
+		int64                     lru = 0;
+	};
+	ArrayMap<Value, ResultCacheEntry> result_cache;
+	int                           result_cache_limit = 0;
+	int                           result_cache_maxrows = 1000;
+	int                           result_cache_size = 0;
+	int64                         result_cache_lru = 0;
+	int64                         result_cache_hits = 0;
+	int64                         result_cache_misses = 0;
+	int64                         result_cache_invalidations = 0;
+
+	void                          ShrinkResultCache(int maxsize);
+	void                          AddCachedResult(const Value& key, const Value& result, Index<String>&& ids, int size);
+	void                          InvalidateResultCacheFor(const String& statement);
+
 	One<Sql>                      sql;
 	One<Sql>                      sqlr;
 	
@@ -351,6 +429,7 @@ public:
 	virtual void                  Commit();
 	virtual void                  Rollback();
 	virtual int                   GetTransactionLevel() const;
+	virtual bool                  IsTransactionOpen() const;
 
 	virtual String                Savepoint(); // Deprecated
 	virtual void                  RollbackTo(const String& savepoint); // Deprecated
@@ -420,6 +499,29 @@ public:
 	void                          UseRealcase()                           { use_realcase = true; }
 	bool                          IsUseRealcase() const                   { return use_realcase; }
 
+	SqlSession&                   StatementCache(int n)                   { stmt_cache_size = max(n, 0); return *this; }
+	int                           GetStatementCacheSize() const           { return stmt_cache_size; }
+	int64                         GetStatementCacheHits() const           { return stmt_cache_hits; }
+	int64                         GetStatementCacheMisses() const         { return stmt_cache_misses; }
+	void                          ResetStatementCacheStats()              { stmt_cache_hits = stmt_cache_misses = 0; }
+	virtual void                  ClearStatementCache();
+
+	SqlSession&                   ResultCache(int maxsize = 4 * 1024 * 1024, int maxrows = 1000);
+	SqlSession&                   NoResultCache()                         { return ResultCache(0); }
+	int                           GetResultCacheLimit() const             { return result_cache_limit; }
+	int                           GetResultCacheSize() const              { return result_cache_size; }
+	int                           GetResultCacheCount() const             { return result_cache.GetCount(); }
+	int64                         GetResultCacheHits() const              { return result_cache_hits; }
+	int64                         GetResultCacheMisses() const            { return result_cache_misses; }
+	int64                         GetResultCacheInvalidations() const     { return result_cache_invalidations; }
+	void                          ResetResultCacheStats()                 { result_cache_hits = result_cache_misses = result_cache_invalidations = 0; }
+	void                          InvalidateResultCache(const String& table);
+	void                          ClearResultCache();
+
+	virtual bool                  HasBulkInsert() const;
+	virtual bool                  BulkInsert(const String& table, const Vector<String>& column,
+	                                         const Vector< Vector<Value> >& row);
+
 	Callback1<const SqlSession&>  WhenDatabaseActivity;
 
 	static void PerThread(bool b = true); // Activates thread local SQL/SQLR
@@ -456,7 +558,6 @@ bool SqlPerformScript(const String& script,
 
 class SqlMassInsert {
 	struct Row : Moveable<Row> {
-		uint64         nulls;
 		Vector <Value> value;
 		SqlBool        remove;
 		
@@ -471,8 +572,10 @@ class SqlMassInsert {
 	int             pos;
 	bool            error;
 	bool            use_transaction;
+	bool            bulk;
 	
 	void            NewRow();
+	Vector<String>  InsertStatements(int dialect);
 
 public:
 	SqlMassInsert& operator()(SqlId col, const Value& val);
@@ -482,10 +585,12 @@ public:
 	bool           IsError() const                                 { return error; }
 	SqlMassInsert& UseTransaction(bool b = true)                   { use_transaction = b; return *this; }
 	SqlMassInsert& NoUseTransaction()                              { return UseTransaction(false); }
+	SqlMassInsert& Bulk(bool b = true)                             { bulk = b; return *this; }
+	SqlMassInsert& NoBulk()                                        { return Bulk(false); }
 	
-	SqlMassInsert(Sql& sql, SqlId table) : sql(sql), table(table)  { pos = 0; error = false; use_transaction = true; }
+	SqlMassInsert(Sql& sql, SqlId table) : sql(sql), table(table)  { pos = 0; error = false; use_transaction = bulk = true; }
 #ifndef NOAPPSQL
-	SqlMassInsert(SqlId table) : sql(SQL), table(table)            { pos = 0; error = false; use_transaction = true; }
+	SqlMassInsert(SqlId table) : sql(SQL), table(table)            { pos = 0; error = false; use_transaction = bulk = true; }
 #endif
 	~SqlMassInsert();
 };
@@ -529,6 +634,7 @@ void SqlLoadColumn(T& t, SqlSelect select)
 }
 
 void operator*=(ValueMap& map, SqlSelect select);
+void operator*=(SqlBatch& batch, SqlSelect select);
 
 template<class K, class V>
 void operator*=(VectorMap<K, V>& map, SqlSelect select)
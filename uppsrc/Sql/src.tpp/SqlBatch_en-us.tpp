@@ -0,0 +1,130 @@
+topic "SqlBatch";
+[2 $$0,0#00000000000000000000000000000000:Default]
+[i448;a25;kKO9;2 $$1,0#37138531426314131252341829483380:class]
+[l288;2 $$2,2#27521748481378242620020725143825:desc]
+[0 $$3,0#96390100711032703541132217272105:end]
+[H6;0 $$4,0#05600065144404261032431302351956:begin]
+[i448;a25;kKO9;2 $$5,0#37138531426314131252341829483370:item]
+[l288;a4;*@5;1 $$6,6#70004532496200323422659154056402:requirement]
+[l288;i1121;b17;O9;~~~.1408;2 $$7,0#10431211400427159095818037425705:param]
+[i448;b42;O9;2 $$8,8#61672508125594000341940100500538:tparam]
+[b42;2 $$9,9#13035079074754324216151401829390:normal]
+[{_}%EN-US 
+[ {{10000@(113.42.0) [s0; [*@7;4 SqlBatchColumn]]}}&]
+[s1;@(0.0.255)3%- &]
+[s1;:SqlBatchColumn`:`:struct:%- [@(0.0.255)3 struct][3 _][*3 SqlBatchColumn]&]
+[s2; Single column of SqlBatch. Depending on the type, values are 
+stored in one of typed vectors, NULL cells are marked in the null 
+bitmap and have default value (0 or empty String) in the vector.&]
+[s3;%- &]
+[ {{10000F(128)G(128)@1 [s0; [* Public Member List]]}}&]
+[s3;%- &]
+[s5;:SqlBatchColumn`:`:name:%- [_^String^ String]_[* name]&]
+[s2; Column name.&]
+[s3; &]
+[s4;%- &]
+[s5;:SqlBatchColumn`:`:type:%- [@(0.0.255) int]_[* type]&]
+[s2; INT64`_V for integer and boolean columns (stored in i64), DOUBLE`_V 
+(dbl), STRING`_V for text and binary columns (str) or VOID`_V for 
+other types, stored as Value in val.&]
+[s3; &]
+[s4;%- &]
+[s5;:SqlBatchColumn`:`:null:%- [_^Bits^ Bits]_[* null]&]
+[s2; Null bitmap.&]
+[s3; &]
+[s4;%- &]
+[s5;:SqlBatchColumn`:`:error:%- [_^VectorMap^ VectorMap]<[@(0.0.255) int], 
+[_^String^ String]>_[* error]&]
+[s2; Cells of numeric column with value that could not be converted 
+(e.g. text in SQLite integer column), mapped to error description. 
+These cells are NULL in the typed vector.&]
+[s3; &]
+[s4;%- &]
+[s5;:SqlBatchColumn`:`:GetCount`(`)const:%- [@(0.0.255) int]_[* GetCount]()_[@(0.0.255) c
+onst]&]
+[s2; Returns the number of cells.&]
+[s3; &]
+[s4;%- &]
+[s5;:SqlBatchColumn`:`:IsNull`(int`)const:%- [@(0.0.255) bool]_[* IsNull]([@(0.0.255) int]_
+[*@3 i])_[@(0.0.255) const]&]
+[s2; Returns true if cell [%-*@3 i] is NULL.&]
+[s3; &]
+[s4;%- &]
+[s5;:SqlBatchColumn`:`:IsError`(int`)const:%- [@(0.0.255) bool]_[* IsError]([@(0.0.255) int]_
+[*@3 i])_[@(0.0.255) const]&]
+[s2; Returns true if value of cell [%-*@3 i] could not be converted 
+to the column type.&]
+[s3; &]
+[s4;%- &]
+[s5;:SqlBatchColumn`:`:Get`(int`)const:%- [_^Value^ Value]_[* Get]([@(0.0.255) int]_[*@3 i])_[@(0.0.255) c
+onst]&]
+[s2; Returns cell [%-*@3 i] as Value. Cells that could not be converted 
+are returned as ErrorValue.&]
+[s3; &]
+[s4;%- &]
+[s5;:SqlBatchColumn`:`:AddNull`(`):%- [@(0.0.255) void]_[* AddNull]()&]
+[s2; Adds NULL cell.&]
+[s3; &]
+[s4;%- &]
+[s5;:SqlBatchColumn`:`:AddValue`(const Value`&`):%- [@(0.0.255) void]_[* AddValue]([@(0.0.255) c
+onst]_[_^Value^ Value][@(0.0.255) `&]_[*@3 v])&]
+[s2; Adds cell, converting [%-*@3 v] to the column type if needed. 
+If the value cannot be converted to number, NULL cell is added 
+and the error is recorded (see IsError). Used by drivers for types 
+they do not handle directly.&]
+[s3; &]
+[s0; &]
+[ {{10000@(113.42.0) [s0; [*@7;4 SqlBatch]]}}&]
+[s1;@(0.0.255)3%- &]
+[s1;:SqlBatch`:`:class:%- [@(0.0.255)3 class][3 _][*3 SqlBatch]&]
+[s2; Block of result set rows stored by columns, filled by Sql`::FetchBatch. 
+Intended for processing of large result sets, where creating 
+Value for each cell would dominate.&]
+[s2; The whole result of SqlSelect can be loaded using&]
+[s2; [C void_operator`*`=(SqlBatch`&_batch, SqlSelect_select)]&]
+[s2; using the default session.&]
+[s3;%- &]
+[ {{10000F(128)G(128)@1 [s0; [* Public Member List]]}}&]
+[s3;%- &]
+[s5;:SqlBatch`:`:GetCount`(`)const:%- [@(0.0.255) int]_[* GetCount]()_[@(0.0.255) const]&]
+[s2; Returns the number of rows.&]
+[s3; &]
+[s4;%- &]
+[s5;:SqlBatch`:`:GetColumns`(`)const:%- [@(0.0.255) int]_[* GetColumns]()_[@(0.0.255) cons
+t]&]
+[s2; Returns the number of columns.&]
+[s3; &]
+[s4;%- &]
+[s5;:SqlBatch`:`:FindColumn`(const String`&`)const:%- [@(0.0.255) int]_[* FindColumn]([@(0.0.255) c
+onst]_[_^String^ String][@(0.0.255) `&]_[*@3 name])_[@(0.0.255) const]&]
+[s2; Returns the index of column [%-*@3 name] or negative value if 
+not found.&]
+[s3; &]
+[s4;%- &]
+[s5;:SqlBatch`:`:operator`[`]`(int`)const:%- [@(0.0.255) const]_[_^SqlBatchColumn^ SqlBa
+tchColumn][@(0.0.255) `&]_[* operator`[`]]([@(0.0.255) int]_[*@3 i])_[@(0.0.255) const]&]
+[s5;:SqlBatch`:`:Column`(int`):%- [_^SqlBatchColumn^ SqlBatchColumn][@(0.0.255) `&]_[* Col
+umn]([@(0.0.255) int]_[*@3 i])&]
+[s2; Returns column [%-*@3 i].&]
+[s3; &]
+[s4;%- &]
+[s5;:SqlBatch`:`:Get`(int`,int`)const:%- [_^Value^ Value]_[* Get]([@(0.0.255) int]_[*@3 row],
+ [@(0.0.255) int]_[*@3 col])_[@(0.0.255) const]&]
+[s2; Returns single cell as Value.&]
+[s3; &]
+[s4;%- &]
+[s5;:SqlBatch`:`:GetRow`(int`)const:%- [_^Vector^ Vector]<[_^Value^ Value]>_[* GetRow]([@(0.0.255) i
+nt]_[*@3 row])_[@(0.0.255) const]&]
+[s2; Returns the whole [%-*@3 row].&]
+[s3; &]
+[s4;%- &]
+[s5;:SqlBatch`:`:Init`(const Vector`<SqlColumnInfo`>`&`):%- [@(0.0.255) void]_[* Init]([@(0.0.255) c
+onst]_[_^Vector^ Vector]<[_^SqlColumnInfo^ SqlColumnInfo]>`&_[*@3 info])&]
+[s2; Sets up empty columns for result set described by [%-*@3 info]. 
+Called by Sql`::FetchBatch.&]
+[s3; &]
+[s4;%- &]
+[s5;:SqlBatch`:`:Clear`(`):%- [@(0.0.255) void]_[* Clear]()&]
+[s2; Removes all columns and rows.&]
+[s3; &]
+[s0; ]]
\ No newline at end of file
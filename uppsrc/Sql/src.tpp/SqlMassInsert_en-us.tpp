@@ -74,6 +74,20 @@ is default.&]
 [s2; Same as UseTransaction(false).&]
 [s3; &]
 [s4; &]
+[s5;:SqlMassInsert`:`:Bulk`(bool`):%- [_^SqlMassInsert^ SqlMassInsert][@(0.0.255) `&]_[* B
+ulk]([@(0.0.255) bool]_[*@3 b]_`=_[@(0.0.255) true])&]
+[s2; If the session supports it (SqlSession`::HasBulkInsert), rows 
+are passed to SqlSession`::BulkInsert as values, avoiding conversion 
+of values to SQL text (PostgreSQL uses COPY, SQLite and MySQL 
+multi`-row insert with parameters). Larger batches are buffered 
+in this mode. This is default.&]
+[s3; &]
+[s4; &]
+[s5;:SqlMassInsert`:`:NoBulk`(`):%- [_^SqlMassInsert^ SqlMassInsert][@(0.0.255) `&]_[* NoBu
+lk]()&]
+[s2; Same as Bulk(false).&]
+[s3; &]
+[s4; &]
 [s5;:SqlMassInsert`:`:SqlMassInsert`(Sql`&`,SqlId`):%- [* SqlMassInsert]([_^Sql^ Sql][@(0.0.255) `&
 ]_[*@3 sql], [_^SqlId^ SqlId]_[*@3 table])&]
 [s2; Creates instance for [%-*@3 sql] context and [%-*@3 table] .&]
@@ -0,0 +1,128 @@
+topic "SqlSessionPool";
+[2 $$0,0#00000000000000000000000000000000:Default]
+[i448;a25;kKO9;2 $$1,0#37138531426314131252341829483380:class]
+[l288;2 $$2,2#27521748481378242620020725143825:desc]
+[0 $$3,0#96390100711032703541132217272105:end]
+[H6;0 $$4,0#05600065144404261032431302351956:begin]
+[i448;a25;kKO9;2 $$5,0#37138531426314131252341829483370:item]
+[l288;a4;*@5;1 $$6,6#70004532496200323422659154056402:requirement]
+[l288;i1121;b17;O9;~~~.1408;2 $$7,0#10431211400427159095818037425705:param]
+[i448;b42;O9;2 $$8,8#61672508125594000341940100500538:tparam]
+[b42;2 $$9,9#13035079074754324216151401829390:normal]
+[{_}%EN-US 
+[ {{10000@(113.42.0) [s0; [*@7;4 SqlSessionPool]]}}&]
+[s1;@(0.0.255)3%- &]
+[s1;:SqlSessionPool`:`:class:%- [@(0.0.255)3 class][3 _][*3 SqlSessionPool]&]
+[s2; Thread`-safe pool of opened SqlSessions. Sessions are created 
+by the factory function, which makes the pool usable with any 
+database driver. Threads check sessions out (preferably using 
+SqlPooledSession), use them exclusively and return them to the 
+pool. Returned sessions with unfinished transaction are rolled 
+back, sessions that lost connection are closed. Idle sessions 
+are checked before checkout if they were not used for some time.&]
+[s3;%- &]
+[ {{10000F(128)G(128)@1 [s0; [* Public Member List]]}}&]
+[s3;%- &]
+[s5;:SqlSessionPool`:`:WhenCheck:%- [_^Gate^ Gate]<[_^SqlSession^ SqlSession][@(0.0.255) `&
+]>_[* WhenCheck]&]
+[s2; Custom health check of idle session, should return false if 
+the session is not usable. If not defined, the pool executes CheckStatement.&]
+[s3; &]
+[s4;%- &]
+[s5;:SqlSessionPool`:`:Factory`(Function`<SqlSession`*`(`)`>`):%- [_^SqlSessionPool^ SqlSessionPool][@(0.0.255) `&]_[* Factory]([_^Function^ Function]<[_^SqlSession^ S
+qlSession]_`*()>_[*@3 f])&]
+[s2; Sets the function that creates new opened session (allocated with 
+new, the pool takes ownership) or returns NULL on failure. Returns `*this.&]
+[s3; &]
+[s4;%- &]
+[s5;:SqlSessionPool`:`:MinSize`(int`):%- [_^SqlSessionPool^ SqlSessionPool][@(0.0.255) `&]_[* MinSize]([@(0.0.255) int]_[*@3 n])&]
+[s2; Number of sessions created by Open. Default is 1. Returns `*this.&]
+[s3; &]
+[s4;%- &]
+[s5;:SqlSessionPool`:`:MaxSize`(int`):%- [_^SqlSessionPool^ SqlSessionPool][@(0.0.255) `&]_[* MaxSize]([@(0.0.255) int]_[*@3 n])&]
+[s2; Maximum number of sessions. When all are in use, Acquire waits. 
+Default is 8. Returns `*this.&]
+[s3; &]
+[s4;%- &]
+[s5;:SqlSessionPool`:`:Timeout`(int`):%- [_^SqlSessionPool^ SqlSessionPool][@(0.0.255) `&]_[* Timeout]([@(0.0.255) int]_[*@3 ms])&]
+[s2; Default time Acquire waits for the session, negative value means 
+waiting forever. Default is 30 seconds. Returns `*this.&]
+[s3; &]
+[s4;%- &]
+[s5;:SqlSessionPool`:`:CheckIdle`(int`):%- [_^SqlSessionPool^ SqlSessionPool][@(0.0.255) `&]_[* CheckIdle]([@(0.0.255) int]_[*@3 ms])&]
+[s2; Sessions idle for longer than [%-*@3 ms] are checked before checkout. 
+Default is 10 seconds. Returns `*this.&]
+[s3; &]
+[s4;%- &]
+[s5;:SqlSessionPool`:`:CheckStatement`(const char`*`):%- [_^SqlSessionPool^ SqlSessionPool][@(0.0.255) `&]_[* CheckStatement]([@(0.0.255) const]_[@(0.0.255) c
+har]_`*[*@3 s])&]
+[s2; Statement used to check idle session, default is `"select 1`". 
+Empty statement disables the check. Returns `*this.&]
+[s3; &]
+[s4;%- &]
+[s5;:SqlSessionPool`:`:Open`(`):%- [@(0.0.255) bool]_[* Open]()&]
+[s2; Creates MinSize sessions. Returns false if the factory failed.&]
+[s3; &]
+[s4;%- &]
+[s5;:SqlSessionPool`:`:Close`(`):%- [@(0.0.255) void]_[* Close]()&]
+[s2; Closes idle sessions; sessions in use are closed when released. 
+Acquire returns NULL after Close.&]
+[s3; &]
+[s4;%- &]
+[s5;:SqlSessionPool`:`:Acquire`(int`):%- [_^SqlSession^ SqlSession]_`*[* Acquire]([@(0.0.255) int]_[*@3 timeout]_`=_Null)&]
+[s2; Checks out the session, creating the new one if there is no idle 
+session and MaxSize is not reached, otherwise waits up to [%-*@3 timeout] 
+ms (Null means Timeout setting). Returns NULL on timeout or failure. 
+The session has to be returned by Release.&]
+[s3; &]
+[s4;%- &]
+[s5;:SqlSessionPool`:`:Release`(SqlSession`*`,bool`):%- [@(0.0.255) void]_[* Release]([_^SqlSession^ SqlSession]_`*[*@3 session], 
+[@(0.0.255) bool]_[*@3 discard]_`=_[@(0.0.255) false])&]
+[s2; Returns the session to the pool. Unfinished transaction is rolled 
+back, errors are cleared. If [%-*@3 discard] is true or the connection 
+is broken, the session is closed instead.&]
+[s3; &]
+[s4;%- &]
+[s5;:SqlSessionPool`:`:GetStats`(`)const:%- [_^SqlSessionPool`:`:Stats^ Stats]_[* GetStats]()_[@(0.0.255) const]&]
+[s2; Returns the current size of the pool and counters of checkouts, 
+waits (with total and maximal waiting time in microseconds), timeouts, 
+created and discarded sessions and rollbacks.&]
+[s3; &]
+[s4;%- &]
+[s5;:SqlSessionPool`:`:ResetStats`(`):%- [@(0.0.255) void]_[* ResetStats]()&]
+[s2; Sets all counters to zero.&]
+[s3; &]
+[s0; &]
+[ {{10000@(113.42.0) [s0; [*@7;4 SqlPooledSession]]}}&]
+[s1;@(0.0.255)3%- &]
+[s1;:SqlPooledSession`:`:class:%- [@(0.0.255)3 class][3 _][*3 SqlPooledSession]&]
+[s2; Scoped checkout of the session from SqlSessionPool. Converts 
+to SqlSession`&, so it can be directly used to construct Sql. Nested 
+SqlPooledSession of the same pool in the same thread shares the 
+session of the outer one, so functions called within the transaction 
+take part in it and the thread never waits for itself.&]
+[s3;%- &]
+[ {{10000F(128)G(128)@1 [s0; [* Public Member List]]}}&]
+[s3;%- &]
+[s4;%- &]
+[s5;:SqlPooledSession`:`:IsOk`(`)const:%- [@(0.0.255) bool]_[* IsOk]()_[@(0.0.255) const]&]
+[s2; Returns true if the session was obtained. Same as operator bool.&]
+[s3; &]
+[s4;%- &]
+[s5;:SqlPooledSession`:`:Get`(`)const:%- [_^SqlSession^ SqlSession][@(0.0.255) `&]_[* Get]()_[@(0.0.255) const]&]
+[s2; Returns the session. Same as operator SqlSession`& and operator`->.&]
+[s3; &]
+[s4;%- &]
+[s5;:SqlPooledSession`:`:Discard`(`):%- [@(0.0.255) void]_[* Discard]()&]
+[s2; The session will be closed instead of returned to the pool.&]
+[s3; &]
+[s4;%- &]
+[s5;:SqlPooledSession`:`:Release`(`):%- [@(0.0.255) void]_[* Release]()&]
+[s2; Returns the session to the pool before the end of scope.&]
+[s3; &]
+[s4;%- &]
+[s5;:SqlPooledSession`:`:SqlPooledSession`(SqlSessionPool`&`,int`):%- [* SqlPooledSession]([_^SqlSessionPool^ SqlSessionPool][@(0.0.255) `&]_[*@3 pool], 
+[@(0.0.255) int]_[*@3 timeout]_`=_Null)&]
+[s2; Checks out the session from [%-*@3 pool], see SqlSessionPool`::Acquire.&]
+[s3; &]
+[s0; ]]
\ No newline at end of file
@@ -47,6 +47,14 @@ active. (Originally, U`+`+ allowed nested transaction, this is
 now deprecated).&]
 [s3;%% &]
 [s4;%% &]
+[s5;:SqlSession`:`:IsTransactionOpen`(`)const: [@(0.0.255) virtual] 
+[@(0.0.255) bool]_[* IsTransactionOpen]()_[@(0.0.255) const]&]
+[s2;%% Returns true if changes done by this session can still be 
+rolled back. Unlike GetTransactionLevel, this includes implicit 
+transactions (e.g. Sqlite3Session`::AutoBatch). Default implementation 
+returns GetTransactionLevel() > 0.&]
+[s3;%% &]
+[s4;%% &]
 [s5;:SqlSession`:`:IsOpen`(`)const: [@(0.0.255) virtual] [@(0.0.255) bool]_[* IsOpen]()_[@(0.0.255) c
 onst]&]
 [s2;%% Returns true if session is connected and ready to recieve 
@@ -206,6 +214,134 @@ Sql`::ERRORCLASS_clss))&]
 [s2;%% Same as IsOpen().&]
 [s3;%% &]
 [s4;%% &]
+[s5;:SqlSession`:`:StatementCache`(int`): [_^SqlSession^ SqlSession][@(0.0.255) `&]_[* S
+tatementCache]([@(0.0.255) int]_[*@3 n])&]
+[s2;%% Sets the maximum number of prepared statements the session 
+keeps for reuse, keyed by the statement text, least recently used 
+statement being discarded first. Values should be passed as parameters 
+(`'?`' in the statement, SetParam or Execute/Run with arguments), 
+as statements with values inlined have different text for each 
+execution. 0 disables the cache. Only some drivers support the 
+cache (Sqlite3 has it active by default, PostgreSQL after this 
+method is called); others ignore the setting.&]
+[s3;%% &]
+[s4;%% &]
+[s5;:SqlSession`:`:GetStatementCacheSize`(`)const: [@(0.0.255) int]_[* GetStatementCac
+heSize]()_[@(0.0.255) const]&]
+[s2;%% Returns the statement cache size.&]
+[s3;%% &]
+[s4;%% &]
+[s5;:SqlSession`:`:GetStatementCacheHits`(`)const: [_^int64^ int64]_[* GetStatementCach
+eHits]()_[@(0.0.255) const]&]
+[s2;%% Returns the number of executions that reused a cached prepared 
+statement.&]
+[s3;%% &]
+[s4;%% &]
+[s5;:SqlSession`:`:GetStatementCacheMisses`(`)const: [_^int64^ int64]_[* GetStatementCa
+cheMisses]()_[@(0.0.255) const]&]
+[s2;%% Returns the number of executions that had to prepare the statement.&]
+[s3;%% &]
+[s4;%% &]
+[s5;:SqlSession`:`:ResetStatementCacheStats`(`): [@(0.0.255) void]_[* ResetStatementCac
+heStats]()&]
+[s2;%% Sets hit and miss counters to zero.&]
+[s3;%% &]
+[s4;%% &]
+[s5;:SqlSession`:`:ClearStatementCache`(`): [@(0.0.255) virtual] [@(0.0.255) void]_[* Cle
+arStatementCache]()&]
+[s2;%% Releases all cached prepared statements.&]
+[s3;%% &]
+[s4;%% &]
+[s5;:SqlSession`:`:ResultCache`(int`,int`): [_^SqlSession^ SqlSession][@(0.0.255) `&]_[* R
+esultCache]([@(0.0.255) int]_[*@3 maxsize]_`=_[@3 4]_`*_[@3 1024]_`*_[@3 1024], 
+[@(0.0.255) int]_[*@3 maxrows]_`=_[@3 1000])&]
+[s2;%% Activates the cache of query results. Only statements marked 
+with SqlSelect`::Cached (or SqlStatement`::Cached) are cached, keyed 
+by compiled statement text and parameters. Rows are stored in the 
+session and subsequent executions are served without accessing 
+the database, until SqlInsert, SqlUpdate or SqlDelete of any table 
+referenced by the statement is executed with Sql of this session. 
+Target table of plain text insert, update and delete statements 
+is detected by simple parsing, other plain text statements that 
+are not queries drop all cached results. Changes done by other 
+sessions are not detected; use InvalidateResultCache or ClearResultCache 
+in that case. [%-*@3 maxsize] is the approximate limit of memory in 
+bytes (least recently used results are discarded first), results 
+with more than [%-*@3 maxrows] rows are not stored; rows are buffered 
+only up to the limit, the rest is fetched directly from the database. 
+Results are 
+not stored while transaction is open (see IsTransactionOpen). 0 [%-*@3 maxsize] 
+disables the cache.&]
+[s3;%% &]
+[s4;%% &]
+[s5;:SqlSession`:`:NoResultCache`(`): [_^SqlSession^ SqlSession][@(0.0.255) `&]_[* NoResul
+tCache]()&]
+[s2;%% Same as ResultCache(0).&]
+[s3;%% &]
+[s4;%% &]
+[s5;:SqlSession`:`:GetResultCacheLimit`(`)const: [@(0.0.255) int]_[* GetResultCacheLimi
+t]()_[@(0.0.255) const]&]
+[s2;%% Returns the memory limit of the result cache.&]
+[s3;%% &]
+[s4;%% &]
+[s5;:SqlSession`:`:GetResultCacheSize`(`)const: [@(0.0.255) int]_[* GetResultCacheSize](
+)_[@(0.0.255) const]&]
+[s2;%% Returns the approximate memory used by cached results.&]
+[s3;%% &]
+[s4;%% &]
+[s5;:SqlSession`:`:GetResultCacheCount`(`)const: [@(0.0.255) int]_[* GetResultCacheCoun
+t]()_[@(0.0.255) const]&]
+[s2;%% Returns the number of cached results.&]
+[s3;%% &]
+[s4;%% &]
+[s5;:SqlSession`:`:GetResultCacheHits`(`)const: [_^int64^ int64]_[* GetResultCacheHits](
+)_[@(0.0.255) const]&]
+[s2;%% Returns the number of executions served from the result cache.&]
+[s3;%% &]
+[s4;%% &]
+[s5;:SqlSession`:`:GetResultCacheMisses`(`)const: [_^int64^ int64]_[* GetResultCacheMis
+ses]()_[@(0.0.255) const]&]
+[s2;%% Returns the number of Cached executions that had to query 
+the database.&]
+[s3;%% &]
+[s4;%% &]
+[s5;:SqlSession`:`:GetResultCacheInvalidations`(`)const: [_^int64^ int64]_[* GetResultC
+acheInvalidations]()_[@(0.0.255) const]&]
+[s2;%% Returns the number of cached results dropped because referenced 
+table was modified.&]
+[s3;%% &]
+[s4;%% &]
+[s5;:SqlSession`:`:ResetResultCacheStats`(`): [@(0.0.255) void]_[* ResetResultCacheStats
+]()&]
+[s2;%% Sets hit, miss and invalidation counters to zero.&]
+[s3;%% &]
+[s4;%% &]
+[s5;:SqlSession`:`:InvalidateResultCache`(const String`&`): [@(0.0.255) void]_[* Invali
+dateResultCache]([@(0.0.255) const]_[_^String^ String][@(0.0.255) `&]_[*@3 table])&]
+[s2;%% Drops all cached results referencing [%-*@3 table].&]
+[s3;%% &]
+[s4;%% &]
+[s5;:SqlSession`:`:ClearResultCache`(`): [@(0.0.255) void]_[* ClearResultCache]()&]
+[s2;%% Drops all cached results. Called when the session is closed.&]
+[s3;%% &]
+[s4;%% &]
+[s5;:SqlSession`:`:HasBulkInsert`(`)const: [@(0.0.255) virtual] [@(0.0.255) bool]_[* Has
+BulkInsert]()_[@(0.0.255) const]&]
+[s2;%% Returns true if BulkInsert is supported by the session.&]
+[s3;%% &]
+[s4;%% &]
+[s5;:SqlSession`:`:BulkInsert`(const String`&`,const Vector`<String`>`&`,const Vector`<Vector`<Value`>`>`&`): [@(0.0.255) v
+irtual] [@(0.0.255) bool]_[* BulkInsert]([@(0.0.255) const]_[_^String^ String][@(0.0.255) `&
+]_[*@3 table], [@(0.0.255) const]_[_^Vector^ Vector]<[_^String^ String]>`&_[*@3 column], 
+[@(0.0.255) const]_[_^Vector^ Vector]<_[_^Vector^ Vector]<[_^Value^ Value]>_>`&_[*@3 row])&]
+[s2;%% Inserts [%-*@3 row] values of [%-*@3 column] to [%-*@3 table] 
+using the fastest method of the database. Default implementation 
+executes multi`-row inserts with parameters (the same statement 
+for each chunk of rows, so it is prepared once with statement 
+cache), PostgreSQL uses COPY in binary format. Returns false on 
+error. Used by SqlMassInsert.&]
+[s3;%% &]
+[s4;%% &]
 [s5;:SqlSession`:`:PerThread`(bool`): [@(0.0.255) static] [@(0.0.255) void]_[* PerThread]([@(0.0.255) b
 ool]_[*@3 b]_`=_[@(0.0.255) true])&]
 [s2;%% In multithreded mode, activates mode where each thread has 
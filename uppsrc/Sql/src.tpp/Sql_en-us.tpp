@@ -65,7 +65,11 @@ tring][@(0.0.255) `&]_[*@3 s])&]
 [s4; &]
 [s5;:Sql`:`:Execute`(const SqlStatement`&`):%- [@(0.0.255) bool]_[* Execute]([@(0.0.255) co
 nst]_[_^SqlStatement^ SqlStatement][@(0.0.255) `&]_[*@3 s])&]
-[s2; Same as SetStatement([%-*@3 s]); return Execute().&]
+[s2; Same as SetStatement([%-*@3 s]); return Execute(). If [%-*@3 s] 
+is marked Cached and SqlSession`::ResultCache is active, the result 
+can be served from the session result cache. If [%-*@3 s] is SqlInsert, 
+SqlUpdate or SqlDelete, cached results referencing modified table 
+are dropped.&]
 [s3; &]
 [s4; &]
 [s5;:Sql`:`:Run`(const Value`&`[`,const Value`&v2`.`.`.`]`):%- [@(0.0.255) bool]_[* Run](
@@ -111,6 +115,15 @@ Fields usually represent some S`_`* table row structure based
 on .sch file.&]
 [s3; &]
 [s4; &]
+[s5;:Sql`:`:FetchBatch`(SqlBatch`&`,int`):%- [@(0.0.255) int]_[* FetchBatch]([_^SqlBatch^ S
+qlBatch][@(0.0.255) `&]_[*@3 batch], [@(0.0.255) int]_[*@3 n]_`=_[@3 4096])&]
+[s2; Fetches up to [%-*@3 n] rows into typed column vectors of [%-*@3 batch] 
+(previous content is discarded). Drivers read numbers and strings 
+directly from their result buffers without creating Value for 
+each cell. Returns the number of rows fetched, 0 when there are 
+no more rows.&]
+[s3; &]
+[s4; &]
 [s5;:Sql`:`:GetRowsProcessed`(`)const:%- [@(0.0.255) int]_[* GetRowsProcessed]()_[@(0.0.255) c
 onst]&]
 [s2; After [/ update] statement, this returns a number of rows that 
@@ -148,7 +148,7 @@ void Pdb::PrettyValueMap_(adr_t a, Pdb::Pretty& p, int64 from, int count)
 
 	Pretty key, value;
 	Val m = MakeVal("Upp::ValueMap::Data", PeekPtr(a));
-	PrettyIndex(GetAttr(m, "key"), { "Upp::Value" }, from, count, key);
+	PrettyIndex(GetAttr(DeRef(GetAttr(m, "shape")), "key"), { "Upp::Value" }, from, count, key);
 	PrettyVector(GetAttr(DeRef(GetAttr(GetAttr(m, "value"), "data")), "data"),
 	             { "Upp::Value" }, from, count, value);
 	PrettyMap(p, key, value);
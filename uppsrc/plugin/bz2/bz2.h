@@ -8,7 +8,9 @@
 #endif
 
 namespace Upp {
-	
+
+INITIALIZE(BZ2Codec);
+
 namespace bz2 {
 	class Lib {
 		enum { NONE, DEFLATE, INFLATE };
@@ -22,6 +24,7 @@ namespace bz2 {
 		bool          error;
 		bool          rdall;
 		bool          eos;
+		bool          instream; // decompression of stream has started but not finished
 		String        out;
 		
 		void          SetError(bool v) { error = v; }
@@ -75,7 +78,7 @@ namespace bz2 {
 		Lib z;
 	
 	public:
-		void Open(Stream& in, bool all = true) { z.Decompress(all); Set(in, z); FilterEof = [=]() -> bool { return z.IsEOS(); }; }
+		void Open(Stream& in, bool all = true);
 		Lib& ChunkSize(int n)                  { return z.ChunkSize(n); }
 	
 		DecompressStream()                             {}
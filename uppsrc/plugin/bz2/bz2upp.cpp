@@ -37,6 +37,7 @@ namespace bz2 {
 		Begin();
 		rdall = all;
 		eos = false;
+		instream = false;
 		if(BZ2_bzDecompressInit(&z, 0, 0) != BZ_OK)
 			Panic("BZ2_bzDecompressInit failed");
 		mode = INFLATE;
@@ -54,6 +55,7 @@ namespace bz2 {
 			z.next_out = output;
 			while (z.avail_in && !IsEOS()) {
 				const int code = BZ2_bzDecompress(&z);
+				instream = code == BZ_OK;
 				const int count = chunk - z.avail_out;
 				if(count) {
 					WhenOut((const char *)~output, count);
@@ -138,6 +140,9 @@ namespace bz2 {
 		LLOG("BZLIB End");
 		if(mode != INFLATE)
 			Pump(true);
+		else
+		if(instream)
+			SetError(true); // truncated input
 		Free();
 	}
 	
@@ -157,6 +162,7 @@ namespace bz2 {
 		SetError(false);
 		rdall = true;
 		eos = false;
+		instream = false;
 		Zero(z);
 	}
 	
@@ -189,6 +195,22 @@ namespace bz2 {
 	{
 		Free();
 	}
+
+	void DecompressStream::Open(Stream& in, bool all)
+	{
+		z.Decompress(all);
+		Set(in, z);
+		FilterEof = [=]() -> bool {
+			if(z.IsError())
+				SetError();
+			return z.IsEOS() || z.IsError();
+		};
+		End = [=] {
+			z.End();
+			if(z.IsError())
+				SetError();
+		};
+	}
 }
 
 void BZ2Decompress(Stream& out, Stream& in, Gate<int, int> progress)
@@ -240,6 +262,24 @@ void BZ2Decompress(Stream& out, Stream& in, Gate<int, int> progress)
 				return;
 			}
 		}
+		if(code == BZ_STREAM_END && (z.avail_in || (running && !in.IsEof())))
+		{ // concatenated streams (e.g. from parallel compressor)
+			char *next_in = z.next_in;
+			unsigned avail_in = z.avail_in;
+			char *next_out = z.next_out;
+			unsigned avail_out = z.avail_out;
+			BZ2_bzDecompressEnd(&z);
+			if(BZ2_bzDecompressInit(&z, 0, 0) != BZ_OK)
+			{
+				out.SetError();
+				return;
+			}
+			z.next_in = next_in;
+			z.avail_in = avail_in;
+			z.next_out = next_out;
+			z.avail_out = avail_out;
+			code = BZ_OK;
+		}
 	}
 	while(code == BZ_OK);
 	if(z.avail_out < BUF_SIZE)
@@ -337,4 +377,28 @@ String BZ2Decompress(const String& data, Gate<int, int> progress)
 	return BZ2Decompress(~data, data.GetLength(), progress);
 }
 
+INITIALIZER(BZ2Codec)
+{
+	StreamCodec c;
+	c.name = "bz2";
+	c.extension = ".bz2";
+	c.default_level = 9;
+	c.block_size = 900 * 1024; // bzip2 block size, larger blocks do not improve ratio
+	c.Detect = [](const byte *h, int len) {
+		return len >= 4 && h[0] == 'B' && h[1] == 'Z' && h[2] == 'h' && h[3] >= '1' && h[3] <= '9';
+	};
+	c.CompressBlock = [](const void *data, int len, int level) {
+		unsigned int sz = len + len / 100 + 600;
+		StringBuffer out(sz);
+		if(BZ2_bzBuffToBuffCompress(~out, &sz, (char *)data, len, minmax(level, 1, 9), 0, 30) != BZ_OK)
+			return String::GetVoid();
+		out.SetCount(sz);
+		return String(out);
+	};
+	c.CreateDecompressStream = [](Stream& in, bool) -> Stream * {
+		return new BZ2DecompressStream(in);
+	};
+	CodecRegistry::Register(c);
+}
+
 }
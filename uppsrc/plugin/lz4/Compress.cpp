@@ -2,12 +2,15 @@
 
 namespace Upp {
 
+void sWriteSeekTable_(Stream& out, const Vector<Tuple<dword, dword>>& frame);
+
 void LZ4CompressStream::Open(Stream& out_)
 {
 	out = &out_;
 	ClearError();
 	pos = 0;
 	xxh.Reset();
+	seektable.Clear();
 	Alloc();
 	pos = 0;
 	byte h[7];
@@ -74,11 +77,14 @@ void LZ4CompressStream::FlushOut()
 		if(clen >= origsize || clen == 0) {
 			out->Put32le(0x80000000 | origsize);
 			out->Put(s, origsize);
+			clen = origsize;
 		}
 		else {
 			out->Put32le(clen);
 			out->Put(t, clen);
 		}
+		if(seekable)
+			seektable.Add(MakeTuple(dword(clen + 4), (dword)origsize));
 		s += BLOCK_BYTES;
 		t += osz;
 	}
@@ -95,6 +101,8 @@ void LZ4CompressStream::Close()
 		FlushOut();
 		out->Put32le(0);
 		out->Put32le(xxh.Finish());
+		if(seekable)
+			sWriteSeekTable_(*out, seektable);
 		out = NULL;
 	}
 }
@@ -137,6 +145,7 @@ LZ4CompressStream::LZ4CompressStream()
 {
 	style = STRM_WRITE;
 	concurrent = false;
+	seekable = false;
 	out = NULL;
 }
 
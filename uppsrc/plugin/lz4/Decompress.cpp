@@ -4,6 +4,8 @@
 
 namespace Upp {
 
+bool sReadSeekTable_(Stream& in, int64 base, Vector<int64>& coffset, Vector<int64>& doffset);
+
 void LZ4DecompressStream::Init()
 {
 	for(int i = 0; i < 16; i++)
@@ -13,6 +15,7 @@ void LZ4DecompressStream::Init()
 	dlen = 0;
 	pos = 0;
 	eof = false;
+	seeked = false;
 	static byte h;
 	ptr = rdlim = buffer = &h;
 	xxh.Reset();
@@ -24,45 +27,106 @@ bool LZ4DecompressStream::Open(Stream& in_)
 	Init();
 
 	in = &in_;
-	String header_data = in->Get(7);
-	if(header_data.GetCount() < 7) {
+	if(!ReadHeader(in->Get32le())) {
 		SetError();
 		return false;
 	}
+	
+	if(!(lz4hdr & LZ4F_BLOCKCHECKSUM) && sReadSeekTable_(*in, in->GetPos(), seek_c, seek_d))
+		style |= STRM_SEEK;
+	else
+		style &= ~STRM_SEEK;
 
-	if(Peek32le(~header_data) != LZ4F_MAGIC) {
-		SetError();
+	return true;
+}
+
+bool LZ4DecompressStream::ReadHeader(dword magic)
+{
+	String header_data = in->Get(3);
+	if(header_data.GetCount() < 3 || magic != LZ4F_MAGIC)
 		return false;
-	}
-	lz4hdr = header_data[4];
-	if((lz4hdr & LZ4F_VERSIONMASK) != LZ4F_VERSION) {
-		SetError();
+	lz4hdr = header_data[0];
+	if((lz4hdr & LZ4F_VERSIONMASK) != LZ4F_VERSION)
 		return false;
-	}
-	if(!(lz4hdr & LZ4F_BLOCKINDEPENDENCE)) { // dependent blocks not supported
-		SetError();
+	if(!(lz4hdr & LZ4F_BLOCKINDEPENDENCE)) // dependent blocks not supported
 		return false;
-	}
-	maxblock = header_data[5];
+	maxblock = header_data[1];
 	maxblock = decode(maxblock & LZ4F_MAXSIZEMASK,
 	                  LZ4F_MAXSIZE_64KB, 1024 * 64,
 	                  LZ4F_MAXSIZE_256KB, 1024 * 256,
 	                  LZ4F_MAXSIZE_1024KB, 1024 * 1024,
 	                  LZ4F_MAXSIZE_4096KB, 1024 * 4096,
 	                  -1);
-	if(maxblock < 0) {
-		SetError();
+	if(maxblock < 0)
 		return false;
-	}
 	
-	if((lz4hdr & LZ4F_CONTENTSIZE) && in->Get(8).GetCount() != 8) {
-		SetError();
+	if((lz4hdr & LZ4F_CONTENTSIZE) && in->Get(8).GetCount() != 8)
 		return false;
-	}
 
+	xxh.Reset();
 	return true;
 }
 
+bool LZ4DecompressStream::NextFrame()
+{ // stream can contain more concatenated frames, skippable frames (like seek table) are ignored
+	for(;;) {
+		if(in->IsEof())
+			return false;
+		dword magic = in->Get32le();
+		if((magic & 0xfffffff0) == 0x184D2A50) {
+			dword len = in->Get32le();
+			if(in->IsEof() && len) {
+				SetError();
+				return false;
+			}
+			in->SeekCur(len);
+		}
+		else
+		if(magic == LZ4F_MAGIC) {
+			if(ReadHeader(magic))
+				return true;
+			SetError();
+			return false;
+		}
+		else
+			return false;
+	}
+}
+
+void LZ4DecompressStream::Seek(int64 p)
+{
+	if(seek_c.GetCount() == 0) { // no seek table, only forward skipping is possible
+		if(p < GetPos())
+			SetError();
+		else
+			while(p > GetPos() && !Ended())
+				Skip((int)min(p - GetPos(), (int64)INT_MAX));
+		return;
+	}
+	p = clamp(p, (int64)0, seek_d.Top());
+	int64 blk = rdlim - buffer;
+	if(p >= pos && p < pos + blk) { // inside the current block
+		ptr = buffer + (p - pos);
+		return;
+	}
+	int n = seek_c.GetCount() - 1;
+	int i = clamp(FindUpperBound(seek_d, p) - 1, 0, n);
+	static byte h;
+	ptr = rdlim = buffer = &h;
+	ii = count = 0;
+	pos = seek_d[i];
+	seeked = true;
+	in->Seek(seek_c[i]);
+	eof = false;
+	Fetch();
+	ptr = min(rdlim, ptr + (p - pos));
+}
+
+int64 LZ4DecompressStream::GetSize() const
+{
+	return seek_d.GetCount() ? seek_d.Top() : Stream::GetSize();
+}
+
 bool LZ4DecompressStream::Next()
 {
 	pos += ptr - buffer;
@@ -102,9 +166,10 @@ void LZ4DecompressStream::Fetch()
 			SetError();
 			return;
 		}
-		if(!t.c) {
+		if(t.size < maxblock) { // next frame can have bigger blocks
 			t.c.Alloc(maxblock);
 			t.d.Alloc(maxblock);
+			t.size = maxblock;
 		}
 		if(blksz & 0x80000000) { // block is not compressed
 			t.dlen = t.clen;
@@ -143,9 +208,9 @@ void LZ4DecompressStream::Fetch()
 		for(int i = 0; i < count; i++)
 			xxh.Put(wb[i].d, wb[i].dlen);
 		if(last) {
-			if(in->Get32le() != xxh.Finish())
+			if((lz4hdr & LZ4F_CONTENTCHECKSUM) && in->Get32le() != xxh.Finish() && !seeked)
 				SetError();
-			eof = true;
+			eof = IsError() || !NextFrame();
 		}
 		Next();
 	}
@@ -0,0 +1,123 @@
+#define LZ4_STATIC_LINKING_ONLY
+#include <Core/lib/lz4.h>
+
+#include "lz4.h"
+
+namespace Upp {
+
+// Record format is the varint encoded original length followed by single raw LZ4 block.
+// LZ4 frame header and checksums would be larger than the whole compressed record.
+
+void LZ4Dictionary::Set(const String& dict)
+{
+	Clear();
+	data = dict.Mid(max(dict.GetLength() - 65536, 0)); // LZ4 window is 64KB
+	if(data.GetCount()) {
+		stream.Alloc(1);
+		LZ4_initStream(~stream, sizeof(LZ4_stream_t));
+		LZ4_loadDict(~stream, ~data, data.GetLength());
+	}
+}
+
+void LZ4Dictionary::Clear()
+{
+	data.Clear();
+	stream.Clear();
+}
+
+static LZ4_stream_t *sInitWork(One<LZ4_stream_t>& work)
+{
+	if(!work) {
+		work.Create();
+		LZ4_initStream(~work, sizeof(LZ4_stream_t));
+	}
+	return ~work;
+}
+
+static String sLZ4CompressRecord(LZ4_stream_t *work, const void *data, int len,
+                                 const LZ4Dictionary& dict, int acceleration)
+{
+	if(len < 0 || len > LZ4_MAX_INPUT_SIZE)
+		return String::GetVoid();
+	StringBuffer out(5 + LZ4_compressBound(len));
+	byte *t = (byte *)~out;
+	dword l = len;
+	while(l >= 0x80) {
+		*t++ = byte(l | 0x80);
+		l >>= 7;
+	}
+	*t++ = byte(l);
+	int hdr = int(t - (byte *)~out);
+	LZ4_resetStream_fast(work);
+	LZ4_attach_dictionary(work, dict.GetStream());
+	int sz = LZ4_compress_fast_continue(work, (const char *)data, (char *)t, len,
+	                                    out.GetCount() - hdr, acceleration);
+	if(sz <= 0 && len)
+		return String::GetVoid();
+	out.SetCount(hdr + sz);
+	return String(out);
+}
+
+static String sLZ4DecompressRecord(const void *data, int len, const LZ4Dictionary& dict)
+{
+	const byte *s = (const byte *)data;
+	const byte *e = s + len;
+	dword l = 0;
+	for(int shift = 0;; shift += 7) {
+		if(s >= e || shift > 28)
+			return String::GetVoid();
+		l |= dword(*s & 0x7f) << shift;
+		if(!(*s++ & 0x80))
+			break;
+	}
+	if(l > (dword)INT_MAX)
+		return String::GetVoid();
+	StringBuffer out(l);
+	int n = LZ4_decompress_safe_usingDict((const char *)s, ~out, int(e - s), l,
+	                                      ~dict.Get(), dict.Get().GetLength());
+	if(n != (int)l)
+		return String::GetVoid();
+	return String(out);
+}
+
+String LZ4CompressRecord(const void *data, int len, const LZ4Dictionary& dict, int acceleration)
+{
+	thread_local One<LZ4_stream_t> work;
+	return sLZ4CompressRecord(sInitWork(work), data, len, dict, acceleration);
+}
+
+String LZ4CompressRecord(const String& s, const LZ4Dictionary& dict, int acceleration)
+{
+	return LZ4CompressRecord(~s, s.GetLength(), dict, acceleration);
+}
+
+String LZ4DecompressRecord(const void *data, int len, const LZ4Dictionary& dict)
+{
+	return sLZ4DecompressRecord(data, len, dict);
+}
+
+String LZ4DecompressRecord(const String& s, const LZ4Dictionary& dict)
+{
+	return LZ4DecompressRecord(~s, s.GetLength(), dict);
+}
+
+Vector<String> CoLZ4CompressRecords(const Vector<String>& data, const LZ4Dictionary& dict, int acceleration)
+{
+	Vector<String> r;
+	r.SetCount(data.GetCount());
+	CoWorkerResources<One<LZ4_stream_t>> work;
+	CoFor(data.GetCount(), [&](int i) {
+		r[i] = sLZ4CompressRecord(sInitWork(work.Get()), ~data[i], data[i].GetLength(), dict, acceleration);
+	});
+	return r;
+}
+
+Vector<String> CoLZ4DecompressRecords(const Vector<String>& data, const LZ4Dictionary& dict)
+{
+	Vector<String> r;
+	r.SetCount(data.GetCount());
+	CoFor(data.GetCount(), [&](int i) { r[i] = LZ4DecompressRecord(data[i], dict); });
+	return r;
+}
+
+};
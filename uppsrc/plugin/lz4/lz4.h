@@ -9,6 +9,8 @@
 
 namespace Upp {
 
+INITIALIZE(LZ4Codec);
+
 enum {
 	LZ4F_MAGIC       = 0x184D2204,
 
@@ -46,6 +48,9 @@ protected:
 	xxHashStream xxh;
 
 	bool          concurrent;
+	bool          seekable;
+	
+	Vector<Tuple<dword, dword>> seektable; // compressed / decompressed size of blocks
     
     void          Alloc();
 	void          Init();
@@ -53,6 +58,7 @@ protected:
 
 public:
 	void Co(bool b = true);
+	void Seekable(bool b = true)                           { seekable = b; }
 	void Open(Stream& out_);
 
 	LZ4CompressStream();
@@ -63,6 +69,8 @@ public:
 class LZ4DecompressStream : public Stream {
 public:
 	virtual   bool  IsOpen() const;
+	virtual   void  Seek(int64 pos);
+	virtual   int64 GetSize() const;
 
 protected:
 	virtual   int   _Term();
@@ -74,8 +82,9 @@ private:
 	struct Workblock {
 		Buffer<char> c, d; // compressed, decompressed data
 		int   clen = 0, dlen = 0; // compressed, decompressed len
+		int   size = 0; // allocated size of c, d
 		
-		void Clear() { c.Clear(); d.Clear(); }
+		void Clear() { c.Clear(); d.Clear(); size = 0; }
 	};
 	Workblock wb[16];
 	int       count; // count of workblocks fetched
@@ -89,12 +98,17 @@ private:
 	int          blockchksumsz;
 	byte         lz4hdr;
 	bool         eof;
+	bool         seeked; // content checksum cannot be checked
 	
 	bool         concurrent;
+	
+	Vector<int64> seek_c, seek_d; // seek table: compressed / decompressed block offsets
 
     void          TryHeader();
 
 	void          Init();
+	bool          ReadHeader(dword magic);
+	bool          NextFrame();
 	bool          Next();
 	void          Fetch();
 	bool          Ended() const { return IsError() || in->IsError() || ptr == rdlim && ii == count && eof; }
@@ -103,6 +117,7 @@ public:
 	bool Open(Stream& in);
 
 	void Co(bool b = true)                                  { concurrent = b; }
+	bool IsSeekable() const                                 { return seek_c.GetCount(); }
 
 	LZ4DecompressStream();
 	LZ4DecompressStream(Stream& in) : LZ4DecompressStream() { Open(in); }
@@ -129,6 +144,30 @@ String CoLZ4Decompress(const String& s, Gate<int64, int64> progress = Null);
 
 bool IsLZ4(Stream& s);
 
+class LZ4Dictionary : NoCopy { // raw content dictionary for small records, last 64KB are used
+	String               data;
+	Buffer<LZ4_stream_t> stream; // dictionary loaded once, attached to per-thread work streams
+
+public:
+	void                Set(const String& dict);
+	void                Clear();
+
+	bool                IsEmpty() const                   { return data.IsEmpty(); }
+	const String&       Get() const                       { return data; }
+	const LZ4_stream_t *GetStream() const                 { return data.GetCount() ? ~stream : NULL; }
+
+	LZ4Dictionary()                                       {}
+	explicit LZ4Dictionary(const String& dict)            { Set(dict); }
+};
+
+String LZ4CompressRecord(const void *data, int len, const LZ4Dictionary& dict, int acceleration = 1);
+String LZ4CompressRecord(const String& s, const LZ4Dictionary& dict, int acceleration = 1);
+String LZ4DecompressRecord(const void *data, int len, const LZ4Dictionary& dict);
+String LZ4DecompressRecord(const String& s, const LZ4Dictionary& dict);
+
+Vector<String> CoLZ4CompressRecords(const Vector<String>& data, const LZ4Dictionary& dict, int acceleration = 1);
+Vector<String> CoLZ4DecompressRecords(const Vector<String>& data, const LZ4Dictionary& dict);
+
 };
 
 #endif
@@ -29,6 +29,16 @@ routines provided by LZ4 author, Yann Collet).&]
 encapsulated, nothing special is required from calling thread.&]
 [s3;%% &]
 [s4;%% &]
+[s5;:Upp`:`:LZ4CompressStream`:`:Seekable`(bool`): [@(0.0.255) void]_[* Seekable]([@(0.0.255) b
+ool]_[*@3 b]_`=_[@(0.0.255) true])&]
+[s2;% When active, seek table with compressed and decompressed sizes 
+of all blocks is appended at the end of output. Table is stored 
+in skippable frame compatible with zstd seekable format, so output 
+is still readable by standard decoders, while LZ4DecompressStream can use 
+it to Seek to any position, decompressing only the blocks covering 
+the requested range. Must be set before Open.&]
+[s3;% &]
+[s4;% &]
 [s5;:Upp`:`:LZ4CompressStream`:`:Open`(Upp`:`:Stream`&`): [@(0.0.255) void]_[* Open]([_^Upp`:`:Stream^ S
 tream][@(0.0.255) `&]_[*@3 out`_])&]
 [s5;:Upp`:`:LZ4CompressStream`:`:LZ4CompressStream`(Upp`:`:Stream`&`): [* LZ4CompressSt
@@ -51,6 +61,15 @@ format compliant streams.&]
 encapsulated, nothing special is required from calling thread.&]
 [s3;%% &]
 [s4; &]
+[s5;:Upp`:`:LZ4DecompressStream`:`:IsSeekable`(`)const: [@(0.0.255) bool]_[* IsSeekable]()
+_[@(0.0.255) const]&]
+[s2;% Returns true if input has seek table (see LZ4CompressStream`::Seekable) 
+and input stream is seekable. In that case GetSize returns the 
+size of decompressed data and Seek repositions to any offset by 
+decompressing only the blocks that cover it. Without seek table, 
+Seek can only skip forward.&]
+[s3;% &]
+[s4;% &]
 [s5;:Upp`:`:LZ4DecompressStream`:`:Open`(Upp`:`:Stream`&`): [@(0.0.255) bool]_[* Open]([_^Upp`:`:Stream^ S
 tream][@(0.0.255) `&]_[*@3 in])&]
 [s5;:Upp`:`:LZ4DecompressStream`:`:LZ4DecompressStream`(Upp`:`:Stream`&`): [* LZ4Decomp
@@ -137,4 +156,86 @@ Seeks back after the check. Returns true if magic number was
 detected.&]
 [s3;%% &]
 [s3;%% &]
+[ {{10000@(113.42.0) [s0;%% [*@7;4 LZ4Dictionary]]}}&]
+[s3; &]
+[s1;:Upp`:`:LZ4Dictionary`:`:class: [@(0.0.255)3 class][3 _][*3 LZ4Dictionary][3 _:_][@(0.0.255)3 p
+rivate][3 _][*@3;3 NoCopy]&]
+[s2;%% Raw content dictionary for compression of small records. LZ4 
+can reference only last 64KB of dictionary, so only that part 
+is kept. Dictionary is loaded into LZ4 state once, compression 
+then just attaches it to the work state of calling thread, so 
+single instance can be shared by any number of threads. Dictionary 
+trained by ZstdTrainDictionary works well here too.&]
+[s3; &]
+[ {{10000F(128)G(128)@1 [s0;%% [* Public Method List]]}}&]
+[s3; &]
+[s5;:Upp`:`:LZ4Dictionary`:`:Set`(const Upp`:`:String`&`): [@(0.0.255) void]_[* Set]([@(0.0.255) c
+onst]_[_^Upp`:`:String^ String][@(0.0.255) `&]_[*@3 dict])&]
+[s2;%% Sets the dictionary content.&]
+[s3;%% &]
+[s4; &]
+[s5;:Upp`:`:LZ4Dictionary`:`:Clear`(`): [@(0.0.255) void]_[* Clear]()&]
+[s2;%% Removes the dictionary.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:LZ4Dictionary`:`:IsEmpty`(`)const: [@(0.0.255) bool]_[* IsEmpty]()_[@(0.0.255) c
+onst]&]
+[s2;%% Returns true if there is no dictionary.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:LZ4Dictionary`:`:Get`(`)const: [@(0.0.255) const]_[_^Upp`:`:String^ String][@(0.0.255) `&
+]_[* Get]()_[@(0.0.255) const]&]
+[s2;%% Returns the dictionary content (at most 64KB).&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:LZ4Dictionary`:`:GetStream`(`)const: [@(0.0.255) const]_[_^LZ4`_stream`_t^ LZ4`_
+stream`_t]_`*[* GetStream]()_[@(0.0.255) const]&]
+[s2;%% Returns LZ4 state with dictionary loaded, NULL if empty.&]
+[s3; &]
+[ {{10000F(128)G(128)@1 [s0;%% [* Constructor detail]]}}&]
+[s3; &]
+[s5;:Upp`:`:LZ4Dictionary`:`:LZ4Dictionary`(const Upp`:`:String`&`): [@(0.0.255) explic
+it]_[* LZ4Dictionary]([@(0.0.255) const]_[_^Upp`:`:String^ String][@(0.0.255) `&]_[*@3 dict])&]
+[s2;%% Same as Set([%-*@3 dict]).&]
+[s3;%% &]
+[ {{10000@(113.42.0) [s0;%% [*@7;4 Record functions]]}}&]
+[s3; &]
+[s5;:Upp`:`:LZ4CompressRecord`(const void`*`,int`,const Upp`:`:LZ4Dictionary`&`,int`): [_^Upp`:`:String^ S
+tring]_[* LZ4CompressRecord]([@(0.0.255) const]_[@(0.0.255) void]_`*[*@3 data], 
+[@(0.0.255) int]_[*@3 len], [@(0.0.255) const]_[_^Upp`:`:LZ4Dictionary^ LZ4Dictionary][@(0.0.255) `&
+]_[*@3 dict], [@(0.0.255) int]_[*@3 acceleration]_`=_[@3 1])&]
+[s5;:Upp`:`:LZ4CompressRecord`(const Upp`:`:String`&`,const Upp`:`:LZ4Dictionary`&`,int`): [_^Upp`:`:String^ S
+tring]_[* LZ4CompressRecord]([@(0.0.255) const]_[_^Upp`:`:String^ String][@(0.0.255) `&]_[*@3 s
+], [@(0.0.255) const]_[_^Upp`:`:LZ4Dictionary^ LZ4Dictionary][@(0.0.255) `&]_[*@3 dict], 
+[@(0.0.255) int]_[*@3 acceleration]_`=_[@3 1])&]
+[s2;%% Compresses small record using dictionary [%-*@3 dict] (which 
+can be empty). Output is not LZ4 frame, but compact format of 
+variable length encoded original size followed by single LZ4 
+block, it has to be decompressed by LZ4DecompressRecord. Higher 
+[%-*@3 acceleration] is faster with worse ratio. Uses work state 
+private to calling thread.&]
+[s3;%% &]
+[s4; &]
+[s5;:Upp`:`:LZ4DecompressRecord`(const void`*`,int`,const Upp`:`:LZ4Dictionary`&`): [_^Upp`:`:String^ S
+tring]_[* LZ4DecompressRecord]([@(0.0.255) const]_[@(0.0.255) void]_`*[*@3 data], 
+[@(0.0.255) int]_[*@3 len], [@(0.0.255) const]_[_^Upp`:`:LZ4Dictionary^ LZ4Dictionary][@(0.0.255) `&
+]_[*@3 dict])&]
+[s5;:Upp`:`:LZ4DecompressRecord`(const Upp`:`:String`&`,const Upp`:`:LZ4Dictionary`&`): [_^Upp`:`:String^ S
+tring]_[* LZ4DecompressRecord]([@(0.0.255) const]_[_^Upp`:`:String^ String][@(0.0.255) `&]_
+[*@3 s], [@(0.0.255) const]_[_^Upp`:`:LZ4Dictionary^ LZ4Dictionary][@(0.0.255) `&]_[*@3 dic
+t])&]
+[s2;%% Decompresses record produced by LZ4CompressRecord with the same 
+dictionary. Returns void String if data are corrupted.&]
+[s3;%% &]
+[s4; &]
+[s5;:Upp`:`:CoLZ4CompressRecords`(const Upp`:`:Vector`<Upp`:`:String`>`&`,const Upp`:`:LZ4Dictionary`&`,int`): [_^Upp`:`:Vector^ V
+ector]<[_^Upp`:`:String^ String]>_[* CoLZ4CompressRecords]([@(0.0.255) const]_[_^Upp`:`:Vector^ V
+ector]<[_^Upp`:`:String^ String]>`&_[*@3 data], [@(0.0.255) const]_[_^Upp`:`:LZ4Dictionary^ L
+Z4Dictionary][@(0.0.255) `&]_[*@3 dict], [@(0.0.255) int]_[*@3 acceleration]_`=_[@3 1])&]
+[s5;:Upp`:`:CoLZ4DecompressRecords`(const Upp`:`:Vector`<Upp`:`:String`>`&`,const Upp`:`:LZ4Dictionary`&`): [_^Upp`:`:Vector^ V
+ector]<[_^Upp`:`:String^ String]>_[* CoLZ4DecompressRecords]([@(0.0.255) const]_[_^Upp`:`:Vector^ V
+ector]<[_^Upp`:`:String^ String]>`&_[*@3 data], [@(0.0.255) const]_[_^Upp`:`:LZ4Dictionary^ L
+Z4Dictionary][@(0.0.255) `&]_[*@3 dict])&]
+[s2;%% Compresses / decompresses a batch of records in parallel.&]
+[s3;%% &]
 [s0;%% ]]
\ No newline at end of file
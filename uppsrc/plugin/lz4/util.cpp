@@ -118,4 +118,23 @@ String CoLZ4Decompress(const String& s, Gate<int64, int64> progress)
 	return CoLZ4Decompress(~s, s.GetLength(), progress);
 }
 
+INITIALIZER(LZ4Codec)
+{
+	StreamCodec c;
+	c.name = "lz4";
+	c.extension = ".lz4";
+	c.Detect = [](const byte *h, int len) {
+		return len >= 4 && Peek32le(h) == LZ4F_MAGIC;
+	};
+	c.CompressBlock = [](const void *data, int len, int) {
+		return LZ4Compress(data, len);
+	};
+	c.CreateDecompressStream = [](Stream& in, bool co) -> Stream * {
+		LZ4DecompressStream *s = new LZ4DecompressStream(in);
+		s->Co(co);
+		return s;
+	};
+	CodecRegistry::Register(c);
+}
+
 };
\ No newline at end of file
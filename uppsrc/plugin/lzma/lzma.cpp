@@ -164,6 +164,7 @@ static SRes Encode(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 file
 
 	LzmaEncProps_Init(&props);
 	props.level = lvl;
+	props.reduceSize = fileSize; // no need for dictionary bigger than input
 	res = LzmaEnc_SetProps(enc, &props);
 
 	if(res == SZ_OK) {
@@ -279,4 +280,158 @@ bool LZMADecompressFile(const char *srcfile, Gate2<int64, int64> progress)
 	return LZMADecompressFile(dstfile, srcfile, progress);
 }
 
+enum { LZMA_HEADER_SIZE = LZMA_PROPS_SIZE + 8, LZMA_OUT_SIZE = 1 << 16 };
+
+struct LZMADecoder::Data {
+	CLzmaDec     state;
+	bool         allocated = false;
+	Byte         header[LZMA_HEADER_SIZE];
+	int          hdrlen = 0; // 0 means that new member can start
+	UInt64       left = 0; // remaining size of member
+	bool         sized = false;
+	int          members = 0;
+	bool         error = false;
+	Buffer<Byte> out;
+
+	void Free() {
+		if(allocated)
+			LzmaDec_Free(&state, &g_Alloc);
+		allocated = false;
+	}
+	~Data() { Free(); }
+};
+
+LZMADecoder::LZMADecoder()
+{
+	Decompress();
+}
+
+LZMADecoder::~LZMADecoder()
+{
+}
+
+void LZMADecoder::Decompress()
+{
+	data.Create();
+}
+
+bool LZMADecoder::IsError() const
+{
+	return data->error;
+}
+
+void LZMADecoder::Put(const void *ptr, int size)
+{
+	Data& d = *data;
+	const Byte *s = (const Byte *)ptr;
+	while(size > 0 && !d.error) {
+		if(d.hdrlen < LZMA_HEADER_SIZE) {
+			int n = min(LZMA_HEADER_SIZE - d.hdrlen, size);
+			memcpy(d.header + d.hdrlen, s, n);
+			d.hdrlen += n;
+			s += n;
+			size -= n;
+			if(d.hdrlen == LZMA_HEADER_SIZE) {
+				d.Free();
+				LzmaDec_Construct(&d.state);
+				if(LzmaDec_Allocate(&d.state, d.header, LZMA_PROPS_SIZE, &g_Alloc) != SZ_OK) {
+					d.error = true;
+					return;
+				}
+				d.allocated = true;
+				LzmaDec_Init(&d.state);
+				d.left = 0;
+				for(int i = 0; i < 8; i++)
+					d.left += (UInt64)d.header[LZMA_PROPS_SIZE + i] << (i * 8);
+				d.sized = d.left != (UInt64)(Int64)-1;
+				d.members++;
+				if(!d.out)
+					d.out.Alloc(LZMA_OUT_SIZE);
+			}
+			continue;
+		}
+		SizeT inlen = size;
+		SizeT outlen = LZMA_OUT_SIZE;
+		ELzmaFinishMode finish = LZMA_FINISH_ANY;
+		if(d.sized && outlen >= d.left) {
+			outlen = (SizeT)d.left;
+			finish = LZMA_FINISH_END;
+		}
+		ELzmaStatus status;
+		SRes res = LzmaDec_DecodeToBuf(&d.state, d.out, &outlen, s, &inlen, finish, &status);
+		s += inlen;
+		size -= (int)inlen;
+		if(res != SZ_OK) {
+			d.error = true;
+			return;
+		}
+		if(outlen) {
+			WhenOut(~d.out, (int)outlen);
+			if(d.sized)
+				d.left -= outlen;
+		}
+		if(d.sized ? d.left == 0 && status != LZMA_STATUS_NEEDS_MORE_INPUT
+		           : status == LZMA_STATUS_FINISHED_WITH_MARK)
+			d.hdrlen = 0; // member is complete, another one can follow
+		else
+		if(inlen == 0 && outlen == 0) {
+			d.error = true;
+			return;
+		}
+	}
+}
+
+void LZMADecoder::End()
+{
+	Data& d = *data;
+	if(d.hdrlen || d.members == 0)
+		d.error = true;
+	d.Free();
+}
+
+void LZMADecompressStream::Open(Stream& in)
+{
+	z.Decompress();
+	Set(in, z);
+	FilterEof = [=] {
+		if(z.IsError())
+			SetError();
+		return z.IsError();
+	};
+	End = [=] {
+		z.End();
+		if(z.IsError())
+			SetError();
+	};
+}
+
+static bool sIsLZMAHeader(const byte *h, int len)
+{ // .lzma has no magic number, check that properties and sizes are sane
+	if(len < LZMA_HEADER_SIZE || h[0] >= 9 * 5 * 5)
+		return false;
+	dword dict = Peek32le(h + 1);
+	if(dict < 4096 || !((dict & (dict - 1)) == 0 || dict % 3 == 0 && ((dict / 3) & (dict / 3 - 1)) == 0 ||
+	                    dict >= (1 << 22) && dict % (1 << 20) == 0))
+		return false;
+	uint64 size = Peek64le(h + 5);
+	return size == (uint64)-1 || size < ((uint64)1 << 48);
+}
+
+INITIALIZER(LZMACodec)
+{
+	StreamCodec c;
+	c.name = "lzma";
+	c.extension = ".lzma";
+	c.default_level = 6;
+	c.block_size = 8 * 1024 * 1024;
+	c.Detect = sIsLZMAHeader;
+	c.CompressBlock = [](const void *data, int len, int level) {
+		return LZMACompress(data, len, false, level);
+	};
+	c.CreateDecompressStream = [](Stream& in, bool) -> Stream * {
+		return new LZMADecompressStream(in);
+	};
+	CodecRegistry::Register(c);
+}
+
 }
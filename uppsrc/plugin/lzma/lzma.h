@@ -5,6 +5,8 @@
 
 namespace Upp {
 
+INITIALIZE(LZMACodec);
+
 int64  LZMACompress(Stream& out, Stream& in, int64 size, Gate2<int64, int64> progress = false, int lvl = 6);
 int64  LZMACompress(Stream& out, Stream& in, Gate2<int64, int64> progress = false, int lvl = 6);
 String LZMACompress(const void *data, int64 len, Gate2<int64, int64> progress = false, int lvl = 6);
@@ -19,6 +21,33 @@ bool   LZMACompressFile(const char *srcfile, Gate2<int64, int64> progress, int l
 bool   LZMADecompressFile(const char *dstfile, const char *srcfile, Gate2<int64, int64> progress = false);
 bool   LZMADecompressFile(const char *srcfile, Gate2<int64, int64> progress);
 
+class LZMADecoder { // incremental decoder, accepts concatenated .lzma streams
+	struct Data;
+	One<Data> data;
+
+public:
+	Event<const void *, int>  WhenOut;
+
+	void Decompress();
+	void Put(const void *ptr, int size);
+	void End();
+	bool IsError() const;
+
+	LZMADecoder();
+	~LZMADecoder();
+};
+
+class LZMADecompressStream : public InFilterStream {
+	LZMADecoder z;
+
+public:
+	void Open(Stream& in);
+
+	LZMADecompressStream()                 {}
+	LZMADecompressStream(Stream& in)       { Open(in); }
+	~LZMADecompressStream()                { Close(); }
+};
+
 }
 
 #endif
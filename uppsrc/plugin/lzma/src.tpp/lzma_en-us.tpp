@@ -89,4 +89,19 @@ DecompressFile]([@(0.0.255) const]_[@(0.0.255) char]_`*[*@3 srcfile],
 present, the name is created by removing .lzma extension to [%-*@3 srcfile]. 
 If [%-*@3 srcfile] does not have .lzma extension, function returns 
 false to signal error and does nothing. Returns true on success.&]
-[s3;%% ]]
\ No newline at end of file
+[s3;%% &]
+[s4;%% &]
+[s5;:LZMADecompressStream`:`:class: [@(0.0.255) class]_[* LZMADecompressStream]_:_[@(0.0.255) p
+ublic]_[*@3 InFilterStream]&]
+[s2;%% Input stream decompressing .lzma data. Unlike LZMADecompress 
+functions, accepts concatenation of several .lzma streams and 
+sets the error if the input is truncated or invalid. Registered 
+as `"lzma`" codec in CodecRegistry.&]
+[s3;%% &]
+[s4;%% &]
+[s5;:LZMADecoder`:`:class: [@(0.0.255) class]_[* LZMADecoder]&]
+[s2;%% Incremental decoder used by LZMADecompressStream. Data are passed 
+by Put, decompressed output is passed to WhenOut. End has to be 
+called after the last data; IsError then reports whether input 
+was complete and valid.&]
+[s3;%% ]]
@@ -28,6 +28,7 @@ public:
 	virtual Vector<String> EnumViews(String database);
 	virtual Vector<SqlColumnInfo> EnumColumns(String database, String table);
 	virtual int            GetTransactionLevel() const;
+	virtual bool           IsTransactionOpen() const;
 
 	// Some opaque structures used by the sqlite3 library
 	typedef struct sqlite3 sqlite3;
@@ -46,15 +47,48 @@ private:
 	String current_dbname;
 	Link<> clink;
 
+	struct CachedStmt : Moveable<CachedStmt> {
+		sqlite3_stmt *stmt; // NULL while used by some Sql
+		int64         lru;
+	};
+	VectorMap<String, CachedStmt> stmt_cache; // prepared statements by statement text
+	int64                         stmt_lru;
+
 	int busy_timeout;
 
+	String password; // to open reader sessions
+	int    cipher;
+	bool   readonly;
+
+	bool   wal;
+	int    synchronous;
+	int64  mmap_size;
+	int    cache_size;
+	bool   temp_store_memory;
+
+	Mutex                               reader_lock;
+	ArrayMap<Thread::Id, Sqlite3Session> reader;
+
+	int    autobatch; // max statements in implicit transaction, 0: off
+	int    autobatch_ms;
+	bool   batch_open;
+	int    batch_count;
+	int    batch_start;
+
 	int SqlExecRetry(const char *sql);
 
+	bool Open0(const char *filename, const String& password, int cipher, bool readonly);
+	void ApplyPragmas();
+	void BatchWrite();
+
 	void Reset();
 	void Cancel();
 
 	int SetDBEncryption(int cipher);
 
+	sqlite3_stmt *GetCachedStmt(const String& statement);
+	void          ReleaseStmt(const String& statement, sqlite3_stmt *stmt);
+
 public:
 	bool IsSee()                                        { return see; };
 	bool IsEncrypted()                                  { return NULL != db && encrypted; };
@@ -71,6 +105,25 @@ public:
 
 	void SetBusyTimeout(int ms)                         { busy_timeout = ms; } //infinite if less than 0
 
+	Sqlite3Session& Wal(bool b = true);
+	Sqlite3Session& Synchronous(int level); // 0 OFF, 1 NORMAL, 2 FULL, 3 EXTRA
+	Sqlite3Session& MmapSize(int64 bytes);
+	Sqlite3Session& CacheSize(int kb);
+	Sqlite3Session& TempStoreMemory(bool b = true);
+	Sqlite3Session& Tuned();
+
+	Sqlite3Session *Reader();
+	void            CloseReader();
+	bool            IsReadOnly() const                  { return readonly; }
+
+	Sqlite3Session& AutoBatch(int statements = 1000, int ms = 200);
+	Sqlite3Session& NoAutoBatch()                       { return AutoBatch(0); }
+	void            FlushBatch();
+	void            FlushDueBatch();
+	bool            IsBatchOpen() const                 { return batch_open; }
+
+	virtual void ClearStatementCache();
+
 	Sqlite3Session();
 	~Sqlite3Session();
 
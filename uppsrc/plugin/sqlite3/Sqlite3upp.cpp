@@ -15,6 +15,7 @@ protected:
 	virtual Value       GetInsertedId() const;
 	virtual bool        Fetch();
 	virtual void        GetColumn(int i, Ref f) const;
+	virtual int         FetchBatch(SqlBatch& batch, int n);
 	virtual void        Cancel();
 	virtual SqlSession& GetSession() const;
 	virtual String      ToString() const;
@@ -61,7 +62,7 @@ void Sqlite3Connection::Cancel()
 //		if (sqlite3_finalize(current_stmt) != SQLITE_OK)
 //			session.SetError(sqlite3_errmsg(db), "Finalizing statement: "+ current_stmt_string, sqlite3_errcode(db));
 		//this seems to be the correct way how to do error recovery...
-		sqlite3_finalize(current_stmt);
+		session.ReleaseStmt(current_stmt_string, current_stmt); // reset and cache or finalize
 		current_stmt = NULL;
 		current_stmt_string.Clear();
 		parse = true;
@@ -151,11 +152,15 @@ bool Sqlite3Connection::Execute() {
 		session.SetError("Empty statement", String("Preparing: ") + statement);
 		return false;
 	}
-	String utf8_stmt = ToCharset(CHARSET_UTF8, statement, CHARSET_DEFAULT);
-	if (SQLITE_OK != sqlite3_prepare(db,utf8_stmt,utf8_stmt.GetLength(),&current_stmt,NULL)) {
-		LLOG("Sqlite3Connection::Compile(" << statement << ") -> error");
-		session.SetError(sqlite3_errmsg(db), String("Preparing: ") + statement, sqlite3_errcode(db));
-		return false;
+	current_stmt = session.GetCachedStmt(statement);
+	if(!current_stmt) {
+		String utf8_stmt = ToCharset(CHARSET_UTF8, statement, CHARSET_DEFAULT);
+		if (SQLITE_OK != sqlite3_prepare_v2(db,utf8_stmt,utf8_stmt.GetLength(),&current_stmt,NULL)) {
+			LLOG("Sqlite3Connection::Compile(" << statement << ") -> error");
+			session.SetError(sqlite3_errmsg(db), String("Preparing: ") + statement, sqlite3_errcode(db));
+			current_stmt = NULL;
+			return false;
+		}
 	}
 	current_stmt_string = statement;
 	int nparams = ParseForArgs(current_stmt_string);
@@ -165,6 +170,10 @@ bool Sqlite3Connection::Execute() {
 	param.Clear();
 	// Make sure that compiling the statement never fails.
 	ASSERT(NULL != current_stmt);
+	if(session.autobatch && !sqlite3_stmt_readonly(current_stmt))
+		session.BatchWrite();
+	else
+		session.FlushDueBatch();
 	int retcode;
 	dword ticks_start = msecs();
 	int sleep_ms = 1;
@@ -320,6 +329,38 @@ void Sqlite3Connection::GetColumn(int i, Ref f) const {
 	return;
 }
 
+int Sqlite3Connection::FetchBatch(SqlBatch& batch, int n)
+{ // reads sqlite3_column_* directly into typed columns, Value only for dates and mixed types
+	int count = 0;
+	while(count < n && Fetch()) {
+		for(int i = 0; i < info.GetCount(); i++) {
+			SqlBatchColumn& c = batch.Column(i);
+			int t = sqlite3_column_type(current_stmt, i);
+			if(t == SQLITE_NULL)
+				c.AddNull();
+			else
+			if(c.type == INT64_V && t == SQLITE_INTEGER)
+				c.i64.Add(sqlite3_column_int64(current_stmt, i));
+			else
+			if(c.type == DOUBLE_V && (t == SQLITE_FLOAT || t == SQLITE_INTEGER))
+				c.dbl.Add(sqlite3_column_double(current_stmt, i));
+			else
+			if(c.type == STRING_V && (t == SQLITE_TEXT || t == SQLITE_BLOB)) {
+				const char *s = t == SQLITE_TEXT ? (const char *)sqlite3_column_text(current_stmt, i)
+				                                 : (const char *)sqlite3_column_blob(current_stmt, i);
+				c.str.Add(String(s, sqlite3_column_bytes(current_stmt, i))); // bytes after text/blob
+			}
+			else {
+				Value v;
+				GetColumn(i, v);
+				c.AddValue(v);
+			}
+		}
+		count++;
+	}
+	return count;
+}
+
 SqlSession& Sqlite3Connection::GetSession() const { return session; }
 String Sqlite3Connection::ToString() const {
 	return statement;
@@ -392,6 +433,10 @@ int Sqlite3Session::CheckDBAccess() {
 }
 
 bool Sqlite3Session::Open(const char* filename, const String& password, int cipher) {
+	return Open0(filename, password, cipher, false);
+}
+
+bool Sqlite3Session::Open0(const char* filename, const String& password, int cipher, bool readonly) {
 	// Only open db once.
 	ASSERT(NULL == db);
 	current_filename = filename;
@@ -399,7 +444,11 @@ bool Sqlite3Session::Open(const char* filename, const String& password, int ciph
 	// However, using the ATTACH sql command, it can connect to more databases.
 	// I don't know how to get the list of attached databases from the API
 	current_dbname = "main";
-	int retcode = sqlite3_open(filename, &db);
+	this->password = password;
+	this->cipher = cipher;
+	this->readonly = readonly;
+	int retcode = readonly ? sqlite3_open_v2(filename, &db, SQLITE_OPEN_READONLY|SQLITE_OPEN_NOMUTEX|SQLITE_OPEN_URI, NULL)
+	                       : sqlite3_open(filename, &db);
 	if(SQLITE_OK == retcode && password.GetCount() > 0) {
 		if(SQLITE_OK == SetDBEncryption(cipher)) {
 			retcode = sqlite3_key(db, password, password.GetCount());
@@ -419,8 +468,10 @@ bool Sqlite3Session::Open(const char* filename, const String& password, int ciph
 	}
 	if(SQLITE_OK == retcode)
 		retcode = CheckDBAccess();
-	if(SQLITE_OK == retcode)
+	if(SQLITE_OK == retcode) {
+		ApplyPragmas();
 		return true;
+	}
 	if(db) {
 		SetError(sqlite3_errstr(retcode), "", retcode, sqlite3_errstr(retcode));
 		sqlite3_close(db);
@@ -431,8 +482,14 @@ bool Sqlite3Session::Open(const char* filename, const String& password, int ciph
 
 void Sqlite3Session::Close() {
 	sql.Clear();
+	{
+		Mutex::Lock __(reader_lock);
+		reader.Clear();
+	}
 	if (NULL != db) {
+		FlushBatch();
 		SessionClose();
+		ClearStatementCache();
 	#ifdef _DEBUG
 		int retval = sqlite3_close(db);
 		// If this function fails, that means that some of the
@@ -470,6 +527,69 @@ int Sqlite3Session::SqlExecRetry(const char *sql)
 	return retcode;
 }
 
+// Statements are prepared with sqlite3_prepare_v2, so cached ones are recompiled by
+// sqlite3_step if the schema changes. Statement is removed from the cache (its slot is
+// set to NULL) while some Sql uses it, other Sql executing the same text prepares its own.
+
+sqlite3_stmt *Sqlite3Session::GetCachedStmt(const String& statement)
+{
+	if(stmt_cache_size <= 0)
+		return NULL;
+	int q = stmt_cache.Find(statement);
+	if(q >= 0 && stmt_cache[q].stmt) {
+		CachedStmt& c = stmt_cache[q];
+		sqlite3_stmt *stmt = c.stmt;
+		c.stmt = NULL;
+		c.lru = ++stmt_lru;
+		stmt_cache_hits++;
+		return stmt;
+	}
+	stmt_cache_misses++;
+	return NULL;
+}
+
+void Sqlite3Session::ReleaseStmt(const String& statement, sqlite3_stmt *stmt)
+{
+	int q = stmt_cache.Find(statement);
+	if(db && stmt_cache_size > 0) {
+		sqlite3_reset(stmt);
+		sqlite3_clear_bindings(stmt);
+		if(q >= 0) {
+			if(stmt_cache[q].stmt)
+				sqlite3_finalize(stmt); // the same statement was used by two Sqls at once
+			else
+				stmt_cache[q].stmt = stmt;
+			return;
+		}
+		while(stmt_cache.GetCount() >= stmt_cache_size) { // evict least recently used
+			int mi = -1;
+			for(int i = 0; i < stmt_cache.GetCount(); i++)
+				if(stmt_cache[i].stmt && (mi < 0 || stmt_cache[i].lru < stmt_cache[mi].lru))
+					mi = i;
+			if(mi < 0)
+				break;
+			sqlite3_finalize(stmt_cache[mi].stmt);
+			stmt_cache.Remove(mi);
+		}
+		CachedStmt& c = stmt_cache.Add(statement);
+		c.stmt = stmt;
+		c.lru = ++stmt_lru;
+		return;
+	}
+	if(q >= 0 && !stmt_cache[q].stmt)
+		stmt_cache.Remove(q);
+	sqlite3_finalize(stmt);
+}
+
+void Sqlite3Session::ClearStatementCache()
+{
+	for(int i = stmt_cache.GetCount() - 1; i >= 0; i--)
+		if(stmt_cache[i].stmt) {
+			sqlite3_finalize(stmt_cache[i].stmt);
+			stmt_cache.Remove(i);
+		}
+}
+
 void Sqlite3Session::Reset()
 {
 	for(Link<> *s = clink.GetNext(); s != &clink; s = s->GetNext())
@@ -482,11 +602,188 @@ void Sqlite3Session::Cancel()
 		((Sqlite3Connection *)s)->Cancel();
 }
 
+void Sqlite3Session::ApplyPragmas()
+{
+	if(!db)
+		return;
+	String pragma;
+	if(wal && !readonly)
+		pragma << "PRAGMA journal_mode=WAL;";
+	if(!IsNull(synchronous) && !readonly)
+		pragma << "PRAGMA synchronous=" << synchronous << ';';
+	if(!IsNull(mmap_size))
+		pragma << "PRAGMA mmap_size=" << mmap_size << ';';
+	if(!IsNull(cache_size))
+		pragma << "PRAGMA cache_size=" << -cache_size << ';'; // negative value is in KiB
+	if(temp_store_memory)
+		pragma << "PRAGMA temp_store=MEMORY;";
+	if(pragma.GetCount() && SQLITE_OK != SqlExecRetry(pragma))
+		SetError(sqlite3_errmsg(db), pragma, sqlite3_errcode(db), sqlite3_errstr(sqlite3_errcode(db)));
+}
+
+Sqlite3Session& Sqlite3Session::Wal(bool b)
+{
+	if(db && !readonly && wal && !b)
+		SqlExecRetry("PRAGMA journal_mode=DELETE;");
+	wal = b;
+	ApplyPragmas();
+	return *this;
+}
+
+Sqlite3Session& Sqlite3Session::Synchronous(int level)
+{
+	synchronous = level;
+	ApplyPragmas();
+	return *this;
+}
+
+Sqlite3Session& Sqlite3Session::MmapSize(int64 bytes)
+{
+	mmap_size = bytes;
+	ApplyPragmas();
+	return *this;
+}
+
+Sqlite3Session& Sqlite3Session::CacheSize(int kb)
+{
+	cache_size = kb;
+	ApplyPragmas();
+	return *this;
+}
+
+Sqlite3Session& Sqlite3Session::TempStoreMemory(bool b)
+{
+	temp_store_memory = b;
+	ApplyPragmas();
+	return *this;
+}
+
+Sqlite3Session& Sqlite3Session::Tuned()
+{
+	wal = true;
+	synchronous = 1; // NORMAL is safe in WAL mode, only last transactions can be lost on power failure
+	mmap_size = 256 * 1024 * 1024;
+	cache_size = 64 * 1024;
+	temp_store_memory = true;
+	ApplyPragmas();
+	return *this;
+}
+
+// Reader sessions are read-only connections to the same file, one per thread. In WAL mode
+// they run SELECTs concurrently with the writer and with each other (connection opened with
+// sqlite3_open shares single mutex for all statements). Returns NULL if reader cannot be
+// opened (error is set in this session), this for databases private to this connection.
+
+Sqlite3Session *Sqlite3Session::Reader()
+{
+	if(!db)
+		return NULL;
+	if(readonly || current_filename.IsEmpty() || current_filename == ":memory:" ||
+	   current_filename.StartsWith("file::memory:"))
+		return this;
+	Mutex::Lock __(reader_lock);
+	Thread::Id id = Thread::GetCurrentId();
+	int q = reader.Find(id);
+	if(q >= 0)
+		return &reader[q];
+	Sqlite3Session& r = reader.Add(id);
+	r.busy_timeout = busy_timeout;
+	r.mmap_size = mmap_size;
+	r.cache_size = cache_size;
+	r.temp_store_memory = temp_store_memory;
+	r.StatementCache(GetStatementCacheSize());
+	r.ThrowOnError(IsThrowOnError());
+	if(IsUseRealcase())
+		r.UseRealcase();
+	if(!r.Open0(current_filename, password, cipher, true)) {
+		SetError(r.GetLastError(), "Opening reader: " + current_filename, r.GetErrorCode());
+		reader.Drop();
+		return NULL;
+	}
+	return &r;
+}
+
+void Sqlite3Session::CloseReader()
+{
+	Mutex::Lock __(reader_lock);
+	int q = reader.Find(Thread::GetCurrentId());
+	if(q >= 0)
+		reader.Remove(q);
+}
+
+// AutoBatch wraps writes executed outside of explicit transaction into implicit one, which is
+// committed before the write that exceeds statement count, by any statement executed after
+// the time limit, by FlushBatch, Begin or Close. Without statements, the time limit is only
+// checked by FlushDueBatch, call it when the session is idle (e.g. from timer).
+// Other connections (including readers) see the changes after commit.
+
+Sqlite3Session& Sqlite3Session::AutoBatch(int statements, int ms)
+{
+	autobatch = max(statements, 0);
+	autobatch_ms = ms;
+	if(!autobatch)
+		FlushBatch();
+	return *this;
+}
+
+void Sqlite3Session::BatchWrite()
+{
+	if(batch_open && batch_count >= autobatch)
+		FlushBatch();
+	FlushDueBatch();
+	if(!batch_open && sqlite3_get_autocommit(db)) {
+		static const char begin[] = "BEGIN;";
+		if(trace)
+			*trace << begin << "\n";
+		if(SQLITE_OK != SqlExecRetry(begin)) {
+			SetError(sqlite3_errmsg(db), begin, sqlite3_errcode(db), sqlite3_errstr(sqlite3_errcode(db)));
+			return;
+		}
+		batch_open = true;
+		batch_count = 0;
+		batch_start = msecs();
+	}
+	if(batch_open)
+		batch_count++;
+}
+
+void Sqlite3Session::FlushBatch()
+{
+	if(!batch_open)
+		return;
+	static const char commit[] = "COMMIT;";
+	if(trace)
+		*trace << commit << "\n";
+	if(SQLITE_OK == SqlExecRetry(commit))
+		batch_open = false;
+	else // e.g. busy, batch stays open and commit is retried later
+		SetError(sqlite3_errmsg(db), commit, sqlite3_errcode(db), sqlite3_errstr(sqlite3_errcode(db)));
+}
+
+void Sqlite3Session::FlushDueBatch()
+{
+	if(batch_open && (int)(msecs() - batch_start) >= autobatch_ms)
+		FlushBatch();
+}
+
 Sqlite3Session::Sqlite3Session()
 {
 	db = NULL;
 	Dialect(SQLITE3);
 	busy_timeout = 0;
+	stmt_lru = 0;
+	cipher = CIPHER_CHAHA2020_SQLEET;
+	readonly = false;
+	wal = false;
+	synchronous = Null;
+	mmap_size = Null;
+	cache_size = Null;
+	temp_store_memory = false;
+	autobatch = 0;
+	autobatch_ms = 0;
+	batch_open = false;
+	batch_count = batch_start = 0;
+	StatementCache(64);
 	see = true;
 	encrypted = false;
 }
@@ -497,6 +794,7 @@ Sqlite3Session::~Sqlite3Session()
 }
 
 void Sqlite3Session::Begin() {
+	FlushBatch();
 	static const char begin[] = "BEGIN;";
 	if(trace)
 		*trace << begin << "\n";
@@ -506,6 +804,7 @@ void Sqlite3Session::Begin() {
 }
 
 void Sqlite3Session::Commit() {
+	batch_open = false;
 	Cancel();
 	static const char commit[] = "COMMIT;";
 	if(trace)
@@ -516,6 +815,7 @@ void Sqlite3Session::Commit() {
 }
 
 void Sqlite3Session::Rollback() {
+	batch_open = false;
 	Cancel();
 	static const char rollback[] = "ROLLBACK;";
 	if(trace)
@@ -558,7 +858,12 @@ Vector<String> Sqlite3Session::EnumViews(String database) {
 int Sqlite3Session::GetTransactionLevel() const
 {
 	int autocommit = sqlite3_get_autocommit(db);
-	return (autocommit ? 0 : 1);
+	return (autocommit || batch_open ? 0 : 1); // AutoBatch transaction is not reported
+}
+
+bool Sqlite3Session::IsTransactionOpen() const
+{
+	return db && !sqlite3_get_autocommit(db); // including AutoBatch
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -7,6 +7,7 @@ void UnZip::ReadDir()
 	error = true;
 	
 	file.Clear();
+	index.Clear();
 	current = 0;
 
 	int64 entries = -1;
@@ -82,15 +83,30 @@ void UnZip::ReadDir()
 			return; // Multiple disks not supported
 		zip->Get16le(); // internal file attributes
 		zip->Get32le(); // external file attributes
-		f.offset = zip->Get32le();
+		f.offset = (dword)zip->Get32le();
 		f.path = zip->Get(fnlen);
 		int64 skipto = zip->GetPos() + extralen + commentlen;
-		if(extralen>=4 && zip->Get16le()==1){ // ZIP64 extra field : header ID
-			int bytes = zip->Get16le(); // ZIP64 extra field : bytes to follow
-			if(bytes>=8) f.usize = zip->Get64le(); // ZIP64 extra field : uncomp size
-			if(bytes>=16) f.csize = zip->Get64le(); // ZIP64 extra field : comp size
-			if(bytes>=24) f.offset = zip->Get64le(); // ZIP64 extra field : relative offset of local header
+		int64 extraend = zip->GetPos() + extralen;
+		while(zip->GetPos() + 4 <= extraend) {
+			int id = zip->Get16le(); // extra field : header ID
+			int bytes = zip->Get16le(); // extra field : bytes to follow
+			int64 next = zip->GetPos() + bytes;
+			if(id == 1) { // ZIP64 extra field, only values that overflowed the 32-bit fields are present
+				if(f.usize == 0xffffffff && bytes >= 8) {
+					f.usize = zip->Get64le();
+					bytes -= 8;
+				}
+				if(f.csize == 0xffffffff && bytes >= 8) {
+					f.csize = zip->Get64le();
+					bytes -= 8;
+				}
+				if(f.offset == 0xffffffff && bytes >= 8)
+					f.offset = zip->Get64le();
+				break;
+			}
+			zip->Seek(next);
 		}
+		index.Add(f.path);
 		
 		zip->Seek(skipto);
 		if(zip->IsEof() || zip->IsError())
@@ -115,31 +131,27 @@ Time UnZip::GetZipTime(dword dt)
 int64 zPress(Stream& out, Stream& in, int64 size, Gate<int64, int64> progress, bool gzip,
              bool compress, dword *crc, bool hdr);
 
-bool UnZip::ReadFile(Stream& out, Gate<int, int> progress)
+int64 UnZip::GetDataPos(Stream& in, const File& f)
+{
+	in.Seek(f.offset);
+	if(in.Get32le() != 0x04034b50)
+		return -1;
+	in.Get16le();
+	in.Get16le(); // Skip header, use info from centrall dir
+	in.Get16le();
+	in.Get32le();
+	in.Get32le();
+	in.Get32le();
+	in.Get32le();
+	dword filelen = in.Get16le();
+	dword extralen = in.Get16le();
+	if(in.IsEof() || in.IsError())
+		return -1;
+	return in.GetPos() + filelen + extralen;
+}
+
+bool UnZip::Decode(Stream& in, const File& f, Stream& out, Gate<int, int> progress)
 {
-	if(error)
-		return false;
-	if(IsFolder()) {
-		current++;
-		return true;
-	}
-	error = true;
-	if(current >= file.GetCount())
-		return false;
-	const File& f = file[current];
-	zip->Seek(f.offset);
-	if(zip->Get32le() != 0x04034b50)
-		return false;
-	zip->Get16le();
-	zip->Get16le(); // Skip header, use info from centrall dir
-	zip->Get16le();
-	zip->Get32le();
-	zip->Get32le();
-	zip->Get32le();
-	zip->Get32le();
-	dword filelen = zip->Get16le();
-	dword extralen = zip->Get16le();
-	zip->SeekCur(filelen + extralen);
 	dword crc;
 	qword l;
 	if(f.method == 0) {
@@ -147,7 +159,7 @@ bool UnZip::ReadFile(Stream& out, Gate<int, int> progress)
 		int loaded;
 		int64 count = f.csize;
 		Crc32Stream crc32;
-		while(count > 0 && (loaded = zip->Get(temp, (int)min<int64>(count, 65536))) > 0) {
+		while(count > 0 && (loaded = in.Get(temp, (int)min<int64>(count, 65536))) > 0) {
 			out.Put(temp, loaded);
 			crc32.Put(temp, loaded);
 			count -= loaded;
@@ -159,10 +171,61 @@ bool UnZip::ReadFile(Stream& out, Gate<int, int> progress)
 	}
 	else
 	if(f.method == 8)
-		l = zPress(out, *zip, f.csize, AsGate64(progress), false, false, &crc, false);
+		l = zPress(out, in, f.csize, AsGate64(progress), false, false, &crc, false);
 	else
 		return false;
-	if(crc != f.crc || l != f.usize)
+	return crc == f.crc && l == f.usize;
+}
+
+bool UnZip::Extract(int i, Stream& out, Gate<int, int> progress)
+{
+	ASSERT(i >= 0 && i < file.GetCount());
+	const File& f = file[i];
+	if(IsFolder(i))
+		return true;
+	if(base) {
+		MemReadStream in(base, base_size);
+		int64 pos = GetDataPos(in, f);
+		if(pos < 0 || pos + (int64)f.csize > base_size)
+			return false;
+		in.Seek(pos);
+		return Decode(in, f, out, progress);
+	}
+	String raw;
+	{
+		Mutex::Lock __(lock);
+		int64 pos = GetDataPos(*zip, f);
+		if(pos < 0)
+			return false;
+		zip->Seek(pos);
+		if(f.csize > 16 * 1024 * 1024) // too big to buffer, decompress under the lock
+			return Decode(*zip, f, out, progress);
+		raw = zip->Get((int)f.csize);
+		if(raw.GetCount() != (int)f.csize)
+			return false;
+	}
+	StringStream in(raw);
+	return Decode(in, f, out, progress);
+}
+
+String UnZip::Extract(int i, Gate<int, int> progress)
+{
+	StringStream ss;
+	return Extract(i, ss, progress) ? ss.GetResult() : String::GetVoid();
+}
+
+bool UnZip::ReadFile(Stream& out, Gate<int, int> progress)
+{
+	if(error)
+		return false;
+	if(IsFolder()) {
+		current++;
+		return true;
+	}
+	error = true;
+	if(current >= file.GetCount())
+		return false;
+	if(!Extract(current, out, progress))
 		return false;
 	current++;
 	error = false;
@@ -177,18 +240,91 @@ String UnZip::ReadFile(Gate<int, int> progress)
 
 String UnZip::ReadFile(const char *path, Gate<int, int> progress)
 {
-    for(int i = 0; i < file.GetCount(); i++)
-        if(file[i].path == path) {
-            Seek(i);
-            return ReadFile(progress);
-        }
+	int i = Find(path);
+	if(i < 0)
+		return String::GetVoid();
+	Seek(i);
+	return ReadFile(progress);
+}
 
-    return String::GetVoid();
+bool UnZip::CoDo(Function<bool (int)> fn, Gate<int, int> progress)
+{
+	if(error)
+		return false;
+	Vector<int> order; // biggest entries first for better load balancing
+	for(int i = 0; i < file.GetCount(); i++)
+		if(IsFile(i))
+			order.Add(i);
+	Sort(order, [&](int a, int b) { return file[a].csize > file[b].csize; });
+	std::atomic<bool> failed(false);
+	int done = 0;
+	int n = order.GetCount();
+	CoWork co;
+	for(int i : order)
+		co & [=, &fn, &failed, &done] {
+			if(failed)
+				return;
+			if(!fn(i))
+				failed = true;
+			if(progress) {
+				CoWork::FinLock();
+				if(progress(++done, n))
+					failed = true;
+			}
+		};
+	co.Finish();
+	return !failed;
+}
+
+bool UnZip::CoRead(Event<int, const String&> fn, Gate<int, int> progress)
+{
+	return CoDo([&](int i) {
+		String data = Extract(i);
+		if(data.IsVoid())
+			return false;
+		fn(i, data);
+		return true;
+	}, progress);
+}
+
+bool UnZip::CoExtract(const char *dir, Gate<int, int> progress)
+{
+	if(error)
+		return false;
+	auto GetTarget = [&](int i) -> String {
+		String path = GetPath(i);
+		for(const String& s : Split(path, [](int c) -> int { return c == '/' || c == '\\'; }))
+			if(s == "..")
+				return Null; // do not allow escaping the target directory
+		if(*path == '/' || *path == '\\' || path.Find(':') >= 0)
+			return Null; // absolute or drive qualified path (C:\x, C:x)
+		return AppendFileName(dir, path);
+	};
+	for(int i = 0; i < file.GetCount(); i++)
+		if(IsFolder(i)) {
+			String p = GetTarget(i);
+			if(IsNull(p) || !RealizeDirectory(p))
+				return false;
+		}
+	return CoDo([&](int i) {
+		String p = GetTarget(i);
+		if(IsNull(p) || !RealizePath(p))
+			return false;
+		FileOut out(p);
+		if(!out || !Extract(i, out))
+			return false;
+		out.Close();
+		if(out.IsError())
+			return false;
+		SetFileTime(p, TimeToFileTime(GetTime(i)));
+		return true;
+	}, progress);
 }
 
 void UnZip::Create(Stream& _zip)
 {
 	zip = &_zip;
+	base = NULL;
 	ReadDir();
 }
 
@@ -201,6 +337,7 @@ UnZip::UnZip()
 {
 	error = true;
 	zip = NULL;
+	base = NULL;
 }
 
 UnZip::~UnZip() {}
@@ -14,12 +14,25 @@ void MemUnZip::Create(const void *ptr, int count)
 {
 	zip.Create(ptr, count);
 	UnZip::Create(zip);
+	SetBase(ptr, count);
+}
+
+bool MappedUnZip::Create(const char *name)
+{
+	if(!map.Open(name) || !map.Map())
+		return false;
+	zip.Create(~map, map.GetFileSize());
+	UnZip::Create(zip);
+	SetBase(~map, map.GetFileSize());
+	return true;
 }
 
 void StringUnZip::Create(const String& s)
 {
-	zip.Open(s);
+	data = s;
+	zip.Open(data);
 	UnZip::Create(zip);
+	SetBase(~data, data.GetCount());
 }
 
 }
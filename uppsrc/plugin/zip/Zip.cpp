@@ -56,7 +56,7 @@ void Zip::BeginFile(const char *path, Time tm, bool deflate, bool zip64)
 	if(deflate) {
 		pipeZLib.Create();
 		pipeZLib->WhenOut = THISBACK(PutCompressed);
-		pipeZLib->GZip(false).CRC().NoHeader().Compress();
+		pipeZLib->GZip(false).CRC().NoHeader().Co(concurrent).Compress();
 	}
 	else {
 		crc32.Clear();
@@ -274,6 +274,7 @@ Zip::Zip()
 	done = 0;
 	zip = NULL;
 	uncompressed = false;
+	concurrent = false;
 }
 
 Zip::Zip(Stream& out)
@@ -281,6 +282,7 @@ Zip::Zip(Stream& out)
 	done = 0;
 	zip = NULL;
 	uncompressed = false;
+	concurrent = false;
 	Create(out);
 }
 
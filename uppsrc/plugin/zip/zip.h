@@ -17,14 +17,24 @@ class UnZip {
 		int64  offset;
 	};
 	
-	Stream      *zip;
-	bool         error;
-	Vector<File> file;
-	int          current;
+	Stream       *zip;
+	const byte   *base; // whole archive in memory, allows lock-free concurrent extraction
+	int64         base_size;
+	bool          error;
+	Vector<File>  file;
+	Index<String> index;
+	int           current;
+	Mutex         lock; // serializes access to zip if there is no base
 
 	void   ReadDir();
+	bool   CoDo(Function<bool (int)> fn, Gate<int, int> progress);
 
 	static Time   GetZipTime(dword time);
+	static int64  GetDataPos(Stream& in, const File& f);
+	static bool   Decode(Stream& in, const File& f, Stream& out, Gate<int, int> progress);
+
+protected:
+	void   SetBase(const void *ptr, int64 size) { base = (const byte *)ptr; base_size = size; }
 
 public:
 	bool   IsEof() const          { return current >= file.GetCount(); }
@@ -38,8 +48,11 @@ public:
 	bool   IsFolder(int i) const  { return *file[i].path.Last() == '/'; }
 	bool   IsFile(int i) const    { return !IsFolder(i); }
 	int64  GetLength(int i) const { return file[i].usize; }
+	int64  GetCompressedLength(int i) const { return file[i].csize; }
 	Time   GetTime(int i) const   { return GetZipTime(file[i].time); }
 
+	int    Find(const char *path) const { return index.Find(path); }
+
 	void   Seek(int i)            { ASSERT(i >= 0 && i < file.GetCount()); current = i; }
 
 	bool   IsFolder() const       { return IsFolder(current); }
@@ -55,8 +68,14 @@ public:
 
 	String ReadFile(const char *path, Gate<int, int> progress = Null);
 
+	bool   Extract(int i, Stream& out, Gate<int, int> progress = Null);
+	String Extract(int i, Gate<int, int> progress = Null);
+
+	bool   CoRead(Event<int, const String&> fn, Gate<int, int> progress = Null);
+	bool   CoExtract(const char *dir, Gate<int, int> progress = Null);
+
 	void   Create(Stream& in);
-	void   Close()                { file.Clear(); zip->Close(); }
+	void   Close()                { file.Clear(); index.Clear(); zip->Close(); base = NULL; }
 
 	UnZip(Stream& in);
 	UnZip();
@@ -83,7 +102,19 @@ public:
 	MemUnZip();
 };
 
+class MappedUnZip : public UnZip {
+	FileMapping map;
+	MemReadStream zip;
+
+public:
+	bool Create(const char *name);
+
+	MappedUnZip(const char *name)               { Create(name); }
+	MappedUnZip()                               {}
+};
+
 class StringUnZip : public UnZip {
+	String       data;
 	StringStream zip;
 
 public:
@@ -115,6 +146,7 @@ class Zip {
 	One<Zlib> pipeZLib;
 	Crc32Stream crc32; // for uncompressed files
 	bool        uncompressed;
+	bool        concurrent;
 
 	void WriteFile0(const void *ptr, int size, const char *path, Gate<int, int> progress, Time tm, int method);
 
@@ -144,6 +176,8 @@ public:
 	bool IsError()                           { return zip && zip->IsError(); }
 
 	qword  GetLength() const                 { return done; }
+
+	void   Co(bool b = true)                 { concurrent = b; }
 	
 	Zip();
 	Zip(Stream& out);
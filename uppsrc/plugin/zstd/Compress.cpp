@@ -5,12 +5,15 @@ namespace Upp {
 // we simply store data as series of complete Zstd frames, as library gives us no easy way
 // to do it in MT
 
+void sWriteSeekTable_(Stream& out, const Vector<Tuple<dword, dword>>& frame);
+
 void ZstdCompressStream::Open(Stream& out_, int level_)
 {
 	out = &out_;
 	level = level_;
 	ClearError();
 	pos = 0;
+	seektable.Clear();
 	Alloc();
 }
 
@@ -59,6 +62,7 @@ void ZstdCompressStream::FlushOut()
 		co.Finish();
 	
 	t = ~outbuf;
+	byte *s = ~buffer;
 	for(int i = 0; i < ii; i++) {
 		int clen = outsz[i];
 		if(clen < 0) {
@@ -66,7 +70,10 @@ void ZstdCompressStream::FlushOut()
 			return;
 		}
 		out->Put(t, clen);
+		if(seekable)
+			seektable.Add(MakeTuple((dword)clen, (dword)min((int)BLOCK_BYTES, int(ptr - s))));
 		t += osz;
+		s += BLOCK_BYTES;
 	}
 	
 	int origsize = int(ptr - ~buffer);
@@ -78,6 +85,8 @@ void ZstdCompressStream::Close()
 {
 	if(out) {
 		FlushOut();
+		if(seekable)
+			sWriteSeekTable_(*out, seektable);
 		out = NULL;
 	}
 }
@@ -120,6 +129,7 @@ ZstdCompressStream::ZstdCompressStream()
 {
 	style = STRM_WRITE;
 	concurrent = false;
+	seekable = false;
 	out = NULL;
 }
 
@@ -4,6 +4,8 @@
 
 namespace Upp {
 
+bool sReadSeekTable_(Stream& in, int64 base, Vector<int64>& coffset, Vector<int64>& doffset);
+
 void ZstdDecompressStream::Init()
 {
 	for(int i = 0; i < 16; i++)
@@ -17,6 +19,7 @@ void ZstdDecompressStream::Init()
 	ptr = rdlim = buffer = &h;
 	compressed_data.Clear();
 	compressed_at = 0;
+	cframe = 0;
 	ClearError();
 }
 
@@ -24,9 +27,51 @@ bool ZstdDecompressStream::Open(Stream& in_)
 {
 	Init();
 	in = &in_;
+	if(sReadSeekTable_(*in, in->GetPos(), seek_c, seek_d))
+		style |= STRM_SEEK;
+	else
+		style &= ~STRM_SEEK;
 	return true;
 }
 
+void ZstdDecompressStream::Seek(int64 p)
+{
+	if(seek_c.GetCount() == 0) { // no seek table, only forward skipping is possible
+		if(p < GetPos())
+			SetError();
+		else
+			while(p > GetPos() && !Ended())
+				Skip((int)min(p - GetPos(), (int64)INT_MAX));
+		return;
+	}
+	p = clamp(p, (int64)0, seek_d.Top());
+	int64 blk = rdlim - buffer;
+	if(p >= pos && p < pos + blk) { // inside the current block
+		ptr = buffer + (p - pos);
+		return;
+	}
+	int n = seek_c.GetCount() - 1;
+	int i = clamp(FindUpperBound(seek_d, p) - 1, 0, n);
+	static byte h;
+	ptr = rdlim = buffer = &h;
+	ii = count = 0;
+	compressed_data.Clear();
+	compressed_at = 0;
+	cframe = i;
+	pos = seek_d[i];
+	eof = i >= n;
+	if(eof)
+		return;
+	in->Seek(seek_c[i]);
+	Fetch();
+	ptr = min(rdlim, ptr + (p - pos));
+}
+
+int64 ZstdDecompressStream::GetSize() const
+{
+	return seek_d.GetCount() ? seek_d.Top() : Stream::GetSize();
+}
+
 bool ZstdDecompressStream::Next()
 {
 	pos += ptr - buffer;
@@ -54,6 +99,12 @@ void ZstdDecompressStream::Fetch()
 	for(int i = 0; i < count; i++) {
 		Workblock& w = wb[i];
 		
+		if(seek_c.GetCount() && cframe >= seek_c.GetCount() - 1) { // only seek table is left
+			eof = true;
+			count = i;
+			goto eof;
+		}
+		
 		size_t frameSize;
 		for(;;) {
 			int sz = compressed_data.GetCount() - compressed_at;
@@ -72,9 +123,16 @@ void ZstdDecompressStream::Fetch()
 				count = i;
 				goto eof;
 			}
-			StringBuffer b(sz + count * BLOCK_BYTES);
+			int n = count * BLOCK_BYTES;
+			if(seek_c.GetCount()) // read just frames we need
+				n = int(seek_c[min(cframe + count - i, seek_c.GetCount() - 1)] - seek_c[cframe] - sz);
+			if(n <= 0) {
+				SetError();
+				return;
+			}
+			StringBuffer b(sz + n);
 			memcpy(~b, at, sz);
-			b.SetCount(sz + in->Get(~b + sz, count * BLOCK_BYTES));
+			b.SetCount(sz + in->Get(~b + sz, n));
 			compressed_data = b;
 			compressed_at = 0;
 		}
@@ -89,6 +147,7 @@ void ZstdDecompressStream::Fetch()
 		w.frame_sz = (int)frameSize;
 		
 		compressed_at += w.frame_sz;
+		cframe++;
 		
 		uint64 sz = ZSTD_getFrameContentSize(w.FramePtr(), w.frame_sz);
 		if(sz == ZSTD_CONTENTSIZE_ERROR || sz > 1024*1024*1024) {
@@ -181,6 +240,7 @@ ZstdDecompressStream::ZstdDecompressStream()
 	style = STRM_READ|STRM_LOADING;
 	in = NULL;
 	concurrent = false;
+	cframe = 0;
 }
 
 ZstdDecompressStream::~ZstdDecompressStream()
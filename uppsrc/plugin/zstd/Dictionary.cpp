@@ -0,0 +1,195 @@
+#include "zstd.h"
+#include "lib/zdict.h"
+
+namespace Upp {
+
+// Small records (few KB) compress poorly on their own, as there is not enough history to
+// find matches in. Dictionary trained from representative samples provides that history.
+// Dictionaries are 'digested' once (ZSTD_CDict / ZSTD_DDict) and then shared read-only by
+// any number of threads, each thread using its own ZstdContext.
+
+String ZstdTrainDictionary(const Vector<String>& samples, int maxsize)
+{
+	StringBuffer all;
+	Buffer<size_t> size(max(samples.GetCount(), 1));
+	for(int i = 0; i < samples.GetCount(); i++) {
+		all.Cat(samples[i]);
+		size[i] = samples[i].GetLength();
+	}
+	StringBuffer dict(maxsize);
+	size_t sz = ZDICT_trainFromBuffer(~dict, maxsize, ~all, size, samples.GetCount());
+	if(ZDICT_isError(sz))
+		return String::GetVoid();
+	dict.SetCount((int)sz);
+	return String(dict);
+}
+
+ZstdDictionary::ZstdDictionary()
+{
+	cdict = NULL;
+	ddict = NULL;
+	level = 3;
+}
+
+ZstdDictionary::~ZstdDictionary()
+{
+	Clear();
+}
+
+void ZstdDictionary::Clear()
+{
+	if(cdict)
+		ZSTD_freeCDict(cdict);
+	if(ddict)
+		ZSTD_freeDDict(ddict);
+	cdict = NULL;
+	ddict = NULL;
+	data.Clear();
+}
+
+bool ZstdDictionary::Set(const String& dict, int level_)
+{
+	Clear();
+	level = level_;
+	if(dict.IsEmpty())
+		return false;
+	data = dict;
+	cdict = ZSTD_createCDict(~data, data.GetLength(), level);
+	ddict = ZSTD_createDDict(~data, data.GetLength());
+	if(cdict && ddict)
+		return true;
+	Clear();
+	return false;
+}
+
+dword ZstdDictionary::GetId() const
+{
+	return ZSTD_getDictID_fromDict(~data, data.GetLength());
+}
+
+ZstdContext::ZstdContext()
+{
+	cctx = NULL;
+	dctx = NULL;
+	maxsize = INT_MAX;
+}
+
+ZstdContext::~ZstdContext()
+{
+	if(cctx)
+		ZSTD_freeCCtx(cctx);
+	if(dctx)
+		ZSTD_freeDCtx(dctx);
+}
+
+static String sZstdResult(StringBuffer& out, size_t sz)
+{
+	if(ZSTD_isError(sz))
+		return String::GetVoid();
+	out.SetCount((int)sz);
+	return String(out);
+}
+
+String ZstdContext::Compress(const void *data, int len, int level)
+{
+	if(!cctx)
+		cctx = ZSTD_createCCtx();
+	StringBuffer out((int)ZSTD_compressBound(len));
+	return sZstdResult(out, ZSTD_compressCCtx(cctx, ~out, out.GetCount(), data, len, level));
+}
+
+String ZstdContext::Compress(const void *data, int len, const ZstdDictionary& dict)
+{
+	if(dict.IsEmpty())
+		return Compress(data, len, dict.GetLevel());
+	if(!cctx)
+		cctx = ZSTD_createCCtx();
+	StringBuffer out((int)ZSTD_compressBound(len));
+	return sZstdResult(out, ZSTD_compress_usingCDict(cctx, ~out, out.GetCount(), data, len, dict.GetCDict()));
+}
+
+String ZstdContext::DecompressStream(const void *data, int len)
+{
+	ZSTD_inBuffer in = { data, (size_t)len, 0 };
+	StringBuffer out;
+	Buffer<char> h(ZSTD_DStreamOutSize());
+	for(;;) {
+		ZSTD_outBuffer o = { ~h, ZSTD_DStreamOutSize(), 0 };
+		size_t ret = ZSTD_decompressStream(dctx, &o, &in);
+		if(ZSTD_isError(ret) || (int64)out.GetCount() + (int64)o.pos > maxsize)
+			return String::GetVoid();
+		out.Cat(~h, (int)o.pos);
+		if(ret == 0)
+			break;
+		if(in.pos == in.size && o.pos < o.size)
+			return String::GetVoid(); // truncated
+	}
+	return String(out);
+}
+
+String ZstdContext::Decompress0(const void *data, int len, const ZSTD_DDict *ddict)
+{
+	enum { MAX_RESERVE = 4 * 1024 * 1024 }; // size in header is not trusted to allocate more
+	if(!dctx)
+		dctx = ZSTD_createDCtx();
+	unsigned long long sz = ZSTD_getFrameContentSize(data, len);
+	if(sz == ZSTD_CONTENTSIZE_ERROR)
+		return String::GetVoid();
+	if(sz != ZSTD_CONTENTSIZE_UNKNOWN && sz > (unsigned long long)maxsize)
+		return String::GetVoid();
+	if(sz <= MAX_RESERVE) {
+		StringBuffer out((int)sz);
+		size_t n = ddict ? ZSTD_decompress_usingDDict(dctx, ~out, out.GetCount(), data, len, ddict)
+		                 : ZSTD_decompressDCtx(dctx, ~out, out.GetCount(), data, len);
+		if(n != sz)
+			return String::GetVoid();
+		return String(out);
+	}
+	// content size unknown (streamed frame) or large, decompress in pieces
+	ZSTD_DCtx_reset(dctx, ZSTD_reset_session_and_parameters);
+	ZSTD_DCtx_refDDict(dctx, ddict);
+	String r = DecompressStream(data, len);
+	ZSTD_DCtx_refDDict(dctx, NULL); // reference would persist for later calls
+	return r;
+}
+
+String ZstdContext::Decompress(const void *data, int len, const ZstdDictionary& dict)
+{
+	return Decompress0(data, len, dict.GetDDict());
+}
+
+static ZstdContext& sThreadContext()
+{
+	thread_local ZstdContext ctx;
+	return ctx;
+}
+
+String ZstdCompress(const String& s, const ZstdDictionary& dict)
+{
+	return sThreadContext().Compress(s, dict);
+}
+
+String ZstdDecompress(const String& s, const ZstdDictionary& dict)
+{
+	return sThreadContext().Decompress(s, dict);
+}
+
+Vector<String> CoZstdCompress(const Vector<String>& data, const ZstdDictionary& dict)
+{
+	Vector<String> r;
+	r.SetCount(data.GetCount());
+	CoWorkerResources<ZstdContext> ctx;
+	CoFor(data.GetCount(), [&](int i) { r[i] = ctx.Get().Compress(data[i], dict); });
+	return r;
+}
+
+Vector<String> CoZstdDecompress(const Vector<String>& data, const ZstdDictionary& dict)
+{
+	Vector<String> r;
+	r.SetCount(data.GetCount());
+	CoWorkerResources<ZstdContext> ctx;
+	CoFor(data.GetCount(), [&](int i) { r[i] = ctx.Get().Decompress(data[i], dict); });
+	return r;
+}
+
+};
@@ -96,4 +96,25 @@ String CoZstdDecompress(const String& s, Gate<int64, int64> progress)
 	return CoZstdDecompress(~s, s.GetLength(), progress);
 }
 
+INITIALIZER(ZstdCodec)
+{
+	StreamCodec c;
+	c.name = "zstd";
+	c.extension = ".zst";
+	c.default_level = 3;
+	c.Detect = [](const byte *h, int len) {
+		return len >= 4 && (dword)Peek32le(h) == 0xFD2FB528;
+	};
+	c.CompressBlock = [](const void *data, int len, int level) {
+		thread_local ZstdContext ctx;
+		return ctx.Compress(data, len, level);
+	};
+	c.CreateDecompressStream = [](Stream& in, bool co) -> Stream * {
+		ZstdDecompressStream *s = new ZstdDecompressStream(in);
+		s->Co(co);
+		return s;
+	};
+	CodecRegistry::Register(c);
+}
+
 };
\ No newline at end of file
@@ -27,6 +27,16 @@ can be decompressed by Zstd commandline utilities.&]
 encapsulated, nothing special is required from calling thread.&]
 [s3;%% &]
 [s4;%% &]
+[s5;:Upp`:`:ZstdCompressStream`:`:Seekable`(bool`): [@(0.0.255) void]_[* Seekable]([@(0.0.255) b
+ool]_[*@3 b]_`=_[@(0.0.255) true])&]
+[s2;% When active, seek table with compressed and decompressed sizes 
+of all frames is appended at the end of output. Table is stored 
+in skippable frame compatible with zstd seekable format, so output 
+is still readable by standard decoders, while ZstdDecompressStream can use 
+it to Seek to any position, decompressing only the frames covering 
+the requested range. Must be set before Open.&]
+[s3;% &]
+[s4;% &]
 [s5;:Upp`:`:ZstdCompressStream`:`:Open`(Upp`:`:Stream`&`,int`): [@(0.0.255) void]_[* Open
 ]([_^Upp`:`:Stream^ Stream][@(0.0.255) `&]_[*@3 out], [@(0.0.255) int]_[*@3 level]_`=_[@3 1])
 &]
@@ -54,6 +64,15 @@ but slower speed. For fast compression, level 1 is recommended.&]
 encapsulated, nothing special is required from calling thread.&]
 [s3;%% &]
 [s4; &]
+[s5;:Upp`:`:ZstdDecompressStream`:`:IsSeekable`(`)const: [@(0.0.255) bool]_[* IsSeekable]()
+_[@(0.0.255) const]&]
+[s2;% Returns true if input has seek table (see ZstdCompressStream`::Seekable) 
+and input stream is seekable. In that case GetSize returns the 
+size of decompressed data and Seek repositions to any offset by 
+decompressing only the frames that cover it. Without seek table, 
+Seek can only skip forward.&]
+[s3;% &]
+[s4;% &]
 [s5;:Upp`:`:ZstdDecompressStream`:`:Open`(Upp`:`:Stream`&`): [@(0.0.255) bool]_[* Open]([_^Upp`:`:Stream^ S
 tream][@(0.0.255) `&]_[*@3 in])&]
 [s5;:Upp`:`:ZstdDecompressStream`:`:ZstdDecompressStream`(Upp`:`:Stream`&`): [* ZstdDec
@@ -127,4 +146,162 @@ m][@(0.0.255) `&]_[*@3 s])&]
 Seeks back after the check. Returns true if magic number was 
 detected.&]
 [s3;%% &]
+[s4; &]
+[s5;:Upp`:`:ZstdTrainDictionary`(const Upp`:`:Vector`<Upp`:`:String`>`&`,int`): [_^Upp`:`:String^ S
+tring]_[* ZstdTrainDictionary]([@(0.0.255) const]_[_^Upp`:`:Vector^ Vector]<[_^Upp`:`:String^ S
+tring]>`&_[*@3 samples], [@(0.0.255) int]_[*@3 maxsize]_`=_[@3 110]_`*_[@3 1024])&]
+[s2;%% Trains Zstd dictionary of at most [%-*@3 maxsize] bytes from 
+representative [%-*@3 samples] of records to be compressed. Dictionary 
+improves both compression ratio and speed of small records (up 
+to few KB) which do not contain enough history to be compressed 
+well alone. Good training set has at least hundreds of samples 
+and its total size is about 100 times the dictionary size. Returns 
+void String if training fails (e.g. not enough samples). Result 
+can be stored and later used with ZstdDictionary.&]
+[s3;%% &]
+[ {{10000@(113.42.0) [s0;%% [*@7;4 ZstdDictionary]]}}&]
+[s3; &]
+[s1;:Upp`:`:ZstdDictionary`:`:class: [@(0.0.255)3 class][3 _][*3 ZstdDictionary][3 _:_][@(0.0.255)3 p
+rivate][3 _][*@3;3 NoCopy]&]
+[s2;%% Digested Zstd dictionary, prepared once for both compression 
+and decompression. It is read only after Set, so single instance 
+can be shared by any number of threads, each thread using its 
+own ZstdContext.&]
+[s3; &]
+[ {{10000F(128)G(128)@1 [s0;%% [* Public Method List]]}}&]
+[s3; &]
+[s5;:Upp`:`:ZstdDictionary`:`:Set`(const Upp`:`:String`&`,int`): [@(0.0.255) bool]_[* Set
+]([@(0.0.255) const]_[_^Upp`:`:String^ String][@(0.0.255) `&]_[*@3 dict], 
+[@(0.0.255) int]_[*@3 level]_`=_[@3 3])&]
+[s2;%% Sets the dictionary, which can either be trained by ZstdTrainDictionary 
+or any raw content typical for compressed data. [%-*@3 level] is 
+the compression level used with this dictionary. Returns false 
+on failure.&]
+[s3;%% &]
+[s4; &]
+[s5;:Upp`:`:ZstdDictionary`:`:Clear`(`): [@(0.0.255) void]_[* Clear]()&]
+[s2;%% Removes the dictionary.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:ZstdDictionary`:`:IsEmpty`(`)const: [@(0.0.255) bool]_[* IsEmpty]()_[@(0.0.255) c
+onst]&]
+[s2;%% Returns true if there is no dictionary.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:ZstdDictionary`:`:Get`(`)const: [@(0.0.255) const]_[_^Upp`:`:String^ String][@(0.0.255) `&
+]_[* Get]()_[@(0.0.255) const]&]
+[s2;%% Returns the dictionary data.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:ZstdDictionary`:`:GetLevel`(`)const: [@(0.0.255) int]_[* GetLevel]()_[@(0.0.255) c
+onst]&]
+[s2;%% Returns the compression level.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:ZstdDictionary`:`:GetId`(`)const: [_^Upp`:`:dword^ dword]_[* GetId]()_[@(0.0.255) c
+onst]&]
+[s2;%% Returns the id of trained dictionary (stored in compressed 
+frames so that wrong dictionary is detected), 0 for raw content 
+dictionary.&]
+[s3; &]
+[s4; &]
+[s5;:Upp`:`:ZstdDictionary`:`:GetCDict`(`)const: [@(0.0.255) const]_[_^ZSTD`_CDict^ ZSTD`_
+CDict]_`*[* GetCDict]()_[@(0.0.255) const]&]
+[s5;:Upp`:`:ZstdDictionary`:`:GetDDict`(`)const: [@(0.0.255) const]_[_^ZSTD`_DDict^ ZSTD`_
+DDict]_`*[* GetDDict]()_[@(0.0.255) const]&]
+[s2;%% Returns digested dictionaries for direct use with zstd library.&]
+[s3; &]
+[ {{10000F(128)G(128)@1 [s0;%% [* Constructor detail]]}}&]
+[s3; &]
+[s5;:Upp`:`:ZstdDictionary`:`:ZstdDictionary`(const Upp`:`:String`&`,int`): [@(0.0.255) e
+xplicit]_[* ZstdDictionary]([@(0.0.255) const]_[_^Upp`:`:String^ String][@(0.0.255) `&]_[*@3 d
+ict], [@(0.0.255) int]_[*@3 level]_`=_[@3 3])&]
+[s2;%% Same as Set([%-*@3 dict], [%-*@3 level]).&]
+[s3;%% &]
+[ {{10000@(113.42.0) [s0;%% [*@7;4 ZstdContext]]}}&]
+[s3; &]
+[s1;:Upp`:`:ZstdContext`:`:class: [@(0.0.255)3 class][3 _][*3 ZstdContext][3 _:_][@(0.0.255)3 pr
+ivate][3 _][*@3;3 NoCopy]&]
+[s2;%% Reusable compression / decompression context for small records. 
+Unlike ZstdCompress, which sets up stream and buffers for each 
+call, ZstdContext keeps zstd contexts allocated between calls, 
+so its per record overhead is minimal. Output is single zstd frame 
+with content size, compatible with zstd utilities and ZstdDecompress. 
+Context must not be used by more threads at once, use one per 
+thread (e.g. with CoWorkerResources).&]
+[s3; &]
+[ {{10000F(128)G(128)@1 [s0;%% [* Public Method List]]}}&]
+[s3; &]
+[s5;:Upp`:`:ZstdContext`:`:Compress`(const void`*`,int`,int`): [_^Upp`:`:String^ String
+]_[* Compress]([@(0.0.255) const]_[@(0.0.255) void]_`*[*@3 data], [@(0.0.255) int]_[*@3 len], 
+[@(0.0.255) int]_[*@3 level]_`=_[@3 1])&]
+[s5;:Upp`:`:ZstdContext`:`:Compress`(const Upp`:`:String`&`,int`): [_^Upp`:`:String^ St
+ring]_[* Compress]([@(0.0.255) const]_[_^Upp`:`:String^ String][@(0.0.255) `&]_[*@3 s], 
+[@(0.0.255) int]_[*@3 level]_`=_[@3 1])&]
+[s2;%% Compresses data without dictionary with compression [%-*@3 level]. 
+Returns void String on failure.&]
+[s3;%% &]
+[s4; &]
+[s5;:Upp`:`:ZstdContext`:`:Compress`(const void`*`,int`,const Upp`:`:ZstdDictionary`&`): [_^Upp`:`:String^ S
+tring]_[* Compress]([@(0.0.255) const]_[@(0.0.255) void]_`*[*@3 data], [@(0.0.255) int]_[*@3 l
+en], [@(0.0.255) const]_[_^Upp`:`:ZstdDictionary^ ZstdDictionary][@(0.0.255) `&]_[*@3 dict])&]
+[s5;:Upp`:`:ZstdContext`:`:Compress`(const Upp`:`:String`&`,const Upp`:`:ZstdDictionary`&`): [_^Upp`:`:String^ S
+tring]_[* Compress]([@(0.0.255) const]_[_^Upp`:`:String^ String][@(0.0.255) `&]_[*@3 s], 
+[@(0.0.255) const]_[_^Upp`:`:ZstdDictionary^ ZstdDictionary][@(0.0.255) `&]_[*@3 dict])&]
+[s2;%% Compresses data using dictionary [%-*@3 dict]. Returns void String 
+on failure.&]
+[s3;%% &]
+[s4; &]
+[s5;:Upp`:`:ZstdContext`:`:Decompress`(const void`*`,int`): [_^Upp`:`:String^ String]_[* D
+ecompress]([@(0.0.255) const]_[@(0.0.255) void]_`*[*@3 data], [@(0.0.255) int]_[*@3 len])&]
+[s5;:Upp`:`:ZstdContext`:`:Decompress`(const Upp`:`:String`&`): [_^Upp`:`:String^ Strin
+g]_[* Decompress]([@(0.0.255) const]_[_^Upp`:`:String^ String][@(0.0.255) `&]_[*@3 s])&]
+[s5;:Upp`:`:ZstdContext`:`:Decompress`(const void`*`,int`,const Upp`:`:ZstdDictionary`&`): [_^Upp`:`:String^ S
+tring]_[* Decompress]([@(0.0.255) const]_[@(0.0.255) void]_`*[*@3 data], 
+[@(0.0.255) int]_[*@3 len], [@(0.0.255) const]_[_^Upp`:`:ZstdDictionary^ ZstdDictionary][@(0.0.255) `&
+]_[*@3 dict])&]
+[s5;:Upp`:`:ZstdContext`:`:Decompress`(const Upp`:`:String`&`,const Upp`:`:ZstdDictionary`&`): [_^Upp`:`:String^ S
+tring]_[* Decompress]([@(0.0.255) const]_[_^Upp`:`:String^ String][@(0.0.255) `&]_[*@3 s], 
+[@(0.0.255) const]_[_^Upp`:`:ZstdDictionary^ ZstdDictionary][@(0.0.255) `&]_[*@3 dict])&]
+[s2;%% Decompresses data, optionally using dictionary [%-*@3 dict]. 
+Returns void String if data are corrupted, compressed with different 
+dictionary or larger than MaxSize. Output is allocated in advance 
+only up to 4MB, larger data grow the output as they are decoded, 
+so the size stored in the (untrusted) frame header cannot force 
+large allocation.&]
+[s3;%% &]
+[s4; &]
+[s5;:Upp`:`:ZstdContext`:`:MaxSize`(int`): [_^Upp`:`:ZstdContext^ ZstdContext][@(0.0.255) `&
+]_[* MaxSize]([@(0.0.255) int]_[*@3 bytes])&]
+[s2;%% Sets the maximal size of decompressed data (default is INT`_MAX). 
+Returns `*this.&]
+[s3;%% &]
+[s4; &]
+[s5;:Upp`:`:ZstdContext`:`:GetMaxSize`(`)const: [@(0.0.255) int]_[* GetMaxSize]()_[@(0.0.255) c
+onst]&]
+[s2;%% Returns the maximal size of decompressed data.&]
+[s3;%% &]
+[ {{10000@(113.42.0) [s0;%% [*@7;4 Dictionary functions]]}}&]
+[s3; &]
+[s5;:Upp`:`:ZstdCompress`(const Upp`:`:String`&`,const Upp`:`:ZstdDictionary`&`): [_^Upp`:`:String^ S
+tring]_[* ZstdCompress]([@(0.0.255) const]_[_^Upp`:`:String^ String][@(0.0.255) `&]_[*@3 s], 
+[@(0.0.255) const]_[_^Upp`:`:ZstdDictionary^ ZstdDictionary][@(0.0.255) `&]_[*@3 dict])&]
+[s5;:Upp`:`:ZstdDecompress`(const Upp`:`:String`&`,const Upp`:`:ZstdDictionary`&`): [_^Upp`:`:String^ S
+tring]_[* ZstdDecompress]([@(0.0.255) const]_[_^Upp`:`:String^ String][@(0.0.255) `&]_[*@3 s
+], [@(0.0.255) const]_[_^Upp`:`:ZstdDictionary^ ZstdDictionary][@(0.0.255) `&]_[*@3 dict])&]
+[s2;%% Compresses / decompresses single record with dictionary using 
+ZstdContext private to calling thread.&]
+[s3;%% &]
+[s4; &]
+[s5;:Upp`:`:CoZstdCompress`(const Upp`:`:Vector`<Upp`:`:String`>`&`,const Upp`:`:ZstdDictionary`&`): [_^Upp`:`:Vector^ V
+ector]<[_^Upp`:`:String^ String]>_[* CoZstdCompress]([@(0.0.255) const]_[_^Upp`:`:Vector^ V
+ector]<[_^Upp`:`:String^ String]>`&_[*@3 data], [@(0.0.255) const]_[_^Upp`:`:ZstdDictionary^ Z
+stdDictionary][@(0.0.255) `&]_[*@3 dict])&]
+[s5;:Upp`:`:CoZstdDecompress`(const Upp`:`:Vector`<Upp`:`:String`>`&`,const Upp`:`:ZstdDictionary`&`): [_^Upp`:`:Vector^ V
+ector]<[_^Upp`:`:String^ String]>_[* CoZstdDecompress]([@(0.0.255) const]_[_^Upp`:`:Vector^ V
+ector]<[_^Upp`:`:String^ String]>`&_[*@3 data], [@(0.0.255) const]_[_^Upp`:`:ZstdDictionary^ Z
+stdDictionary][@(0.0.255) `&]_[*@3 dict])&]
+[s2;%% Compresses / decompresses a batch of records in parallel, with 
+one ZstdContext per worker thread.&]
+[s3;%% &]
 [s0;%% ]]
\ No newline at end of file
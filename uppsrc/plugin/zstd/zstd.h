@@ -8,6 +8,8 @@
 
 namespace Upp {
 
+INITIALIZE(ZstdCodec);
+
 class ZstdCompressStream : public Stream  {
 public:
 	virtual   void  Close();
@@ -28,6 +30,9 @@ protected:
 	int           level;
 	
 	bool          concurrent;
+	bool          seekable;
+	
+	Vector<Tuple<dword, dword>> seektable; // compressed / decompressed size of frames
     
     void          Alloc();
 	void          Init();
@@ -35,6 +40,7 @@ protected:
 
 public:
 	void Co(bool b = true);
+	void Seekable(bool b = true)                             { seekable = b; }
 	void Open(Stream& out, int level = 1);
 
 	ZstdCompressStream();
@@ -45,6 +51,8 @@ public:
 class ZstdDecompressStream : public Stream {
 public:
 	virtual   bool  IsOpen() const;
+	virtual   void  Seek(int64 pos);
+	virtual   int64 GetSize() const;
 
 protected:
 	virtual   int   _Term();
@@ -80,6 +88,9 @@ private:
 	bool         eof;
 	
 	bool         concurrent;
+	
+	Vector<int64> seek_c, seek_d; // seek table: compressed / decompressed frame offsets
+	int           cframe; // frame at compressed_at (if there is seek table)
 
     void          TryHeader();
 
@@ -91,6 +102,7 @@ private:
 public:	
 	bool Open(Stream& in);
 	void Co(bool b = true)                                    { concurrent = b; }
+	bool IsSeekable() const                                   { return seek_c.GetCount(); }
 
 	ZstdDecompressStream();
 	ZstdDecompressStream(Stream& in) : ZstdDecompressStream() { Open(in); }
@@ -113,6 +125,62 @@ String CoZstdDecompress(const String& s, Gate<int64, int64> progress = Null);
 
 bool IsZstd(Stream& s);
 
+String ZstdTrainDictionary(const Vector<String>& samples, int maxsize = 110 * 1024);
+
+class ZstdDictionary : NoCopy {
+	String      data;
+	ZSTD_CDict *cdict;
+	ZSTD_DDict *ddict;
+	int         level;
+
+public:
+	bool              Set(const String& dict, int level = 3);
+	void              Clear();
+
+	bool              IsEmpty() const                         { return !cdict; }
+	const String&     Get() const                             { return data; }
+	int               GetLevel() const                        { return level; }
+	dword             GetId() const;
+
+	const ZSTD_CDict *GetCDict() const                        { return cdict; }
+	const ZSTD_DDict *GetDDict() const                        { return ddict; }
+
+	ZstdDictionary();
+	explicit ZstdDictionary(const String& dict, int level = 3) : ZstdDictionary() { Set(dict, level); }
+	~ZstdDictionary();
+};
+
+class ZstdContext : NoCopy { // reusable per-thread context for small records
+	ZSTD_CCtx *cctx;
+	ZSTD_DCtx *dctx;
+	int        maxsize;
+
+	String     Decompress0(const void *data, int len, const ZSTD_DDict *ddict);
+	String     DecompressStream(const void *data, int len);
+
+public:
+	String Compress(const void *data, int len, int level = 1);
+	String Compress(const String& s, int level = 1)           { return Compress(~s, s.GetLength(), level); }
+	String Compress(const void *data, int len, const ZstdDictionary& dict);
+	String Compress(const String& s, const ZstdDictionary& dict) { return Compress(~s, s.GetLength(), dict); }
+	String Decompress(const void *data, int len)              { return Decompress0(data, len, NULL); }
+	String Decompress(const String& s)                        { return Decompress(~s, s.GetLength()); }
+	String Decompress(const void *data, int len, const ZstdDictionary& dict);
+	String Decompress(const String& s, const ZstdDictionary& dict) { return Decompress(~s, s.GetLength(), dict); }
+
+	ZstdContext& MaxSize(int bytes)                           { maxsize = bytes; return *this; }
+	int          GetMaxSize() const                           { return maxsize; }
+
+	ZstdContext();
+	~ZstdContext();
+};
+
+String ZstdCompress(const String& s, const ZstdDictionary& dict);
+String ZstdDecompress(const String& s, const ZstdDictionary& dict);
+
+Vector<String> CoZstdCompress(const Vector<String>& data, const ZstdDictionary& dict);
+Vector<String> CoZstdDecompress(const Vector<String>& data, const ZstdDictionary& dict);
+
 }
 
 #endif